@@ -29,6 +29,8 @@ namespace vaca {
 @titleRow{URL}
   @itemRow{decode_url}
   @itemRow{encode_url}
+  @itemRow{url_decode}
+  @itemRow{url_encode}
 @titleRow{Bindings}
   @itemRow{page_bind, Adapts functions or methods to be connected to signals.}
   @itemRow{Ref}
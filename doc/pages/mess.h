@@ -18,10 +18,10 @@ MESS stands for Message-Event-Signal/Slot:
 @li @c Message: a message produced by the operating system (e.g. @msdn{WM_KEYUP}).
 @li @c Event: a virtual method to control the message (e.g. Widget#onKeyUp)
 @li @c Signal: a variable member which anybody can connect their callbacks (e.g. Widget#KeyUp)
-@li @c Slot: an instance of @link Slot0 Slot@endlink that wraps functions,
+@li @c Slot: an instance of @link Slot Slot@endlink that wraps functions,
     function objects (@em functors), or classes' methods.
     They are automatically created/connected to signals when you
-    use functions like @link Signal0_base#connect Signal::connect@endlink.
+    use functions like @link Signal_base#connect Signal::connect@endlink.
 
 Basically when a @em message came from the operating system, it means
 that the user inputs a value or is waiting for an output. The @em message
@@ -30,8 +30,8 @@ Default implementations of the events fire a @em signal
 related to that event.
 
 Signals can be intercepted by anyone. Each connection to a signal is
-called a @link Slot0 slot@endlink. You shouldn't worry about slots,
-they are created and destroyed automatically, you just use Signal0#connect.
+called a @link Slot slot@endlink. You shouldn't worry about slots,
+they are created and destroyed automatically, you just use Signal_base#connect.
 
 In each Vaca's widget there are defined methods to handle @em events
 inside the widget, and there are @em signals for events that should be
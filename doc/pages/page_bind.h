@@ -47,8 +47,8 @@ Prints the value
 Why? There are two things in the example:
 
 @li First we call @em Bind<int>(&func, 1, 2) constructor, which creates
-    a BindAdapter object that allocates memory to hold the address of 
-    @em func and two integers (1 and 2 in this case).
+    a BindAdapter object that holds the address of @em func and two
+    integers (1 and 2 in this case).
 @li Then we are calling the @em operator()(double, const char*, int) of
     that new BindAdapter. The BindAdapter completelly ignores those
     arguments (2.3, "Hello", 200) and a call to @em func(1, 2) is made
@@ -73,7 +73,7 @@ int func(int a, int b)
 
 int main()
 {
-  vaca::BindAdapter2_fun<int, int(*)(int,int), int, int>
+  vaca::BindAdapter<int, int(*)(int,int), int, int>
     adapter(&func, 1, 2);
 
   std::cout << adapter() << std::endl;
@@ -91,7 +91,15 @@ It will print:
 3
 @endcode
 Arguments in each call are ignored, just the values passed in the
-constructor of BindAdapter2_fun() are used.
+constructor of BindAdapter are used.
+
+If you want to use the arguments of the call, you can bind
+placeholders: @c _1 is replaced with the first argument of the
+call, @c _2 with the second one, etc.
+@code
+using namespace vaca::placeholders;
+vaca::Bind<int>(&func, _2, 10)(2.3, 5); // calls func(5, 10)
+@endcode
 
 
 @section page_bind_signals How to Use Bind With Signals?
@@ -99,6 +107,13 @@ constructor of BindAdapter2_fun() are used.
 
 @section page_bind_details Details About Bind
 
+@li Bind accepts any number of arguments, and they are stored by value
+    inside the BindAdapter (use Ref to store a reference). Move-only
+    arguments (like a std::unique_ptr) can be bound too.
+@li Empty function objects take no space inside the BindAdapter, and a
+    bound member function holds only the pointer to member and the
+    instance, so it can be stored inside a Slot without allocating memory.
+
 */
 
 }
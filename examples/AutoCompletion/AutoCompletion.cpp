@@ -600,15 +600,24 @@ int ColorNames_size = sizeof(ColorNames) / sizeof(struct ColorName);
 class AutoCompletionComboBox : public ComboBox
 {
   Timer m_timer;
+  PrefixIndex m_index;
+  PrefixIndex::Search m_search;
 
 public:
 
   AutoCompletionComboBox(Widget* parent)
     : ComboBox(parent, ComboBox::Styles::Editable)
     , m_timer(250)
+    , m_search(m_index)
   {
-    for (int c=0; c<ColorNames_size; ++c)
+    // the IDs of the index are the indexes of the items, and the
+    // first items have a higher rank (like the order of the list)
+    for (int c=0; c<ColorNames_size; ++c) {
       addItem(ColorNames[c].name);
+      m_index.add(ColorNames[c].name, ColorNames_size - c);
+    }
+    m_index.build();
+    m_search.reset();
 
     m_timer.Tick.connect(&AutoCompletionComboBox::complete, this);
   }
@@ -640,7 +649,15 @@ private:
     String text = getText();
     int len1 = text.size();
 
-    setSelectedItem(text);
+    // only the items of the previous prefix are searched
+    std::vector<int> ids;
+    m_search.setPrefix(text);
+    m_index.getTopMatches(m_search.getRange(), 1, ids);
+
+    if (!ids.empty())
+      setSelectedItem(ids[0]);
+    else
+      setSelectedItem(-1);
     setDropDownVisibile(true);
 
     String new_text = getText();
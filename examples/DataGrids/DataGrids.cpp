@@ -594,6 +594,7 @@ class GridView : public Widget
   std::vector<GridValue> m_values;
   std::vector<GridColumn> m_columns;
   std::vector<GridRow> m_rows;
+  RectBatch m_rowSpans;		// vertical position of each row (the first one in y=0)
   int m_currentRow;
   int m_hotRow;
   int m_hotCol;
@@ -1182,6 +1183,7 @@ void GridView::clearGrid()
   //   delete m_columns[i];
 
   m_rows.clear();
+  m_rowSpans.clear();
   m_columns.clear();
 }
 
@@ -1213,6 +1215,9 @@ void GridView::addRow(const GridRow& row)
   row2.m_rowHeight = m_headerHeight;
   m_rows.push_back(row2);
 
+  Rect prev = m_rowSpans.empty() ? Rect(): m_rowSpans[m_rowSpans.size()-1];
+  m_rowSpans.add(Rect(0, prev.y+prev.h, 1, row2.m_rowHeight));
+
   resizeCells(oldRowCount, getColumnCount());
 }
 
@@ -1252,14 +1257,17 @@ int GridView::getColumnByPoint(const Point& pt, bool useRows)
 
 int GridView::getRowByPoint(const Point& pt)
 {
-  Rect bounds = getClientBounds();
-  int rowCount = getRowCount();
+  if (m_rows.empty())
+    return NULL_ROW_INDEX;
 
-  for (int i=0; i<rowCount; ++i)
-    if (getRowBounds(i).contains(pt))
-      return i;
+  // all rows have the horizontal bounds of the first one, so only the
+  // vertical position is searched
+  Rect first = getRowBounds(0);
+  if (pt.x < first.x || pt.x >= first.x+first.w)
+    return NULL_ROW_INDEX;
 
-  return NULL_ROW_INDEX;
+  int i = m_rowSpans.findFirst(Point(0, pt.y - first.y));
+  return i >= 0 ? i: NULL_ROW_INDEX;
 }
 
 Rect GridView::getColumnBounds(int columnIndex)
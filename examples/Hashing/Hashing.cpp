@@ -38,10 +38,10 @@ static String MD5File(const String& fileName)
   MD5Final(digest, &md5);
 
   // transform "digest" to String
-  String res;
+  FormatBuffer res;
   for(int c=0; c<16; ++c)
-    res += format_string(L"%02x", digest[c]);
-  return res;
+    VACA_FORMAT_TO(res, L"{:02x}", digest[c]);
+  return res.str();
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -67,10 +67,10 @@ static String SHA1File(const String &fileName)
   SHA1Result(&sha, digest);
 
   // transform "digest" to String
-  String res;
+  FormatBuffer res;
   for(int c=0; c<20; ++c)
-    res += format_string(L"%02x", digest[c]);
-  return res;
+    VACA_FORMAT_TO(res, L"{:02x}", digest[c]);
+  return res.str();
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -268,6 +268,8 @@ class MainFrame : public MdiFrame
   int m_docCounter; // counter for documents (only to make "Untitled1", "Untitled2", etc.)
   Font m_font;
   bool m_viewEol;
+  Utf8TextSearch m_search; // last search (reused by each "Find Next")
+  String m_searchText;
 
 public:
 
@@ -276,6 +278,7 @@ public:
     , m_docCounter(0)
     , m_font(L"Courier New", 10)
     , m_viewEol(false)
+    , m_search("")
   {
     setMenuBar(createMenuBar());
     setIcon(ResourceId(IDI_VACA));
@@ -547,35 +550,26 @@ private:
   {
     SciEdit &sciEdit(getTextEditor()->getEditor());
     String findWhat = dlg->getFindWhat();
-    int flags =
-      (dlg->isMatchCase() ? SCFIND_MATCHCASE: 0) |
-      (dlg->isWholeWord() ? SCFIND_WHOLEWORD: 0);
+
+    // prepare the search only when the options change
+    if (m_searchText != findWhat ||
+	m_search.isMatchCase() != dlg->isMatchCase() ||
+	m_search.isWholeWord() != dlg->isWholeWord()) {
+      m_search = Utf8TextSearch(sciEdit.encodeText(findWhat),
+				dlg->isMatchCase(),
+				dlg->isWholeWord());
+      m_searchText = findWhat;
+    }
 
     // forward search
     if (dlg->isForward()) {
-      sciEdit.goToPos(sciEdit.getSelectionEnd());
-      sciEdit.searchAnchor();
-
-      if (!sciEdit.searchNext(flags, findWhat))
+      if (!sciEdit.findNext(m_search))
 	Beep(100, 10);
-
-      int start = sciEdit.getSelectionStart();
-      int end = sciEdit.getSelectionEnd();
-      sciEdit.goToPos(end);
-      sciEdit.setAnchor(start);
     }
     // backward search
     else {
-      sciEdit.goToPos(sciEdit.getSelectionStart());
-      sciEdit.searchAnchor();
-
-      if (!sciEdit.searchPrev(flags, findWhat))
+      if (!sciEdit.findPrev(m_search))
 	Beep(100, 10);
-
-      int start = sciEdit.getSelectionStart();
-      int end = sciEdit.getSelectionEnd();
-      sciEdit.goToPos(start);
-      sciEdit.setAnchor(end);
     }
   }
 
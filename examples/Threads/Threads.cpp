@@ -10,13 +10,15 @@
 
 using namespace vaca;
 
-Message progress_message(L"Vaca.Message.Progress");
 Message kill_message(L"Vaca.Message.Kill");
-Message end_message(L"Vaca.Message.End");
+
+// Signals emitted by working threads, their slots are called in the
+// main thread (the thread that connected them)
+typedef QueuedSignal<void(ThreadId)> ThreadSignal;
 
 //////////////////////////////////////////////////////////////////////
 
-void working_thread(Widget* dest)
+void working_thread(ThreadSignal* progress, ThreadSignal* end)
 {
   ThreadId id = CurrentThread::getId();
 
@@ -25,8 +27,9 @@ void working_thread(Widget* dest)
 
     // After doing something, we can notify the main thread for a
     // event (like disk error, end-of-file, one packet was received,
-    // etc.); here we are enqueuing a message towards the widget...
-    dest->enqueueMessage(Message(progress_message, (void*)id));
+    // etc.); here we are enqueuing a call to the slots connected
+    // from the main thread...
+    (*progress)(id);
 
     // Look if the main thread send us a message to stop working
     Message message;
@@ -35,7 +38,7 @@ void working_thread(Widget* dest)
   }
 
   // Notify the main thread so it can remove the related ThreadView widget
-  dest->enqueueMessage(Message(end_message, (void*)id));
+  (*end)(id);
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -94,6 +97,8 @@ class MainFrame : public Frame
   Button m_createThread;
   Threads m_threads;
   StatusBar m_statusBar;
+  ThreadSignal m_progress;
+  ThreadSignal m_end;
 
 public:
 
@@ -105,6 +110,8 @@ public:
     setLayout(new BoxLayout(Orientation::Vertical, false));
 
     m_createThread.Click.connect(Bind(&MainFrame::onCreateThread, this));
+    m_progress.connect(&MainFrame::onThreadProgress, this);
+    m_end.connect(&MainFrame::onThreadEnd, this);
 
     setSize(getBounds().w, getPreferredSize().h);
   }
@@ -131,7 +138,7 @@ protected:
   void onCreateThread()
   {
     // Create the new thread
-    Thread* newThread = new Thread(Bind<void>(&working_thread, this));
+    Thread* newThread = new Thread(Bind<void>(&working_thread, &m_progress, &m_end));
     m_threads.push_back(newThread);
 
     // Create a progress bar and a "Kill" button to stop the new thread
@@ -152,46 +159,34 @@ protected:
       threadView->setupDyingThread();
   }
 
-  // We need to override "preTranslateMessage" to get messages from
-  // other threads
-  virtual bool preTranslateMessage(Message& message)
+  void onThreadProgress(ThreadId id)
   {
-    if (Frame::preTranslateMessage(message))
-      return true;
-
-    if (message == progress_message) {
-      ThreadId id = (ThreadId)message.getPayload();
-      if (ThreadView* threadView = getThreadView(id)) {
-	threadView->makeProgress();
-      }
-      return true;
-    }
-    else if (message == end_message) {
-      ThreadId id = (ThreadId)message.getPayload();
-      if (ThreadView* threadView = getThreadView(id)) {
-	// Get the thread that sent us the "end_message"
-	Thread* thread = threadView->getThread();
+    if (ThreadView* threadView = getThreadView(id))
+      threadView->makeProgress();
+  }
+
+  void onThreadEnd(ThreadId id)
+  {
+    if (ThreadView* threadView = getThreadView(id)) {
+      // Get the thread that called the "m_end" signal
+      Thread* thread = threadView->getThread();
 
-	// Erase it from the list of current running threads
-	remove_from_container(m_threads, thread);
+      // Erase it from the list of current running threads
+      remove_from_container(m_threads, thread);
 
-	// Remove the thread-view widget
-	delete threadView;
+      // Remove the thread-view widget
+      delete threadView;
 
-	// Resize
-	setSize(getBounds().w, getPreferredSize().h);
+      // Resize
+      setSize(getBounds().w, getPreferredSize().h);
 
-	// Join the thread and delete it
-	thread->join();
-	delete thread;
+      // Join the thread and delete it
+      thread->join();
+      delete thread;
 
-	// Show a status message, we are done
-	m_statusBar.setText(format_string(L"Thread %d joined.", id));
-      }
-      return true;
+      // Show a status message, we are done
+      m_statusBar.setText(format_string(L"Thread %d joined.", id));
     }
-
-    return false;
   }
 
   ThreadView* getThreadView(ThreadId id)
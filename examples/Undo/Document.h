@@ -11,12 +11,12 @@
 
 using namespace vaca;
 
-typedef String::size_type DocPos;
+typedef std::size_t DocPos;
 
 class Document : public Referenceable
 {
   String m_name;
-  String m_string;
+  TextBuffer m_text;
 
 public:
 
@@ -31,23 +31,33 @@ public:
   }
 
   Char at(DocPos pos) const {
-    return m_string.at(pos);
+    return m_text.at(pos);
   }
 
   DocPos size() const {
-    return m_string.size();
+    return m_text.size();
+  }
+
+  // Returns a copy of the current text (in constant time) that can be
+  // used to restore it
+  TextBuffer getText() const {
+    return m_text;
+  }
+
+  void setText(const TextBuffer& text) {
+    m_text = text;
   }
 
   void add(DocPos pos, Char chr) {
-    m_string.insert(pos, 1, chr);
+    m_text.insert(pos, chr);
   }
 
   void add(DocPos pos, const String& s) {
-    m_string.insert(pos, s);
+    m_text.insert(pos, StringView(s));
   }
 
   void remove(DocPos pos, DocPos n) {
-    m_string.erase(pos, n);
+    m_text.erase(pos, n);
   }
 
 };
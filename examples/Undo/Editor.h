@@ -108,17 +108,22 @@ protected:
 		    Rect(origPt, Size(celBox.w*max_length, celBox.h)),
 		    Size(6, 6));
     if (m_doc) {
-      for (DocPos i=0; i<m_doc->size(); ++i) {
-	int x = origPt.x+i*celBox.w;
+      TextBuffer text = m_doc->getText();
+      DocPos i = 0;
 
-	g.drawRoundRect(blackPen,
-			Rect(Point(x, origPt.y), celBox),
-			Size(6, 6));
+      for (TextBuffer::ChunkIterator it = text.begin(); it != text.end(); ++it) {
+	for (StringView::iterator chr = it->begin(); chr != it->end(); ++chr, ++i) {
+	  int x = origPt.x+i*celBox.w;
 
-	tmp[0] = m_doc->at(i);
+	  g.drawRoundRect(blackPen,
+			  Rect(Point(x, origPt.y), celBox),
+			  Size(6, 6));
 
-	g.drawString(tmp, Color::Black,
-		     Point(x, origPt.y) + Point(celBox)/2 - Point(g.measureString(tmp))/2);
+	  tmp[0] = *chr;
+
+	  g.drawString(tmp, Color::Black,
+		       Point(x, origPt.y) + Point(celBox)/2 - Point(g.measureString(tmp))/2);
+	}
       }
 
       // draw the caret
@@ -1,4 +1,8 @@
 #include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
 
 #include "vaca/Bind.h"
 #include "vaca/Signal.h"
@@ -536,3 +540,174 @@ TEST_F(RefTest, test2_int)
 }
 
 }
+
+//////////////////////////////////////////////////////////////////////
+
+namespace test3 {
+
+using namespace vaca::placeholders;
+
+struct Empty {
+  int operator()(int a, int b) { return a - b; }
+};
+
+struct Job {
+  int value;
+  explicit Job(int value) : value(value) { }
+};
+
+int sub(int a, int b) { return a - b; }
+int peek(const std::unique_ptr<Job>& job) { return job->value; }
+int consume(std::unique_ptr<Job> job) { return job->value; }
+
+struct T4 {
+  int k;
+  T4() : k(10) { }
+  int scale(int a) const { return a*k; }
+  int add(int a, int b) { return a+b+k; }
+};
+
+// Empty function objects take no space, and a bound member function
+// is just the pointer to member plus the instance
+static_assert(sizeof(Bind<int>(Empty())) == 1, "empty functor should take no space");
+static_assert(sizeof(Bind<int>(Empty(), 1)) == sizeof(int), "EBO");
+static_assert(sizeof(Bind(&T4::add, (T4*)NULL)) == sizeof(int (T4::*)(int, int)) + sizeof(T4*),
+	      "a bound member function must not store anything else");
+
+// Move-only arguments make move-only adapters
+static_assert(!std::is_copy_constructible<decltype(Bind<int>(&peek, std::unique_ptr<Job>()))>::value,
+	      "move-only bound arguments");
+static_assert(std::is_nothrow_move_constructible<decltype(Bind<int>(&peek, std::unique_ptr<Job>()))>::value,
+	      "adapters with move-only arguments can be stored inline in a Slot");
+
+TEST(Bind, Placeholders)
+{
+  EXPECT_EQ(3, Bind<int>(&sub, _1, _2)(5, 2));
+  EXPECT_EQ(-3, Bind<int>(&sub, _2, _1)(5, 2));
+  EXPECT_EQ(4, Bind<int>(&sub, 6, _1)(2, 100));
+  EXPECT_EQ(1, Bind<int>(Empty(), _2, 1)(0, 2));
+
+  T4 a;
+  EXPECT_EQ(17, Bind(&T4::add, &a, _1, 5)(2));
+  EXPECT_EQ(30, Bind(&T4::scale, &a, _1)(3));
+
+  Signal2<int, int, int> s;
+  s.connect(Bind<int>(&sub, _2, _1));
+  EXPECT_EQ(1, s(2, 3));
+}
+
+TEST(Bind, MoveOnlyArguments)
+{
+  std::unique_ptr<Job> job(new Job(7));
+  Job* ptr = job.get();
+
+  // the adapter owns the job, it is passed to peek() as an lvalue
+  Slot<int()> slot(Bind<int>(&peek, std::move(job)));
+  EXPECT_EQ(NULL, job.get());
+  EXPECT_EQ(7, slot());
+  EXPECT_EQ(7, slot());
+
+  // moved slots move the adapter (and the job) too
+  Slot<int()> slot2(std::move(slot));
+  EXPECT_TRUE(slot.empty());
+  EXPECT_EQ(7, slot2());
+
+  // an rvalue adapter gives the job to consume()
+  std::unique_ptr<Job> job2(new Job(9));
+  auto adapter = Bind<int>(&consume, std::move(job2));
+  EXPECT_EQ(9, std::move(adapter)());
+  (void)ptr;
+}
+
+TEST(Bind, CopySignalWithMoveOnlySlot)
+{
+  Signal0<int> sig;
+  sig.connect(Bind<int>(&peek, std::unique_ptr<Job>(new Job(5))));
+  EXPECT_EQ(5, sig());
+
+  // the slot cannot be copied, the original signal is not modified
+  EXPECT_THROW(Signal0<int> copy(sig), std::logic_error);
+
+  Signal0<int> other;
+  EXPECT_THROW(other = sig, std::logic_error);
+  EXPECT_EQ(5, sig());
+}
+
+TEST(Bind, NoCopiesWithRvalues)
+{
+  ctor_hits = copy_ctor_hits = 0;
+  test2::Int n(5);
+  auto adapter = Bind<void>(&test2::f1, std::move(n));
+  EXPECT_EQ(1, copy_ctor_hits);	// test2::Int has no move constructor
+
+  copy_ctor_hits = 0;
+  adapter();
+  adapter(1, 2.0, "ignored");
+  EXPECT_EQ(0, copy_ctor_hits);
+}
+
+} // test3
+
+//////////////////////////////////////////////////////////////////////
+// Benchmark
+
+namespace test4 {
+
+// The fixed-arity adapter that Bind used to return for a member
+// function with one bound argument (BindAdapter1_mem)
+template<typename R, typename T, typename B1, typename X1>
+class LegacyBindAdapter1_mem
+{
+  R (T::*m)(B1);
+  T* t;
+  X1 x1;
+public:
+  LegacyBindAdapter1_mem(R (T::*m)(B1), T* t, X1 x1) : m(m), t(t), x1(x1) { }
+
+  R operator()() { return (t->*m)(x1); }
+
+  template<typename A1>
+  R operator()(const A1&) { return (t->*m)(x1); }
+};
+
+struct Acc {
+  int total;
+  Acc() : total(0) { }
+  int add(int a) { total += a; return total; }
+};
+
+template<typename F>
+double run(F f, int n)
+{
+  std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+  for (int i=0; i<n; ++i)
+    f(i);
+  std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+TEST(BindBenchmark, DirectCall)
+{
+  const int n = 10000000;
+  Acc a, b;
+
+  double legacy = run(LegacyBindAdapter1_mem<int, Acc, int, int>(&Acc::add, &a, 3), n);
+  double bind = run(Bind(&Acc::add, &b, 3), n);
+
+  EXPECT_EQ(a.total, b.total);
+  std::printf("%d calls: legacy adapter %.2f ms, Bind %.2f ms\n",
+	      n, legacy, bind);
+
+  Signal1<int, int> s1, s2;
+  Acc d, e;
+  s1.connect(LegacyBindAdapter1_mem<int, Acc, int, int>(&Acc::add, &d, 3));
+  s2.connect(Bind(&Acc::add, &e, 3));
+  legacy = run([&s1](int i) { s1(i); }, n);
+  bind = run([&s2](int i) { s2(i); }, n);
+
+  EXPECT_EQ(d.total, e.total);
+  std::printf("%d emissions: legacy adapter %.2f ms, Bind %.2f ms\n",
+	      n, legacy, bind);
+}
+
+} // test4
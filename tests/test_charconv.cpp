@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <limits>
+#include <vector>
+
+#include "vaca/CharConv.h"
+
+using namespace vaca;
+
+template<class T>
+static String str(T value)
+{
+  Char buf[max_number_chars];
+  ToCharsResult res = to_chars(buf, buf+max_number_chars, value);
+  EXPECT_EQ(CharConvError::None, res.error);
+  return String(buf, res.ptr);
+}
+
+template<class T>
+static T parse(const String& s, CharConvError expectedError = CharConvError::None,
+	       std::size_t expectedLength = String::npos)
+{
+  T value = T();
+  FromCharsResult res = from_chars(s.data(), s.data()+s.size(), value);
+  EXPECT_EQ(expectedError, res.error);
+  EXPECT_EQ(expectedLength == String::npos ? s.size(): expectedLength,
+	    (std::size_t)(res.ptr - s.data()));
+  return value;
+}
+
+TEST(CharConv, Integers)
+{
+  EXPECT_EQ(L"0",	str(0));
+  EXPECT_EQ(L"7",	str(7));
+  EXPECT_EQ(L"-10",	str(-10));
+  EXPECT_EQ(L"123456",	str(123456));
+  EXPECT_EQ(L"-2147483648", str(INT_MIN));
+  EXPECT_EQ(L"2147483647",  str(INT_MAX));
+  EXPECT_EQ(L"4294967295",  str(UINT_MAX));
+
+  for (int i=-1000; i<=1000; ++i)
+    EXPECT_EQ(i, parse<int>(str(i)));
+
+  EXPECT_EQ(INT_MIN,   parse<int>(str(INT_MIN)));
+  EXPECT_EQ(INT_MAX,   parse<int>(str(INT_MAX)));
+  EXPECT_EQ(LONG_MIN,  parse<long>(str(LONG_MIN)));
+  EXPECT_EQ(LONG_MAX,  parse<long>(str(LONG_MAX)));
+  EXPECT_EQ(UINT_MAX,  parse<unsigned int>(str(UINT_MAX)));
+  EXPECT_EQ(ULONG_MAX, parse<unsigned long>(str(ULONG_MAX)));
+  EXPECT_EQ(LLONG_MIN,  parse<long long>(str(LLONG_MIN)));
+  EXPECT_EQ(ULLONG_MAX, parse<unsigned long long>(str(ULLONG_MAX)));
+}
+
+TEST(CharConv, IntegerErrors)
+{
+  EXPECT_EQ(12, parse<int>(L"12abc", CharConvError::None, 2));
+  EXPECT_EQ(0,  parse<int>(L"abc", CharConvError::InvalidArgument, 0));
+  EXPECT_EQ(0,  parse<int>(L"", CharConvError::InvalidArgument, 0));
+  EXPECT_EQ(0,  parse<int>(L"-", CharConvError::InvalidArgument, 0));
+  EXPECT_EQ(0,  parse<int>(L" 1", CharConvError::InvalidArgument, 0));
+  EXPECT_EQ(0,  parse<unsigned int>(L"-1", CharConvError::InvalidArgument, 0));
+  EXPECT_EQ(0,  parse<int>(L"2147483648", CharConvError::OutOfRange));
+  EXPECT_EQ(0,  parse<int>(L"-2147483649", CharConvError::OutOfRange));
+  EXPECT_EQ(0,  parse<unsigned int>(L"4294967296", CharConvError::OutOfRange));
+
+  // the buffer is too small
+  Char buf[3];
+  ToCharsResult res = to_chars(buf, buf+3, 1234);
+  EXPECT_EQ(CharConvError::OutOfRange, res.error);
+  EXPECT_EQ(buf+3, res.ptr);
+}
+
+TEST(CharConv, Floats)
+{
+  EXPECT_EQ(L"0",	str(0.0));
+  EXPECT_EQ(L"-0",	str(-0.0));
+  EXPECT_EQ(L"1",	str(1.0));
+  EXPECT_EQ(L"0.1",	str(0.1));
+  EXPECT_EQ(L"0.324",	str(0.324));
+  EXPECT_EQ(L"-2.5",	str(-2.5));
+  EXPECT_EQ(L"1500",	str(1500.0));
+  EXPECT_EQ(L"0.30000000000000004", str(0.1+0.2));
+  EXPECT_EQ(L"0.0001",	str(1e-4));
+  EXPECT_EQ(L"1e-05",	str(1e-5));
+  EXPECT_EQ(L"1234567890123456", str(1234567890123456.0));
+  EXPECT_EQ(L"1e+16",	str(1e16));
+  EXPECT_EQ(L"1.5e+300", str(1.5e300));
+  EXPECT_EQ(L"1.7976931348623157e+308", str(std::numeric_limits<double>::max()));
+  EXPECT_EQ(L"5e-324",	str(std::numeric_limits<double>::denorm_min()));
+  EXPECT_EQ(L"inf",	str(std::numeric_limits<double>::infinity()));
+  EXPECT_EQ(L"-inf",	str(-std::numeric_limits<double>::infinity()));
+  EXPECT_EQ(L"nan",	str(std::numeric_limits<double>::quiet_NaN()));
+
+  EXPECT_EQ(L"0.1",	str(0.1f));
+  EXPECT_EQ(L"3.4028235e+38", str(std::numeric_limits<float>::max()));
+  EXPECT_EQ(L"1e-45",	str(std::numeric_limits<float>::denorm_min()));
+  EXPECT_EQ(L"16777216", str(16777216.0f));
+
+  EXPECT_EQ(0.1,	parse<double>(L"0.1"));
+  EXPECT_EQ(0.1,	parse<double>(L".1"));
+  EXPECT_EQ(100.0,	parse<double>(L"100."));
+  EXPECT_EQ(-2.5e-3,	parse<double>(L"-2.5E-3"));
+  EXPECT_EQ(1e300,	parse<double>(L"1e300"));
+  EXPECT_EQ(0.1f,	parse<float>(L"0.1"));
+  EXPECT_EQ(123456789012345678901234567890.0, parse<double>(L"123456789012345678901234567890"));
+  EXPECT_EQ(0.30000000000000004, parse<double>(L"0.30000000000000004"));
+  EXPECT_EQ(5e-324,	parse<double>(L"4.9406564584124654e-324"));
+  EXPECT_TRUE(std::isinf(parse<double>(L"-Infinity")));
+  EXPECT_TRUE(std::isnan(parse<double>(L"nan")));
+}
+
+TEST(CharConv, FloatErrors)
+{
+  EXPECT_EQ(1.5, parse<double>(L"1.5e", CharConvError::None, 3));
+  EXPECT_EQ(1.5, parse<double>(L"1.5e+", CharConvError::None, 3));
+  EXPECT_EQ(2.0, parse<double>(L"2,5", CharConvError::None, 1));
+  EXPECT_EQ(0.0, parse<double>(L".", CharConvError::InvalidArgument, 0));
+  EXPECT_EQ(0.0, parse<double>(L"e5", CharConvError::InvalidArgument, 0));
+  EXPECT_EQ(0.0, parse<double>(L"+1", CharConvError::InvalidArgument, 0));
+  EXPECT_EQ(0.0, parse<double>(L"1e400", CharConvError::OutOfRange));
+  EXPECT_EQ(0.0f, parse<float>(L"1e39", CharConvError::OutOfRange));
+}
+
+// Random numbers (from their bits) must be converted back to the same number
+TEST(CharConv, RoundTrip)
+{
+  std::srand(13);
+  Char buf[max_number_chars];
+
+  for (int i=0; i<200000; ++i) {
+    unsigned long long bits = 0;
+    for (int j=0; j<4; ++j)
+      bits = (bits << 16) ^ (std::rand() & 0xffff);
+
+    double d;
+    std::memcpy(&d, &bits, sizeof(d));
+    if (std::isnan(d))
+      continue;
+
+    ToCharsResult res = to_chars(buf, buf+max_number_chars, d);
+    double d2 = 0;
+    from_chars(buf, res.ptr, d2);
+    ASSERT_EQ(0, std::memcmp(&d, &d2, sizeof(d)));
+
+    float f;
+    unsigned int fbits = static_cast<unsigned int>(bits);
+    std::memcpy(&f, &fbits, sizeof(f));
+    if (std::isnan(f))
+      continue;
+
+    res = to_chars(buf, buf+max_number_chars, f);
+    float f2 = 0;
+    from_chars(buf, res.ptr, f2);
+    ASSERT_EQ(0, std::memcmp(&f, &f2, sizeof(f)));
+  }
+}
+
+// Formats and parses the cells of a big grid of prices
+TEST(CharConv, Benchmark)
+{
+  typedef std::chrono::steady_clock Clock;
+  const int n = 1000000;
+  std::vector<double> values(n);
+  std::srand(7);
+  for (int i=0; i<n; ++i)
+    values[i] = (std::rand() % 10000000) / 100.0;
+
+  Char buf[64];
+  std::size_t check = 0;
+
+  Clock::time_point t0 = Clock::now();
+  for (int i=0; i<n; ++i)
+    check += std::swprintf(buf, 64, L"%.16g", values[i]);
+  Clock::time_point t1 = Clock::now();
+  for (int i=0; i<n; ++i)
+    check += to_chars(buf, buf+64, values[i]).ptr - buf;
+  Clock::time_point t2 = Clock::now();
+
+  std::vector<String> cells(n);
+  for (int i=0; i<n; ++i)
+    cells[i] = str(values[i]);
+
+  Clock::time_point t3 = Clock::now();
+  double sum1 = 0, sum2 = 0;
+  for (int i=0; i<n; ++i)
+    sum1 += std::wcstod(cells[i].c_str(), NULL);
+  Clock::time_point t4 = Clock::now();
+  for (int i=0; i<n; ++i) {
+    double value = 0;
+    from_chars(cells[i].data(), cells[i].data()+cells[i].size(), value);
+    sum2 += value;
+  }
+  Clock::time_point t5 = Clock::now();
+
+  EXPECT_EQ(sum1, sum2);
+  std::printf("%d numbers: swprintf = %.1f ms, to_chars = %.1f ms, wcstod = %.1f ms, from_chars = %.1f ms (%d)\n",
+	      n,
+	      std::chrono::duration<double, std::milli>(t1 - t0).count(),
+	      std::chrono::duration<double, std::milli>(t2 - t1).count(),
+	      std::chrono::duration<double, std::milli>(t4 - t3).count(),
+	      std::chrono::duration<double, std::milli>(t5 - t4).count(),
+	      (int)(check & 1));
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include "vaca/CompactString.h"
+#include "vaca/InternedString.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace vaca;
+
+TEST(CompactString, Inline)
+{
+  CompactString empty;
+  EXPECT_TRUE(empty.empty());
+  EXPECT_TRUE(empty.isInline());
+  EXPECT_STREQ("", empty.c_str());
+  EXPECT_TRUE(empty.str() == L"");
+
+  CompactString label(L"First name:");
+  EXPECT_EQ(11u, label.size());
+  EXPECT_TRUE(label.isInline());
+  EXPECT_STREQ("First name:", label.c_str());
+  EXPECT_TRUE(label.str() == L"First name:");
+
+  // 23 bytes is the limit to be inside the object
+  String str23(23, L'x'), str24(24, L'x');
+  EXPECT_TRUE(CompactString(str23).isInline());
+  EXPECT_FALSE(CompactString(str24).isInline());
+  EXPECT_TRUE(CompactString(str23).str() == str23);
+  EXPECT_TRUE(CompactString(str24).str() == str24);
+  EXPECT_EQ(23u, std::strlen(CompactString(str23).c_str()));
+
+  if (sizeof(void*) == 8) {
+    EXPECT_EQ(24u, sizeof(CompactString));
+  }
+}
+
+TEST(CompactString, Utf8)
+{
+  // "año" and "€" use 2 and 3 bytes
+  const Char text[] = { L'a', 0xF1, L'o', L' ', 0x20AC, 0 };
+  CompactString str(text);
+  EXPECT_EQ(8u, str.size());
+  EXPECT_STREQ("a\xC3\xB1o \xE2\x82\xAC", str.c_str());
+  EXPECT_TRUE(str.str() == text);
+
+  // a String with an invalid surrogate
+  const Char invalid[] = { L'a', 0xD800, L'b', 0 };
+  EXPECT_STREQ("a\xEF\xBF\xBD" "b", CompactString(invalid).c_str());
+
+  EXPECT_STREQ("a\xEF\xBF\xBD", CompactString::fromUtf8("a\xFF", 2).c_str());
+  EXPECT_STREQ("a\xC3\xB1o", CompactString::fromUtf8("a\xC3\xB1o", 4).c_str());
+}
+
+TEST(CompactString, CopyAndMove)
+{
+  CompactString a(L"short"), b(String(40, L'l'));
+  CompactString c(a), d(b);
+  EXPECT_TRUE(a == c);
+  EXPECT_TRUE(b == d);
+  EXPECT_NE(b.c_str(), d.c_str());
+
+  CompactString e(static_cast<CompactString&&>(d));
+  EXPECT_TRUE(d.empty());
+  EXPECT_TRUE(e == b);
+
+  a.swap(e);
+  EXPECT_FALSE(a.isInline());
+  EXPECT_TRUE(e.isInline());
+  EXPECT_STREQ("short", e.c_str());
+
+  a = c;
+  EXPECT_STREQ("short", a.c_str());
+  a = a;
+  EXPECT_STREQ("short", a.c_str());
+  c = static_cast<CompactString&&>(b);
+  EXPECT_EQ(40u, c.size());
+
+  EXPECT_TRUE(CompactString(L"abc") < CompactString(L"abd"));
+  EXPECT_TRUE(CompactString(L"ab") < CompactString(L"abc"));
+  EXPECT_TRUE(CompactString(L"ab") != CompactString(L"abc"));
+}
+
+TEST(CompactString, Boundary)
+{
+  CompactString str(L"Label");
+
+  Char buf[8];
+  EXPECT_EQ(5u, str.copyTo(buf, 8));
+  EXPECT_TRUE(String(buf) == L"Label");
+  EXPECT_EQ(5u, str.copyTo(buf, 5)); // too small
+  EXPECT_EQ(0u, CompactString().copyTo(buf, 1));
+  EXPECT_EQ(0, buf[0]);
+
+  EXPECT_TRUE(InternedString(str) == InternedString(L"Label"));
+  EXPECT_TRUE(InternedString(CompactString(String(100, L'z'))) == InternedString(String(100, L'z')));
+}
+
+// Memory used by 200000 short labels
+TEST(CompactString, Memory)
+{
+  const int n = 200000;
+  const Char* words[] = { L"Name", L"Address:", L"Phone number", L"E-mail", L"Total amount (USD)",
+			  L"Date of birth", L"Comments", L"A label which is a bit longer than the others" };
+
+  std::vector<String> strings;
+  std::vector<CompactString> compacts;
+  std::size_t stringBytes = 0, compactBytes = 0;
+
+  for (int i=0; i<n; ++i) {
+    const Char* word = words[i % 8];
+    strings.push_back(String(word));
+    compacts.push_back(CompactString(word));
+
+    const String& s = strings.back();
+    stringBytes += sizeof(String);
+    if (s.capacity() * sizeof(Char) >= sizeof(String)) // it is not in the small string buffer
+      stringBytes += (s.capacity()+1) * sizeof(Char);
+
+    const CompactString& c = compacts.back();
+    compactBytes += sizeof(CompactString);
+    if (!c.isInline())
+      compactBytes += c.size()+1;
+  }
+
+  EXPECT_LT(compactBytes*2, stringBytes);
+  std::printf("%d labels: String = %.1f MB, CompactString = %.1f MB\n",
+	      n, stringBytes / 1048576.0, compactBytes / 1048576.0);
+}
@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <climits>
+#include <cstdarg>
+#include <cstdio>
+#include <cwchar>
+#include <vector>
+
+#include "vaca/Format.h"
+#include "vaca/ParseException.h"
+
+using namespace vaca;
+using namespace vaca::details;
+
+// The format strings are checked at compile time
+static_assert(check_format(L"{}: {:08x}", FormatSignature<String, int>()) == FormatOk, "");
+static_assert(check_format(L"{1} {0} {1}", FormatSignature<int, double>()) == FormatOk, "");
+static_assert(check_format(L"{{}} {:>10.3f}", FormatSignature<double>()) == FormatOk, "");
+static_assert(check_format(L"{:*^12s}", FormatSignature<const Char*>()) == FormatOk, "");
+static_assert(check_format(L"{} {}", FormatSignature<int>()) == FormatMissingArgument, "");
+static_assert(check_format(L"{} {0}", FormatSignature<int>()) == FormatMixedIndexing, "");
+static_assert(check_format(L"{:x}", FormatSignature<double>()) == FormatTypeMismatch, "");
+static_assert(check_format(L"{:.2}", FormatSignature<int>()) == FormatTypeMismatch, "");
+static_assert(check_format(L"{:+}", FormatSignature<String>()) == FormatTypeMismatch, "");
+static_assert(check_format(L"{:q}", FormatSignature<int>()) == FormatInvalidSpec, "");
+static_assert(check_format(L"{", FormatSignature<int>()) == FormatUnmatchedBrace, "");
+static_assert(check_format(L"}", FormatSignature<>()) == FormatUnmatchedBrace, "");
+static_assert(check_format(L"{}", FormatSignature<const char*>()) == FormatUnsupportedType, "");
+
+TEST(Format, Basic)
+{
+  EXPECT_EQ(L"", format(L""));
+  EXPECT_EQ(L"text", format(L"text"));
+  EXPECT_EQ(L"{} {x}", format(L"{{}} {{x}}"));
+  EXPECT_EQ(L"a: 5", VACA_FORMAT(L"{}: {}", L"a", 5));
+  EXPECT_EQ(L"b a b", VACA_FORMAT(L"{1} {0} {1}", String(L"a"), StringView(L"b")));
+  EXPECT_EQ(L"-7 7 x true", VACA_FORMAT(L"{} {} {} {}", -7L, 7U, L'x', true));
+  EXPECT_EQ(L"0.1 2.5", VACA_FORMAT(L"{} {}", 0.1, 2.5f));
+  EXPECT_EQ(L"-9223372036854775808", VACA_FORMAT(L"{}", LLONG_MIN));
+  EXPECT_EQ(L"18446744073709551615", VACA_FORMAT(L"{}", ULLONG_MAX));
+}
+
+TEST(Format, Specs)
+{
+  EXPECT_EQ(L"0000002a", VACA_FORMAT(L"{:08x}", 42));
+  EXPECT_EQ(L"0X2A", VACA_FORMAT(L"{:#X}", 42));
+  EXPECT_EQ(L"-0x002a", VACA_FORMAT(L"{:#07x}", -42));
+  EXPECT_EQ(L"0b101 017", VACA_FORMAT(L"{:#b} {:#o}", 5, 15));
+  EXPECT_EQ(L"+5 -5  5", VACA_FORMAT(L"{:+} {:+} {: }", 5, -5, 5));
+  EXPECT_EQ(L"A", VACA_FORMAT(L"{:c}", 65));
+  EXPECT_EQ(L"65", VACA_FORMAT(L"{:d}", L'A'));
+  EXPECT_EQ(L"1", VACA_FORMAT(L"{:d}", true));
+
+  EXPECT_EQ(L"   42|42   | 42 ", VACA_FORMAT(L"{:5}|{:<5}|{:^4}", 42, 42, 42));
+  EXPECT_EQ(L"ab   |   ab|*ab**", VACA_FORMAT(L"{:5}|{:>5}|{:*^5}", L"ab", L"ab", L"ab"));
+  EXPECT_EQ(L"abc", VACA_FORMAT(L"{:.3}", L"abcdef"));
+  EXPECT_EQ(L"x    ", VACA_FORMAT(L"{:5}", L'x'));
+
+  EXPECT_EQ(L"3.14", VACA_FORMAT(L"{:.2f}", 3.14159));
+  EXPECT_EQ(L"003.14", VACA_FORMAT(L"{:06.2f}", 3.14159));
+  EXPECT_EQ(L"-03.1", VACA_FORMAT(L"{:05.1f}", -3.14159));
+  EXPECT_EQ(L"1.5e+10", VACA_FORMAT(L"{:.1e}", 1.5e10));
+  EXPECT_EQ(L"3.1", VACA_FORMAT(L"{:.2}", 3.14159));
+  EXPECT_EQ(L"+2.5", VACA_FORMAT(L"{:+}", 2.5));
+
+  int value = 0;
+  EXPECT_EQ(L"0x0", VACA_FORMAT(L"{}", static_cast<void*>(NULL)));
+  EXPECT_EQ(L"0x", VACA_FORMAT(L"{}", &value).substr(0, 2));
+}
+
+TEST(Format, Buffers)
+{
+  // the text does not fit in the caller buffer
+  Char small[4];
+  FormatBuffer buf(small, 4);
+  VACA_FORMAT_TO(buf, L"{}-{}", 12, 34);
+  EXPECT_EQ(L"12-34", buf.str());
+  EXPECT_STREQ(L"12-34", buf.c_str());
+
+  // nor in the inline buffer
+  FormatBuffer big;
+  for (int i=0; i<1000; ++i)
+    VACA_FORMAT_TO(big, L"{:03}", i % 1000);
+  EXPECT_EQ(3000u, big.size());
+  EXPECT_EQ(L"998999", big.view().substr(2994).str());
+}
+
+TEST(Format, RuntimeErrors)
+{
+  EXPECT_THROW(format(L"{} {}", 1), ParseException);
+  EXPECT_THROW(format(L"{} {0}", 1), ParseException);
+  EXPECT_THROW(format(L"{:x}", L"text"), ParseException);
+  EXPECT_THROW(format(L"{:q}", 1), ParseException);
+  EXPECT_THROW(format(L"{", 1), ParseException);
+  EXPECT_THROW(format(L"{0", 1), ParseException);
+  EXPECT_THROW(format(L"}", 1), ParseException);
+  EXPECT_THROW(format(L"{}", "narrow"), ParseException);
+
+  try {
+    format(L"abc {:.}", 1.0);
+    FAIL();
+  }
+  catch (ParseException& e) {
+    EXPECT_EQ(4, e.getIndex());
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+// Benchmarks against the printf-based functions
+
+typedef std::chrono::steady_clock Clock;
+
+static double ms(Clock::duration d)
+{
+  return std::chrono::duration<double, std::milli>(d).count();
+}
+
+// The same code of details::trace (without the output file)
+static std::size_t old_trace(char* out, const char* fmt, ...)
+{
+  char buf[1024];
+  va_list ap;
+  va_start(ap, fmt);
+  vsprintf(buf, fmt, ap);
+  va_end(ap);
+  return std::snprintf(out, 1024, "%s:%d: [%d] %s", "Frame.cpp", 145, 1, buf);
+}
+
+// The same code of format_string (with vswprintf instead of _vsnwprintf)
+static String old_format_string(const Char* fmt, ...)
+{
+  Char stackBuf[256];
+  std::vector<Char> heapBuf;
+  Char* buf = stackBuf;
+  int size = 256;
+
+  while (true) {
+    va_list ap;
+    va_start(ap, fmt);
+    int written = std::vswprintf(buf, size, fmt, ap);
+    va_end(ap);
+
+    if (written >= 0 && written < size)
+      return String(buf, written);
+
+    size *= 2;
+    heapBuf.resize(size);
+    buf = &heapBuf[0];
+  }
+}
+
+// The messages of VACA_TRACE in Frame::onCommand
+TEST(Format, BenchmarkTrace)
+{
+  const int n = 500000;
+  char out[1024];
+  std::size_t check = 0;
+  void* menuItem = &check;
+
+  Clock::time_point t0 = Clock::now();
+  for (int i=0; i<n; ++i)
+    check += old_trace(out, "Frame::onCommand(%d), menuItem=%p\n", i, menuItem);
+  Clock::time_point t1 = Clock::now();
+  for (int i=0; i<n; ++i)
+    check += old_format_string(L"Frame::onCommand(%d), menuItem=%p\n", i, menuItem).size();
+  Clock::time_point t2 = Clock::now();
+  for (int i=0; i<n; ++i) {
+    FormatBuffer buf;
+    VACA_FORMAT_TO(buf, L"{}:{}: [{}] Frame::onCommand({}), menuItem={}\n",
+		   L"Frame.cpp", 145, 1, i, menuItem);
+    check += buf.size();
+  }
+  Clock::time_point t3 = Clock::now();
+
+  std::printf("%d trace lines: trace = %.1f ms, format_string = %.1f ms, VACA_FORMAT_TO = %.1f ms (%d)\n",
+	      n, ms(t1 - t0), ms(t2 - t1), ms(t3 - t2), (int)(check & 1));
+}
+
+// The loops of the Hashing example (a SHA1 digest to hex)
+TEST(Format, BenchmarkHex)
+{
+  const int n = 200000;
+  unsigned char digest[20];
+  for (int c=0; c<20; ++c)
+    digest[c] = static_cast<unsigned char>(c * 37 + 11);
+  std::size_t check = 0;
+
+  Clock::time_point t0 = Clock::now();
+  for (int i=0; i<n; ++i) {
+    String res;
+    for (int c=0; c<20; ++c)
+      res += old_format_string(L"%02x", digest[c]);
+    check += res.size();
+  }
+  Clock::time_point t1 = Clock::now();
+  for (int i=0; i<n; ++i) {
+    FormatBuffer buf;
+    for (int c=0; c<20; ++c)
+      VACA_FORMAT_TO(buf, L"{:02x}", static_cast<unsigned>(digest[c]));
+    String res = buf.str();
+    check += res.size();
+  }
+  Clock::time_point t2 = Clock::now();
+
+  String a;
+  FormatBuffer buf;
+  for (int c=0; c<20; ++c) {
+    a += old_format_string(L"%02x", digest[c]);
+    VACA_FORMAT_TO(buf, L"{:02x}", static_cast<unsigned>(digest[c]));
+  }
+  EXPECT_EQ(a, buf.str());
+
+  std::printf("%d digests: format_string = %.1f ms, VACA_FORMAT_TO = %.1f ms (%d)\n",
+	      n, ms(t1 - t0), ms(t2 - t1), (int)(check & 1));
+}
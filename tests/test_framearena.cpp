@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "vaca/FrameArena.h"
+
+using namespace vaca;
+
+// Counts the allocations made with the global operator new
+static std::atomic<long> global_allocs(0);
+
+void* operator new(std::size_t size)
+{
+  ++global_allocs;
+  void* ptr = std::malloc(size ? size: 1);
+  if (!ptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void operator delete(void* ptr) throw()
+{
+  std::free(ptr);
+}
+
+TEST(FrameArena, Alignment)
+{
+  FrameArena arena(256);
+
+  char* a = static_cast<char*>(arena.allocate(1, 1));
+  char* b = static_cast<char*>(arena.allocate(1, 1));
+  EXPECT_EQ(a+1, b);
+
+  void* c = arena.allocate(8, 8);
+  EXPECT_EQ(0u, reinterpret_cast<std::size_t>(c) % 8);
+
+  void* d = arena.allocate(16, 16);
+  EXPECT_EQ(0u, reinterpret_cast<std::size_t>(d) % 16);
+}
+
+TEST(FrameArena, BigAllocations)
+{
+  FrameArena arena(256);
+
+  char* a = static_cast<char*>(arena.allocate(1000));
+  for (int i=0; i<1000; ++i)
+    a[i] = 1;
+  EXPECT_LE(1000u, arena.getCapacity());
+}
+
+TEST(FrameArena, Scopes)
+{
+  FrameArena arena(256);
+  void* a;
+  {
+    FrameArena::Scope scope(arena);
+    a = arena.allocate(32);
+    {
+      FrameArena::Scope scope2(arena);
+      arena.allocate(1000);	// in a second chunk
+    }
+    EXPECT_EQ(static_cast<char*>(a)+32, arena.allocate(1, 1));
+  }
+  EXPECT_EQ(a, arena.allocate(32));
+
+  std::size_t capacity = arena.getCapacity();
+  arena.reset();
+  EXPECT_EQ(a, arena.allocate(32));
+  arena.allocate(1000);
+  EXPECT_EQ(capacity, arena.getCapacity()); // the chunks are reused
+}
+
+TEST(FrameArena, Allocator)
+{
+  FrameArena::Scope scope;
+
+  std::vector<int, FrameAllocator<int> > v;
+  for (int i=0; i<10000; ++i)
+    v.push_back(i);
+  for (int i=0; i<10000; ++i)
+    EXPECT_EQ(i, v[i]);
+
+  std::vector<double, FrameAllocator<double> > w(v.begin(), v.end());
+  EXPECT_EQ(10000u, w.size());
+}
+
+// Allocates like a layout cycle of a form with thousands of widgets
+// (the containers are sized before the nested scopes are opened)
+static void layout_cycle(int widgets)
+{
+  FrameArena::Scope scope;
+
+  std::vector<void*, FrameAllocator<void*> > children;
+  children.reserve(widgets);
+  for (int i=0; i<widgets; ++i)
+    children.push_back(&children);
+
+  for (int row=0; row<widgets/10; ++row) {
+    FrameArena::Scope rowScope;
+    std::vector<int, FrameAllocator<int> > sizes(10);
+  }
+}
+
+TEST(FrameArena, ChunksAreReusedByNextCycles)
+{
+  layout_cycle(5000);		// warm up
+  std::size_t capacity = FrameArena::getCurrent().getCapacity();
+
+  long start = global_allocs.load();
+  for (int c=0; c<100; ++c)
+    layout_cycle(5000);
+  EXPECT_EQ(0, global_allocs.load() - start);
+  EXPECT_EQ(capacity, FrameArena::getCurrent().getCapacity());
+}
+
+TEST(FrameArena, CopiesBelongToTheirScope)
+{
+  FrameArena::Scope scope;
+  std::vector<int, FrameAllocator<int> > v(3, 1);
+  {
+    FrameArena::Scope nested;
+    std::vector<int, FrameAllocator<int> > copy(v);
+    copy.push_back(2);
+    EXPECT_EQ(4u, copy.size());
+  }
+  EXPECT_EQ(3u, v.size());
+}
+
+#ifndef NDEBUG
+TEST(FrameArena, GrowingUnderYoungerScopeAsserts)
+{
+  FrameArena::Scope scope;
+  std::vector<int, FrameAllocator<int> > v(1, 1);
+
+  FrameArena::Scope nested;
+  EXPECT_DEATH(v.push_back(2), "younger");
+}
+#endif
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include "vaca/InternedString.h"
+
+#include <chrono>
+#include <cstdio>
+#include <set>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+using namespace vaca;
+
+TEST(InternedString, Basic)
+{
+  EXPECT_EQ(sizeof(void*), sizeof(InternedString));
+
+  InternedString empty;
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(0u, empty.size());
+  EXPECT_STREQ(L"", empty.c_str());
+  EXPECT_TRUE(empty == InternedString(L""));
+
+  std::size_t count = InternedString::getInternedCount();
+  {
+    InternedString a(L"Name");
+    InternedString b(String(L"Name"));
+    InternedString c(StringView(L"Names", 4));
+    InternedString d(L"Other");
+
+    EXPECT_EQ(count+2, InternedString::getInternedCount());
+    EXPECT_TRUE(a == b);
+    EXPECT_TRUE(a == c);
+    EXPECT_TRUE(a != d);
+    EXPECT_EQ(a.c_str(), b.c_str());
+    EXPECT_EQ(a.hash(), c.hash());
+    EXPECT_EQ(L"Name", a.str());
+    EXPECT_EQ(4u, a.size());
+    EXPECT_TRUE(a < d);
+    EXPECT_FALSE(d < a);
+    EXPECT_FALSE(a < b);
+
+    InternedString e(a);
+    InternedString f(std::move(e));
+    EXPECT_TRUE(e.empty());
+    EXPECT_TRUE(a == f);
+    f = d;
+    EXPECT_TRUE(d == f);
+  }
+  // all the handles were destroyed
+  EXPECT_EQ(count, InternedString::getInternedCount());
+}
+
+TEST(InternedString, Containers)
+{
+  std::vector<InternedString> v;
+  for (int i=0; i<1000; ++i)
+    v.push_back(InternedString(i % 2 ? L"Odd": L"Even"));
+
+  std::unordered_set<InternedString> hashed(v.begin(), v.end());
+  std::set<InternedString> sorted(v.begin(), v.end());
+  EXPECT_EQ(2u, hashed.size());
+  ASSERT_EQ(2u, sorted.size());
+  EXPECT_EQ(L"Even", sorted.begin()->str());
+}
+
+// Several threads create and destroy the same strings
+TEST(InternedString, Threads)
+{
+  std::size_t count = InternedString::getInternedCount();
+  const int nthreads = 4;
+  std::vector<std::thread> threads;
+
+  for (int t=0; t<nthreads; ++t) {
+    threads.push_back(std::thread([t] {
+	  wchar_t buf[32];
+	  for (int i=0; i<20000; ++i) {
+	    std::swprintf(buf, 32, L"Item %d", (i*7 + t) % 50);
+	    InternedString a(buf);
+	    InternedString b(buf);
+	    ASSERT_TRUE(a == b);
+	    ASSERT_EQ(String(buf), a.str());
+	  }
+	}));
+  }
+  for (int t=0; t<nthreads; ++t)
+    threads[t].join();
+
+  EXPECT_EQ(count, InternedString::getInternedCount());
+}
+
+// The labels of a big form (e.g. a ListView with thousands of items
+// with the same few values in each column)
+TEST(InternedString, Memory)
+{
+  const int n = 100000;
+  const Char* labels[] = { L"Pending approval", L"Approved by the manager",
+			   L"Rejected (see the comments)", L"Archived" };
+
+  std::vector<String> strings;
+  std::vector<InternedString> interned;
+  for (int i=0; i<n; ++i) {
+    strings.push_back(String(labels[i % 4]));
+    interned.push_back(InternedString(labels[i % 4]));
+  }
+
+  std::size_t stringBytes = 0;
+  for (int i=0; i<n; ++i)
+    stringBytes += sizeof(String) + (strings[i].capacity()+1)*sizeof(Char);
+
+  std::size_t internedBytes = n*sizeof(InternedString);
+  for (int i=0; i<4; ++i)
+    internedBytes += sizeof(details::InternedStringData) + (interned[i].size()+1)*sizeof(Char);
+
+  EXPECT_LT(internedBytes*4, stringBytes);
+  std::printf("%d labels: String = %d KB, InternedString = %d KB\n",
+	      n, (int)(stringBytes/1024), (int)(internedBytes/1024));
+}
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+
+#include "vaca/MpscQueue.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace vaca;
+
+namespace {
+
+  struct Item
+  {
+    int producer;
+    int value;
+    Item(int producer, int value) : producer(producer), value(value) { }
+  };
+
+  struct Counted
+  {
+    static int alive;
+    Counted() { ++alive; }
+    Counted(const Counted&) { ++alive; }
+    ~Counted() { --alive; }
+  };
+
+  int Counted::alive = 0;
+
+  template<typename T>
+  struct Store {
+    T* out;
+    Store(T* out) : out(out) { }
+    void operator()(T& value) const { *out = value; }
+  };
+
+  struct Ignore {
+    template<typename T>
+    void operator()(T&) const { }
+  };
+
+}
+
+TEST(MpscQueue, PushPop)
+{
+  MpscQueue<int> q(4);
+  int value = 0;
+
+  EXPECT_EQ(4u, q.getCapacity());
+  EXPECT_TRUE(q.empty());
+  EXPECT_FALSE(q.pop(Store<int>(&value)));
+
+  EXPECT_TRUE(q.push(1));
+  EXPECT_TRUE(q.push(2));
+  EXPECT_FALSE(q.empty());
+
+  EXPECT_TRUE(q.pop(Store<int>(&value)));
+  EXPECT_EQ(1, value);
+  EXPECT_TRUE(q.pop(Store<int>(&value)));
+  EXPECT_EQ(2, value);
+  EXPECT_TRUE(q.empty());
+}
+
+TEST(MpscQueue, Full)
+{
+  MpscQueue<int> q(3);		// rounded up to 4
+  int value = 0;
+
+  EXPECT_EQ(4u, q.getCapacity());
+  for (int i=0; i<4; ++i)
+    EXPECT_TRUE(q.push(i));
+  EXPECT_FALSE(q.push(4));
+
+  // after a pop there is room for one more element (the ring wraps around)
+  EXPECT_TRUE(q.pop(Store<int>(&value)));
+  EXPECT_EQ(0, value);
+  EXPECT_TRUE(q.push(4));
+  EXPECT_FALSE(q.push(5));
+
+  for (int i=1; i<=4; ++i) {
+    EXPECT_TRUE(q.pop(Store<int>(&value)));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_TRUE(q.empty());
+}
+
+TEST(MpscQueue, DestroysElements)
+{
+  {
+    MpscQueue<Counted> q(8);
+    q.push();
+    q.push();
+    q.push();
+    EXPECT_EQ(3, Counted::alive);
+
+    q.pop(Ignore());
+    EXPECT_EQ(2, Counted::alive);
+  }
+  // the destructor drains the queue
+  EXPECT_EQ(0, Counted::alive);
+}
+
+TEST(MpscQueue, MultipleProducers)
+{
+  const int producers = 4;
+  const int itemsPerProducer = 100000;
+
+  MpscQueue<Item> q(256);
+  std::vector<std::thread> threads;
+
+  for (int p=0; p<producers; ++p)
+    threads.push_back(std::thread([&q, p]() {
+	  for (int i=0; i<itemsPerProducer; ++i)
+	    while (!q.push(p, i))
+	      std::this_thread::yield();
+	}));
+
+  // elements of each producer must arrive in the same order
+  std::vector<int> next(producers, 0);
+  int received = 0;
+  while (received < producers*itemsPerProducer) {
+    Item item(0, 0);
+    if (q.pop(Store<Item>(&item))) {
+      ASSERT_EQ(next[item.producer], item.value);
+      ++next[item.producer];
+      ++received;
+    }
+    else
+      std::this_thread::yield();
+  }
+
+  for (int p=0; p<producers; ++p) {
+    threads[p].join();
+    EXPECT_EQ(itemsPerProducer, next[p]);
+  }
+  EXPECT_TRUE(q.empty());
+}
+
+TEST(MpscQueueBenchmark, Throughput)
+{
+  const int producers = 2;
+  const int itemsPerProducer = 1000000;
+
+  MpscQueue<Item> q(1024);
+  std::vector<std::thread> threads;
+  std::atomic<bool> start(false);
+
+  for (int p=0; p<producers; ++p)
+    threads.push_back(std::thread([&q, &start, p]() {
+	  while (!start.load())
+	    std::this_thread::yield();
+	  for (int i=0; i<itemsPerProducer; ++i)
+	    while (!q.push(p, i))
+	      std::this_thread::yield();
+	}));
+
+  std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+  start = true;
+
+  int received = 0;
+  while (received < producers*itemsPerProducer) {
+    if (q.pop(Ignore()))
+      ++received;
+    else
+      std::this_thread::yield();
+  }
+
+  std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+  for (int p=0; p<producers; ++p)
+    threads[p].join();
+
+  double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+  std::printf("%d items from %d producers: %.2f ms (%.1f M items/s)\n",
+	      received, producers, ms, received / ms / 1000.0);
+}
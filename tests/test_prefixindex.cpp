@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+
+#include "vaca/PrefixIndex.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+
+using namespace vaca;
+
+static String match(const PrefixIndex& index, const PrefixIndex::Range& range)
+{
+  String res;
+  for (std::size_t i=range.first; i<range.last; ++i) {
+    if (!res.empty())
+      res += L",";
+    res += index.getText(index.getId(i)).str();
+  }
+  return res;
+}
+
+TEST(PrefixIndex, Find)
+{
+  PrefixIndex index;
+  EXPECT_EQ(0, index.add(L"blue"));
+  EXPECT_EQ(1, index.add(L"Black"));
+  EXPECT_EQ(2, index.add(L"blanched almond"));
+  EXPECT_EQ(3, index.add(L"red"));
+  EXPECT_EQ(4, index.add(L"BLUE violet"));
+  EXPECT_EQ(5, index.add(L""));
+  index.build();
+
+  EXPECT_EQ(6u, index.find(L"").size());
+  EXPECT_EQ(L"Black,blanched almond,blue,BLUE violet", match(index, index.find(L"b")));
+  EXPECT_EQ(L"Black,blanched almond", match(index, index.find(L"BLA")));
+  EXPECT_EQ(L"blue,BLUE violet", match(index, index.find(L"Blue")));
+  EXPECT_EQ(L"BLUE violet", match(index, index.find(L"blue ")));
+  EXPECT_EQ(L"red", match(index, index.find(L"r")));
+  EXPECT_TRUE(index.find(L"x").empty());
+  EXPECT_TRUE(index.find(L"reddish").empty());
+  EXPECT_TRUE(PrefixIndex().find(L"a").empty());
+}
+
+TEST(PrefixIndex, Search)
+{
+  PrefixIndex index;
+  index.add(L"cadet blue");
+  index.add(L"cyan");
+  index.add(L"coral");
+  index.add(L"cornsilk");
+  index.add(L"cornflower blue");
+  index.build();
+
+  PrefixIndex::Search search(index);
+  EXPECT_EQ(5u, search.getRange().size());
+  search.setPrefix(L"c");
+  EXPECT_EQ(5u, search.getRange().size());
+  search.setPrefix(L"co");
+  EXPECT_EQ(L"coral,cornflower blue,cornsilk", match(index, search.getRange()));
+  search.setPrefix(L"Corn");
+  EXPECT_EQ(L"cornflower blue,cornsilk", match(index, search.getRange()));
+  search.setPrefix(L"cornx");
+  EXPECT_TRUE(search.getRange().empty());
+  // backspace
+  search.setPrefix(L"cor");
+  EXPECT_EQ(L"coral,cornflower blue,cornsilk", match(index, search.getRange()));
+  search.setPrefix(L"cy");
+  EXPECT_EQ(L"cyan", match(index, search.getRange()));
+  search.reset();
+  EXPECT_EQ(5u, search.getRange().size());
+}
+
+TEST(PrefixIndex, TopMatches)
+{
+  PrefixIndex index;
+  index.add(L"aa", 5);
+  index.add(L"ab", 9);
+  index.add(L"ac", 1);
+  index.add(L"ad", 9);
+  index.add(L"b", 100);
+  index.build();
+
+  std::vector<int> ids;
+  index.getTopMatches(index.find(L"a"), 3, ids);
+  ASSERT_EQ(3u, ids.size());
+  EXPECT_EQ(1, ids[0]);
+  EXPECT_EQ(3, ids[1]);
+  EXPECT_EQ(0, ids[2]);
+
+  ids.clear();
+  index.getTopMatches(index.find(L"a"), 10, ids);
+  EXPECT_EQ(4u, ids.size());
+  EXPECT_EQ(2, ids[3]);
+}
+
+TEST(PrefixIndex, RandomTopMatches)
+{
+  std::srand(11);
+  PrefixIndex index;
+  for (int i=0; i<3000; ++i) {
+    Char buf[8] = { 0 };
+    int len = std::rand() % 4 + 1;
+    for (int j=0; j<len; ++j)
+      buf[j] = L'a' + std::rand() % 3;
+    index.add(buf, std::rand() % 50);
+  }
+  index.build();
+
+  const Char* prefixes[] = { L"", L"a", L"ab", L"cab", L"b" };
+  for (int p=0; p<5; ++p) {
+    PrefixIndex::Range range = index.find(prefixes[p]);
+    std::vector<int> ids;
+    index.getTopMatches(range, 20, ids);
+
+    // compare with a sorted copy of the range
+    std::vector<std::pair<int, std::size_t> > expected;
+    for (std::size_t i=range.first; i<range.last; ++i)
+      expected.push_back(std::make_pair(-index.getRank(index.getId(i)), i));
+    std::sort(expected.begin(), expected.end());
+
+    ASSERT_EQ(std::min<std::size_t>(20, expected.size()), ids.size());
+    for (std::size_t i=0; i<ids.size(); ++i)
+      EXPECT_EQ(index.getId(expected[i].second), ids[i]);
+  }
+}
+
+// Case-insensitive comparison of the first "n" characters (like the
+// linear search of CB_SELECTSTRING)
+static bool starts_with(const String& str, const String& prefix, std::size_t n)
+{
+  if (str.size() < n)
+    return false;
+  for (std::size_t i=0; i<n; ++i)
+    if (PrefixIndex::foldCase(str[i]) != PrefixIndex::foldCase(prefix[i]))
+      return false;
+  return true;
+}
+
+// Typing a word in an auto-completion list of 1M entries
+TEST(PrefixIndex, Benchmark)
+{
+  typedef std::chrono::steady_clock Clock;
+  const int n = 1000000;
+
+  std::srand(1);
+  std::vector<String> entries(n);
+  PrefixIndex index;
+  for (int i=0; i<n; ++i) {
+    Char buf[16];
+    for (int j=0; j<10; ++j)
+      buf[j] = L'a' + std::rand() % 26;
+    buf[10] = 0;
+    entries[i] = buf;
+    index.add(buf, std::rand());
+  }
+
+  Clock::time_point t0 = Clock::now();
+  index.build();
+  Clock::time_point t1 = Clock::now();
+
+  const String word = entries[n/2];
+  std::size_t check = 0;
+
+  // linear matching of all the entries for each keystroke
+  for (std::size_t len=1; len<=word.size(); ++len) {
+    for (int i=0; i<n; ++i)
+      if (starts_with(entries[i], word, len)) {
+	++check;
+	break;
+      }
+  }
+  Clock::time_point t2 = Clock::now();
+
+  PrefixIndex::Search search(index);
+  std::vector<int> ids;
+  for (std::size_t len=1; len<=word.size(); ++len) {
+    search.setPrefix(StringView(word).substr(0, len));
+    ids.clear();
+    index.getTopMatches(search.getRange(), 10, ids);
+    check += ids.size();
+  }
+  Clock::time_point t3 = Clock::now();
+
+  EXPECT_EQ(1u, search.getRange().size());
+  std::printf("%d entries: build = %.1f ms, %d keystrokes: linear = %.2f ms, PrefixIndex (top 10) = %.3f ms (%d)\n",
+	      n,
+	      std::chrono::duration<double, std::milli>(t1 - t0).count(),
+	      (int)word.size(),
+	      std::chrono::duration<double, std::milli>(t2 - t1).count(),
+	      std::chrono::duration<double, std::milli>(t3 - t2).count(),
+	      (int)(check & 1));
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <string>
+
+#include "vaca/Profiling.h"
+#include "vaca/Signal.h"
+
+using namespace vaca;
+using namespace vaca::profiling;
+
+TEST(Profiling, Buckets)
+{
+  EXPECT_EQ(0, SignalStats::getBucketIndex(0));
+  EXPECT_EQ(1, SignalStats::getBucketIndex(1));
+  EXPECT_EQ(2, SignalStats::getBucketIndex(2));
+  EXPECT_EQ(2, SignalStats::getBucketIndex(3));
+  EXPECT_EQ(11, SignalStats::getBucketIndex(1024));
+  EXPECT_EQ(SignalStats::Buckets-1, SignalStats::getBucketIndex(~0ull));
+}
+
+TEST(Profiling, SignalStats)
+{
+  SignalStats* stats = getSignalStats("Test::Stats");
+  EXPECT_EQ(stats, getSignalStats("Test::Stats"));
+  EXPECT_EQ("Test::Stats", stats->getName());
+
+  stats->reset();
+  stats->addEmit();
+  for (int i=0; i<99; ++i)
+    stats->addSlotCall(100);	// bucket [64, 128)
+  stats->addSlotCall(5000);	// bucket [4096, 8192)
+
+  EXPECT_EQ(1u, stats->getEmits());
+  EXPECT_EQ(100u, stats->getSlotCalls());
+  EXPECT_EQ(99*100u + 5000u, stats->getTotalNanos());
+  EXPECT_EQ(5000u, stats->getMaxNanos());
+  EXPECT_EQ(128u, stats->getPercentileNanos(0.5));
+  EXPECT_EQ(128u, stats->getPercentileNanos(0.99));
+  EXPECT_EQ(5000u, stats->getPercentileNanos(1.0));
+
+  std::string text = dumpSignals();
+  EXPECT_NE(std::string::npos, text.find("Test::Stats"));
+
+  std::string json = dumpSignals(DumpFormat::Json);
+  EXPECT_EQ(0u, json.find("{\"signals\":["));
+  EXPECT_NE(std::string::npos, json.find("{\"name\":\"Test::Stats\",\"emits\":1,\"slot_calls\":100,"));
+  EXPECT_NE(std::string::npos, json.find("\"histogram\":[[128,99],[8192,1]]"));
+
+  resetSignals();
+  EXPECT_EQ(0u, stats->getEmits());
+  EXPECT_EQ(0u, stats->getSlotCalls());
+}
+
+#ifdef VACA_PROFILING
+
+namespace {
+  int twice(int x) { return x*2; }
+}
+
+TEST(Profiling, NamedSignals)
+{
+  Signal<int(int)> a, b;
+  a.setName("Test::Signal");
+  b.setName("Test::Signal");
+  a.connect(&twice);
+  a.connect(&twice);
+  b.connect(&twice);
+
+  SignalStats* stats = getSignalStats("Test::Signal");
+  stats->reset();
+
+  a(1);
+  a(2);
+  b(3);
+
+  EXPECT_EQ(3u, stats->getEmits());
+  EXPECT_EQ(5u, stats->getSlotCalls());
+}
+
+#endif
@@ -4,8 +4,24 @@
 #include "vaca/Point.h"
 #include "vaca/Size.h"
 
+#include <chrono>
+#include <cstdio>
+#include <type_traits>
+#include <vector>
+
 using namespace vaca;
 
+// The geometry types are plain values, they can be copied with memcpy
+// and stored in arrays with the layout of the Win32 structures
+static_assert(sizeof(Point) == 2*sizeof(int), "Point must have only two ints");
+static_assert(sizeof(Size) == 2*sizeof(int), "Size must have only two ints");
+static_assert(sizeof(Rect) == 4*sizeof(int), "Rect must have only four ints");
+static_assert(std::is_trivially_copyable<Point>::value, "Point must be trivially copyable");
+static_assert(std::is_trivially_copyable<Size>::value, "Size must be trivially copyable");
+static_assert(std::is_trivially_copyable<Rect>::value, "Rect must be trivially copyable");
+static_assert(std::is_standard_layout<Rect>::value, "Rect must have standard layout");
+static_assert(noexcept(Rect().createIntersect(Rect())), "Rect operations must not throw");
+
 inline std::ostream& operator<<(std::ostream& os, const Rect& rc)
 {
   return os << "Rect(" 
@@ -111,3 +127,100 @@ TEST(Rect, UnionAndIntersection)
   r2 = Rect(2, 7, 3, 3);
   EXPECT_TRUE(r1.createUnion(r2) == Rect(2, 7, 18, 23));
 }
+
+// A table of cell sizes of a layout computed at compile time
+static constexpr Size cells[] = { Size(80, 24), Size(120, 24), Size(64, 32) };
+
+static constexpr Size row_size(const Size* cells, int n, int spacing)
+{
+  return (n == 0 ? Size():
+	  n == 1 ? cells[0]:
+	  Size(cells[0].w + spacing + row_size(cells+1, n-1, spacing).w,
+	       max_value(cells[0].h, row_size(cells+1, n-1, spacing).h)));
+}
+
+TEST(Rect, Constexpr)
+{
+  constexpr Rect client(0, 0, 320, 240);
+  constexpr Rect area = client.createIntersect(Rect(300, 0, 40, 40));
+  static_assert(area == Rect(300, 0, 20, 40), "");
+  static_assert(client.contains(area) && !client.contains(Point(320, 0)), "");
+  static_assert(Rect(Point(10, 10), Point(0, 0)) == Rect(0, 0, 10, 10), "");
+  static_assert(client.createUnion(Rect(-10, 0, 10, 10)).getSize() == Size(330, 240), "");
+  static_assert(Point(Size(2, 3)) + Point(1, 1) == Point(3, 4), "");
+  static_assert(Size(Point(2, 3)).createUnion(Size(4, 1)) == Size(4, 3), "");
+
+  constexpr Size row = row_size(cells, 3, 4);
+  static_assert(row == Size(80+4+120+4+64, 32), "");
+  int widths[row.w / 8];		// array sized at compile time
+  EXPECT_EQ(34u, sizeof(widths)/sizeof(int));
+}
+
+// The loops of the layout managers (a BoxLayout row and the cells of a
+// Bix) with inlined operations, and with calls to functions that are
+// not inlined (like the functions exported by the DLL before)
+namespace {
+
+  typedef Rect (*RectOp)(const Rect&, const Rect&);
+  typedef Rect (*SizeToRect)(const Point&, const Size&);
+
+  Rect intersect_op(const Rect& a, const Rect& b) { return a.createIntersect(b); }
+  Rect union_op(const Rect& a, const Rect& b) { return a.createUnion(b); }
+  Rect make_rect(const Point& pt, const Size& sz) { return Rect(pt, sz); }
+
+  // volatile pointers: the compiler cannot inline the calls
+  RectOp volatile intersect_call = intersect_op;
+  RectOp volatile union_call = union_op;
+  SizeToRect volatile rect_call = make_rect;
+
+  template<bool Inline>
+  Rect layout_cells(const std::vector<Size>& prefs, const Rect& client, int spacing)
+  {
+    Rect bounds;
+    Point pt(client.x, client.y);
+    for (std::size_t i=0; i<prefs.size(); ++i) {
+      Size sz = prefs[i].createUnion(Size(16, 16)) + Size(spacing, 0);
+      Rect cell = (Inline ? Rect(pt, sz): rect_call(pt, sz));
+      cell = (Inline ? cell.createIntersect(client): intersect_call(cell, client));
+      bounds = (Inline ? bounds.createUnion(cell): union_call(bounds, cell));
+
+      pt.x += sz.w;
+      if (pt.x >= client.x+client.w) {
+	pt.x = client.x;
+	pt.y += sz.h;
+      }
+    }
+    return bounds;
+  }
+
+}
+
+TEST(Rect, Benchmark)
+{
+  typedef std::chrono::steady_clock Clock;
+  const int n = 1000;
+  const int rounds = 10000;
+
+  std::vector<Size> prefs;
+  for (int i=0; i<n; ++i)
+    prefs.push_back(Size(8 + (i*37) % 120, 8 + (i*13) % 32));
+  Rect client(0, 0, 1920, 200000);
+
+  Clock::time_point t0 = Clock::now();
+  Rect a;
+  for (int k=0; k<rounds; ++k)
+    a = a.createUnion(layout_cells<true>(prefs, client, k & 3));
+  Clock::time_point t1 = Clock::now();
+  Rect b;
+  for (int k=0; k<rounds; ++k)
+    b = b.createUnion(layout_cells<false>(prefs, client, k & 3));
+  Clock::time_point t2 = Clock::now();
+
+  EXPECT_TRUE(a == b);
+
+  double cells = double(n) * rounds;
+  std::printf("layout of %d cells: inline = %.2f ns/cell, not inline = %.2f ns/cell\n",
+	      n,
+	      std::chrono::duration<double, std::nano>(t1 - t0).count() / cells,
+	      std::chrono::duration<double, std::nano>(t2 - t1).count() / cells);
+}
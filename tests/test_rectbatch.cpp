@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include "vaca/RectBatch.h"
+#include "vaca/Point.h"
+#include "vaca/Rect.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace vaca;
+
+static Rect random_rect(int range)
+{
+  // some empty rectangles and rectangles with negative sizes
+  return Rect(std::rand() % range - range/2, std::rand() % range - range/2,
+	      std::rand() % 40 - 4, std::rand() % 40 - 4);
+}
+
+TEST(RectBatch, Basic)
+{
+  RectBatch batch;
+  EXPECT_TRUE(batch.empty());
+  EXPECT_EQ(-1, batch.findFirst(Point(0, 0)));
+  EXPECT_TRUE(batch.getBounds() == Rect());
+
+  batch.add(Rect(0, 0, 10, 10));
+  batch.add(Rect(5, 5, 10, 10));
+  batch.add(Rect(100, 100, 0, 10));
+  EXPECT_EQ(3u, batch.size());
+  EXPECT_TRUE(batch[1] == Rect(5, 5, 10, 10));
+
+  EXPECT_EQ(0, batch.findFirst(Point(7, 7)));
+  EXPECT_EQ(1, batch.findLast(Point(7, 7)));
+  EXPECT_EQ(-1, batch.findLast(Point(100, 100)));
+  EXPECT_TRUE(batch.getBounds() == Rect(0, 0, 15, 15));
+
+  std::vector<int> indices;
+  EXPECT_EQ(1u, batch.findIntersecting(Rect(12, 12, 5, 5), indices));
+  EXPECT_EQ(1, indices[0]);
+
+  batch.set(2, Rect(-5, -5, 2, 2));
+  batch.offset(Point(5, 5));
+  EXPECT_TRUE(batch[2] == Rect(0, 0, 2, 2));
+  EXPECT_TRUE(batch.getBounds() == Rect(0, 0, 20, 20));
+
+  batch.intersect(Rect(8, 8, 100, 100));
+  EXPECT_TRUE(batch[0] == Rect(8, 8, 7, 7));
+  EXPECT_TRUE(batch[1] == Rect(10, 10, 10, 10));
+  EXPECT_TRUE(batch[2] == Rect());
+}
+
+// The results must be the same of the Rect member functions
+TEST(RectBatch, SameAsRect)
+{
+  std::srand(23);
+  for (int c=0; c<300; ++c) {
+    std::vector<Rect> rects;
+    int n = std::rand() % 40;
+    for (int i=0; i<n; ++i)
+      rects.push_back(random_rect(100));
+    RectBatch batch(rects);
+    ASSERT_EQ(rects.size(), batch.size());
+
+    for (int k=0; k<20; ++k) {
+      Point pt(std::rand() % 120 - 60, std::rand() % 120 - 60);
+      int first = -1, last = -1;
+      for (int i=0; i<n; ++i)
+	if (rects[i].contains(pt)) {
+	  if (first < 0) first = i;
+	  last = i;
+	}
+      ASSERT_EQ(first, batch.findFirst(pt));
+      ASSERT_EQ(last, batch.findLast(pt));
+
+      Rect rc = random_rect(100);
+      std::vector<int> expected, indices;
+      for (int i=0; i<n; ++i)
+	if (rects[i].intersects(rc))
+	  expected.push_back(i);
+      ASSERT_EQ(expected.size(), batch.findIntersecting(rc, indices));
+      ASSERT_TRUE(expected == indices);
+    }
+
+    // createUnion returns the last rectangle if all of them are empty
+    Rect bounds;
+    for (int i=0; i<n; ++i)
+      bounds = bounds.createUnion(rects[i]);
+    if (bounds.isEmpty())
+      ASSERT_TRUE(batch.getBounds() == Rect());
+    else
+      ASSERT_TRUE(bounds == batch.getBounds());
+
+    Rect clip = random_rect(100);
+    RectBatch clipped(batch);
+    clipped.intersect(clip);
+    RectBatch moved(batch);
+    moved.offset(7, -3);
+    for (int i=0; i<n; ++i) {
+      ASSERT_TRUE(rects[i].createIntersect(clip) == clipped[i]);
+      ASSERT_TRUE(Rect(rects[i]).offset(7, -3) == moved[i]);
+    }
+  }
+}
+
+// Hit-testing 100000 children (e.g. the cells of a big grid)
+TEST(RectBatch, Benchmark)
+{
+  typedef std::chrono::steady_clock Clock;
+  const int n = 100000;
+  const int queries = 1000;
+
+  std::srand(29);
+  std::vector<Rect> rects;
+  for (int i=0; i<n; ++i)
+    rects.push_back(Rect(std::rand() % 4000, std::rand() % 4000,
+			 8 + std::rand() % 64, 8 + std::rand() % 32));
+  RectBatch batch(rects);
+
+  std::vector<Point> points;
+  for (int k=0; k<queries; ++k)
+    points.push_back(Point(std::rand() % 4100, std::rand() % 4100));
+
+  Clock::time_point t0 = Clock::now();
+  int hits = 0;
+  for (int k=0; k<queries; ++k)
+    hits += batch.findLast(points[k]) >= 0 ? 1: 0;
+  Clock::time_point t1 = Clock::now();
+
+  // one Rect::contains for each child, from the top to the bottom
+  int hits2 = 0;
+  for (int k=0; k<queries; ++k)
+    for (int i=n-1; i>=0; --i)
+      if (rects[i].contains(points[k])) {
+	++hits2;
+	break;
+      }
+  Clock::time_point t2 = Clock::now();
+
+  // rectangles that must be painted in a dirty area
+  std::vector<int> indices;
+  std::size_t found = 0;
+  for (int k=0; k<queries; ++k)
+    found += batch.findIntersecting(Rect(points[k].x, points[k].y, 200, 100), indices);
+  Clock::time_point t3 = Clock::now();
+
+  EXPECT_EQ(hits2, hits);
+  EXPECT_GT(found, 0u);
+
+  typedef std::chrono::duration<double, std::micro> Micro;
+  std::printf("%d rectangles: findLast = %.1f us, Rect::contains loop = %.1f us, findIntersecting = %.1f us\n",
+	      n,
+	      Micro(t1 - t0).count() / queries,
+	      Micro(t2 - t1).count() / queries,
+	      Micro(t3 - t2).count() / queries);
+}
@@ -1,13 +1,23 @@
 #include <gtest/gtest.h>
+#include <chrono>
 #include <cstdio>
+#include <cstdlib>
+#include <vector>
 
 #include "vaca/Region.h"
+#include "vaca/Point.h"
 #include "vaca/Rect.h"
 #include "vaca/Size.h"
-#include "vaca/TimePoint.h"
 
 using namespace vaca;
 
+typedef std::chrono::steady_clock Clock;
+
+static double seconds_since(Clock::time_point t0)
+{
+  return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
 inline std::ostream& operator<<(std::ostream& os, const Rect& rc)
 {
   return os << "Rect(" 
@@ -40,7 +50,7 @@ TEST(Region, Time)
   double seconds_accum = 0.0;
 
   for (int c=0; c<1000; ++c) {
-    TimePoint pt;
+    Clock::time_point pt = Clock::now();
     {
       Region r1;
       r1 |= Region::fromRect(Rect(5, 5, 25, 25));
@@ -50,12 +60,40 @@ TEST(Region, Time)
       r1 ^= Region::fromEllipse(Rect(0, 0, 100, 100));
       r1 &= Region::fromRoundRect(Rect(0, 0, 100, 100), Size(16, 16));
     }
-    seconds_accum += pt.elapsed();
+    seconds_accum += seconds_since(pt);
   }
 
   std::printf("seconds_accum = %.16g\n", seconds_accum / 1000.0);
 }
 
+namespace {
+  // Forces the copy that was done before Region was movable
+  const Region& copy(const Region& rgn) { return rgn; }
+}
+
+TEST(Region, TimeValueOperators)
+{
+  Region a = Region::fromRect(Rect(5, 5, 25, 25));
+  Region b = Region::fromRect(Rect(20, 20, 20, 20));
+  Region r;
+
+  Clock::time_point pt1 = Clock::now();
+  for (int c=0; c<10000; ++c) {
+    r = copy(a | b);
+    r = copy(r - copy(a & b));
+  }
+  double copy_seconds = seconds_since(pt1);
+
+  Clock::time_point pt2 = Clock::now();
+  for (int c=0; c<10000; ++c) {
+    r = a | b;
+    r = r - (a & b);
+  }
+  double move_seconds = seconds_since(pt2);
+
+  std::printf("copy = %.16g, move = %.16g\n", copy_seconds, move_seconds);
+}
+
 TEST(Region, GeometricOperations)
 {
   Region r1 = Region::fromRect(Rect(5, 5, 25, 25));
@@ -92,3 +130,222 @@ TEST(Region, References)
   EXPECT_TRUE(a != c);
   EXPECT_TRUE(b != c);
 }
+
+TEST(Region, Contains)
+{
+  Region rgn = (Region::fromRect(Rect(0, 0, 10, 10)) |
+		Region::fromRect(Rect(20, 0, 10, 10)) |
+		Region::fromRect(Rect(0, 20, 30, 10)));
+  EXPECT_TRUE(rgn.isComplex());
+  EXPECT_TRUE(rgn.getBounds() == Rect(0, 0, 30, 30));
+
+  EXPECT_TRUE(rgn.contains(Point(0, 0)));
+  EXPECT_TRUE(rgn.contains(Point(29, 9)));
+  EXPECT_FALSE(rgn.contains(Point(15, 5)));
+  EXPECT_FALSE(rgn.contains(Point(30, 5)));
+  EXPECT_FALSE(rgn.contains(Point(5, 15)));
+  EXPECT_TRUE(rgn.contains(Point(15, 25)));
+
+  // some part of the rectangle is in the region
+  EXPECT_TRUE(rgn.contains(Rect(5, 5, 20, 2)));
+  EXPECT_FALSE(rgn.contains(Rect(10, 0, 10, 20)));
+  EXPECT_TRUE(rgn.contains(Rect(10, 0, 10, 21)));
+  EXPECT_FALSE(rgn.contains(Rect(5, 5, 0, 0)));
+
+  rgn.offset(100, 50);
+  EXPECT_TRUE(rgn.getBounds() == Rect(100, 50, 30, 30));
+  EXPECT_TRUE(rgn.contains(Point(115, 75)));
+  EXPECT_FALSE(rgn.contains(Point(115, 55)));
+}
+
+TEST(Region, Shapes)
+{
+  Region ellipse = Region::fromEllipse(Rect(10, 10, 40, 20));
+  EXPECT_TRUE(ellipse.getBounds() == Rect(10, 10, 40, 20));
+  EXPECT_TRUE(ellipse.contains(Point(30, 20)));
+  EXPECT_FALSE(ellipse.contains(Point(10, 10)));
+  EXPECT_FALSE(ellipse.contains(Point(49, 29)));
+
+  // it is symmetric
+  Rect bounds = ellipse.getBounds();
+  for (int y=bounds.y; y<bounds.y+bounds.h; ++y)
+    for (int x=bounds.x; x<bounds.x+bounds.w; ++x)
+      ASSERT_EQ(ellipse.contains(Point(x, y)),
+		ellipse.contains(Point(2*bounds.x+bounds.w-1-x, 2*bounds.y+bounds.h-1-y)));
+
+  Region round = Region::fromRoundRect(Rect(0, 0, 40, 30), Size(10, 10));
+  EXPECT_TRUE(round.getBounds() == Rect(0, 0, 40, 30));
+  EXPECT_FALSE(round.contains(Point(0, 0)));
+  EXPECT_FALSE(round.contains(Point(39, 29)));
+  EXPECT_TRUE(round.contains(Point(0, 15)));
+  EXPECT_TRUE(round.contains(Point(20, 0)));
+  EXPECT_TRUE((round & Region::fromRect(Rect(0, 5, 40, 20))) == Region::fromRect(Rect(0, 5, 40, 20)));
+
+  EXPECT_TRUE(Region::fromEllipse(Rect(0, 0, 0, 10)).isEmpty());
+  EXPECT_TRUE(Region::fromRoundRect(Rect(0, 0, 10, 10), Size(0, 0)) == Region::fromRect(Rect(0, 0, 10, 10)));
+}
+
+// Compares the operations with a bitmap of 48x48 pixels
+TEST(Region, Random)
+{
+  const int size = 48;
+  typedef std::vector<bool> Bitmap;
+
+  std::srand(17);
+  for (int c=0; c<300; ++c) {
+    Region rgn;
+    Bitmap bitmap(size*size, false);
+
+    for (int i=0; i<20; ++i) {
+      Rect rc(std::rand() % size - 4, std::rand() % size - 4,
+	      std::rand() % 24, std::rand() % 24);
+      Region other = (std::rand() % 4 == 0 ? Region::fromEllipse(rc): Region::fromRect(rc));
+      int op = std::rand() % 4;
+
+      Bitmap otherBitmap(size*size);
+      for (int y=0; y<size; ++y)
+	for (int x=0; x<size; ++x)
+	  otherBitmap[y*size+x] = other.contains(Point(x, y));
+
+      switch (op) {
+	case 0: rgn |= other; break;
+	case 1: rgn &= other; break;
+	case 2: rgn -= other; break;
+	case 3: rgn ^= other; break;
+      }
+      for (int j=0; j<size*size; ++j)
+	switch (op) {
+	  case 0: bitmap[j] = bitmap[j] || otherBitmap[j]; break;
+	  case 1: bitmap[j] = bitmap[j] && otherBitmap[j]; break;
+	  case 2: bitmap[j] = bitmap[j] && !otherBitmap[j]; break;
+	  case 3: bitmap[j] = bitmap[j] != otherBitmap[j]; break;
+	}
+      rgn &= Region::fromRect(Rect(0, 0, size, size));
+
+      for (int y=0; y<size; ++y)
+	for (int x=0; x<size; ++x)
+	  ASSERT_EQ(bitmap[y*size+x], rgn.contains(Point(x, y)));
+
+      // the same shape has the same rectangles
+      Region rows;
+      for (int y=0; y<size; ++y)
+	for (int x=0; x<size; ++x)
+	  if (bitmap[y*size+x])
+	    rows |= Region::fromRect(Rect(x, y, 1, 1));
+      ASSERT_TRUE(rows == rgn);
+      ASSERT_TRUE(rows.getBounds() == rgn.getBounds());
+    }
+  }
+}
+
+// Checks that the rectangles are a decomposition of the region
+static void check_rects(const Region& rgn, const std::vector<Rect>& rects)
+{
+  Region sum;
+  for (std::size_t i=0; i<rects.size(); ++i) {
+    ASSERT_FALSE(rects[i].isEmpty());
+    ASSERT_TRUE((sum & Region(rects[i])).isEmpty()); // they do not overlap
+    sum |= Region(rects[i]);
+
+    if (i > 0) {
+      ASSERT_TRUE(rects[i-1].y < rects[i].y ||
+		  (rects[i-1].y == rects[i].y && rects[i-1].x < rects[i].x));
+    }
+  }
+  ASSERT_TRUE(sum == rgn);
+}
+
+TEST(Region, Rects)
+{
+  EXPECT_TRUE(Region().rects().empty());
+  EXPECT_TRUE(Region().rects(true).empty());
+  EXPECT_EQ(1u, Region(Rect(2, 3, 4, 5)).rects().size());
+  EXPECT_TRUE(Region(Rect(2, 3, 4, 5)).rects(true)[0] == Rect(2, 3, 4, 5));
+
+  // a tall rectangle with a small one at its side: four boxes in three
+  // bands, or the two original rectangles
+  Region rgn = Region(Rect(0, 0, 10, 100)) | Region(Rect(20, 50, 10, 10));
+  std::vector<Rect> bands = rgn.rects();
+  std::vector<Rect> rects = rgn.rects(true);
+  ASSERT_EQ(4u, bands.size());
+  EXPECT_TRUE(bands[0] == Rect(0, 0, 10, 50));
+  EXPECT_TRUE(bands[1] == Rect(0, 50, 10, 10));
+  EXPECT_TRUE(bands[2] == Rect(20, 50, 10, 10));
+  EXPECT_TRUE(bands[3] == Rect(0, 60, 10, 40));
+  ASSERT_EQ(2u, rects.size());
+  EXPECT_TRUE(rects[0] == Rect(0, 0, 10, 100));
+  EXPECT_TRUE(rects[1] == Rect(20, 50, 10, 10));
+
+  // two thin strips of damage
+  rgn = Region(Rect(0, 0, 640, 2)) | Region(Rect(0, 478, 640, 2));
+  EXPECT_EQ(2u, rgn.rects(true).size());
+  check_rects(rgn, rgn.rects(true));
+
+  // a frame: top, sides and bottom
+  rgn = Region(Rect(0, 0, 100, 100)) - Region(Rect(10, 10, 80, 80));
+  ASSERT_EQ(4u, rgn.rects(true).size());
+  EXPECT_TRUE(rgn.rects(true)[1] == Rect(0, 10, 10, 80));
+  EXPECT_TRUE(rgn.rects(true)[2] == Rect(90, 10, 10, 80));
+
+  std::srand(19);
+  for (int c=0; c<500; ++c) {
+    rgn = Region();
+    for (int i=0; i<10; ++i) {
+      Rect rc(std::rand() % 64, std::rand() % 64, std::rand() % 32, std::rand() % 32);
+      Region other = (std::rand() % 4 == 0 ? Region::fromEllipse(rc): Region::fromRect(rc));
+      if (std::rand() % 3 == 0)
+	rgn -= other;
+      else
+	rgn |= other;
+    }
+
+    bands = rgn.rects();
+    rects = rgn.rects(true);
+    check_rects(rgn, bands);
+    check_rects(rgn, rects);
+    ASSERT_LE(rects.size(), bands.size());
+  }
+}
+
+// Damage accumulation: the rectangles that are invalidated in a
+// frame are added to a region that is painted at the end of it
+TEST(Region, DamageBenchmark)
+{
+  const int n = 10000;
+  std::vector<Rect> rects;
+
+  // small rectangles everywhere in the screen (like a lot of
+  // animated icons)
+  std::srand(19);
+  for (int i=0; i<n; ++i)
+    rects.push_back(Rect(std::rand() % 1920, std::rand() % 1080,
+			 8 + std::rand() % 56, 8 + std::rand() % 24));
+
+  Clock::time_point t0 = Clock::now();
+  Region damage;
+  for (int i=0; i<n; ++i)
+    damage |= Region::fromRect(rects[i]);
+  double scattered = seconds_since(t0);
+  EXPECT_TRUE(damage.contains(rects[n/2]));
+
+  // the lines of a text editor that are modified, and the caret
+  rects.clear();
+  for (int i=0; i<n; ++i) {
+    int line = std::rand() % 60;
+    rects.push_back(Rect(40 + std::rand() % 800, line*16, 8 + std::rand() % 200, 16));
+    rects.push_back(Rect(std::rand() % 1000, line*16, 1, 16));
+  }
+
+  t0 = Clock::now();
+  Region lines;
+  for (std::size_t i=0; i<rects.size(); ++i)
+    lines |= Region::fromRect(rects[i]);
+  // the parts covered by opaque children are not painted
+  for (int i=0; i<100; ++i)
+    lines -= Region::fromRect(Rect((i % 10) * 100, (i / 10) * 96, 50, 50));
+  double editor = seconds_since(t0);
+  EXPECT_TRUE(lines.getBounds().y >= 0);
+
+  std::printf("%d rectangles: scattered = %.3f ms, text lines = %.3f ms\n",
+	      n, scattered * 1000.0, editor * 1000.0);
+}
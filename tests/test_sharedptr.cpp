@@ -1,6 +1,12 @@
 #include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "vaca/SharedPtr.h"
+#include "vaca/WeakPtr.h"
 #include "vaca/Referenceable.h"
 
 using namespace vaca;
@@ -32,3 +38,213 @@ TEST(SharedPtr, Equal)
   EXPECT_TRUE(b != c);
   EXPECT_TRUE(&a->value_ == &b->value_); // Same address
 }
+
+class LocalInt : public BasicReferenceable<NonAtomicRefCount>
+{
+public:
+  int value_;
+  LocalInt(int value) : value_(value) { }
+};
+
+TEST(SharedPtr, NonAtomicPolicy)
+{
+  SharedPtr<LocalInt> a(new LocalInt(5));
+  EXPECT_EQ(1u, a->getRefCount());
+  {
+    SharedPtr<LocalInt> b(a);
+    EXPECT_EQ(2u, a->getRefCount());
+  }
+  EXPECT_EQ(1u, a->getRefCount());
+}
+
+TEST(SharedPtr, ThreadsShareReferences)
+{
+  const int threads = 4;
+  const int copies = 100000;
+
+  SharedPtr<Int> a(new Int(5));
+  std::vector<std::thread> workers;
+  for (int i=0; i<threads; ++i)
+    workers.push_back(std::thread([a]() {
+	  for (int j=0; j<copies; ++j) {
+	    SharedPtr<Int> b(a);
+	    SharedPtr<Int> c;
+	    c = b;
+	  }
+	}));
+  for (int i=0; i<threads; ++i)
+    workers[i].join();
+
+  EXPECT_EQ(1u, a->getRefCount());
+}
+
+#ifndef NDEBUG
+TEST(SharedPtr, LeakTracking)
+{
+  std::size_t before = Referenceable::getLiveCount();
+  {
+    std::vector<SharedPtr<Int> > v;
+    for (int i=0; i<100000; ++i)
+      v.push_back(new Int(i));
+    EXPECT_EQ(before + 100000, Referenceable::getLiveCount());
+
+    // remove in a different order than they were created
+    for (int i=0; i<100000; i += 2)
+      v[i].reset();
+    EXPECT_EQ(before + 50000, Referenceable::getLiveCount());
+  }
+  EXPECT_EQ(before, Referenceable::getLiveCount());
+}
+#endif
+
+// The layout of the objects must not depend on NDEBUG (the application
+// and vaca.dll can be compiled with different settings)
+static_assert(sizeof(details::LeakTracked) == 2*sizeof(void*),
+	      "LeakTracked must have the same size in debug and release builds");
+
+class Int2 : public Int
+{
+public:
+  Int2(int value) : Int(value) { }
+};
+
+TEST(SharedPtr, Move)
+{
+  SharedPtr<Int> a(new Int(5));
+  Int* ptr = a.get();
+
+  SharedPtr<Int> b(std::move(a));
+  EXPECT_TRUE(a.get() == NULL);
+  EXPECT_EQ(ptr, b.get());
+  EXPECT_EQ(1u, b->getRefCount());
+
+  SharedPtr<Int> c(new Int(6));
+  c = std::move(b);
+  EXPECT_TRUE(b.get() == NULL);
+  EXPECT_EQ(ptr, c.get());
+  EXPECT_EQ(1u, c->getRefCount());
+
+  SharedPtr<Int> d(new Int2(7));
+  SharedPtr<Int2> e(new Int2(8));
+  d = std::move(e);
+  EXPECT_TRUE(e.get() == NULL);
+  EXPECT_EQ(8, d->value_);
+  EXPECT_EQ(1u, d->getRefCount());
+
+  c.swap(d);
+  EXPECT_EQ(8, c->value_);
+  EXPECT_EQ(5, d->value_);
+}
+
+TEST(SharedPtr, MakeSharedPtr)
+{
+  SharedPtr<Int> a = make_shared_ptr<Int>(5);
+  EXPECT_EQ(5, a->value_);
+  EXPECT_EQ(1u, a->getRefCount());
+
+  SharedPtr<Int> b = make_shared_ptr<Int2>(6);
+  EXPECT_EQ(6, b->value_);
+  EXPECT_EQ(1u, b->getRefCount());
+}
+
+TEST(WeakPtr, Lock)
+{
+  WeakPtr<Int> empty;
+  EXPECT_TRUE(empty.isExpired());
+  EXPECT_TRUE(empty.lock().get() == NULL);
+
+  SharedPtr<Int> a(new Int(5));
+  WeakPtr<Int> w(a);
+  WeakPtr<Int> w2 = w;
+  EXPECT_FALSE(w.isExpired());
+  EXPECT_EQ(1u, a->getRefCount()); // weak references do not count
+
+  {
+    SharedPtr<Int> b = w.lock();
+    EXPECT_EQ(a.get(), b.get());
+    EXPECT_EQ(2u, a->getRefCount());
+  }
+
+  a.reset();
+  EXPECT_TRUE(w.isExpired());
+  EXPECT_TRUE(w2.isExpired());
+  EXPECT_TRUE(w.lock().get() == NULL);
+
+  w2.reset();
+  EXPECT_TRUE(w2.isExpired());
+}
+
+TEST(WeakPtr, NonAtomicPolicy)
+{
+  SharedPtr<LocalInt> a(new LocalInt(5));
+  WeakPtr<LocalInt> w(a);
+  EXPECT_EQ(5, w.lock()->value_);
+
+  a.reset();
+  EXPECT_TRUE(w.lock().get() == NULL);
+}
+
+TEST(WeakPtr, ThreadsLockWhileTheObjectIsReleased)
+{
+  for (int i=0; i<1000; ++i) {
+    SharedPtr<Int> a(new Int(i));
+    WeakPtr<Int> w(a);
+
+    std::thread t([w, i]() {
+	for (int j=0; j<10; ++j) {
+	  SharedPtr<Int> b = w.lock();
+	  if (b) {
+	    EXPECT_EQ(i, b->value_);
+	  }
+	}
+      });
+    a.reset();
+    t.join();
+
+    EXPECT_TRUE(w.isExpired());
+  }
+}
+
+// ======================================================================
+// Benchmarks
+
+namespace {
+
+  // Simulates an operator of a resource wrapper (like Region::operator|)
+  // which returns its result by value
+  SharedPtr<Int> combine(const SharedPtr<Int>& a, const SharedPtr<Int>& b)
+  {
+    SharedPtr<Int> res(new Int(a->value_ | b->value_));
+    return res;
+  }
+
+  // Forces the copy that was done before SharedPtr was movable
+  template<class T>
+  const T& copy(const T& x) { return x; }
+
+}
+
+TEST(SharedPtr, BenchmarkMove)
+{
+  typedef std::chrono::steady_clock Clock;
+  const int n = 1000000;
+
+  SharedPtr<Int> a(new Int(1)), b(new Int(2)), r;
+  std::vector<SharedPtr<Int> > v(16);
+
+  Clock::time_point t0 = Clock::now();
+  for (int i=0; i<n; ++i) {
+    r = copy(combine(a, b));
+    v[i & 15] = copy(r);
+  }
+  Clock::time_point t1 = Clock::now();
+  for (int i=0; i<n; ++i) {
+    r = combine(a, b);
+    v[i & 15] = std::move(r);
+  }
+  Clock::time_point t2 = Clock::now();
+
+  std::printf("copy = %.3f ms, move = %.3f ms\n",
+	      std::chrono::duration<double, std::milli>(t1 - t0).count(),
+	      std::chrono::duration<double, std::milli>(t2 - t1).count());
+}
@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
 #include <string>
+#include <vector>
 
+#include "vaca/Command.h"
 #include "vaca/Signal.h"
 
 using namespace std;
@@ -160,11 +164,10 @@ namespace test1 {
   {
     Signal0<void> s;
     {
-      Slot0<void>* a = s.connect(&func1);
+      Connection a = s.connect(&func1);
       s();
       s();
       s.disconnect(a);
-      delete a;
     }
     s();
     s.connect(op1(9));
@@ -172,8 +175,8 @@ namespace test1 {
     {
       Q q1(1);
       Q q2(2);
-      Slot0<void>* b = s.connect(&Q::ok, &q1);
-      Slot0<void>* c = s.connect(&Q::cancel, &q2);
+      s.connect(&Q::ok, &q1);
+      s.connect(&Q::cancel, &q2);
       s();
     }
     EXPECT_EQ(2, func1_counter);
@@ -224,10 +227,9 @@ namespace test3 {
   TEST(Signal, ReturnVoidOneArg)
   {
     Signal1<void, int> s;
-    Slot1<void, int>* a = s.connect(&return_check_arg_eq_5);
+    Connection a = s.connect(&return_check_arg_eq_5);
     s(5);
     s.disconnect(a);
-    delete a;
 
     s.connect(checker(4));
     s(5);
@@ -324,3 +326,417 @@ namespace test5 {
 }
 
 //////////////////////////////////////////////////////////////////////
+
+namespace test6 {
+
+  int sum3(int a, int b, int c) { return a+b+c; }
+
+  struct sum4 {
+    int operator()(int a, int b, int c, int d) { return a+b+c+d; }
+  };
+
+  TEST(Signal, MoreArgs)
+  {
+    Signal3<int, int, int, int> s3;
+    s3.connect(&sum3);
+    EXPECT_EQ(6, s3(1, 2, 3));
+
+    Signal4<int, int, int, int, int> s4;
+    s4.connect(sum4());
+    EXPECT_EQ(10, s4(1, 2, 3, 4));
+
+    Signal<void(int, int, int, int, int)> s5;
+    int total = 0;
+    s5.connect([&total](int a, int b, int c, int d, int e) { total = a+b+c+d+e; });
+    s5(1, 2, 3, 4, 5);
+    EXPECT_EQ(15, total);
+  }
+
+  TEST(Signal, CopySignal)
+  {
+    Signal1<int, int> s;
+    s.connect(&test0::func1_int);
+    Signal1<int, int> s2(s);
+    EXPECT_EQ(1u, s2.size());
+    EXPECT_EQ(7, s2(7));
+
+    s.disconnectAll();
+    EXPECT_TRUE(s.empty());
+    EXPECT_EQ(7, s2(7));
+  }
+
+  TEST(Signal, DisconnectKeepsOrder)
+  {
+    std::string out;
+    Signal0<void> s;
+    s.connect([&out]() { out += "a"; });
+    Connection b = s.connect([&out]() { out += "b"; });
+    s.connect([&out]() { out += "c"; });
+    s();
+    s.disconnect(b);
+    s();
+    EXPECT_EQ("abcac", out);
+  }
+
+}
+
+//////////////////////////////////////////////////////////////////////
+// Connections/disconnections while the signal is being emitted
+
+namespace test8 {
+
+  TEST(Signal, ScopedConnection)
+  {
+    int hits = 0;
+    Signal0<void> s;
+    {
+      ScopedConnection a = s.connect([&hits]() { ++hits; });
+      s();
+      EXPECT_EQ(1u, s.size());
+    }
+    EXPECT_TRUE(s.empty());
+    s();
+    EXPECT_EQ(1, hits);
+
+    ScopedConnection b;
+    b = s.connect([&hits]() { ++hits; });
+    Connection c = b.release();
+    b.disconnect();
+    s();
+    EXPECT_EQ(2, hits);
+
+    c.disconnect();
+    c.disconnect();		// disconnecting twice is harmless
+    s.disconnect(c);
+    EXPECT_TRUE(s.empty());
+  }
+
+  // e.g. a ScopedConnection member connected to the Click signal of a
+  // sibling button that is deleted before the owner
+  TEST(Signal, ScopedConnectionOutlivesSignal)
+  {
+    ScopedConnection a;
+    Connection b;
+    {
+      Signal0<void> s;
+      a = s.connect([]() { });
+      b = s.connect([]() { });
+      EXPECT_TRUE(a.get().isValid());
+    }
+    EXPECT_FALSE(a.get().isValid());
+    EXPECT_FALSE(b.isValid());
+    b.disconnect();
+    a.disconnect();
+
+    // the old connections of an assigned signal do not disconnect
+    // the copied slots
+    int hits = 0;
+    Signal0<void> s1, s2;
+    s1.connect([&hits]() { ++hits; });
+    {
+      ScopedConnection c = s2.connect([]() { });
+      s2 = s1;
+      EXPECT_FALSE(c.get().isValid());
+    }
+    EXPECT_EQ(1u, s2.size());
+    s2();
+    EXPECT_EQ(1, hits);
+  }
+
+  struct SelfDisconnect {
+    Signal0<void>* sig;
+    Connection* conn;
+    int* hits;
+    void operator()() { ++*hits; sig->disconnect(*conn); }
+  };
+
+  TEST(Signal, DisconnectWhileEmitting)
+  {
+    Signal0<void> s;
+    int hits = 0, later_hits = 0;
+    Connection self;
+    Connection later;
+
+    SelfDisconnect f = { &s, &self, &hits };
+    self = s.connect(f);
+    s.connect([&s, &later]() { s.disconnect(later); });
+    later = s.connect([&later_hits]() { ++later_hits; });
+
+    s();
+    EXPECT_EQ(1, hits);
+    EXPECT_EQ(0, later_hits);	// disconnected before its turn
+    EXPECT_EQ(1u, s.size());
+
+    s();
+    EXPECT_EQ(1, hits);
+  }
+
+  TEST(Signal, ConnectWhileEmitting)
+  {
+    Signal0<void> s;
+    int hits = 0;
+    s.connect([&s, &hits]() {
+	s.connect([&hits]() { ++hits; });
+      });
+
+    s();			// new slots are called in the next emission
+    EXPECT_EQ(0, hits);
+    EXPECT_EQ(2u, s.size());
+    s();
+    EXPECT_EQ(1, hits);
+    EXPECT_EQ(3u, s.size());
+  }
+
+  TEST(Signal, DisconnectAllWhileEmitting)
+  {
+    Signal1<void, int> s;
+    int hits = 0;
+    s.connect([&s, &hits](int) { ++hits; s.disconnectAll(); });
+    s.connect([&hits](int) { ++hits; });
+    s(0);
+    EXPECT_EQ(1, hits);
+    EXPECT_TRUE(s.empty());
+  }
+
+  TEST(Signal, RecursiveEmit)
+  {
+    Signal1<void, int> s;
+    std::vector<Connection> conns;
+    int hits = 0;
+    s.connect([&](int depth) {
+	++hits;
+	if (depth < 3) {
+	  conns.push_back(s.connect([&hits](int) { ++hits; }));
+	  s(depth+1);
+	  s.disconnect(conns.front());
+	}
+      });
+    s(0);
+    EXPECT_EQ(4, hits);
+    EXPECT_EQ(3u, s.size());
+  }
+
+  TEST(Signal, StressMutateWhileEmitting)
+  {
+    Signal1<void, int> s;
+    std::vector<Connection> conns;
+    unsigned seed = 12345;
+    int calls = 0;
+
+    struct Mutator {
+      Signal1<void, int>* s;
+      std::vector<Connection>* conns;
+      unsigned* seed;
+      int* calls;
+      void operator()(int depth) {
+	++*calls;
+	*seed = *seed * 1103515245 + 12345;
+	unsigned r = (*seed >> 16) % 8;
+	if (r < 3 && !conns->empty()) {
+	  std::size_t i = (*seed >> 8) % conns->size();
+	  s->disconnect((*conns)[i]);
+	  conns->erase(conns->begin() + i);
+	}
+	else if (r < 6 && conns->size() < 200) {
+	  conns->push_back(s->connect(*this));
+	}
+	else if (r == 6 && depth < 2) {
+	  (*s)(depth+1);
+	}
+      }
+    };
+
+    Mutator m = { &s, &conns, &seed, &calls };
+    for (int i=0; i<32; ++i)
+      conns.push_back(s.connect(m));
+
+    for (int i=0; i<500; ++i) {
+      s(0);
+      EXPECT_EQ(conns.size(), s.size());
+    }
+    EXPECT_LT(0, calls);
+
+    for (std::size_t i=0; i<conns.size(); ++i)
+      conns[i].disconnect();
+    EXPECT_TRUE(s.empty());
+  }
+
+}
+
+//////////////////////////////////////////////////////////////////////
+
+namespace test9 {
+
+  int calls = 0;
+
+  bool yes() { ++calls; return true; }
+  bool no() { ++calls; return false; }
+
+  int zero() { ++calls; return 0; }
+  int five() { ++calls; return 5; }
+  int six() { ++calls; return 6; }
+
+  struct Unique
+  {
+    int* ptr;
+    explicit Unique(int v) : ptr(new int(v)) { }
+    Unique(Unique&& other) : ptr(other.ptr) { other.ptr = NULL; }
+    Unique& operator=(Unique&& other) { std::swap(ptr, other.ptr); return *this; }
+    ~Unique() { delete ptr; }
+  private:
+    Unique(const Unique&);
+    Unique& operator=(const Unique&);
+  };
+
+  TEST(Signal, CollectorsOnEmptySignal)
+  {
+    Signal<bool()> b;
+    Signal<int(int)> i;
+
+    EXPECT_FALSE(b.collect(any_of()));
+    EXPECT_TRUE(b.collect(all_of()));
+    EXPECT_EQ(0, i.collect(1, first_non_default<int>()));
+    EXPECT_EQ(7, i.collect(1, last(7)));
+    EXPECT_TRUE(i.collect(1, to_vector<int>()).empty());
+  }
+
+  TEST(Signal, CollectorsShortCircuit)
+  {
+    Signal<bool()> s;
+    s.connect(&yes);
+    s.connect(&no);
+    s.connect(&yes);
+
+    calls = 0;
+    EXPECT_TRUE(s.collect(any_of()));
+    EXPECT_EQ(1, calls);
+
+    calls = 0;
+    EXPECT_FALSE(s.collect(all_of()));
+    EXPECT_EQ(2, calls);
+
+    Signal<int()> t;
+    t.connect(&zero);
+    t.connect(&five);
+    t.connect(&six);
+
+    calls = 0;
+    EXPECT_EQ(5, t.collect(first_non_default<int>()));
+    EXPECT_EQ(2, calls);
+
+    calls = 0;
+    EXPECT_EQ(6, t.collect(last<int>()));
+    EXPECT_EQ(3, calls);
+
+    std::vector<int> v = t.collect(to_vector<int>());
+    ASSERT_EQ(3u, v.size());
+    EXPECT_EQ(0, v[0]);
+    EXPECT_EQ(5, v[1]);
+    EXPECT_EQ(6, v[2]);
+  }
+
+  TEST(Signal, CollectorsMoveResults)
+  {
+    Signal<Unique(int)> s;
+    s.connect([](int v) { return Unique(v); });
+    s.connect([](int v) { return Unique(v*2); });
+
+    std::vector<Unique> v = s.collect(3, to_vector<Unique>());
+    ASSERT_EQ(2u, v.size());
+    EXPECT_EQ(3, *v[0].ptr);
+    EXPECT_EQ(6, *v[1].ptr);
+  }
+
+  TEST(Signal, SignalCommandUsesCollectors)
+  {
+    SignalCommand cmd(1);
+    EXPECT_TRUE(cmd.isEnabled());
+    EXPECT_FALSE(cmd.isChecked());
+
+    // the last slot decides
+    cmd.Enabled.connect(&yes);
+    cmd.Enabled.connect(&no);
+    cmd.Checked.connect(&no);
+    cmd.Checked.connect(&yes);
+    EXPECT_FALSE(cmd.isEnabled());
+    EXPECT_TRUE(cmd.isChecked());
+
+    cmd.Enabled.connect(&yes);
+    cmd.Checked.connect(&no);
+    EXPECT_TRUE(cmd.isEnabled());
+    EXPECT_FALSE(cmd.isChecked());
+  }
+
+}
+
+//////////////////////////////////////////////////////////////////////
+// Benchmarks
+
+namespace test7 {
+
+  class Counter {
+  public:
+    int hits;
+    Counter() : hits(0) { }
+    void onEvent(int value) { hits += value; }
+  };
+
+  double elapsed_ms(std::chrono::steady_clock::time_point start)
+  {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  const int signals = 10000;
+  const int slots = 8;
+
+  TEST(SignalBenchmark, Connect)
+  {
+    std::vector<Counter> counters(slots);
+    std::vector<Signal1<void, int> > sigs(signals);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i=0; i<signals; ++i)
+      for (int j=0; j<slots; ++j)
+	sigs[i].connect(&Counter::onEvent, &counters[j]);
+    printf("connect: %d slots in %.3f ms\n", signals*slots, elapsed_ms(start));
+
+    EXPECT_EQ(std::size_t(slots), sigs[0].size());
+  }
+
+  TEST(SignalBenchmark, Emit)
+  {
+    std::vector<Counter> counters(slots);
+    Signal1<void, int> sig;
+    for (int j=0; j<slots; ++j)
+      sig.connect(&Counter::onEvent, &counters[j]);
+
+    const int emits = 1000000;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i=0; i<emits; ++i)
+      sig(1);
+    printf("emit: %d emissions to %d slots in %.3f ms\n", emits, slots, elapsed_ms(start));
+
+    for (int j=0; j<slots; ++j)
+      EXPECT_EQ(emits, counters[j].hits);
+  }
+
+  TEST(SignalBenchmark, Disconnect)
+  {
+    std::vector<Counter> counters(slots);
+    std::vector<Signal1<void, int> > sigs(signals);
+    std::vector<Connection> conns;
+    conns.reserve(signals*slots);
+    for (int i=0; i<signals; ++i)
+      for (int j=0; j<slots; ++j)
+	conns.push_back(sigs[i].connect(&Counter::onEvent, &counters[j]));
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i=0; i<signals; ++i)
+      for (int j=0; j<slots; ++j)
+	sigs[i].disconnect(conns[i*slots + j]);
+    printf("disconnect: %d slots in %.3f ms\n", signals*slots, elapsed_ms(start));
+
+    EXPECT_TRUE(sigs[0].empty());
+  }
+
+}
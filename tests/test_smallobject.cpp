@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "vaca/SmallObject.h"
+#include "vaca/SharedPtr.h"
+#include "vaca/Referenceable.h"
+
+using namespace vaca;
+
+// Counts the allocations made with the global operator new, so we can
+// check that some code does not use the global heap.
+
+static std::atomic<long> global_allocs(0);
+
+void* operator new(std::size_t size)
+{
+  ++global_allocs;
+  void* ptr = std::malloc(size ? size: 1);
+  if (!ptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void operator delete(void* ptr) throw()
+{
+  std::free(ptr);
+}
+
+class AllocationCounter
+{
+  long m_start;
+public:
+  AllocationCounter() : m_start(global_allocs.load()) { }
+  long getCount() const { return global_allocs.load() - m_start; }
+};
+
+// A handle like GdiObject<T>
+class Handle : public Referenceable
+	     , public SmallObject
+{
+public:
+  int value;
+  Handle(int value) : value(value) { }
+};
+
+class BigHandle : public Handle
+{
+public:
+  char data[SmallObject::MaxSize];
+  BigHandle() : Handle(0) { }
+};
+
+// Simulates the temporaries of a paint event
+static void paint()
+{
+  std::vector<SharedPtr<Handle> > v;
+  v.reserve(64);
+  for (int i=0; i<64; ++i)
+    v.push_back(new Handle(i));
+  for (int i=0; i<64; ++i)
+    EXPECT_EQ(i, v[i]->value);
+}
+
+TEST(SmallObject, NoGlobalAllocationsInSteadyState)
+{
+  paint();			// warm up
+
+  AllocationCounter counter;
+  for (int frame=0; frame<1000; ++frame)
+    paint();
+
+  // only the std::vector of each frame
+  EXPECT_EQ(1000, counter.getCount());
+}
+
+TEST(SmallObject, ReusesBlocks)
+{
+  Handle* a = new Handle(1);
+  delete a;
+  Handle* b = new Handle(2);
+  EXPECT_EQ(a, b);
+  delete b;
+}
+
+TEST(SmallObject, BigObjectsUseTheGlobalHeap)
+{
+  AllocationCounter counter;
+  SharedPtr<Handle> a(new BigHandle);
+  EXPECT_EQ(1, counter.getCount());
+}
+
+TEST(SmallObject, DeleteInOtherThread)
+{
+  for (int c=0; c<10; ++c) {
+    std::vector<Handle*> v;
+    for (int i=0; i<2000; ++i)
+      v.push_back(new Handle(i));
+
+    std::thread t([&v]() {
+	for (std::size_t i=0; i<v.size(); ++i) {
+	  EXPECT_EQ((int)i, v[i]->value);
+	  delete v[i];
+	}
+	// blocks of the other thread can be used here
+	delete new Handle(0);
+      });
+    t.join();
+  }
+}
@@ -0,0 +1,243 @@
+#include <gtest/gtest.h>
+
+#include "vaca/SpatialIndex.h"
+#include "vaca/Point.h"
+#include "vaca/Rect.h"
+#include "vaca/RectBatch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+using namespace vaca;
+
+typedef SpatialIndex<int> Index;
+
+static Rect random_rect(int range)
+{
+  // some empty rectangles and rectangles with negative sizes
+  return Rect(std::rand() % range, std::rand() % range,
+	      std::rand() % 60 - 4, std::rand() % 60 - 4);
+}
+
+static bool overlap(const Rect& a, const Rect& b)
+{
+  return (std::max(a.x, b.x) < std::min(a.x+a.w, b.x+b.w) &&
+	  std::max(a.y, b.y) < std::min(a.y+a.h, b.y+b.h));
+}
+
+// Sorted result of a query, to compare it with the expected items
+static std::vector<int> at(const Index& index, const Point& pt)
+{
+  std::vector<int> items;
+  index.findAt(pt, items);
+  std::sort(items.begin(), items.end());
+  return items;
+}
+
+static std::vector<int> in(const Index& index, const Rect& rc)
+{
+  std::vector<int> items;
+  index.findIntersecting(rc, items);
+  std::sort(items.begin(), items.end());
+  return items;
+}
+
+// Compares the index with a loop over all the items
+static void check(const Index& index, const std::map<int, Rect>& items, int range)
+{
+  ASSERT_EQ(items.size(), index.size());
+
+  for (int k=0; k<20; ++k) {
+    Point pt(std::rand() % range, std::rand() % range);
+    Rect rc = random_rect(range);
+    std::vector<int> expectedAt, expectedIn;
+
+    for (std::map<int, Rect>::const_iterator it=items.begin(); it!=items.end(); ++it) {
+      const Rect& bounds = it->second;
+      if (bounds.x <= pt.x && pt.x < bounds.x+bounds.w &&
+	  bounds.y <= pt.y && pt.y < bounds.y+bounds.h)
+	expectedAt.push_back(it->first);
+      if (overlap(bounds, rc))
+	expectedIn.push_back(it->first);
+    }
+
+    ASSERT_TRUE(expectedAt == at(index, pt));
+    ASSERT_TRUE(expectedIn == in(index, rc));
+  }
+}
+
+TEST(SpatialIndex, Basic)
+{
+  Index index;
+  std::vector<int> items;
+  EXPECT_TRUE(index.empty());
+  EXPECT_EQ(0u, index.findAt(Point(0, 0), items));
+
+  index.insert(1, Rect(0, 0, 10, 10));
+  index.insert(2, Rect(5, 5, 10, 10));
+  index.insert(3, Rect(20, 0, 0, 10));	// empty
+  EXPECT_EQ(3u, index.size());
+  EXPECT_TRUE(index.contains(3));
+
+  EXPECT_EQ(2u, index.findAt(Point(7, 7), items));
+  EXPECT_EQ(1u, index.findAt(Point(0, 0), items));
+  EXPECT_EQ(0u, index.findAt(Point(10, 0), items));
+  EXPECT_EQ(0u, index.findAt(Point(20, 5), items));
+  EXPECT_EQ(1u, index.findIntersecting(Rect(12, 12, 5, 5), items));
+  EXPECT_EQ(2, items[0]);
+  EXPECT_EQ(0u, index.findIntersecting(Rect(15, 0, 10, 10), items)); // touching edges
+
+  EXPECT_TRUE(index.update(3, Rect(20, 0, 5, 10)));
+  EXPECT_EQ(1u, index.findAt(Point(20, 5), items));
+  EXPECT_TRUE(index.update(1, Rect(100, 100, 10, 10)));
+  EXPECT_EQ(1u, index.findAt(Point(7, 7), items));
+  EXPECT_EQ(2, items[0]);
+
+  EXPECT_TRUE(index.remove(2));
+  EXPECT_FALSE(index.remove(2));
+  EXPECT_FALSE(index.update(2, Rect(0, 0, 1, 1)));
+  EXPECT_EQ(0u, index.findAt(Point(7, 7), items));
+  EXPECT_EQ(2u, index.size());
+
+  index.clear();
+  EXPECT_TRUE(index.empty());
+  EXPECT_EQ(0u, index.findIntersecting(Rect(0, 0, 1000, 1000), items));
+}
+
+TEST(SpatialIndex, Random)
+{
+  std::srand(37);
+  const int range = 2000;
+
+  for (int round=0; round<4; ++round) {
+    Index index;
+    std::map<int, Rect> items;
+
+    // the second half of the rounds start with a bulk-load
+    if (round >= 2) {
+      std::vector<Index::Item> loaded;
+      for (int i=0; i<3000*(round-1); ++i) {
+	Rect rc = random_rect(range);
+	items[i] = rc;
+	loaded.push_back(Index::Item(i, rc));
+      }
+      index.load(loaded);
+      check(index, items, range);
+    }
+
+    for (int step=0; step<6000; ++step) {
+      int item = std::rand() % 4000;
+      int op = std::rand() % 10;
+
+      if (op < 5) {
+	Rect rc = random_rect(range);
+	if (items.find(item) == items.end())
+	  index.insert(item, rc);
+	else if (op < 3) {
+	  // small movements (updated in place most of times)
+	  rc = items[item];
+	  rc.x += std::rand() % 5 - 2;
+	  rc.y += std::rand() % 5 - 2;
+	  ASSERT_TRUE(index.update(item, rc));
+	}
+	else
+	  ASSERT_TRUE(index.update(item, rc));
+	items[item] = rc;
+      }
+      else if (op < 8) {
+	ASSERT_EQ(items.erase(item) == 1, index.remove(item));
+      }
+
+      if (step % 500 == 0)
+	check(index, items, range);
+    }
+    check(index, items, range);
+
+    // remove everything
+    while (!items.empty()) {
+      ASSERT_TRUE(index.remove(items.begin()->first));
+      items.erase(items.begin());
+      if (items.size() % 300 == 0)
+	check(index, items, range);
+    }
+    EXPECT_TRUE(index.empty());
+  }
+}
+
+// A canvas with a lot of children (e.g. a diagram)
+TEST(SpatialIndex, Benchmark)
+{
+  typedef std::chrono::steady_clock Clock;
+  const int n = 50000;
+  const int queries = 10000;
+
+  std::srand(41);
+  std::vector<Rect> rects;
+  std::vector<Index::Item> items;
+  for (int i=0; i<n; ++i) {
+    Rect rc(std::rand() % 20000, std::rand() % 20000, 40 + std::rand() % 80, 20 + std::rand() % 40);
+    rects.push_back(rc);
+    items.push_back(Index::Item(i, rc));
+  }
+
+  std::vector<Point> points;
+  for (int k=0; k<queries; ++k)
+    points.push_back(Point(std::rand() % 20000, std::rand() % 20000));
+
+  Clock::time_point t0 = Clock::now();
+  Index index;
+  index.load(items);
+  Clock::time_point t1 = Clock::now();
+
+  std::vector<int> found;
+  std::size_t hits = 0, damaged = 0;
+  for (int k=0; k<queries; ++k)
+    hits += index.findAt(points[k], found);
+  Clock::time_point t2 = Clock::now();
+
+  for (int k=0; k<queries; ++k)
+    damaged += index.findIntersecting(Rect(points[k].x, points[k].y, 300, 200), found);
+  Clock::time_point t3 = Clock::now();
+
+  // a SIMD loop over all the children
+  RectBatch batch(rects);
+  Clock::time_point t4 = Clock::now();
+  std::size_t hits2 = 0, damaged2 = 0;
+  for (int k=0; k<queries/10; ++k) {
+    std::vector<int> indices;
+    for (int i=0; i<n; ++i)
+      if (rects[i].contains(points[k]))
+	++hits2;
+    damaged2 += batch.findIntersecting(Rect(points[k].x, points[k].y, 300, 200), indices);
+  }
+  Clock::time_point t5 = Clock::now();
+
+  // drag each child a bit
+  for (int i=0; i<n; ++i) {
+    Rect rc = rects[i];
+    rc.x += std::rand() % 200 - 100;
+    rc.y += std::rand() % 200 - 100;
+    index.update(i, rc);
+  }
+  Clock::time_point t6 = Clock::now();
+
+  EXPECT_EQ(std::size_t(n), index.size());
+  EXPECT_GT(hits, 0u);
+  EXPECT_GT(damaged, hits);
+  EXPECT_GT(hits2, 0u);
+  EXPECT_GT(damaged2, 0u);
+
+  typedef std::chrono::duration<double, std::micro> Micro;
+  std::printf("%d children: load = %.1f ms, findAt = %.2f us, findIntersecting = %.2f us, "
+	      "loop over children (both queries) = %.0f us, update = %.2f us\n",
+	      n,
+	      Micro(t1 - t0).count() / 1000,
+	      Micro(t2 - t1).count() / queries,
+	      Micro(t3 - t2).count() / queries,
+	      Micro(t5 - t4).count() / (queries/10),
+	      Micro(t6 - t5).count() / n);
+}
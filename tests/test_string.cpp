@@ -57,6 +57,19 @@ TEST(String, Conversion)
   EXPECT_EQ(UINT_MAX,  convert_to<unsigned int>(b_uint));
   EXPECT_EQ(0UL,       convert_to<unsigned long>(a_ulong));
   EXPECT_EQ(ULONG_MAX, convert_to<unsigned long>(b_ulong));
+
+  // shortest representation that is converted back to the same number
+  EXPECT_EQ(L"0.1",	convert_to<String>(0.1f));
+  EXPECT_EQ(L"1e+20",	convert_to<String>(1e20));
+  EXPECT_EQ(0.1,	convert_to<double>(convert_to<String>(0.1)));
+
+  // like wcstol/wcstod: white spaces, '+' sign, and errors
+  EXPECT_EQ(42,		convert_to<int>(String(L"  +42")));
+  EXPECT_EQ(12,		convert_to<int>(String(L"12px")));
+  EXPECT_EQ(0,		convert_to<int>(String(L"abc")));
+  EXPECT_EQ(INT_MAX,	convert_to<int>(String(L"99999999999")));
+  EXPECT_EQ(INT_MIN,	convert_to<int>(String(L"-99999999999")));
+  EXPECT_EQ(-1.5,	convert_to<double>(String(L" -1.5")));
 }
 
 TEST(String, FilePath)
@@ -151,6 +164,129 @@ TEST(String, TrimAlgorithm)
   EXPECT_EQ(L"No \n \r \ttrim", trim_string(L"\tNo \n \r \ttrim \n "));
 }
 
+TEST(String, View)
+{
+  String str(L"Hello world");
+  StringView view(str);
+
+  EXPECT_EQ(str.data(), view.data());
+  EXPECT_EQ(11, view.size());
+  EXPECT_TRUE(view == L"Hello world");
+  EXPECT_TRUE(view.substr(6) == L"world");
+  EXPECT_TRUE(view.substr(0, 5) == L"Hello");
+  EXPECT_TRUE(view.substr(11).empty());
+  EXPECT_EQ(4, view.find(L'o'));
+  EXPECT_EQ(7, view.find(L'o', 5));
+  EXPECT_EQ(6, view.find(StringView(L"wor")));
+  EXPECT_EQ(StringView::npos, view.find(StringView(L"word")));
+  EXPECT_EQ(7, view.rfind(L'o'));
+  EXPECT_EQ(2, view.find_first_of(L"lw"));
+  EXPECT_EQ(9, view.find_last_of(L"lw"));
+  EXPECT_TRUE(StringView(L"abc") < StringView(L"abd"));
+  EXPECT_TRUE(StringView(L"ab") < StringView(L"abc"));
+  EXPECT_TRUE(StringView() == StringView(L""));
+  EXPECT_EQ(str, view.str());
+}
+
+TEST(String, ViewHelpers)
+{
+  // the results are parts of the original string
+  String fullpath(L"C:\\foo\\pack.tar.gz");
+  StringView path = file_path(StringView(fullpath));
+  StringView name = file_name(StringView(fullpath));
+  StringView ext = file_extension(StringView(fullpath));
+  StringView title = file_title(StringView(fullpath));
+
+  EXPECT_TRUE(path == L"C:\\foo");
+  EXPECT_TRUE(name == L"pack.tar.gz");
+  EXPECT_TRUE(ext == L"gz");
+  EXPECT_TRUE(title == L"pack.tar");
+  EXPECT_EQ(fullpath.data(), path.data());
+  EXPECT_EQ(fullpath.data()+7, name.data());
+  EXPECT_EQ(fullpath.data()+16, ext.data());
+
+  String url(L"http://vaca.sf.net/doc/index.html");
+  EXPECT_TRUE(url_host(StringView(url)) == L"vaca.sf.net");
+  EXPECT_TRUE(url_object(StringView(url)) == L"/doc/index.html");
+  EXPECT_EQ(L"vaca.sf.net", url_host(url));
+  EXPECT_EQ(L"/doc/index.html", url_object(url));
+  EXPECT_EQ(L"vaca.sf.net", url_host(L"http://vaca.sf.net"));
+  EXPECT_EQ(L"", url_object(L"http://vaca.sf.net"));
+  EXPECT_EQ(L"", url_host(L"vaca.sf.net/doc"));
+
+  String text(L"  \t trim me \n");
+  StringView trimmed = trim_string(StringView(text));
+  EXPECT_TRUE(trimmed == L"trim me");
+  EXPECT_EQ(text.data()+4, trimmed.data());
+
+  // char strings work too
+  EXPECT_TRUE(file_name(BasicStringView<char>("/usr/include/stdio.h")) == "stdio.h");
+}
+
+TEST(String, EncodeUrl)
+{
+  EXPECT_EQ(L"http://vaca.sf.net/a%20b/?q=1&r=%7Bx%7D#top",
+	    encode_url(L"http://vaca.sf.net/a b/?q=1&r={x}#top"));
+  EXPECT_EQ(L"http://vaca.sf.net/a%20b", encode_url(L"http://vaca.sf.net/a%20b"));
+  EXPECT_EQ(L"/a%C3%B1o", encode_url(String(L"/a") + Char(0xF1) + L"o"));
+
+  EXPECT_EQ(L"http://vaca.sf.net/a b/?r={x}", decode_url(L"http://vaca.sf.net/a%20b/?r=%7bx%7D"));
+  EXPECT_EQ(String(L"/a") + Char(0xF1) + L"o", decode_url(L"/a%C3%B1o"));
+  EXPECT_EQ(L"100%", decode_url(L"100%"));
+}
+
+TEST(String, Split)
+{
+  std::vector<String> parts;
+
+  split_string(L"a,b;c", parts, L",;");
+  ASSERT_EQ(3, parts.size());
+  EXPECT_EQ(L"a", parts[0]);
+  EXPECT_EQ(L"b", parts[1]);
+  EXPECT_EQ(L"c", parts[2]);
+
+  split_string(L",a,,", parts, L",");
+  ASSERT_EQ(4, parts.size());
+  EXPECT_EQ(L"", parts[0]);
+  EXPECT_EQ(L"a", parts[1]);
+  EXPECT_EQ(L"", parts[2]);
+  EXPECT_EQ(L"", parts[3]);
+
+  split_string(L"", parts, L",");
+  ASSERT_EQ(1, parts.size());
+  EXPECT_EQ(L"", parts[0]);
+
+  split_string(L"no separators", parts, L",");
+  ASSERT_EQ(1, parts.size());
+  EXPECT_EQ(L"no separators", parts[0]);
+}
+
+TEST(String, SplitLazy)
+{
+  String line(L"one two  three");
+  StringSplitter words = split_string(StringView(line), L" ");
+  StringSplitter::iterator it = words.begin();
+
+  ASSERT_TRUE(it != words.end());
+  EXPECT_TRUE(*it == L"one");
+  EXPECT_EQ(line.data(), it->data());
+  ++it;
+  EXPECT_TRUE(*it == L"two");
+  ++it;
+  EXPECT_TRUE(*it == L"");
+  ++it;
+  EXPECT_TRUE(*it == L"three");
+  EXPECT_EQ(line.data()+9, it->data());
+  ++it;
+  EXPECT_TRUE(it == words.end());
+
+  int count = 0;
+  StringSplitter empty = split_string(StringView(), L",");
+  for (StringSplitter::iterator it = empty.begin(); it != empty.end(); ++it)
+    ++count;
+  EXPECT_EQ(1, count);
+}
+
 TEST(String, Format)
 {
   EXPECT_EQ(L"",	format_string(L""));
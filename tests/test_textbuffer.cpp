@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+
+#include "vaca/TextBuffer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace vaca;
+
+static String chunks_to_string(const TextBuffer& text)
+{
+  String res;
+  for (TextBuffer::ChunkIterator it = text.begin(); it != text.end(); ++it)
+    res.append(it->data(), it->size());
+  return res;
+}
+
+TEST(TextBuffer, Basic)
+{
+  TextBuffer text;
+  EXPECT_TRUE(text.empty());
+  EXPECT_EQ(0u, text.size());
+  EXPECT_EQ(L"", text.str());
+  EXPECT_TRUE(text.begin() == text.end());
+
+  text.insert(0, L"world");
+  text.insert(0, L"Hello ");
+  text.insert(5, L',');
+  EXPECT_EQ(L"Hello, world", text.str());
+  EXPECT_EQ(12u, text.size());
+  EXPECT_EQ(L'w', text.at(7));
+  EXPECT_EQ(L"lo, w", text.substr(3, 5));
+  EXPECT_EQ(L"world", text.substr(7, 100));
+
+  text.erase(5, 1);
+  text.erase(5, 100);
+  EXPECT_EQ(L"Hello", text.str());
+  text.clear();
+  EXPECT_TRUE(text.empty());
+}
+
+TEST(TextBuffer, Snapshots)
+{
+  TextBuffer text(L"version 1");
+  TextBuffer v1 = text;
+
+  text.erase(8, 1);
+  text.insert(8, L"2");
+  TextBuffer v2 = text;
+  text.insert(0, L"last ");
+
+  EXPECT_EQ(L"version 1", v1.str());
+  EXPECT_EQ(L"version 2", v2.str());
+  EXPECT_EQ(L"last version 2", text.str());
+
+  text = v1;
+  EXPECT_EQ(L"version 1", text.str());
+}
+
+TEST(TextBuffer, Lines)
+{
+  TextBuffer text(L"first\nsecond\n\nfourth");
+  EXPECT_EQ(4u, text.getLineCount());
+  EXPECT_EQ(0u, text.getLineOffset(0));
+  EXPECT_EQ(6u, text.getLineOffset(1));
+  EXPECT_EQ(13u, text.getLineOffset(2));
+  EXPECT_EQ(14u, text.getLineOffset(3));
+  EXPECT_EQ(text.size(), text.getLineOffset(4));
+
+  EXPECT_EQ(0u, text.getLineAt(0));
+  EXPECT_EQ(0u, text.getLineAt(5));
+  EXPECT_EQ(1u, text.getLineAt(6));
+  EXPECT_EQ(2u, text.getLineAt(13));
+  EXPECT_EQ(3u, text.getLineAt(text.size()));
+
+  EXPECT_EQ(1u, TextBuffer().getLineCount());
+}
+
+// Random edits compared with the same edits in a String
+TEST(TextBuffer, RandomEdits)
+{
+  std::srand(5);
+  String expected;
+  TextBuffer text;
+  TextBuffer snapshot;
+  String snapshotExpected;
+
+  for (int i=0; i<20000; ++i) {
+    std::size_t pos = expected.empty() ? 0: std::rand() % (expected.size()+1);
+
+    if (std::rand() % 3 == 0 && !expected.empty()) {
+      std::size_t n = std::rand() % 600;
+      expected.erase(pos, n);
+      text.erase(pos, n);
+    }
+    else {
+      String ins(std::rand() % 32 == 0 ? 3000: std::rand() % 5 + 1, L'a' + (i % 26));
+      if (i % 7 == 0)
+	ins[0] = L'\n';
+      expected.insert(pos, ins);
+      text.insert(pos, ins);
+    }
+
+    if (i % 4000 == 0) {
+      ASSERT_EQ(expected, text.str());
+      ASSERT_EQ(expected, chunks_to_string(text));
+      ASSERT_EQ(snapshotExpected, snapshot.str());
+      snapshot = text;
+      snapshotExpected = expected;
+
+      std::size_t line = 0;
+      for (std::size_t j=0; j<expected.size(); ++j) {
+	ASSERT_EQ(line, text.getLineAt(j));
+	if (expected[j] == L'\n') {
+	  ++line;
+	  ASSERT_EQ(j+1, text.getLineOffset(line));
+	}
+      }
+      ASSERT_EQ(line+1, text.getLineCount());
+    }
+  }
+  EXPECT_EQ(expected, text.str());
+}
+
+// Edits in the middle of a 100 MB document
+TEST(TextBuffer, Benchmark)
+{
+  typedef std::chrono::steady_clock Clock;
+  const std::size_t size = 100*1024*1024 / sizeof(Char);
+  String line(79, L'x');
+  line.push_back(L'\n');
+
+  String doc;
+  doc.reserve(size);
+  while (doc.size() + line.size() <= size)
+    doc += line;
+
+  Clock::time_point t0 = Clock::now();
+  TextBuffer text(doc);
+  Clock::time_point t1 = Clock::now();
+
+  const int n = 10000;
+  std::srand(3);
+  for (int i=0; i<n; ++i) {
+    std::size_t pos = doc.size()/2 + std::rand() % 100000;
+    if (i % 2 == 0)
+      text.insert(pos, L'a');
+    else
+      text.erase(pos, 1);
+  }
+  Clock::time_point t2 = Clock::now();
+
+  // as many inserts as erases
+  EXPECT_EQ(doc.size(), text.size());
+
+  const int m = 20;
+  for (int i=0; i<m; ++i) {
+    std::size_t pos = doc.size()/2 + std::rand() % 100000;
+    if (i % 2 == 0)
+      doc.insert(pos, 1, L'a');
+    else
+      doc.erase(pos, 1);
+  }
+  Clock::time_point t3 = Clock::now();
+
+  double textEdit = std::chrono::duration<double, std::milli>(t2 - t1).count() / n;
+  double stringEdit = std::chrono::duration<double, std::milli>(t3 - t2).count() / m;
+  EXPECT_LT(textEdit, 1.0);
+
+  std::printf("100 MB document: load = %.1f ms, TextBuffer edit = %.4f ms, String edit = %.4f ms\n",
+	      std::chrono::duration<double, std::milli>(t1 - t0).count(),
+	      textEdit, stringEdit);
+}
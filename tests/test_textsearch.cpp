@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+
+#include "vaca/TextSearch.h"
+
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace vaca;
+
+template<class T>
+static bool is_word(T chr)
+{
+  return std::isalnum(chr) || chr == '_';
+}
+
+// Naive search to compare the results
+template<class T>
+static bool naive_match(const std::basic_string<T>& text, const std::basic_string<T>& needle,
+			std::size_t pos, bool matchCase, bool wholeWord)
+{
+  for (std::size_t i=0; i<needle.size(); ++i) {
+    T a = text[pos+i], b = needle[i];
+    if (!matchCase) {
+      if (a >= 'A' && a <= 'Z') a += 32;
+      if (b >= 'A' && b <= 'Z') b += 32;
+    }
+    if (a != b)
+      return false;
+  }
+  if (wholeWord) {
+    if (pos > 0 && is_word(text[pos-1]) && is_word(text[pos]))
+      return false;
+    std::size_t end = pos+needle.size();
+    if (end < text.size() && is_word(text[end]) && is_word(text[end-1]))
+      return false;
+  }
+  return true;
+}
+
+template<class T>
+static void compare_with_naive(const std::basic_string<T>& text, const std::basic_string<T>& needle,
+			       bool matchCase, bool wholeWord)
+{
+  BasicTextSearch<T> search(needle, matchCase, wholeWord);
+
+  std::vector<std::size_t> expected;
+  for (std::size_t pos=0; pos+needle.size() <= text.size(); ++pos)
+    if (naive_match(text, needle, pos, matchCase, wholeWord))
+      expected.push_back(pos);
+
+  for (std::size_t from=0; from<=text.size(); from += 7) {
+    std::size_t next = BasicTextSearch<T>::npos;
+    std::size_t prev = BasicTextSearch<T>::npos;
+    for (std::size_t i=0; i<expected.size(); ++i) {
+      if (expected[i] >= from && next == BasicTextSearch<T>::npos)
+	next = expected[i];
+      if (expected[i] < from)
+	prev = expected[i];
+    }
+    ASSERT_EQ(next, search.findNext(text, from));
+    ASSERT_EQ(prev, search.findPrev(text, from));
+  }
+
+  std::vector<std::size_t> all, nonOverlapping;
+  search.findAll(text, all);
+  for (std::size_t i=0; i<expected.size(); ++i)
+    if (nonOverlapping.empty() || expected[i] >= nonOverlapping.back()+needle.size())
+      nonOverlapping.push_back(expected[i]);
+  ASSERT_TRUE(all == nonOverlapping);
+}
+
+template<class T>
+static void random_searches()
+{
+  std::srand(7);
+  const char alphabet[] = "abAB _";
+
+  for (int i=0; i<300; ++i) {
+    std::basic_string<T> text(std::rand() % 200, T());
+    for (std::size_t j=0; j<text.size(); ++j)
+      text[j] = alphabet[std::rand() % 6];
+
+    // short needles (SIMD filter) and long ones (Horspool)
+    std::basic_string<T> needle(i % 3 == 0 ? 32 + std::rand() % 4: 1 + std::rand() % 4, T());
+    for (std::size_t j=0; j<needle.size(); ++j)
+      needle[j] = alphabet[std::rand() % (i % 3 == 0 ? 2: 6)];
+
+    compare_with_naive(text, needle, true, false);
+    compare_with_naive(text, needle, false, false);
+    compare_with_naive(text, needle, true, true);
+    compare_with_naive(text, needle, false, true);
+  }
+}
+
+TEST(TextSearch, Basic)
+{
+  TextSearch search(L"vaca");
+  String text = L"Vaca is vaca, vacavaca";
+  EXPECT_EQ(8u, search.findNext(text));
+  EXPECT_EQ(14u, search.findNext(text, 9));
+  EXPECT_EQ(TextSearch::npos, search.findNext(text, 19));
+  EXPECT_EQ(18u, search.findPrev(text, text.size()));
+  EXPECT_EQ(8u, search.findPrev(text, 14));
+  EXPECT_EQ(TextSearch::npos, search.findPrev(text, 8));
+
+  std::vector<std::size_t> all;
+  TextSearch(L"VACA", false).findAll(text, all);
+  ASSERT_EQ(4u, all.size());
+  EXPECT_EQ(0u, all[0]);
+  EXPECT_EQ(18u, all[3]);
+
+  all.clear();
+  TextSearch(L"vaca", false, true).findAll(text, all);
+  ASSERT_EQ(2u, all.size());
+  EXPECT_EQ(0u, all[0]);
+  EXPECT_EQ(8u, all[1]);
+
+  EXPECT_EQ(TextSearch::npos, TextSearch(L"").findNext(text));
+  EXPECT_EQ(TextSearch::npos, TextSearch(L"vacas").findNext(L"vaca"));
+}
+
+TEST(TextSearch, Latin1)
+{
+  // "ÁRBOL" and "árbol"
+  const Char upper[] = { 0xC1, L'R', L'B', L'O', L'L', 0 };
+  const Char lower[] = { 0xE1, L'r', L'b', L'o', L'l', 0 };
+  String text = String(L"el ") + lower;
+
+  EXPECT_EQ(3u, TextSearch(upper, false).findNext(text));
+  EXPECT_EQ(TextSearch::npos, TextSearch(upper, true).findNext(text));
+}
+
+TEST(TextSearch, Utf8)
+{
+  // "año" in UTF-8, a multibyte character is compared byte by byte
+  std::string text = "El a\xC3\xB1o, el A\xC3\xB1O";
+  Utf8TextSearch search("a\xC3\xB1o", false);
+  std::vector<std::size_t> all;
+  search.findAll(text, all);
+  ASSERT_EQ(2u, all.size());
+  EXPECT_EQ(3u, all[0]);
+  EXPECT_EQ(12u, all[1]);
+
+  // non-ASCII characters are letters for whole words
+  EXPECT_EQ(Utf8TextSearch::npos, Utf8TextSearch("a", true, true).findNext("\xC3\xB1" "a"));
+}
+
+TEST(TextSearch, RandomUtf8)
+{
+  random_searches<char>();
+}
+
+TEST(TextSearch, RandomString)
+{
+  random_searches<Char>();
+}
+
+// Search in a text of 100 MB
+template<class T>
+static void benchmark(const char* name, const char* needleText, bool matchCase)
+{
+  typedef std::chrono::steady_clock Clock;
+  const std::size_t size = 100*1024*1024 / sizeof(T);
+  const char line[] = "The quick brown fox jumps over the lazy dog, searching for something.\n";
+
+  std::basic_string<T> text;
+  text.reserve(size);
+  while (text.size() + sizeof(line) <= size)
+    text.append(line, line + sizeof(line)-1);
+
+  std::basic_string<T> needle(needleText, needleText + std::strlen(needleText));
+  for (std::size_t i=0; i<10; ++i)
+    text.replace(text.size()/10*i + 5, needle.size(), needle);
+
+  Clock::time_point t0 = Clock::now();
+  std::vector<std::size_t> all;
+  BasicTextSearch<T>(needle, matchCase).findAll(text, all);
+  Clock::time_point t1 = Clock::now();
+
+  // std::basic_string::find (it cannot ignore the case)
+  std::size_t count = 0;
+  for (std::size_t pos = text.find(needle); pos != std::basic_string<T>::npos; pos = text.find(needle, pos+needle.size()))
+    ++count;
+  Clock::time_point t2 = Clock::now();
+
+  EXPECT_EQ(10u, all.size());
+  if (matchCase) {
+    EXPECT_EQ(count, all.size());
+  }
+
+  std::printf("%s, \"%s\"%s: TextSearch = %.1f ms, basic_string::find = %.1f ms\n",
+	      name, needleText, matchCase ? "": " (ignore case)",
+	      std::chrono::duration<double, std::milli>(t1 - t0).count(),
+	      std::chrono::duration<double, std::milli>(t2 - t1).count());
+}
+
+TEST(TextSearch, Benchmark)
+{
+  benchmark<char>("100 MB UTF-8", "Vaca", true);
+  benchmark<char>("100 MB UTF-8", "the lazy cat", true);
+  benchmark<char>("100 MB UTF-8", "the lazy cat", false);
+  benchmark<char>("100 MB UTF-8", "searching for something else", true);
+  benchmark<char>("100 MB UTF-8", "searching for something else", false);
+  benchmark<char>("100 MB UTF-8", "searching for something else that is not here", true);
+  benchmark<Char>("100 MB String", "the lazy cat", true);
+  benchmark<Char>("100 MB String", "searching for something else", false);
+}
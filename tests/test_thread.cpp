@@ -3,6 +3,7 @@
 
 #include "vaca/Thread.h"
 #include "vaca/Mutex.h"
+#include "vaca/QueuedSignal.h"
 #include "vaca/ScopedLock.h"
 
 using namespace std;
@@ -34,3 +35,47 @@ namespace test1 {
   }
 
 }
+
+namespace test2 {
+
+  QueuedSignal<void(int)> Progress;
+  ThreadId mainThread;
+  int calls = 0;
+  int total = 0;
+
+  void on_progress(int value)
+  {
+    EXPECT_EQ(mainThread, CurrentThread::getId());
+    ++calls;
+    total += value;
+  }
+
+  void emit_progress()
+  {
+    for (int c=1; c<=100; c++)
+      Progress(c);
+  }
+
+  TEST(QueuedSignal, CallsSlotsInTheirThread)
+  {
+    mainThread = CurrentThread::getId();
+    Connection conn = Progress.connect(&on_progress);
+
+    Thread thread(&emit_progress);
+    thread.join();
+
+    // nothing is called until the main thread pumps its queue
+    EXPECT_EQ(0, calls);
+    CurrentThread::pumpMessageQueue();
+    EXPECT_EQ(100, calls);
+    EXPECT_EQ(5050, total);
+
+    // pending calls to a disconnected slot are discarded
+    Thread thread2(&emit_progress);
+    thread2.join();
+    conn.disconnect();
+    CurrentThread::pumpMessageQueue();
+    EXPECT_EQ(100, calls);
+  }
+
+}
@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+
+#include "vaca/UrlEncoding.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <string>
+
+using namespace vaca;
+
+static std::string encode(const std::string& src, UrlEncoding encoding = UrlEncoding::Component)
+{
+  std::string res(3*src.size(), '\0');
+  res.resize(url_encode(src.data(), src.size(), &res[0], encoding));
+  return res;
+}
+
+static std::string decode(const std::string& src, bool plusAsSpace = false)
+{
+  std::string res(src.size(), '\0');
+  res.resize(url_decode(src.data(), src.size(), &res[0], plusAsSpace));
+  return res;
+}
+
+// Byte by byte, as a reference for the tables and SIMD blocks
+static std::string naive_encode(const std::string& src, UrlEncoding encoding)
+{
+  const char* keep = (encoding == UrlEncoding::Component ? "-._~": "-._~!#$%&'()*+,/:;=?@[]");
+  std::string res;
+  for (std::size_t i=0; i<src.size(); ++i) {
+    unsigned char chr = src[i];
+    if ((chr >= '0' && chr <= '9') || (chr >= 'A' && chr <= 'Z') ||
+	(chr >= 'a' && chr <= 'z') || (chr != 0 && std::strchr(keep, chr)))
+      res += chr;
+    else {
+      char buf[4];
+      std::sprintf(buf, "%%%02X", chr);
+      res += buf;
+    }
+  }
+  return res;
+}
+
+static std::string random_text(std::size_t size)
+{
+  // mostly letters, with some bytes to encode
+  std::string res(size, 'a');
+  for (std::size_t i=0; i<size; ++i) {
+    int r = std::rand() % 10;
+    res[i] = (r < 6 ? 'a' + std::rand() % 26:
+	      r < 8 ? " /%+=&~"[std::rand() % 7]:
+		      static_cast<char>(std::rand() % 256));
+  }
+  return res;
+}
+
+TEST(UrlEncoding, Encode)
+{
+  EXPECT_EQ("", encode(""));
+  EXPECT_EQ("abc-XYZ_0.9~", encode("abc-XYZ_0.9~"));
+  EXPECT_EQ("a%20b%26c%3Dd%2Fe%25", encode("a b&c=d/e%"));
+  EXPECT_EQ("a%C3%B1o%00", encode(std::string("a\xC3\xB1o\0", 5)));
+
+  // the escapes are not encoded again
+  EXPECT_EQ("http://host/a%20b?c=d&e=%7Bf%7D#g%25",
+	    encode("http://host/a b?c=d&e={f}#g%25", UrlEncoding::Url));
+}
+
+TEST(UrlEncoding, Decode)
+{
+  EXPECT_EQ("", decode(""));
+  EXPECT_EQ("a b&c=d/e", decode("a%20b%26c%3dd%2Fe"));
+  EXPECT_EQ("a+b", decode("a+b"));
+  EXPECT_EQ("a b c", decode("a+b%20c", true));
+
+  // invalid escapes are not decoded
+  EXPECT_EQ("100%", decode("100%"));
+  EXPECT_EQ("%4", decode("%4"));
+  EXPECT_EQ("%G1%A", decode("%G1%25A"));
+  EXPECT_EQ("%A", decode("%%41"));
+}
+
+TEST(UrlEncoding, Random)
+{
+  std::srand(11);
+  for (int i=0; i<2000; ++i) {
+    std::string text = random_text(std::rand() % 100);
+    std::string component = encode(text);
+    std::string url = encode(text, UrlEncoding::Url);
+
+    ASSERT_EQ(naive_encode(text, UrlEncoding::Component), component);
+    ASSERT_EQ(naive_encode(text, UrlEncoding::Url), url);
+    ASSERT_EQ(text, decode(component));
+  }
+}
+
+TEST(UrlEncoding, Parts)
+{
+  std::srand(13);
+  for (int i=0; i<500; ++i) {
+    std::string encoded = encode(random_text(std::rand() % 200));
+    if (i % 2 == 0)
+      encoded += "%%4%G%2";	// invalid escapes in the middle of the parts
+    encoded += encode(random_text(std::rand() % 50)) + (i % 3 == 0 ? "%": "");
+
+    // decode in parts of random sizes
+    UrlDecoder decoder;
+    std::string res;
+    char out[64+2];
+    for (std::size_t pos=0; pos<encoded.size(); ) {
+      std::size_t n = std::min<std::size_t>(std::rand() % 5 == 0 ? 1: std::rand() % 64,
+					    encoded.size() - pos);
+      res.append(out, decoder.decode(encoded.data()+pos, n, out));
+      pos += n;
+    }
+    res.append(out, decoder.finish(out));
+
+    ASSERT_EQ(decode(encoded), res);
+  }
+}
+
+// An incomplete escape at the end with '+' decoded as a space
+TEST(UrlEncoding, PartsPlusAsSpace)
+{
+  const char* tests[] = { "a+b%", "a%+", "%+", "+%4", "%2+", "a%+%+", "%" };
+
+  for (std::size_t i=0; i<sizeof(tests)/sizeof(tests[0]); ++i) {
+    std::string encoded = tests[i];
+    std::string expected = decode(encoded, true);
+
+    for (std::size_t split=0; split<=encoded.size(); ++split) {
+      UrlDecoder decoder(true);
+      std::string res;
+      char out[16+2];
+      res.append(out, decoder.decode(encoded.data(), split, out));
+      res.append(out, decoder.decode(encoded.data()+split, encoded.size()-split, out));
+      res.append(out, decoder.finish(out));
+      EXPECT_EQ(expected, res) << encoded << " split at " << split;
+    }
+
+    std::string decoded;
+    url_decode(encoded.begin(), encoded.end(), std::back_inserter(decoded), true);
+    EXPECT_EQ(expected, decoded) << encoded;
+  }
+
+  EXPECT_EQ("a% ", decode("a%+", true));
+}
+
+TEST(UrlEncoding, Iterators)
+{
+  std::string text = "name=Jos\xC3\xA9 & co.";
+  std::string encoded;
+  url_encode(text.begin(), text.end(), std::back_inserter(encoded));
+  EXPECT_EQ("name%3DJos%C3%A9%20%26%20co.", encoded);
+
+  std::string decoded;
+  url_decode(encoded.begin(), encoded.end(), std::back_inserter(decoded));
+  EXPECT_EQ(text, decoded);
+
+  // more than one block of the iterator functions
+  std::string big = random_text(10000);
+  encoded.clear();
+  url_encode(big.begin(), big.end(), std::back_inserter(encoded));
+  EXPECT_EQ(encode(big), encoded);
+}
+
+// Throughput with a big query string
+static void benchmark(const char* name, const std::string& query)
+{
+  typedef std::chrono::steady_clock Clock;
+  std::string encoded(3*query.size(), '\0');
+  std::string decoded(3*query.size(), '\0');
+
+  Clock::time_point t0 = Clock::now();
+  encoded.resize(url_encode(query.data(), query.size(), &encoded[0]));
+  Clock::time_point t1 = Clock::now();
+  decoded.resize(url_decode(encoded.data(), encoded.size(), &decoded[0]));
+  Clock::time_point t2 = Clock::now();
+
+  // one character at a time, formatting each escape
+  std::string naive = naive_encode(query, UrlEncoding::Component);
+  Clock::time_point t3 = Clock::now();
+
+  EXPECT_EQ(naive, encoded);
+  EXPECT_EQ(query, decoded);
+
+  double mb = query.size() / 1048576.0;
+  std::printf("%.0f MB query (%s): url_encode = %.0f MB/s, url_decode = %.0f MB/s, byte by byte = %.0f MB/s\n",
+	      mb, name,
+	      mb / std::chrono::duration<double>(t1 - t0).count(),
+	      mb / std::chrono::duration<double>(t2 - t1).count(),
+	      mb / std::chrono::duration<double>(t3 - t2).count());
+}
+
+TEST(UrlEncoding, Benchmark)
+{
+  const std::size_t size = 64*1024*1024;
+  const char digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+  // values of the filters of a grid (short runs)
+  std::string query;
+  for (int i=0; query.size() < size; ++i) {
+    char buf[128];
+    std::sprintf(buf, "column%d=customer_name_%d&filter%d=contains value %d/%d&", i, i*7, i, i, i % 13);
+    query += buf;
+  }
+  benchmark("filters", query);
+
+  // long tokens (long runs of unreserved characters)
+  query.clear();
+  for (int i=0; query.size() < size; ++i) {
+    char buf[32];
+    std::sprintf(buf, "token%d=", i);
+    query += buf;
+    for (int j=0; j<200; ++j)
+      query += digits[(i*31 + j*7) % 64];
+    query += '&';
+  }
+  benchmark("tokens", query);
+}
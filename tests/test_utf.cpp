@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "vaca/Utf.h"
+#include "vaca/String.h"
+
+using namespace vaca;
+
+typedef std::u16string U16;
+typedef std::u32string U32;
+
+static std::string utf16_to_8(const U16& s, bool replace = false)
+{
+  std::string res(s.size()*3, '\0');
+  std::size_t n = utf16_to_utf8(s.data(), s.size(), &res[0], replace);
+  if (n == utf_error)
+    return "<error>";
+  res.resize(n);
+  return res;
+}
+
+static U16 utf8_to_16(const std::string& s, bool replace = false)
+{
+  U16 res(s.size(), 0);
+  std::size_t n = utf8_to_utf16(s.data(), s.size(), &res[0], replace);
+  if (n == utf_error)
+    return u"<error>";
+  res.resize(n);
+  return res;
+}
+
+static U32 utf8_to_32(const std::string& s, bool replace = false)
+{
+  U32 res(s.size(), 0);
+  std::size_t n = utf8_to_utf32(s.data(), s.size(), &res[0], replace);
+  if (n == utf_error)
+    return U"<error>";
+  res.resize(n);
+  return res;
+}
+
+static std::string utf32_to_8(const U32& s, bool replace = false)
+{
+  std::string res(s.size()*4, '\0');
+  std::size_t n = utf32_to_utf8(s.data(), s.size(), &res[0], replace);
+  if (n == utf_error)
+    return "<error>";
+  res.resize(n);
+  return res;
+}
+
+TEST(Utf, Encodings)
+{
+  // "a", "ñ", "€", "𝄞" (U+1D11E)
+  std::string utf8 = "a\xC3\xB1\xE2\x82\xAC\xF0\x9D\x84\x9E";
+  U16 utf16 = u"añ€\U0001D11E";
+  U32 utf32 = U"añ€\U0001D11E";
+
+  EXPECT_TRUE(utf16 == utf8_to_16(utf8));
+  EXPECT_TRUE(utf32 == utf8_to_32(utf8));
+  EXPECT_EQ(utf8, utf16_to_8(utf16));
+  EXPECT_EQ(utf8, utf32_to_8(utf32));
+
+  EXPECT_EQ(utf16.size(), utf16_length_from_utf8(utf8.data(), utf8.size()));
+  EXPECT_EQ(utf32.size(), utf32_length_from_utf8(utf8.data(), utf8.size()));
+  EXPECT_EQ(utf8.size(), utf8_length_from_utf16(utf16.data(), utf16.size()));
+  EXPECT_EQ(utf8.size(), utf8_length_from_utf32(utf32.data(), utf32.size()));
+  EXPECT_TRUE(is_valid_utf8(utf8.data(), utf8.size()));
+}
+
+TEST(Utf, InvalidUtf8)
+{
+  const char* invalid[] = {
+    "\x80",			// continuation byte
+    "\xC0\xAF",			// overlong "/"
+    "\xE0\x80\xAF",		// overlong "/"
+    "\xED\xA0\x80",		// surrogate U+D800
+    "\xF4\x90\x80\x80",		// U+110000
+    "\xF8\x88\x80\x80\x80",	// 5 bytes
+    "\xE2\x82",			// truncated
+    "abc\xFF",
+  };
+  for (std::size_t i=0; i<sizeof(invalid)/sizeof(invalid[0]); ++i) {
+    std::string s = invalid[i];
+    EXPECT_FALSE(is_valid_utf8(s.data(), s.size())) << i;
+    EXPECT_TRUE(u"<error>" == utf8_to_16(s)) << i;
+    EXPECT_TRUE(U"<error>" == utf8_to_32(s)) << i;
+  }
+
+  // maximal subparts are replaced with one U+FFFD
+  EXPECT_TRUE(u"a�b" == utf8_to_16("a\xE2\x82" "b", true));
+  EXPECT_TRUE(u"���" == utf8_to_16("\xED\xA0\x80", true));
+  EXPECT_TRUE(U"��x" == utf8_to_32("\xC0\xAFx", true));
+}
+
+TEST(Utf, InvalidUtf16And32)
+{
+  U16 lone_high(1, 0xD800);
+  U16 lone_low(1, 0xDC00);
+  U16 reversed = U16(1, 0xDC00) + U16(1, 0xD800);
+
+  EXPECT_EQ("<error>", utf16_to_8(lone_high));
+  EXPECT_EQ("<error>", utf16_to_8(lone_low));
+  EXPECT_EQ("<error>", utf16_to_8(reversed));
+  EXPECT_EQ("\xEF\xBF\xBD" "a", utf16_to_8(lone_high + u"a", true));
+
+  EXPECT_EQ("<error>", utf32_to_8(U32(1, 0x110000)));
+  EXPECT_EQ("<error>", utf32_to_8(U32(1, 0xDFFF)));
+  EXPECT_EQ("\xEF\xBF\xBD", utf32_to_8(U32(1, 0x110000), true));
+}
+
+// Reference implementation: one code point at a time
+static U32 decode_reference(const std::string& s)
+{
+  U32 res;
+  for (std::size_t i=0; i<s.size(); ) {
+    unsigned char c = s[i];
+    int n = (c < 0x80 ? 1: c < 0xE0 ? 2: c < 0xF0 ? 3: 4);
+    char32_t cp = (n == 1 ? c: c & (0x7F >> n));
+    for (int k=1; k<n; ++k)
+      cp = (cp << 6) | (s[i+k] & 0x3F);
+    res.push_back(cp);
+    i += n;
+  }
+  return res;
+}
+
+static std::string random_text(std::size_t len, int nonAsciiPercent, unsigned seed)
+{
+  static const char32_t samples[] = { 0xE9, 0x3B1, 0x20AC, 0x4E2D, 0x1F600, 0x10FFFF };
+  std::srand(seed);
+  U32 text;
+  for (std::size_t i=0; i<len; ++i) {
+    if (std::rand() % 100 < nonAsciiPercent)
+      text.push_back(samples[std::rand() % 6]);
+    else
+      text.push_back(32 + std::rand() % 95);
+  }
+  return utf32_to_8(text);
+}
+
+TEST(Utf, RandomRoundTrips)
+{
+  // different lengths and positions of non-ASCII characters to test
+  // the SIMD blocks and the tails
+  for (unsigned seed=0; seed<200; ++seed) {
+    std::string utf8 = random_text(seed % 97, seed % 3 == 0 ? 0: (int)(seed % 20), seed);
+    U32 utf32 = decode_reference(utf8);
+    U16 utf16 = utf8_to_16(utf8);
+
+    EXPECT_TRUE(utf32 == utf8_to_32(utf8));
+    EXPECT_EQ(utf8, utf16_to_8(utf16));
+    EXPECT_EQ(utf8, utf32_to_8(utf32));
+    EXPECT_EQ(utf16.size(), utf16_length_from_utf8(utf8.data(), utf8.size()));
+    EXPECT_EQ(utf8.size(), utf8_length_from_utf16(utf16.data(), utf16.size()));
+  }
+}
+
+TEST(Utf, StringConversions)
+{
+  String str = L"Vaca ñandú €";
+  std::string utf8 = "Vaca \xC3\xB1" "and\xC3\xBA \xE2\x82\xAC";
+
+  EXPECT_EQ(utf8, to_utf8(str));
+  EXPECT_EQ(str, from_utf8(utf8));
+  EXPECT_EQ("", to_utf8(L""));
+  EXPECT_EQ(L"", from_utf8(""));
+  EXPECT_EQ(L"a�", from_utf8("a\xFF"));
+}
+
+// ======================================================================
+// Benchmarks
+
+// The conversion that was used before: one character at a time
+// through a temporary buffer
+static String from_utf8_naive(const std::string& s)
+{
+  std::vector<wchar_t> buf;
+  U32 cps = decode_reference(s);
+  for (std::size_t i=0; i<cps.size(); ++i)
+    buf.push_back((wchar_t)cps[i]);
+  return String(buf.begin(), buf.end());
+}
+
+static void benchmark(const char* name, const std::string& utf8)
+{
+  typedef std::chrono::steady_clock Clock;
+  const int n = 10;
+  std::size_t check = 0;
+
+  Clock::time_point t0 = Clock::now();
+  for (int i=0; i<n; ++i)
+    check += from_utf8_naive(utf8).size();
+  Clock::time_point t1 = Clock::now();
+  String str;
+  for (int i=0; i<n; ++i) {
+    str = from_utf8(utf8);
+    check += str.size();
+  }
+  Clock::time_point t2 = Clock::now();
+  for (int i=0; i<n; ++i)
+    check += to_utf8(str).size();
+  Clock::time_point t3 = Clock::now();
+
+  double mb = utf8.size() * n / 1e6;
+  std::printf("%-16s %6.1f MB: naive from_utf8 = %7.1f MB/s, from_utf8 = %7.1f MB/s, to_utf8 = %7.1f MB/s (%d)\n",
+	      name, utf8.size() / 1e6,
+	      mb / std::chrono::duration<double>(t1 - t0).count(),
+	      mb / std::chrono::duration<double>(t2 - t1).count(),
+	      mb / std::chrono::duration<double>(t3 - t2).count(),
+	      (int)(check & 1));
+}
+
+TEST(Utf, Benchmark)
+{
+  // a log file (ASCII) and a source file edited in Scintilla (with
+  // some non-ASCII characters in comments and strings)
+  benchmark("log", random_text(4*1024*1024, 0, 1));
+  benchmark("scintilla", random_text(4*1024*1024, 2, 2));
+  benchmark("cjk", random_text(1024*1024, 80, 3));
+}
@@ -7,6 +7,11 @@
 #ifndef VACA_BIND_H
 #define VACA_BIND_H
 
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
 namespace vaca {
 
 /**
@@ -15,600 +20,277 @@ namespace vaca {
  */
 
 // ======================================================================
-// BindAdapter0_fun
-
-/**
-   @see @ref page_bind
-*/
-template<typename R, typename F>
-class BindAdapter0_fun
-{
-  F f;
-public:
-  BindAdapter0_fun(const F& f) : f(f) { }
-
-  R operator()() { return f(); }
-
-  template<typename A1>
-  R operator()(const A1& a1) { return f(); }
-
-  template<typename A1, typename A2>
-  R operator()(const A1& a1, const A2& a2) { return f(); }
-
-  template<typename A1, typename A2, typename A3>
-  R operator()(const A1& a1, const A2& a2, const A3& a3) { return f(); }
-
-  template<typename A1, typename A2, typename A3, typename A4>
-  R operator()(const A1& a1, const A2& a2, const A3& a3, const A4& a4) { return f(); }
-};
-
-/**
-   @see @ref page_bind
-*/
-template<typename F>
-class BindAdapter0_fun<void, F>
-{
-  F f;
-public:
-  BindAdapter0_fun(const F& f) : f(f) { }
-
-  void operator()() { f(); }
-
-  template<typename A1>
-  void operator()(const A1& a1) { f(); }
-
-  template<typename A1, typename A2>
-  void operator()(const A1& a1, const A2& a2) { f(); }
-
-  template<typename A1, typename A2, typename A3>
-  void operator()(const A1& a1, const A2& a2, const A3& a3) { f(); }
-
-  template<typename A1, typename A2, typename A3, typename A4>
-  void operator()(const A1& a1, const A2& a2, const A3& a3, const A4& a4) { f(); }
-};
-
-/**
-   @see @ref page_bind
-*/
-template<typename R, typename F>
-BindAdapter0_fun<R, F>
-Bind(const F& f)
-{
-  return BindAdapter0_fun<R, F>(f);
-}
-
-// ======================================================================
-// BindAdapter0_mem
-
-/**
-   @see @ref page_bind
-*/
-template<typename R, typename T>
-class BindAdapter0_mem
-{
-  R (T::*m)();
-  T* t;
-public:
-  template<typename T2>
-  BindAdapter0_mem(R (T::*m)(), T2* t) : m(m), t(t) { }
-
-  R operator()() { return (t->*m)(); }
-
-  template <typename A1>
-  R operator()(const A1& a1) { return (t->*m)(); }
-
-  template <typename A1, typename A2>
-  R operator()(const A1& a1, const A2& a2) { return (t->*m)(); }
-
-  template <typename A1, typename A2, typename A3>
-  R operator()(const A1& a1, const A2& a2, const A3& a3) { return (t->*m)(); }
-
-  template <typename A1, typename A2, typename A3, typename A4>
-  R operator()(const A1& a1, const A2& a2, const A3& a3, const A4& a4) { return (t->*m)(); }
-};
-
-/**
-   @see @ref page_bind
-*/
-template<typename T>
-class BindAdapter0_mem<void, T>
-{
-  void (T::*m)();
-  T* t;
-public:
-  template<typename T2>
-  BindAdapter0_mem(void (T::*m)(), T2* t) : m(m), t(t) { }
-
-  void operator()() { (t->*m)(); }
-
-  template <typename A1>
-  void operator()(const A1& a1) { (t->*m)(); }
-
-  template <typename A1, typename A2>
-  void operator()(const A1& a1, const A2& a2) { (t->*m)(); }
-
-  template <typename A1, typename A2, typename A3>
-  void operator()(const A1& a1, const A2& a2, const A3& a3) { (t->*m)(); }
-
-  template <typename A1, typename A2, typename A3, typename A4>
-  void operator()(const A1& a1, const A2& a2, const A3& a3, const A4& a4) { (t->*m)(); }
-};
-
-/**
-   @see @ref page_bind
-*/
-template<typename R, typename T, typename T2>
-BindAdapter0_mem<R, T>
-Bind(R (T::*m)(), T2* t)
-{
-  return BindAdapter0_mem<R, T>(m, t);
-}
-
-// ======================================================================
-// BindAdapter1_fun
-
-/**
-   @see @ref page_bind
-*/
-template<typename R, typename F,
-	 typename X1>
-class BindAdapter1_fun
-{
-  F f;
-  X1 x1;
-public:
-  BindAdapter1_fun(const F& f, X1 x1) : f(f), x1(x1) { }
-
-  R operator()() { return f(x1); }
-
-  template<typename A1>
-  R operator()(const A1& a1) { return f(x1); }
-
-  template<typename A1, typename A2>
-  R operator()(const A1& a1, const A2& a2) { return f(x1); }
-
-  template<typename A1, typename A2, typename A3>
-  R operator()(const A1& a1, const A2& a2, const A3& a3) { return f(x1); }
-
-  template<typename A1, typename A2, typename A3, typename A4>
-  R operator()(const A1& a1, const A2& a2, const A3& a3, const A4& a4) { return f(x1); }
-};
-
-/**
-   @see @ref page_bind
-*/
-template<typename F,
-	 typename X1>
-class BindAdapter1_fun<void, F, X1>
-{
-  F f;
-  X1 x1;
-public:
-  BindAdapter1_fun(const F& f, X1 x1) : f(f), x1(x1) { }
-
-  void operator()() { f(x1); }
-
-  template<typename A1>
-  void operator()(A1& a1) { f(x1); }
-
-  template<typename A1, typename A2>
-  void operator()(A1& a1, A2& a2) { f(x1); }
-
-  template<typename A1, typename A2, typename A3>
-  void operator()(A1& a1, A2& a2, A3& a3) { f(x1); }
-
-  template<typename A1, typename A2, typename A3, typename A4>
-  void operator()(A1& a1, A2& a2, A3& a3, A4& a4) { f(x1); }
-};
+// RefWrapper
 
 /**
-   @see @ref page_bind
-*/
-template<typename R, typename F,
-	 typename X1>
-BindAdapter1_fun<R, F, X1>
-Bind(const F& f, X1 x1)
-{
-  return BindAdapter1_fun<R, F, X1>(f, x1);
-}
-
-// ======================================================================
-// BindAdapter1_mem
+   Holds a reference to an object so Bind does not copy it.
 
-/**
-   @see @ref page_bind
+   @see Ref, @ref page_bind
 */
-template<typename R, typename T,
-	 typename B1,
-	 typename X1>
-class BindAdapter1_mem
+template<class T>
+class RefWrapper
 {
-  R (T::*m)(B1);
-  T* t;
-  X1 x1;
+  T* ptr;
 public:
-  template<typename T2>
-  BindAdapter1_mem(R (T::*m)(B1), T2* t, X1 x1) : m(m), t(t), x1(x1) { }
-
-  R operator()() { return (t->*m)(x1); }
-
-  template <typename A1>
-  R operator()(const A1& a1) { return (t->*m)(x1); }
-
-  template <typename A1, typename A2>
-  R operator()(const A1& a1, const A2& a2) { return (t->*m)(x1); }
-
-  template <typename A1, typename A2, typename A3>
-  R operator()(const A1& a1, const A2& a2, const A3& a3) { return (t->*m)(x1); }
-
-  template <typename A1, typename A2, typename A3, typename A4>
-  R operator()(const A1& a1, const A2& a2, const A3& a3, const A4& a4) { return (t->*m)(x1); }
+  RefWrapper(T& ref) : ptr(&ref) { }
+  operator T&() const { return *ptr; }
+  T& get() const { return *ptr; }
 };
 
 /**
-   @see @ref page_bind
-*/
-template<typename T,
-	 typename B1,
-	 typename X1>
-class BindAdapter1_mem<void, T, B1, X1>
-{
-  void (T::*m)(B1);
-  T* t;
-  X1 x1;
-public:
-  template<typename T2>
-  BindAdapter1_mem(void (T::*m)(B1), T2* t, X1 x1) : m(m), t(t), x1(x1) { }
-
-  void operator()() { (t->*m)(x1); }
-
-  template <typename A1>
-  void operator()(const A1& a1) { (t->*m)(x1); }
-
-  template <typename A1, typename A2>
-  void operator()(const A1& a1, const A2& a2) { (t->*m)(x1); }
-
-  template <typename A1, typename A2, typename A3>
-  void operator()(const A1& a1, const A2& a2, const A3& a3) { (t->*m)(x1); }
-
-  template <typename A1, typename A2, typename A3, typename A4>
-  void operator()(const A1& a1, const A2& a2, const A3& a3, const A4& a4) { (t->*m)(x1); }
-};
+   Creates RefWrappers, useful to wrap arguments that have to be
+   passed as a reference when you use Bind.
 
-/**
    @see @ref page_bind
 */
-template<typename R, typename T, typename T2,
-	 typename B1, typename X1>
-BindAdapter1_mem<R, T, B1, X1>
-Bind(R (T::*m)(B1), T2* t, X1 x1)
+template<class T>
+RefWrapper<T> Ref(T& ref)
 {
-  return BindAdapter1_mem<R, T, B1, X1>(m, t, x1);
+  return RefWrapper<T>(ref);
 }
 
 // ======================================================================
-// BindAdapter2_fun
+// Placeholders
 
-/**
-   @see @ref page_bind
-*/
-template<typename R, typename F,
-	 typename X1, typename X2>
-class BindAdapter2_fun
-{
-  F f;
-  X1 x1;
-  X2 x2;
-public:
-  BindAdapter2_fun(const F& f, X1 x1, X2 x2) : f(f), x1(x1), x2(x2) { }
+namespace details {
 
-  R operator()() { return f(x1, x2); }
+  /**
+     Argument of Bind replaced with the N-th argument of the call.
 
-  template<typename A1>
-  R operator()(const A1& a1) { return f(x1, x2); }
+     @internal
+  */
+  template<int N>
+  struct Placeholder { };
 
-  template<typename A1, typename A2>
-  R operator()(const A1& a1, const A2& a2) { return f(x1, x2); }
-
-  template<typename A1, typename A2, typename A3>
-  R operator()(const A1& a1, const A2& a2, const A3& a3) { return f(x1, x2); }
-
-  template<typename A1, typename A2, typename A3, typename A4>
-  R operator()(const A1& a1, const A2& a2, const A3& a3, const A4& a4) { return f(x1, x2); }
-};
+} // namespace details
 
 /**
-   @see @ref page_bind
-*/
-template<typename F,
-	 typename X1, typename X2>
-class BindAdapter2_fun<void, F, X1, X2>
-{
-  F f;
-  X1 x1;
-  X2 x2;
-public:
-  BindAdapter2_fun(const F& f, X1 x1, X2 x2) : f(f), x1(x1), x2(x2) { }
-
-  void operator()() { f(x1, x2); }
-
-  template<typename A1>
-  void operator()(const A1& a1) { f(x1, x2); }
-
-  template<typename A1, typename A2>
-  void operator()(const A1& a1, const A2& a2) { f(x1, x2); }
+   Placeholders for Bind: @c _1 is replaced with the first argument
+   that the BindAdapter receives, @c _2 with the second one, etc.
 
-  template<typename A1, typename A2, typename A3>
-  void operator()(const A1& a1, const A2& a2, const A3& a3) { f(x1, x2); }
+   @code
+   using namespace vaca::placeholders;
+   Signal<void(int)> s;
+   s.connect(Bind(&MainFrame::onValue, this, _1, 10));
+   @endcode
 
-  template<typename A1, typename A2, typename A3, typename A4>
-  void operator()(const A1& a1, const A2& a2, const A3& a3, const A4& a4) { f(x1, x2); }
-};
-
-/**
    @see @ref page_bind
 */
-template<typename R, typename F,
-	 typename X1, typename X2>
-BindAdapter2_fun<R, F, X1, X2>
-Bind(const F& f, X1 x1, X2 x2)
-{
-  return BindAdapter2_fun<R, F, X1, X2>(f, x1, x2);
-}
+namespace placeholders {
+
+  const details::Placeholder<1> _1 = details::Placeholder<1>();
+  const details::Placeholder<2> _2 = details::Placeholder<2>();
+  const details::Placeholder<3> _3 = details::Placeholder<3>();
+  const details::Placeholder<4> _4 = details::Placeholder<4>();
+  const details::Placeholder<5> _5 = details::Placeholder<5>();
+  const details::Placeholder<6> _6 = details::Placeholder<6>();
+
+} // namespace placeholders
+
+namespace details {
+
+  template<std::size_t... I>
+  struct BindIndices { };
+
+  template<std::size_t N, std::size_t... I>
+  struct MakeBindIndices : MakeBindIndices<N-1, N-1, I...> { };
+
+  template<std::size_t... I>
+  struct MakeBindIndices<0, I...> { typedef BindIndices<I...> type; };
+
+  // Converts a bound argument to the argument of the function: a
+  // placeholder selects one of the call arguments, a RefWrapper is
+  // unwrapped, and any other value is passed as it is stored.
+  template<typename X>
+  struct BindArg
+  {
+    template<typename Y, typename Call>
+    static Y&& get(Y&& x, Call&) { return std::forward<Y>(x); }
+  };
+
+  template<int N>
+  struct BindArg<Placeholder<N> >
+  {
+    template<typename Y, typename Call>
+    static auto get(Y&&, Call& call) -> decltype(std::get<N-1>(std::move(call))) {
+      return std::get<N-1>(std::move(call));
+    }
+  };
+
+  template<typename T>
+  struct BindArg<RefWrapper<T> >
+  {
+    template<typename Y, typename Call>
+    static T& get(Y&& x, Call&) { return x.get(); }
+  };
+
+  // Calls a function object converting its result to R (or
+  // discarding it when R is void).
+  template<typename R>
+  struct BindCall
+  {
+    template<typename F, typename... A>
+    static R call(F& f, A&&... a) { return f(std::forward<A>(a)...); }
+  };
+
+  template<>
+  struct BindCall<void>
+  {
+    template<typename F, typename... A>
+    static void call(F& f, A&&... a) { f(std::forward<A>(a)...); }
+  };
+
+  // Holds the function object of a BindAdapter. Empty function
+  // objects are used as a base class, so they take no space.
+  template<typename F, bool = std::is_empty<F>::value>
+  class BindFunction
+  {
+    F m_f;
+  public:
+    template<typename G>
+    explicit BindFunction(G&& f) : m_f(std::forward<G>(f)) { }
+    F& function() { return m_f; }
+  };
+
+  template<typename F>
+  class BindFunction<F, true> : private F
+  {
+  public:
+    template<typename G>
+    explicit BindFunction(G&& f) : F(std::forward<G>(f)) { }
+    F& function() { return *this; }
+  };
+
+  // Pointer to a member function of the T class plus the instance
+  // where it has to be called.
+  template<typename M, typename T>
+  class BindMemFun
+  {
+    M m;
+    T* t;
+  public:
+    BindMemFun(M m, T* t) : m(m), t(t) { }
+
+    template<typename... A>
+    auto operator()(A&&... a) -> decltype((t->*m)(std::forward<A>(a)...)) {
+      return (t->*m)(std::forward<A>(a)...);
+    }
+  };
+
+} // namespace details
 
 // ======================================================================
-// BindAdapter2_mem
-
-/**
-   @see @ref page_bind
-*/
-template<typename R, typename T,
-	 typename B1, typename B2,
-	 typename X1, typename X2>
-class BindAdapter2_mem
-{
-  R (T::*m)(B1, B2);
-  T* t;
-  X1 x1;
-  X2 x2;
-public:
-  template<typename T2>
-  BindAdapter2_mem(R (T::*m)(B1, B2), T2* t, X1 x1, X2 x2) : m(m), t(t), x1(x1), x2(x2) { }
-
-  R operator()() { return (t->*m)(x1, x2); }
-
-  template<typename A1>
-  R operator()(const A1& a1) { return (t->*m)(x1, x2); }
-
-  template<typename A1, typename A2>
-  R operator()(const A1& a1, const A2& a2) { return (t->*m)(x1, x2); }
-
-  template<typename A1, typename A2, typename A3>
-  R operator()(const A1& a1, const A2& a2, const A3& a3) { return (t->*m)(x1, x2); }
-
-  template<typename A1, typename A2, typename A3, typename A4>
-  R operator()(const A1& a1, const A2& a2, const A3& a3, const A4& a4) { return (t->*m)(x1, x2); }
-};
+// BindAdapter
 
 /**
-   @see @ref page_bind
-*/
-template<typename T,
-	 typename B1, typename B2,
-	 typename X1, typename X2>
-class BindAdapter2_mem<void, T, B1, B2, X1, X2>
-{
-  void (T::*m)(B1, B2);
-  T* t;
-  X1 x1;
-  X2 x2;
-public:
-  template<typename T2>
-  BindAdapter2_mem(void (T::*m)(B1, B2), T2* t, X1 x1, X2 x2) : m(m), t(t), x1(x1), x2(x2) { }
-
-  void operator()() { (t->*m)(x1, x2); }
+   Function object created by Bind. It calls @a F with the bound
+   arguments @a X, and it can be called with any number of arguments:
+   they are ignored unless a bound argument is a placeholder (see
+   placeholders).
+
+   Bound arguments are stored by value (use Ref to store a reference)
+   and they are passed to @a F as lvalues, so a BindAdapter can be
+   called several times (e.g. each time a Signal is emitted). When an
+   rvalue BindAdapter is called the bound arguments are moved, so
+   move-only values (like a std::unique_ptr) can be passed by value to
+   @a F in a one-time call.
 
-  template<typename A1>
-  void operator()(const A1& a1) { (t->*m)(x1, x2); }
-
-  template<typename A1, typename A2>
-  void operator()(const A1& a1, const A2& a2) { (t->*m)(x1, x2); }
-
-  template<typename A1, typename A2, typename A3>
-  void operator()(const A1& a1, const A2& a2, const A3& a3) { (t->*m)(x1, x2); }
-
-  template<typename A1, typename A2, typename A3, typename A4>
-  void operator()(const A1& a1, const A2& a2, const A3& a3, const A4& a4) { (t->*m)(x1, x2); }
-};
-
-/**
    @see @ref page_bind
 */
-template<typename R, typename T, typename T2, typename B1, typename B2, typename X1, typename X2>
-BindAdapter2_mem<R, T, B1, B2, X1, X2>
-Bind(R (T::*m)(B1, B2), T2* t, X1 x1, X2 x2)
+template<typename R, typename F, typename... X>
+class BindAdapter : private details::BindFunction<F>
+		  , private std::tuple<X...> // base class: empty tuples take no space
 {
-  return BindAdapter2_mem<R, T, B1, B2, X1, X2>(m, t, x1, x2);
-}
+  typedef details::BindFunction<F> Function;
+  typedef std::tuple<X...> Args;
+  typedef typename details::MakeBindIndices<sizeof...(X)>::type Indices;
 
-// ======================================================================
-// BindAdapter3_fun
-
-/**
-   @see @ref page_bind
-*/
-template<typename R, typename F,
-	 typename X1, typename X2, typename X3>
-class BindAdapter3_fun
-{
-  F f;
-  X1 x1;
-  X2 x2;
-  X3 x3;
 public:
-  BindAdapter3_fun(const F& f, X1 x1, X2 x2, X3 x3) : f(f), x1(x1), x2(x2), x3(x3) { }
-
-  R operator()() { return f(x1, x2, x3); }
+  typedef R ReturnType;
+
+  template<typename G, typename... Y>
+  explicit BindAdapter(G&& f, Y&&... args)
+    : Function(std::forward<G>(f))
+    , Args(std::forward<Y>(args)...) { }
+
+  template<typename... A>
+  R operator()(A&&... a) & {
+    std::tuple<A&&...> call(std::forward<A>(a)...);
+    return invoke(call, Indices());
+  }
+
+  template<typename... A>
+  R operator()(A&&... a) && {
+    std::tuple<A&&...> call(std::forward<A>(a)...);
+    return invokeMove(call, Indices());
+  }
+
+private:
+
+  template<typename Call, std::size_t... I>
+  R invoke(Call& call, details::BindIndices<I...>) {
+    return details::BindCall<R>::call
+      (Function::function(),
+       details::BindArg<X>::get(std::get<I>(static_cast<Args&>(*this)), call)...);
+  }
+
+  template<typename Call, std::size_t... I>
+  R invokeMove(Call& call, details::BindIndices<I...>) {
+    return details::BindCall<R>::call
+      (Function::function(),
+       details::BindArg<X>::get(std::get<I>(static_cast<Args&&>(*this)), call)...);
+  }
 
-  template<typename A1>
-  R operator()(const A1& a1) { return f(x1, x2, x3); }
-
-  template<typename A1, typename A2>
-  R operator()(const A1& a1, const A2& a2) { return f(x1, x2, x3); }
-
-  template<typename A1, typename A2, typename A3>
-  R operator()(const A1& a1, const A2& a2, const A3& a3) { return f(x1, x2, x3); }
-
-  template<typename A1, typename A2, typename A3, typename A4>
-  R operator()(const A1& a1, const A2& a2, const A3& a3, const A4& a4) { return f(x1, x2, x3); }
 };
 
 /**
-   @see @ref page_bind
-*/
-template<typename F,
-	 typename X1, typename X2, typename X3>
-class BindAdapter3_fun<void, F, X1, X2, X3>
-{
-  F f;
-  X1 x1;
-  X2 x2;
-  X3 x3;
-public:
-  BindAdapter3_fun(const F& f, X1 x1, X2 x2, X3 x3) : f(f), x1(x1), x2(x2), x3(x3) { }
-
-  void operator()() { f(x1, x2, x3); }
+   Binds the function object (or function pointer) @a f with the
+   arguments @a args. The result type @a R must be specified.
 
-  template<typename A1>
-  void operator()(const A1& a1) { f(x1, x2, x3); }
+   @code
+   Bind<void>(&func, 1, 2)
+   @endcode
 
-  template<typename A1, typename A2>
-  void operator()(const A1& a1, const A2& a2) { f(x1, x2, x3); }
-
-  template<typename A1, typename A2, typename A3>
-  void operator()(const A1& a1, const A2& a2, const A3& a3) { f(x1, x2, x3); }
-
-  template<typename A1, typename A2, typename A3, typename A4>
-  void operator()(const A1& a1, const A2& a2, const A3& a3, const A4& a4) { f(x1, x2, x3); }
-};
-
-/**
    @see @ref page_bind
 */
-template<typename R, typename F,
-	 typename X1, typename X2, typename X3>
-BindAdapter3_fun<R, F, X1, X2, X3>
-Bind(const F& f, X1 x1, X2 x2, X3 x3)
+template<typename R, typename F, typename... X>
+BindAdapter<R, typename std::decay<F>::type, typename std::decay<X>::type...>
+Bind(F&& f, X&&... args)
 {
-  return BindAdapter3_fun<R, F, X1, X2, X3>(f, x1, x2, x3);
+  return BindAdapter<R, typename std::decay<F>::type, typename std::decay<X>::type...>
+    (std::forward<F>(f), std::forward<X>(args)...);
 }
 
-// ======================================================================
-// BindAdapter3_mem
-
 /**
-   @see @ref page_bind
-*/
-template<typename R, typename T,
-	 typename B1, typename B2, typename B3,
-	   typename X1, typename X2, typename X3>
-class BindAdapter3_mem
-{
-  R (T::*m)(B1, B2, B3);
-  T* t;
-  X1 x1;
-  X2 x2;
-  X3 x3;
-public:
-  template<typename T2>
-  BindAdapter3_mem(R (T::*m)(B1, B2, B3), T2* t, X1 x1, X2 x2, X3 x3) : m(m), t(t), x1(x1), x2(x2), x3(x3) { }
-
-  R operator()() { return (t->*m)(x1, x2, x3); }
-
-  template<typename A1>
-  R operator()(const A1& a1) { return (t->*m)(x1, x2, x3); }
-
-  template<typename A1, typename A2>
-  R operator()(const A1& a1, const A2& a2) { return (t->*m)(x1, x2, x3); }
-
-  template<typename A1, typename A2, typename A3>
-  R operator()(const A1& a1, const A2& a2, const A3& a3) { return (t->*m)(x1, x2, x3); }
-
-  template<typename A1, typename A2, typename A3, typename A4>
-  R operator()(const A1& a1, const A2& a2, const A3& a3, const A4& a4) { return (t->*m)(x1, x2, x3); }
-};
-
-/**
-   @see @ref page_bind
-*/
-template<typename T,
-	 typename B1, typename B2, typename B3,
-	 typename X1, typename X2, typename X3>
-class BindAdapter3_mem<void, T, B1, B2, B3, X1, X2, X3>
-{
-  void (T::*m)(B1, B2, B3);
-  T* t;
-  X1 x1;
-  X2 x2;
-  X3 x3;
-public:
-  template<typename T2>
-  BindAdapter3_mem(void (T::*m)(B1, B2, B3), T2* t, X1 x1, X2 x2) : m(m), t(t), x1(x1), x2(x2) { }
-
-  void operator()() { (t->*m)(x1, x2, x3); }
-
-  template<typename A1>
-  void operator()(const A1& a1) { (t->*m)(x1, x2, x3); }
+   Binds the member function @a m of the instance @a t with the
+   arguments @a args.
 
-  template<typename A1, typename A2>
-  void operator()(const A1& a1, const A2& a2) { (t->*m)(x1, x2, x3); }
+   @code
+   Bind(&MainFrame::onCreateThread, this)
+   @endcode
 
-  template<typename A1, typename A2, typename A3>
-  void operator()(const A1& a1, const A2& a2, const A3& a3) { (t->*m)(x1, x2, x3); }
-
-  template<typename A1, typename A2, typename A3, typename A4>
-  void operator()(const A1& a1, const A2& a2, const A3& a3, const A4& a4) { (t->*m)(x1, x2, x3); }
-};
-
-/**
    @see @ref page_bind
 */
-template<typename R, typename T, typename T2,
-	 typename B1, typename B2, typename B3,
-	 typename X1, typename X2, typename X3>
-BindAdapter3_mem<R, T, B1, B2, B3, X1, X2, X3>
-Bind(R (T::*m)(B1, B2, B3), T2* t, X1 x1, X2 x2)
+template<typename R, typename T, typename T2, typename... B, typename... X>
+BindAdapter<R, details::BindMemFun<R (T::*)(B...), T>, typename std::decay<X>::type...>
+Bind(R (T::*m)(B...), T2* t, X&&... args)
 {
-  return BindAdapter3_mem<R, T, B1, B2, B3, X1, X2, X3>(m, t, x1, x2);
+  return BindAdapter<R, details::BindMemFun<R (T::*)(B...), T>, typename std::decay<X>::type...>
+    (details::BindMemFun<R (T::*)(B...), T>(m, t), std::forward<X>(args)...);
 }
 
-// ======================================================================
-// RefWrapper
-
 /**
-   @todo
+   Binds the const member function @a m of the instance @a t with the
+   arguments @a args.
 
    @see @ref page_bind
 */
-template<class T>
-class RefWrapper
+template<typename R, typename T, typename T2, typename... B, typename... X>
+BindAdapter<R, details::BindMemFun<R (T::*)(B...) const, const T>, typename std::decay<X>::type...>
+Bind(R (T::*m)(B...) const, const T2* t, X&&... args)
 {
-  T* ptr;
-public:
-  RefWrapper(T& ref) : ptr(&ref) { }
-  operator T&() const { return *ptr; }
-};
-
-/**
-   Creates RefWrappers, useful to wrap arguments that have to be
-   passed as a reference when you use Bind.
-
-   @see @ref page_bind
-*/
-template<class T>
-RefWrapper<T> Ref(T& ref)
-{
-  return RefWrapper<T>(ref);
+  return BindAdapter<R, details::BindMemFun<R (T::*)(B...) const, const T>, typename std::decay<X>::type...>
+    (details::BindMemFun<R (T::*)(B...) const, const T>(m, t), std::forward<X>(args)...);
 }
 
 /** @} */
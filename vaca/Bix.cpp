@@ -5,6 +5,7 @@
 // please read LICENSE.txt for more information.
 
 #include "vaca/Bix.h"
+#include "vaca/FrameArena.h"
 #include "vaca/Point.h"
 #include "vaca/ParseException.h"
 #include "vaca/Widget.h"
@@ -70,9 +71,13 @@ struct Bix::WidgetElement : public Bix::Element
 
 /**
    @internal Internal matrix to arrange elements
+
+   Its arrays are allocated in the FrameArena of the thread, they are
+   given back when the matrix is destroyed.
 */
 struct Bix::Matrix
 {
+  FrameArena::Scope scope;
   int cols, rows;
   Element*** elem; // matrix of pointers "typeof(elem[y][x]) = Element *"
   Size** size;
@@ -80,38 +85,38 @@ struct Bix::Matrix
   bool* row_fill;
 
   Matrix(int c, int r) {
+    FrameArena& arena = FrameArena::getCurrent();
     cols = c;
     rows = r;
 
-    elem = new Element**[rows];
-    size = new Size*[rows];
+    elem = allocArray<Element**>(arena, rows);
+    size = allocArray<Size*>(arena, rows);
     for (int y=0; y<rows; ++y) {
-      elem[y] = new Element*[cols];
-      size[y] = new Size[cols];
-      for (int x=0; x<cols; ++x)
+      elem[y] = allocArray<Element*>(arena, cols);
+      size[y] = allocArray<Size>(arena, cols);
+      for (int x=0; x<cols; ++x) {
 	elem[y][x] = NULL;
+	new (&size[y][x]) Size();
+      }
     }
 
-    col_fill = new bool[cols];
+    col_fill = allocArray<bool>(arena, cols);
     for (int x=0; x<cols; ++x)
       col_fill[x] = false;
 
-    row_fill = new bool[rows];
+    row_fill = allocArray<bool>(arena, rows);
     for (int y=0; y<rows; ++y)
       row_fill[y] = false;
 
   }
 
   virtual ~Matrix() {
-    for (int y=0; y<rows; ++y) {
-      delete[] elem[y];
-      delete[] size[y];
-    }
-    delete[] elem;
-    delete[] size;
+    // the memory is given back to the arena by "scope"
+  }
 
-    delete[] col_fill;
-    delete[] row_fill;
+  template<class T>
+  static T* allocArray(FrameArena& arena, int n) {
+    return static_cast<T*>(arena.allocate(sizeof(T)*n, alignof(T)));
   }
 
   void setElementAt(int x, int y, Element* e) {
@@ -16,11 +16,13 @@ using namespace vaca;
 ButtonBase::ButtonBase(Widget* parent, Style style)
   : Widget(WidgetClassName(WC_BUTTON), parent, style)
 {
+  Click.setName("ButtonBase::Click");
 }
 
 ButtonBase::ButtonBase(HWND handle)
   : Widget(handle)
 {
+  Click.setName("ButtonBase::Click");
 }
 
 ButtonBase::~ButtonBase()
@@ -0,0 +1,118 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#ifndef VACA_CHARCONV_H
+#define VACA_CHARCONV_H
+
+#include "vaca/base.h"
+
+namespace vaca {
+
+/**
+   @defgroup charconv_utils Number Conversions
+   @{
+
+   Conversions between numbers and characters in the style of
+   @c std::to_chars and @c std::from_chars (C++17).
+
+   These functions do not depend on the C locale (the decimal point
+   is always a dot), do not allocate memory and do not skip white
+   spaces. Integers are written and read in base 10. Floating-point
+   numbers are written with the shortest representation that is
+   converted back to the same number (e.g. 0.1f is "0.1"), in fixed
+   notation if the decimal exponent is in [-4, 16), or in scientific
+   notation (e.g. "1e+20") otherwise.
+
+   @code
+   Char buf[max_number_chars];
+   ToCharsResult res = to_chars(buf, buf+max_number_chars, 3.25);
+   String str(buf, res.ptr);   // "3.25"
+
+   double value;
+   FromCharsResult res2 = from_chars(str.data(), str.data()+str.size(), value);
+   if (res2.error == CharConvError::None)
+     ...
+   @endcode
+
+   @see convert_to
+*/
+
+/**
+   Maximum number of characters written by #to_chars.
+*/
+const int max_number_chars = 32;
+
+struct CharConvErrorEnum
+{
+  enum enumeration {
+    None,
+
+    /**
+       The characters are not a number (#from_chars).
+    */
+    InvalidArgument,
+
+    /**
+       The number does not fit in the type (#from_chars) or the
+       characters do not fit in the buffer (#to_chars).
+    */
+    OutOfRange
+  };
+  static const enumeration default_value = None;
+};
+
+/**
+   Error of a #to_chars or #from_chars call.
+
+   One of the following values:
+   @li CharConvError::None
+   @li CharConvError::InvalidArgument
+   @li CharConvError::OutOfRange
+*/
+typedef Enum<CharConvErrorEnum> CharConvError;
+
+/**
+   Result of #to_chars: @a ptr is the end of the written characters.
+*/
+struct ToCharsResult
+{
+  Char* ptr;
+  CharConvError error;
+};
+
+/**
+   Result of #from_chars: @a ptr is the first character that is not
+   part of the number.
+*/
+struct FromCharsResult
+{
+  const Char* ptr;
+  CharConvError error;
+};
+
+VACA_DLL ToCharsResult to_chars(Char* first, Char* last, int value);
+VACA_DLL ToCharsResult to_chars(Char* first, Char* last, long value);
+VACA_DLL ToCharsResult to_chars(Char* first, Char* last, unsigned int value);
+VACA_DLL ToCharsResult to_chars(Char* first, Char* last, unsigned long value);
+VACA_DLL ToCharsResult to_chars(Char* first, Char* last, long long value);
+VACA_DLL ToCharsResult to_chars(Char* first, Char* last, unsigned long long value);
+VACA_DLL ToCharsResult to_chars(Char* first, Char* last, float value);
+VACA_DLL ToCharsResult to_chars(Char* first, Char* last, double value);
+
+VACA_DLL FromCharsResult from_chars(const Char* first, const Char* last, int& value);
+VACA_DLL FromCharsResult from_chars(const Char* first, const Char* last, long& value);
+VACA_DLL FromCharsResult from_chars(const Char* first, const Char* last, unsigned int& value);
+VACA_DLL FromCharsResult from_chars(const Char* first, const Char* last, unsigned long& value);
+VACA_DLL FromCharsResult from_chars(const Char* first, const Char* last, long long& value);
+VACA_DLL FromCharsResult from_chars(const Char* first, const Char* last, unsigned long long& value);
+VACA_DLL FromCharsResult from_chars(const Char* first, const Char* last, float& value);
+VACA_DLL FromCharsResult from_chars(const Char* first, const Char* last, double& value);
+
+/** @} */
+
+} // namespace vaca
+
+#endif // VACA_CHARCONV_H
@@ -51,7 +51,9 @@ public:
      \param id
        Command ID that will be handled by this SignalCommand.
    */
-  SignalCommand(CommandId id) : Command(id) { }
+  SignalCommand(CommandId id) : Command(id) {
+    setSignalNames();
+  }
 
   /**
      Creates a new SignalCommand with the specified functor .
@@ -64,6 +66,7 @@ public:
    */
   template<typename F>
   SignalCommand(CommandId id, const F& f) : Command(id) {
+    setSignalNames();
     Execute.connect(f);
   }
 
@@ -81,6 +84,7 @@ public:
    */
   template<class T>
   SignalCommand(CommandId id, void (T::*m)(), T* t) : Command(id) {
+    setSignalNames();
     Execute.connect(m, t);
   }
 
@@ -88,17 +92,33 @@ public:
 
   virtual void execute() { Execute(); }
 
+  /**
+     Returns the value of the last slot in the Enabled signal (or true
+     if there are no slots).
+  */
   virtual bool isEnabled() {
-    return Enabled(true);	// true by default
+    return Enabled.collect(last(true));
   }
 
+  /**
+     Returns the value of the last slot in the Checked signal (or false
+     if there are no slots).
+  */
   virtual bool isChecked() {
-    return Checked(false);	// false by default
+    return Checked.collect(last(false));
   }
 
   Signal0<void> Execute;
   Signal0<bool> Enabled;
   Signal0<bool> Checked;
+
+private:
+  // names for vaca::profiling
+  void setSignalNames() {
+    Execute.setName("SignalCommand::Execute");
+    Enabled.setName("SignalCommand::Enabled");
+    Checked.setName("SignalCommand::Checked");
+  }
 };
 
 /**
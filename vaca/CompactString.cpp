@@ -0,0 +1,200 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#include "vaca/CompactString.h"
+#include "vaca/Utf.h"
+
+#include <cstring>
+#include <vector>
+
+using namespace vaca;
+
+const std::size_t CompactString::InlineCapacity;
+
+CompactString::CompactString(const Char* str)
+{
+  setInlineSize(0);
+  assignWide(str, std::char_traits<Char>::length(str));
+}
+
+CompactString::CompactString(const String& str)
+{
+  setInlineSize(0);
+  assignWide(str.data(), str.size());
+}
+
+CompactString::CompactString(StringView str)
+{
+  setInlineSize(0);
+  assignWide(str.data(), str.size());
+}
+
+CompactString::CompactString(const CompactString& other)
+{
+  setInlineSize(0);
+  assign(other.data(), other.size());
+}
+
+CompactString::CompactString(CompactString&& other)
+{
+  std::memcpy(m_inline, other.m_inline, sizeof(m_inline));
+  other.setInlineSize(0);
+}
+
+CompactString::~CompactString()
+{
+  if (!isInline())
+    delete[] m_heap.ptr;
+}
+
+/**
+   Creates a string from UTF-8 bytes. Invalid sequences are replaced
+   with U+FFFD.
+*/
+CompactString CompactString::fromUtf8(const char* utf8, std::size_t size)
+{
+  CompactString res;
+  if (is_valid_utf8(utf8, size))
+    res.assign(utf8, size);
+  else {
+    std::vector<Char> wide(size+1);
+    std::size_t len = utf8_to_wide(utf8, size, &wide[0], true);
+    res.assignWide(&wide[0], len);
+  }
+  return res;
+}
+
+CompactString& CompactString::operator=(const CompactString& other)
+{
+  CompactString(other).swap(*this);
+  return *this;
+}
+
+CompactString& CompactString::operator=(CompactString&& other)
+{
+  CompactString(static_cast<CompactString&&>(other)).swap(*this);
+  return *this;
+}
+
+void CompactString::swap(CompactString& other)
+{
+  char tmp[sizeof(m_inline)];
+  std::memcpy(tmp, m_inline, sizeof(m_inline));
+  std::memcpy(m_inline, other.m_inline, sizeof(m_inline));
+  std::memcpy(other.m_inline, tmp, sizeof(m_inline));
+}
+
+/**
+   Converts the text to a String.
+*/
+String CompactString::str() const
+{
+  std::size_t n = size();
+  String res(wide_length_from_utf8(c_str(), n), L'\0');
+  if (!res.empty())
+    utf8_to_wide(c_str(), n, &res[0]);
+  return res;
+}
+
+/**
+   Converts the text to wide characters in @a buf, without creating a
+   String (e.g. to use a buffer in the stack to call the Win32 API).
+
+   @return The number of characters of the text (without the null
+	   character). If it is equal or greater than @a bufSize, the
+	   buffer is too small and nothing is written in it.
+*/
+std::size_t CompactString::copyTo(Char* buf, std::size_t bufSize) const
+{
+  std::size_t n = size();
+  std::size_t len = wide_length_from_utf8(c_str(), n);
+  if (len < bufSize) {
+    utf8_to_wide(c_str(), n, buf);
+    buf[len] = 0;
+  }
+  return len;
+}
+
+bool CompactString::operator==(const CompactString& other) const
+{
+  std::size_t n = size();
+  return n == other.size() && std::memcmp(c_str(), other.c_str(), n) == 0;
+}
+
+/**
+   Compares the bytes, which is the order of the code points (but not
+   the order of String for characters outside the BMP on Windows).
+*/
+bool CompactString::operator<(const CompactString& other) const
+{
+  return BasicStringView<char>(c_str(), size()) < BasicStringView<char>(other.c_str(), other.size());
+}
+
+void CompactString::setInlineSize(std::size_t size)
+{
+  m_inline[size] = 0;
+  m_inline[InlineCapacity] = static_cast<char>(InlineCapacity - size);
+}
+
+void CompactString::setHeap(char* ptr, std::size_t size)
+{
+  m_heap.ptr = ptr;
+  m_heap.size = size;
+  m_inline[InlineCapacity] = static_cast<char>(HeapFlag);
+}
+
+// Replaces the text with "size" valid UTF-8 bytes
+void CompactString::assign(const char* utf8, std::size_t size)
+{
+  char* ptr = (size > InlineCapacity ? new char[size+1]: NULL);
+
+  if (!isInline())
+    delete[] m_heap.ptr;
+
+  if (ptr) {
+    std::memcpy(ptr, utf8, size);
+    ptr[size] = 0;
+    setHeap(ptr, size);
+  }
+  else {
+    std::memcpy(m_inline, utf8, size);
+    setInlineSize(size);
+  }
+}
+
+// Replaces the text with wide characters (invalid characters are
+// replaced with U+FFFD)
+void CompactString::assignWide(const Char* str, std::size_t len)
+{
+  // The length is exact for valid characters, and the conversion stops
+  // in the first invalid one (so it never writes more bytes)
+  std::size_t size = utf8_length_from_wide(str, len);
+
+  // short strings are converted in the stack, longer ones directly in
+  // the heap buffer of the exact size
+  if (size != utf_error && size > InlineCapacity) {
+    char* ptr = new char[size+1];
+    if (wide_to_utf8(str, len, ptr) == size) {
+      ptr[size] = 0;
+      if (!isInline())
+	delete[] m_heap.ptr;
+      setHeap(ptr, size);
+      return;
+    }
+    delete[] ptr;
+  }
+  else if (size != utf_error) {
+    char buf[InlineCapacity];
+    if (wide_to_utf8(str, len, buf) == size) {
+      assign(buf, size);
+      return;
+    }
+  }
+
+  std::vector<char> buf(4*len);
+  size = wide_to_utf8(str, len, &buf[0], true);
+  assign(&buf[0], size);
+}
@@ -0,0 +1,114 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#ifndef VACA_COMPACTSTRING_H
+#define VACA_COMPACTSTRING_H
+
+#include "vaca/base.h"
+#include "vaca/StringView.h"
+
+#include <cstddef>
+
+namespace vaca {
+
+/**
+   A string stored in UTF-8 to save memory with a lot of short texts
+   (e.g. the labels of a big form).
+
+   A String uses two or four bytes for each character, and the buffer
+   inside the object (to avoid allocations for short strings) is very
+   small. A CompactString uses one byte for each ASCII character, and
+   texts of up to 23 bytes are stored inside the object (which has the
+   size of three pointers in 64-bit platforms, or 24 bytes in 32-bit
+   ones), so most labels do not allocate memory.
+
+   The text is converted to String only when it is needed (e.g. to give
+   it to a Widget). The constructors are explicit so a String is never
+   converted to a CompactString (or vice versa) by accident.
+
+   @code
+   CompactString label(L"First name:");	// inside the object
+   label.size();				// 11 bytes
+   label.c_str();				// UTF-8
+   widget->setText(label);		// converted to String here
+   @endcode
+*/
+class VACA_DLL CompactString
+{
+public:
+
+  /**
+     Maximum number of bytes stored inside the object.
+  */
+  static const std::size_t InlineCapacity = 23;
+
+private:
+
+  // The last byte of m_inline is "InlineCapacity - size" for inline
+  // strings (so it is the null character when the string is full) or
+  // HeapFlag when the bytes are in m_heap.ptr
+  union {
+    char m_inline[InlineCapacity+1];
+    struct {
+      char* ptr;
+      std::size_t size;
+    } m_heap;
+  };
+
+  enum { HeapFlag = 0xFF };
+
+public:
+
+  CompactString() { setInlineSize(0); }
+  explicit CompactString(const Char* str);
+  explicit CompactString(const String& str);
+  explicit CompactString(StringView str);
+  CompactString(const CompactString& other);
+  CompactString(CompactString&& other);
+  ~CompactString();
+
+  static CompactString fromUtf8(const char* utf8, std::size_t size);
+
+  CompactString& operator=(const CompactString& other);
+  CompactString& operator=(CompactString&& other);
+  void swap(CompactString& other);
+
+  /**
+     Returns the number of bytes (not the number of characters).
+  */
+  std::size_t size() const { return isInline() ? InlineCapacity - lastByte(): m_heap.size; }
+  bool empty() const { return size() == 0; }
+
+  /**
+     Returns true if the bytes are stored inside the object (the string
+     does not use memory from the heap).
+  */
+  bool isInline() const { return lastByte() != HeapFlag; }
+
+  /**
+     Returns the UTF-8 bytes (with a null character at the end).
+  */
+  const char* c_str() const { return isInline() ? m_inline: m_heap.ptr; }
+  const char* data() const { return c_str(); }
+
+  String str() const;
+  std::size_t copyTo(Char* buf, std::size_t bufSize) const;
+
+  bool operator==(const CompactString& other) const;
+  bool operator!=(const CompactString& other) const { return !operator==(other); }
+  bool operator<(const CompactString& other) const;
+
+private:
+  unsigned char lastByte() const { return static_cast<unsigned char>(m_inline[InlineCapacity]); }
+  void setInlineSize(std::size_t size);
+  void setHeap(char* ptr, std::size_t size);
+  void assign(const char* utf8, std::size_t size);
+  void assignWide(const Char* str, std::size_t len);
+};
+
+} // namespace vaca
+
+#endif // VACA_COMPACTSTRING_H
@@ -17,11 +17,12 @@ namespace vaca {
    A component is a visual object, such as widgets or menus.
 
    Components are non-copyable but are referenceable (e.g. you can
-   use them inside a SharedPtr).
+   use them inside a SharedPtr). They are used only from the thread
+   that created them, so their reference counter is not atomic.
 
-   @see NonCopyable, Referenceable, SharedPtr
+   @see NonCopyable, BasicReferenceable, SharedPtr
 */
-class VACA_DLL Component : public Referenceable
+class VACA_DLL Component : public BasicReferenceable<NonAtomicRefCount>
 {
 public:
   typedef std::map<String, PropertyPtr> Properties;
@@ -39,7 +39,17 @@ String FindFiles::getFileName() const
 
 String FindFiles::getFullFileName() const
 {
-  return file_path(m_pattern) / m_data.cFileName;
+  // same as file_path(m_pattern) / m_data.cFileName, with one allocation
+  StringView path = file_path(StringView(m_pattern));
+  StringView name(m_data.cFileName);
+
+  String res;
+  res.reserve(path.size() + 1 + name.size());
+  res.append(path.data(), path.size());
+  if (!res.empty() && *(res.end()-1) != L'/' && *(res.end()-1) != L'\\')
+    res.push_back(L'\\');
+  res.append(name.data(), name.size());
+  return res;
 }
 
 bool FindFiles::isFile() const
@@ -27,6 +27,14 @@ Font::Font(const Font& font)
 {
 }
 
+/**
+   Takes the reference of @a font, which is left without font.
+*/
+Font::Font(Font&& font)
+  : SharedPtr<GdiObject<HFONT> >(std::move(font))
+{
+}
+
 /**
    Makes a copy of the font changing it's style.
 */
@@ -123,6 +131,12 @@ Font& Font::operator=(const Font& font)
   return *this;
 }
 
+Font& Font::operator=(Font&& font)
+{
+  SharedPtr<GdiObject<HFONT> >::operator=(std::move(font));
+  return *this;
+}
+
 void Font::assign(LPLOGFONT lplf)
 {
   SharedPtr<GdiObject<HFONT> >::operator=(Font(CreateFontIndirect(lplf)));
@@ -85,6 +85,7 @@ public:
 
   Font();
   Font(const Font& font);
+  Font(Font&& font);
   Font(const Font& font, FontStyle style);
   Font(String familyName, int size, FontStyle style = FontStyle::Regular);
   explicit Font(HFONT hfont);
@@ -95,6 +96,7 @@ public:
   FontStyle getStyle() const;
 
   Font& operator=(const Font& font);
+  Font& operator=(Font&& font);
 
   HFONT getHandle() const;
   bool getLogFont(LPLOGFONT lplf) const;
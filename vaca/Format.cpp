@@ -0,0 +1,399 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#include "vaca/Format.h"
+#include "vaca/CharConv.h"
+#include "vaca/ParseException.h"
+
+#include <clocale>
+#include <cstdio>
+
+using namespace vaca;
+using namespace vaca::details;
+
+// ======================================================================
+// FormatBuffer
+
+FormatBuffer::FormatBuffer()
+  : m_data(m_inline)
+  , m_size(0)
+  , m_capacity(InlineSize)
+  , m_heap(false)
+{
+}
+
+/**
+   Creates a buffer that uses @a buf (of @a size characters) until it
+   is full.
+*/
+FormatBuffer::FormatBuffer(Char* buf, std::size_t size)
+  : m_data(buf)
+  , m_size(0)
+  , m_capacity(size)
+  , m_heap(false)
+{
+}
+
+FormatBuffer::~FormatBuffer()
+{
+  if (m_heap)
+    delete[] m_data;
+}
+
+/**
+   Returns the text with a null character at the end.
+*/
+const Char* FormatBuffer::c_str()
+{
+  push_back(0);
+  --m_size;
+  return m_data;
+}
+
+void FormatBuffer::grow(std::size_t minCapacity)
+{
+  std::size_t capacity = m_capacity*2;
+  if (capacity < minCapacity)
+    capacity = minCapacity;
+
+  Char* data = new Char[capacity];
+  std::memcpy(data, m_data, m_size * sizeof(Char));
+  if (m_heap)
+    delete[] m_data;
+
+  m_data = data;
+  m_capacity = capacity;
+  m_heap = true;
+}
+
+// ======================================================================
+// Formatting of arguments
+
+namespace {
+
+  [[noreturn]] void throw_format_error(const Char* message, const Char* fmt, const Char* pos)
+  {
+    throw ParseException(message, -1, -1, static_cast<int>(pos - fmt));
+  }
+
+  [[noreturn]] void throw_format_error(int error, const Char* fmt, const Char* pos)
+  {
+    switch (error) {
+      case FormatUnmatchedBrace:
+	throw_format_error(L"Unmatched '{' or '}' in the format string", fmt, pos);
+      case FormatMissingArgument:
+	throw_format_error(L"There are more fields than arguments in the format string", fmt, pos);
+      case FormatMixedIndexing:
+	throw_format_error(L"Automatic and explicit argument indexes cannot be mixed", fmt, pos);
+      case FormatTypeMismatch:
+	throw_format_error(L"The format specification cannot be used with the type of the argument", fmt, pos);
+      case FormatUnsupportedType:
+	throw_format_error(L"The type of an argument is not supported", fmt, pos);
+      default:
+	throw_format_error(L"Invalid format specification", fmt, pos);
+    }
+  }
+
+  // Writes "prefix" and "body" in "out" padded to the width of the
+  // specification. "defaultAlign" is '<' for text and '>' for numbers.
+  void write_padded(FormatBuffer& out, const FormatSpec& spec, Char defaultAlign,
+		    const Char* prefix, std::size_t prefixLen,
+		    const Char* body, std::size_t bodyLen)
+  {
+    std::size_t len = prefixLen + bodyLen;
+    std::size_t width = spec.width > 0 ? static_cast<std::size_t>(spec.width): 0;
+
+    if (len >= width) {
+      out.append(prefix, prefixLen);
+      out.append(body, bodyLen);
+      return;
+    }
+
+    std::size_t padding = width - len;
+
+    // zero padding goes between the sign/prefix and the digits
+    if (spec.zero && spec.align == 0) {
+      out.append(prefix, prefixLen);
+      out.append(padding, L'0');
+      out.append(body, bodyLen);
+      return;
+    }
+
+    Char align = spec.align ? spec.align: defaultAlign;
+    std::size_t before =
+      align == '<' ? 0:
+      align == '^' ? padding/2: padding;
+
+    out.append(before, spec.fill);
+    out.append(prefix, prefixLen);
+    out.append(body, bodyLen);
+    out.append(padding - before, spec.fill);
+  }
+
+  void format_integer(FormatBuffer& out, const FormatSpec& spec,
+		      unsigned long long abs, bool negative)
+  {
+    Char prefix[4];
+    std::size_t prefixLen = 0;
+    Char body[72];
+    Char* end = body + 72;
+    Char* begin = end;
+
+    if (negative)
+      prefix[prefixLen++] = L'-';
+    else if (spec.sign == '+' || spec.sign == ' ')
+      prefix[prefixLen++] = spec.sign;
+
+    switch (spec.type) {
+
+      case 'x':
+      case 'X': {
+	const char* digits = (spec.type == 'x' ? "0123456789abcdef": "0123456789ABCDEF");
+	do {
+	  *--begin = digits[abs & 15];
+	  abs >>= 4;
+	} while (abs);
+	if (spec.alt) {
+	  prefix[prefixLen++] = L'0';
+	  prefix[prefixLen++] = spec.type;
+	}
+	break;
+      }
+
+      case 'o':
+	do {
+	  *--begin = static_cast<Char>(L'0' + (abs & 7));
+	  abs >>= 3;
+	} while (abs);
+	if (spec.alt && *begin != L'0')
+	  prefix[prefixLen++] = L'0';
+	break;
+
+      case 'b':
+	do {
+	  *--begin = static_cast<Char>(L'0' + (abs & 1));
+	  abs >>= 1;
+	} while (abs);
+	if (spec.alt) {
+	  prefix[prefixLen++] = L'0';
+	  prefix[prefixLen++] = L'b';
+	}
+	break;
+
+      default:
+	end = to_chars(body, end, abs).ptr;
+	begin = body;
+	break;
+    }
+
+    write_padded(out, spec, '>', prefix, prefixLen, begin, end - begin);
+  }
+
+  void format_char(FormatBuffer& out, const FormatSpec& spec, Char chr)
+  {
+    write_padded(out, spec, '<', L"", 0, &chr, 1);
+  }
+
+  void format_string(FormatBuffer& out, const FormatSpec& spec, const Char* str, std::size_t len)
+  {
+    if (spec.precision >= 0 && static_cast<std::size_t>(spec.precision) < len)
+      len = spec.precision;
+    write_padded(out, spec, '<', L"", 0, str, len);
+  }
+
+  // Formats with the C library (for types 'e', 'f' and 'g'), using a
+  // dot as decimal point whatever the C locale is
+  std::size_t format_float_with_c_library(Char* buf, std::size_t size, const FormatSpec& spec, double value)
+  {
+    char fmt[8];
+    char* f = fmt;
+    *f++ = '%';
+    if (spec.alt)
+      *f++ = '#';
+    *f++ = '.';
+    *f++ = '*';
+    *f++ = static_cast<char>(spec.type ? spec.type: 'g');
+    *f = 0;
+
+    char narrow[512];
+    int precision = spec.precision >= 0 ? spec.precision: 6;
+    if (precision > 300)
+      precision = 300;
+    int len = std::snprintf(narrow, sizeof(narrow), fmt, precision, value);
+    if (len < 0)
+      len = 0;
+    else if (static_cast<std::size_t>(len) >= sizeof(narrow))
+      len = sizeof(narrow)-1;
+
+    char point = std::localeconv()->decimal_point[0];
+    std::size_t n = 0;
+    for (int i=0; i<len && n<size; ++i)
+      buf[n++] = (narrow[i] == point ? L'.': static_cast<Char>(narrow[i]));
+    return n;
+  }
+
+  template<class Float>
+  void format_float(FormatBuffer& out, const FormatSpec& spec, Float value)
+  {
+    Char body[512];
+    std::size_t bodyLen;
+
+    if (spec.type == 0 && spec.precision < 0)
+      bodyLen = to_chars(body, body+512, value).ptr - body;
+    else
+      bodyLen = format_float_with_c_library(body, 512, spec, value);
+
+    // the sign goes in the prefix (before the zero padding)
+    Char prefix[1];
+    std::size_t prefixLen = 0;
+    const Char* begin = body;
+    if (bodyLen > 0 && body[0] == L'-') {
+      prefix[prefixLen++] = L'-';
+      ++begin;
+      --bodyLen;
+    }
+    else if (spec.sign == '+' || spec.sign == ' ')
+      prefix[prefixLen++] = spec.sign;
+
+    write_padded(out, spec, '>', prefix, prefixLen, begin, bodyLen);
+  }
+
+  void format_pointer(FormatBuffer& out, const FormatSpec& spec, const void* ptr)
+  {
+    Char body[2+2*sizeof(void*)];
+    Char* end = body + sizeof(body)/sizeof(Char);
+    Char* begin = end;
+
+    std::size_t value = reinterpret_cast<std::size_t>(ptr);
+    do {
+      *--begin = "0123456789abcdef"[value & 15];
+      value >>= 4;
+    } while (value);
+
+    Char prefix[2] = { L'0', L'x' };
+    write_padded(out, spec, '>', prefix, 2, begin, end - begin);
+  }
+
+  void format_arg(FormatBuffer& out, const FormatSpec& spec, const FormatArg& arg)
+  {
+    switch (arg.type) {
+
+      case FormatArgInt:
+	if (spec.type == 'c')
+	  format_char(out, spec, static_cast<Char>(arg.value.i));
+	else
+	  format_integer(out, spec,
+			 arg.value.i < 0 ? 0ULL - static_cast<unsigned long long>(arg.value.i):
+					   static_cast<unsigned long long>(arg.value.i),
+			 arg.value.i < 0);
+	break;
+
+      case FormatArgUInt:
+	if (spec.type == 'c')
+	  format_char(out, spec, static_cast<Char>(arg.value.u));
+	else
+	  format_integer(out, spec, arg.value.u, false);
+	break;
+
+      case FormatArgChar:
+	if (spec.type == 0 || spec.type == 'c')
+	  format_char(out, spec, arg.value.c);
+	else
+	  format_integer(out, spec, static_cast<unsigned long long>(arg.value.c), false);
+	break;
+
+      case FormatArgBool:
+	if (spec.type == 0 || spec.type == 's') {
+	  if (arg.value.b)
+	    format_string(out, spec, L"true", 4);
+	  else
+	    format_string(out, spec, L"false", 5);
+	}
+	else
+	  format_integer(out, spec, arg.value.b ? 1: 0, false);
+	break;
+
+      case FormatArgFloat:
+	format_float(out, spec, arg.value.f);
+	break;
+
+      case FormatArgDouble:
+	format_float(out, spec, arg.value.d);
+	break;
+
+      case FormatArgString:
+	format_string(out, spec, arg.value.s, arg.length);
+	break;
+
+      case FormatArgPointer:
+	format_pointer(out, spec, arg.value.p);
+	break;
+    }
+  }
+
+}
+
+/**
+   @internal
+   Parses the format string at runtime. It uses the same FormatSpec
+   and check_format_spec of the compile-time check.
+*/
+void vaca::details::vformat(FormatBuffer& out, const Char* fmt, const FormatArg* args, int count)
+{
+  const Char* p = fmt;
+  int next = 0;
+  int mode = 0;
+
+  for (;;) {
+    // copy the text until the next brace
+    const Char* q = p;
+    while (*q && *q != L'{' && *q != L'}')
+      ++q;
+    out.append(p, q - p);
+    if (*q == 0)
+      break;
+
+    // "{{" or "}}"
+    if (q[0] == q[1]) {
+      out.push_back(*q);
+      p = q+2;
+      continue;
+    }
+    if (*q == L'}')
+      throw_format_error(FormatUnmatchedBrace, fmt, q);
+
+    const Char* field = q++;
+    int arg;
+    if (is_format_digit(*q)) {
+      if (mode == 1)
+	throw_format_error(FormatMixedIndexing, fmt, field);
+      mode = 2;
+      arg = 0;
+      for (; is_format_digit(*q); ++q)
+	if (arg < count)
+	  arg = arg*10 + (*q - L'0');
+    }
+    else {
+      if (mode == 2)
+	throw_format_error(FormatMixedIndexing, fmt, field);
+      mode = 1;
+      arg = next++;
+    }
+
+    if (*q != L':' && *q != L'}')
+      throw_format_error(*q ? FormatInvalidSpec: FormatUnmatchedBrace, fmt, q);
+    if (arg >= count)
+      throw_format_error(FormatMissingArgument, fmt, field);
+
+    FormatSpec spec(fmt, static_cast<int>(q - fmt) + (*q == L':' ? 1: 0));
+    int error = check_format_spec(args[arg].type, spec);
+    if (error != FormatOk)
+      throw_format_error(error, fmt, field);
+
+    format_arg(out, spec, args[arg]);
+    p = fmt + spec.end + 1;
+  }
+}
@@ -0,0 +1,467 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#ifndef VACA_FORMAT_H
+#define VACA_FORMAT_H
+
+#include "vaca/base.h"
+#include "vaca/NonCopyable.h"
+#include "vaca/StringView.h"
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace vaca {
+
+/**
+   A buffer of characters for #format_to.
+
+   The characters are stored in a buffer inside the object (or in a
+   buffer given by you), and the heap is used only when the text does
+   not fit in it.
+
+   @code
+   FormatBuffer buf;
+   for (int c=0; c<16; ++c)
+     VACA_FORMAT_TO(buf, L"{:02x}", digest[c]);
+   String hex = buf.str();
+   @endcode
+*/
+class VACA_DLL FormatBuffer : private NonCopyable
+{
+public:
+  enum { InlineSize = 256 };
+
+private:
+  Char* m_data;
+  std::size_t m_size;
+  std::size_t m_capacity;
+  bool m_heap;			// true if m_data was allocated with new[]
+  Char m_inline[InlineSize];
+
+public:
+
+  FormatBuffer();
+  FormatBuffer(Char* buf, std::size_t size);
+  ~FormatBuffer();
+
+  const Char* data() const { return m_data; }
+  std::size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+  void clear() { m_size = 0; }
+
+  const Char* c_str();
+  String str() const { return String(m_data, m_size); }
+  StringView view() const { return StringView(m_data, m_size); }
+
+  void append(const Char* str, std::size_t n) {
+    if (m_size + n > m_capacity)
+      grow(m_size + n);
+    std::memcpy(m_data + m_size, str, n * sizeof(Char));
+    m_size += n;
+  }
+
+  void append(std::size_t n, Char chr) {
+    if (m_size + n > m_capacity)
+      grow(m_size + n);
+    for (std::size_t i=0; i<n; ++i)
+      m_data[m_size++] = chr;
+  }
+
+  void push_back(Char chr) {
+    if (m_size == m_capacity)
+      grow(m_size + 1);
+    m_data[m_size++] = chr;
+  }
+
+private:
+  void grow(std::size_t minCapacity);
+};
+
+namespace details {
+
+  /**
+     @internal
+     Type of an argument of #format.
+  */
+  enum FormatArgType {
+    FormatArgNone,		// not supported
+    FormatArgInt,
+    FormatArgUInt,
+    FormatArgChar,
+    FormatArgBool,
+    FormatArgFloat,
+    FormatArgDouble,
+    FormatArgString,
+    FormatArgPointer
+  };
+
+  /**
+     @internal
+     Errors found in a format string.
+  */
+  enum FormatError {
+    FormatOk,
+    FormatUnmatchedBrace,
+    FormatInvalidSpec,
+    FormatMissingArgument,
+    FormatMixedIndexing,
+    FormatTypeMismatch,
+    FormatUnsupportedType
+  };
+
+  /**
+     @internal
+     An argument of #format without its type.
+  */
+  struct FormatArg
+  {
+    int type;
+    union {
+      long long i;
+      unsigned long long u;
+      double d;
+      float f;
+      Char c;
+      bool b;
+      const Char* s;
+      const void* p;
+    } value;
+    std::size_t length;		// length of the string
+
+    FormatArg() : type(FormatArgNone) { }
+    FormatArg(int v) : type(FormatArgInt) { value.i = v; }
+    FormatArg(long v) : type(FormatArgInt) { value.i = v; }
+    FormatArg(long long v) : type(FormatArgInt) { value.i = v; }
+    FormatArg(unsigned int v) : type(FormatArgUInt) { value.u = v; }
+    FormatArg(unsigned long v) : type(FormatArgUInt) { value.u = v; }
+    FormatArg(unsigned long long v) : type(FormatArgUInt) { value.u = v; }
+    FormatArg(char v) : type(FormatArgChar) { value.c = static_cast<unsigned char>(v); }
+    FormatArg(Char v) : type(FormatArgChar) { value.c = v; }
+    FormatArg(bool v) : type(FormatArgBool) { value.b = v; }
+    FormatArg(float v) : type(FormatArgFloat) { value.f = v; }
+    FormatArg(double v) : type(FormatArgDouble) { value.d = v; }
+    FormatArg(long double v) : type(FormatArgDouble) { value.d = static_cast<double>(v); }
+    FormatArg(const Char* v) : type(FormatArgString), length(std::char_traits<Char>::length(v)) { value.s = v; }
+    FormatArg(const String& v) : type(FormatArgString), length(v.size()) { value.s = v.data(); }
+    FormatArg(StringView v) : type(FormatArgString), length(v.size()) { value.s = v.data(); }
+    FormatArg(const void* v) : type(FormatArgPointer) { value.p = v; }
+    FormatArg(const char* v) : type(FormatArgNone) { value.p = v; }
+  };
+
+  // The same overloads of the FormatArg constructors, to know the
+  // type of an argument at compile time
+  template<int type> struct FormatArgTypeTag { enum { value = type }; };
+  FormatArgTypeTag<FormatArgInt> format_arg_type(int);
+  FormatArgTypeTag<FormatArgInt> format_arg_type(long);
+  FormatArgTypeTag<FormatArgInt> format_arg_type(long long);
+  FormatArgTypeTag<FormatArgUInt> format_arg_type(unsigned int);
+  FormatArgTypeTag<FormatArgUInt> format_arg_type(unsigned long);
+  FormatArgTypeTag<FormatArgUInt> format_arg_type(unsigned long long);
+  FormatArgTypeTag<FormatArgChar> format_arg_type(char);
+  FormatArgTypeTag<FormatArgChar> format_arg_type(Char);
+  FormatArgTypeTag<FormatArgBool> format_arg_type(bool);
+  FormatArgTypeTag<FormatArgFloat> format_arg_type(float);
+  FormatArgTypeTag<FormatArgDouble> format_arg_type(double);
+  FormatArgTypeTag<FormatArgDouble> format_arg_type(long double);
+  FormatArgTypeTag<FormatArgString> format_arg_type(const Char*);
+  FormatArgTypeTag<FormatArgString> format_arg_type(const String&);
+  FormatArgTypeTag<FormatArgString> format_arg_type(StringView);
+  FormatArgTypeTag<FormatArgPointer> format_arg_type(const void*);
+  FormatArgTypeTag<FormatArgNone> format_arg_type(const char*); // narrow strings are not supported
+
+  template<class T>
+  struct FormatArgTypeOf {
+    enum { value = decltype(format_arg_type(std::declval<const T&>()))::value };
+  };
+
+  /**
+     @internal
+     The types of the arguments of a #format call.
+  */
+  template<class... Args> struct FormatSignature;
+
+  template<>
+  struct FormatSignature<> {
+    static constexpr int size() { return 0; }
+    static constexpr int type(int) { return FormatArgNone; }
+  };
+
+  template<class T, class... Rest>
+  struct FormatSignature<T, Rest...> {
+    static constexpr int size() { return 1 + sizeof...(Rest); }
+    static constexpr int type(int i) {
+      return i == 0 ? static_cast<int>(FormatArgTypeOf<T>::value):
+		      FormatSignature<Rest...>::type(i-1);
+    }
+  };
+
+  template<class... Args>
+  FormatSignature<typename std::decay<Args>::type...> format_signature(const Char*, const Args&...);
+
+  // ======================================================================
+  // Format specifications: [[fill]align][sign][#][0][width][.precision][type]
+  //
+  // Everything is constexpr (and C++11 constexpr functions have only
+  // a return statement) so the same code checks the format at compile
+  // time (VACA_FORMAT) and parses it at runtime (format).
+
+  constexpr bool is_format_digit(Char c) { return c >= '0' && c <= '9'; }
+  constexpr bool is_format_align(Char c) { return c == '<' || c == '>' || c == '^'; }
+  constexpr bool is_format_sign(Char c) { return c == '+' || c == '-' || c == ' '; }
+
+  constexpr bool is_format_type(Char c) {
+    return (c == 'b' || c == 'c' || c == 'd' || c == 'o' || c == 'x' || c == 'X' ||
+	    c == 'e' || c == 'E' || c == 'f' || c == 'F' || c == 'g' || c == 'G' ||
+	    c == 's' || c == 'p');
+  }
+
+  constexpr bool is_int_format(Char c) {
+    return c == 0 || c == 'b' || c == 'c' || c == 'd' || c == 'o' || c == 'x' || c == 'X';
+  }
+
+  constexpr bool is_float_format(Char c) {
+    return c == 0 || c == 'e' || c == 'E' || c == 'f' || c == 'F' || c == 'g' || c == 'G';
+  }
+
+  constexpr int skip_format_digits(const Char* f, int i) {
+    return is_format_digit(f[i]) ? skip_format_digits(f, i+1): i;
+  }
+
+  constexpr int parse_format_int(const Char* f, int i, int end, int value) {
+    return i < end ? parse_format_int(f, i+1, end, value*10 + (f[i] - '0')): value;
+  }
+
+  constexpr int skip_format_align(const Char* f, int i) {
+    return (f[i] != 0 && f[i] != '{' && f[i] != '}' && is_format_align(f[i+1])) ? i+2:
+	   is_format_align(f[i]) ? i+1: i;
+  }
+
+  /**
+     @internal
+     A parsed format specification (what is after the ':' of a field).
+  */
+  struct FormatSpec
+  {
+    // positions of the end of each part
+    int alignEnd, signEnd, altEnd, zeroEnd, widthEnd, precisionEnd;
+    int end;			// position of the '}'
+
+    Char fill;
+    Char align;			// 0, '<', '>' or '^'
+    Char sign;			// 0, '+', '-' or ' '
+    bool alt;			// '#'
+    bool zero;			// '0'
+    int width;
+    int precision;		// -1 if it is not specified
+    Char type;			// 0 or one of is_format_type
+    bool valid;
+
+    constexpr FormatSpec(const Char* f, int i)
+      : alignEnd(skip_format_align(f, i))
+      , signEnd(alignEnd + (is_format_sign(f[alignEnd]) ? 1: 0))
+      , altEnd(signEnd + (f[signEnd] == '#' ? 1: 0))
+      , zeroEnd(altEnd + (f[altEnd] == '0' ? 1: 0))
+      , widthEnd(skip_format_digits(f, zeroEnd))
+      , precisionEnd(f[widthEnd] == '.' ? skip_format_digits(f, widthEnd+1): widthEnd)
+      , end(precisionEnd + (is_format_type(f[precisionEnd]) ? 1: 0))
+      , fill(alignEnd == i+2 ? f[i]: ' ')
+      , align(alignEnd > i ? f[alignEnd-1]: 0)
+      , sign(signEnd > alignEnd ? f[alignEnd]: 0)
+      , alt(altEnd > signEnd)
+      , zero(zeroEnd > altEnd)
+      , width(parse_format_int(f, zeroEnd, widthEnd, 0))
+      , precision(f[widthEnd] == '.' ? parse_format_int(f, widthEnd+1, precisionEnd, 0): -1)
+      , type(end > precisionEnd ? f[precisionEnd]: 0)
+      , valid(f[end] == '}' && precisionEnd != widthEnd+1) {
+    }
+  };
+
+  /**
+     @internal
+     Checks if the specification can be used with an argument of the
+     given type.
+  */
+  constexpr int check_format_spec(int type, const FormatSpec& s)
+  {
+    return
+      !s.valid ? FormatInvalidSpec:
+      type == FormatArgNone ? FormatUnsupportedType:
+      // integers
+      (type == FormatArgInt || type == FormatArgUInt) ?
+	(is_int_format(s.type) && s.precision < 0 ? FormatOk: FormatTypeMismatch):
+      // characters and bools (as text or as integers)
+      (type == FormatArgChar || type == FormatArgBool) ?
+	((s.type == 0 || s.type == (type == FormatArgChar ? 'c': 's')) ?
+	   (s.sign == 0 && !s.alt && !s.zero && s.precision < 0 ? FormatOk: FormatTypeMismatch):
+	 (is_int_format(s.type) && s.precision < 0 ? FormatOk: FormatTypeMismatch)):
+      (type == FormatArgFloat || type == FormatArgDouble) ?
+	(is_float_format(s.type) ? FormatOk: FormatTypeMismatch):
+      // strings (the precision is the maximum number of characters)
+      type == FormatArgString ?
+	((s.type == 0 || s.type == 's') && s.sign == 0 && !s.alt && !s.zero ? FormatOk: FormatTypeMismatch):
+      // pointers
+      ((s.type == 0 || s.type == 'p') && s.sign == 0 && !s.alt && s.precision < 0 ? FormatOk: FormatTypeMismatch);
+  }
+
+  // ======================================================================
+  // Compile-time check of a whole format string.
+  //
+  // "next" is the next automatic argument index, "mode" is 0 until
+  // the first field, 1 if the fields use automatic indexes ("{}"),
+  // and 2 if they use explicit indexes ("{0}").
+
+  template<class Sig>
+  constexpr int check_format_text(const Char* f, int i, int next, int mode);
+
+  template<class Sig>
+  constexpr int check_format_field(const Char* f, int arg, int next, int mode, const FormatSpec& spec) {
+    return arg >= Sig::size() ? FormatMissingArgument:
+	   check_format_spec(Sig::type(arg), spec) != FormatOk ? check_format_spec(Sig::type(arg), spec):
+	   check_format_text<Sig>(f, spec.end+1, next, mode);
+  }
+
+  template<class Sig>
+  constexpr int check_format_arg(const Char* f, int i, int arg, int next, int mode) {
+    return f[i] == ':' ? check_format_field<Sig>(f, arg, next, mode, FormatSpec(f, i+1)):
+	   f[i] == '}' ? check_format_field<Sig>(f, arg, next, mode, FormatSpec(f, i)):
+	   f[i] == 0 ? FormatUnmatchedBrace:
+	   FormatInvalidSpec;
+  }
+
+  template<class Sig>
+  constexpr int check_format_text(const Char* f, int i, int next, int mode) {
+    return
+      f[i] == 0 ? FormatOk:
+      f[i] == '}' ? (f[i+1] == '}' ? check_format_text<Sig>(f, i+2, next, mode): FormatUnmatchedBrace):
+      f[i] != '{' ? check_format_text<Sig>(f, i+1, next, mode):
+      f[i+1] == '{' ? check_format_text<Sig>(f, i+2, next, mode):
+      is_format_digit(f[i+1]) ?
+	(mode == 1 ? FormatMixedIndexing:
+	 check_format_arg<Sig>(f, skip_format_digits(f, i+1),
+			       parse_format_int(f, i+1, skip_format_digits(f, i+1), 0), next, 2)):
+	(mode == 2 ? FormatMixedIndexing:
+	 check_format_arg<Sig>(f, i+1, next, next+1, 1));
+  }
+
+  template<class Sig>
+  constexpr int check_format(const Char* f, Sig) {
+    return check_format_text<Sig>(f, 0, 0, 0);
+  }
+
+  /**
+     @internal
+     Shows the error of a format string checked at compile time.
+  */
+  template<int error>
+  struct FormatCheck {
+    static_assert(error != FormatUnmatchedBrace, "VACA_FORMAT: unmatched '{' or '}' in the format string");
+    static_assert(error != FormatInvalidSpec, "VACA_FORMAT: invalid format specification");
+    static_assert(error != FormatMissingArgument, "VACA_FORMAT: there are more fields than arguments");
+    static_assert(error != FormatMixedIndexing, "VACA_FORMAT: automatic and explicit argument indexes cannot be mixed");
+    static_assert(error != FormatTypeMismatch, "VACA_FORMAT: the format specification cannot be used with the type of the argument");
+    static_assert(error != FormatUnsupportedType, "VACA_FORMAT: the type of an argument is not supported");
+    enum { value = 0 };
+  };
+
+  VACA_DLL void vformat(FormatBuffer& out, const Char* fmt, const FormatArg* args, int count);
+
+} // namespace details
+
+/**
+   @defgroup format_utils Formatting
+   @{
+
+   Type-safe formatting of strings with a syntax like @c std::format
+   (C++20) and Python.
+
+   Each <tt>{}</tt> field of the format string is replaced with the next
+   argument, and <tt>{N}</tt> with the N-th argument (starting in 0).
+   After a ':' you can specify
+   <tt>[[fill]align][sign][#][0][width][.precision][type]</tt>:
+   @li align: '<' (left), '>' (right) or '^' (center),
+   @li sign: '+' (always), '-' (only negative numbers) or ' ',
+   @li #: adds "0x", "0b" or "0" prefixes to integers,
+   @li 0: pads numbers with zeros,
+   @li type for integers: 'd', 'x', 'X', 'o', 'b' or 'c' (character),
+   @li type for floating-point numbers: 'f', 'F', 'e', 'E', 'g' or 'G'
+       (without a type, the shortest representation is used),
+   @li type for strings ('s'), characters ('c'), bools ('s') and
+       pointers ('p'). The precision of a string is its maximum length.
+
+   Use "{{" and "}}" to write braces.
+
+   The arguments can be integers, floating-point numbers, bools,
+   characters, String, StringView, <tt>const Char*</tt> and other
+   pointers. Narrow strings (<tt>const char*</tt>) are not supported.
+
+   @code
+   String str = VACA_FORMAT(L"{}: {:08x}", name, value);
+   String title = format(L"Document #{}", m_docCounter);
+   @endcode
+
+   The VACA_FORMAT and VACA_FORMAT_TO macros check the format string and
+   the types of the arguments at compile time. The #format and
+   #format_to functions do the same checks at runtime (throwing a
+   ParseException) so they can be used with format strings that are
+   not literals.
+*/
+
+/**
+   Appends the formatted text to @a out.
+
+   @throw ParseException
+     If the format string is not valid for the arguments.
+*/
+template<class... Args>
+void format_to(FormatBuffer& out, const Char* fmt, const Args&... args)
+{
+  const details::FormatArg array[] = { details::FormatArg(args)..., details::FormatArg() };
+  details::vformat(out, fmt, array, static_cast<int>(sizeof...(Args)));
+}
+
+/**
+   Returns the formatted text.
+
+   @throw ParseException
+     If the format string is not valid for the arguments.
+*/
+template<class... Args>
+String format(const Char* fmt, const Args&... args)
+{
+  FormatBuffer buf;
+  format_to(buf, fmt, args...);
+  return buf.str();
+}
+
+#define VACA_FORMAT_EXPAND_(x) x
+#define VACA_FORMAT_FIRST_(first, ...) first
+#define VACA_FORMAT_CHECK_(...)						\
+  ((void)vaca::details::FormatCheck<vaca::details::check_format(		\
+     VACA_FORMAT_EXPAND_(VACA_FORMAT_FIRST_(__VA_ARGS__, 0)),		\
+     decltype(vaca::details::format_signature(__VA_ARGS__))())>::value)
+
+/**
+   Like #format, but the format string (which must be a literal) is
+   checked at compile time.
+*/
+#define VACA_FORMAT(...)					\
+  (VACA_FORMAT_CHECK_(__VA_ARGS__), vaca::format(__VA_ARGS__))
+
+/**
+   Like #format_to, but the format string (which must be a literal) is
+   checked at compile time.
+*/
+#define VACA_FORMAT_TO(out, ...)					\
+  (VACA_FORMAT_CHECK_(__VA_ARGS__), vaca::format_to(out, __VA_ARGS__))
+
+/** @} */
+
+} // namespace vaca
+
+#endif // VACA_FORMAT_H
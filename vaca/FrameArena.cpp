@@ -0,0 +1,134 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#include "vaca/FrameArena.h"
+
+#include <cassert>
+
+using namespace vaca;
+
+struct FrameArena::Chunk
+{
+  Chunk* next;
+  std::size_t size;		// bytes after the header
+
+  char* getData() {
+    return reinterpret_cast<char*>(this) + HeaderSize;
+  }
+
+  enum { HeaderSize = 2*sizeof(double) };
+};
+
+FrameArena::FrameArena(std::size_t chunkSize)
+  : m_first(NULL)
+  , m_current(NULL)
+  , m_pos(NULL)
+  , m_chunkSize(chunkSize)
+  , m_depth(0)
+{
+}
+
+FrameArena::~FrameArena()
+{
+  Chunk* chunk = m_first;
+  while (chunk) {
+    Chunk* next = chunk->next;
+    ::operator delete(chunk);
+    chunk = next;
+  }
+}
+
+/**
+   Returns the current position of the arena, to go back to it later
+   with #rewind.
+*/
+FrameArena::Marker FrameArena::getMarker() const
+{
+  Marker marker = { m_current, m_pos };
+  return marker;
+}
+
+/**
+   Gives back all the memory allocated after the @a marker was
+   obtained. The chunks are not freed, they are reused by the next
+   allocations.
+*/
+void FrameArena::rewind(const Marker& marker)
+{
+  if (marker.chunk) {
+    m_current = marker.chunk;
+    m_pos = marker.pos;
+  }
+  else
+    reset();
+}
+
+/**
+   Gives back all the memory of the arena.
+*/
+void FrameArena::reset()
+{
+  m_current = m_first;
+  m_pos = m_first ? m_first->getData(): NULL;
+}
+
+/**
+   Returns the number of bytes of all chunks.
+*/
+std::size_t FrameArena::getCapacity() const
+{
+  std::size_t capacity = 0;
+  for (Chunk* chunk = m_first; chunk; chunk = chunk->next)
+    capacity += chunk->size;
+  return capacity;
+}
+
+/**
+   Returns the arena of the current thread.
+*/
+FrameArena& FrameArena::getCurrent()
+{
+  static thread_local FrameArena arena;
+  return arena;
+}
+
+char* FrameArena::getEnd(Chunk* chunk)
+{
+  return chunk->getData() + chunk->size;
+}
+
+void* FrameArena::allocateInNextChunk(std::size_t size, std::size_t align)
+{
+  // use the next chunks (from previous cycles) if they are big enough
+  Chunk* prev = m_current;
+  Chunk* chunk = m_current ? m_current->next: m_first;
+  while (chunk && chunk->size < size + align) {
+    prev = chunk;
+    chunk = chunk->next;
+  }
+
+  // create a new chunk after the last one
+  if (!chunk) {
+    std::size_t chunkSize = m_chunkSize;
+    while (chunkSize < size + align)
+      chunkSize *= 2;
+
+    chunk = static_cast<Chunk*>(::operator new(Chunk::HeaderSize + chunkSize));
+    chunk->next = NULL;
+    chunk->size = chunkSize;
+
+    if (prev)
+      prev->next = chunk;
+    else
+      m_first = chunk;
+  }
+
+  m_current = chunk;
+  char* ptr = alignPointer(chunk->getData(), align);
+  m_pos = ptr + size;
+  assert(m_pos <= getEnd(chunk));
+  return ptr;
+}
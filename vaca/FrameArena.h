@@ -0,0 +1,191 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#ifndef VACA_FRAMEARENA_H
+#define VACA_FRAMEARENA_H
+
+#include "vaca/base.h"
+#include "vaca/NonCopyable.h"
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+
+namespace vaca {
+
+/**
+   A bump allocator for the temporaries of a layout or paint cycle.
+
+   Memory is taken from big chunks moving a pointer, and it is given
+   back all at once: when a FrameArena::Scope is destroyed, all the
+   memory allocated since the scope was created can be used again.
+   The chunks are kept for the next cycle, so in steady state the
+   arena does not use the global heap.
+
+   Each thread has its own arena (see #getCurrent). Scopes are nested
+   like the calls of the layout/paint functions that create them.
+
+   @code
+   void MyLayout::layout(Widget* parent, WidgetList& widgets, const Rect& rc)
+   {
+     FrameArena::Scope scope;
+     std::vector<Rect, FrameAllocator<Rect> > bounds(widgets.size());
+     ...                        // bounds does not grow from here
+   }
+   @endcode
+
+   @warning Destructors of objects created in the arena are not called
+	    automatically, and the memory must not be used after the
+	    scope that was active when it was allocated is destroyed.
+	    So a container cannot grow while a younger scope is open
+	    (e.g. when it is filled by functions that create their own
+	    scopes): its new storage would be given back by that scope.
+
+   @see FrameAllocator
+*/
+class VACA_DLL FrameArena : private NonCopyable
+{
+  struct Chunk;
+
+  Chunk* m_first;		// list of chunks
+  Chunk* m_current;		// chunk where the next allocation is done
+  char* m_pos;			// next free byte in m_current
+  std::size_t m_chunkSize;
+  std::size_t m_depth;		// number of open scopes
+
+public:
+
+  /**
+     A position of the arena.
+  */
+  struct Marker {
+    Chunk* chunk;
+    char* pos;
+  };
+
+  /**
+     Gives back to the arena all the memory allocated during the life
+     of the scope.
+  */
+  class Scope : private NonCopyable
+  {
+    FrameArena& m_arena;
+    Marker m_marker;
+  public:
+    Scope() : m_arena(FrameArena::getCurrent()), m_marker(m_arena.getMarker()) { ++m_arena.m_depth; }
+    explicit Scope(FrameArena& arena) : m_arena(arena), m_marker(arena.getMarker()) { ++m_arena.m_depth; }
+    ~Scope() { --m_arena.m_depth; m_arena.rewind(m_marker); }
+  };
+
+  explicit FrameArena(std::size_t chunkSize = 64*1024);
+  ~FrameArena();
+
+  /**
+     Returns @a size bytes aligned to @a align (which must be a power
+     of two).
+  */
+  void* allocate(std::size_t size, std::size_t align = sizeof(double)) {
+    char* ptr = alignPointer(m_pos, align);
+    if (m_current && ptr + size <= getEnd(m_current)) {
+      m_pos = ptr + size;
+      return ptr;
+    }
+    return allocateInNextChunk(size, align);
+  }
+
+  /**
+     Creates an object in the arena.
+  */
+  template<class T>
+  T* create() {
+    return new (allocate(sizeof(T), alignof(T))) T();
+  }
+
+  Marker getMarker() const;
+  void rewind(const Marker& marker);
+  void reset();
+
+  std::size_t getCapacity() const;
+
+  /**
+     Returns the number of scopes of this arena that are open.
+  */
+  std::size_t getDepth() const { return m_depth; }
+
+  static FrameArena& getCurrent();
+
+private:
+  static char* alignPointer(char* ptr, std::size_t align) {
+    return reinterpret_cast<char*>((reinterpret_cast<std::size_t>(ptr) + align - 1)
+				   & ~(align - 1));
+  }
+
+  static char* getEnd(Chunk* chunk);
+  void* allocateInNextChunk(std::size_t size, std::size_t align);
+};
+
+/**
+   An STL allocator that uses a FrameArena.
+
+   The memory is given back to the arena when the current
+   FrameArena::Scope is destroyed, so the container must be destroyed
+   before it. The allocator belongs to the scope that was open when it
+   was created, and it can allocate only while that scope is the
+   youngest one (debug builds assert it). So allocate all the space
+   before calling functions that open scopes (e.g. give the size to
+   the constructor of the vector, or call reserve). A reallocation
+   is not reused until the scope finishes.
+*/
+template<class T>
+class FrameAllocator
+{
+  template<class> friend class FrameAllocator;
+  FrameArena* m_arena;
+  std::size_t m_depth;		// depth of the scope of the allocator
+
+public:
+  typedef T value_type;
+  typedef T* pointer;
+  typedef const T* const_pointer;
+  typedef T& reference;
+  typedef const T& const_reference;
+  typedef std::size_t size_type;
+  typedef std::ptrdiff_t difference_type;
+
+  template<class U>
+  struct rebind { typedef FrameAllocator<U> other; };
+
+  FrameAllocator() : m_arena(&FrameArena::getCurrent()), m_depth(m_arena->getDepth()) { }
+  explicit FrameAllocator(FrameArena& arena) : m_arena(&arena), m_depth(arena.getDepth()) { }
+
+  template<class U>
+  FrameAllocator(const FrameAllocator<U>& other) : m_arena(other.m_arena), m_depth(other.m_depth) { }
+
+  // a copy of a container belongs to the scope where it is created
+  FrameAllocator select_on_container_copy_construction() const {
+    return FrameAllocator(*m_arena);
+  }
+
+  T* allocate(std::size_t n) {
+    assert(m_arena->getDepth() == m_depth &&
+	   "FrameAllocator: the container grows while a younger FrameArena::Scope is open");
+    return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T*, std::size_t) {
+    // the memory is given back by FrameArena::Scope
+  }
+
+  template<class U>
+  bool operator==(const FrameAllocator<U>& other) const { return m_arena == other.m_arena; }
+
+  template<class U>
+  bool operator!=(const FrameAllocator<U>& other) const { return m_arena != other.m_arena; }
+};
+
+} // namespace vaca
+
+#endif // VACA_FRAMEARENA_H
@@ -9,6 +9,7 @@
 
 #include "vaca/base.h"
 #include "vaca/Referenceable.h"
+#include "vaca/SmallObject.h"
 
 #include <cassert>
 
@@ -33,6 +34,10 @@ struct Win32DestroyGdiObject
 /**
    This class is a wrapper for Win32's GDI objects.
 
+   It is a SmallObject, so the wrappers of temporary pens, brushes,
+   regions, etc. (e.g. the ones created in a paint event) are
+   allocated from a per-thread pool instead of the global heap.
+
    @internal
 
    @tparam T
@@ -44,6 +49,7 @@ struct Win32DestroyGdiObject
 */
 template<typename T, class Destroyer = Win32DestroyGdiObject>
 class GdiObject : public Referenceable
+		, public SmallObject
 {
   T m_handle;
 
@@ -138,9 +138,14 @@ Rect Graphics::getClipBounds()
 void Graphics::getClipRegion(Region& rgn)
 {
   assert(m_handle);
-  // TODO Region::assign(const Rect& rc)
-  rgn = Region::fromRect(getClipBounds());
-  GetClipRgn(m_handle, rgn.getHandle());
+
+  HRGN hrgn = CreateRectRgn(0, 0, 0, 0);
+  if (GetClipRgn(m_handle, hrgn) == 1)
+    rgn = Region(hrgn);
+  else {
+    DeleteObject(hrgn);
+    rgn = Region::fromRect(getClipBounds());
+  }
 }
 
 void Graphics::setClipRegion(Region& rgn)
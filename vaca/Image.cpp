@@ -121,6 +121,11 @@ Image::Image(const Image& image)
 {
 }
 
+Image::Image(Image&& image)
+  : SharedPtr<ImageHandle>(std::move(image))
+{
+}
+
 Image::~Image()
 {
 }
@@ -224,6 +229,12 @@ Image& Image::operator=(const Image& image)
   return *this;
 }
 
+Image& Image::operator=(Image&& image)
+{
+  SharedPtr<ImageHandle>::operator=(std::move(image));
+  return *this;
+}
+
 Image Image::clone() const
 {
   Image image(getSize(), getDepth());
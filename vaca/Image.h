@@ -64,6 +64,7 @@ public:
   Image(const Size& sz, int depth);
   Image(const Size& sz, Graphics& g);
   Image(const Image& image);
+  Image(Image&& image);
   virtual ~Image();
 
   bool isValid() const { return get()->isValid(); }
@@ -81,6 +82,7 @@ public:
   HBITMAP getHandle() const;
 
   Image& operator=(const Image& image);
+  Image& operator=(Image&& image);
 
   Image clone() const;
 
@@ -120,10 +120,30 @@ public:
   {
   }
 
+  ImagePixels(const ImagePixels& other)
+    : SharedPtr<ImagePixelsHandle>(other)
+  {
+  }
+
+  ImagePixels(ImagePixels&& other)
+    : SharedPtr<ImagePixelsHandle>(std::move(other))
+  {
+  }
+
   virtual ~ImagePixels()
   {
   }
 
+  ImagePixels& operator=(const ImagePixels& other) {
+    SharedPtr<ImagePixelsHandle>::operator=(other);
+    return *this;
+  }
+
+  ImagePixels& operator=(ImagePixels&& other) {
+    SharedPtr<ImagePixelsHandle>::operator=(std::move(other));
+    return *this;
+  }
+
   ImagePixels clone() const
   {
     ImagePixels copy(getSize());
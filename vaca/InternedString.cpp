@@ -0,0 +1,192 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#include "vaca/InternedString.h"
+#include "vaca/CompactString.h"
+#include "vaca/Mutex.h"
+#include "vaca/ScopedLock.h"
+
+#include <cstring>
+#include <new>
+#include <vector>
+
+using namespace vaca;
+using namespace vaca::details;
+
+namespace {
+
+  // Hash table of all the interned strings (with chaining). Created in
+  // the first use and never deleted, as handles can be destroyed after
+  // static destructors (e.g. static WidgetClassNames).
+  struct InternTable {
+    Mutex mutex;
+    std::vector<InternedStringData*> buckets;
+    std::size_t count;
+
+    InternTable() : buckets(256, static_cast<InternedStringData*>(NULL)), count(0) { }
+
+    InternedStringData*& bucket(std::size_t hash) {
+      return buckets[hash & (buckets.size()-1)];
+    }
+
+    // Removes "data" from its bucket (if it is there)
+    bool unlink(InternedStringData* data) {
+      for (InternedStringData** p = &bucket(data->hash); *p; p = &(*p)->next) {
+	if (*p == data) {
+	  *p = data->next;
+	  --count;
+	  return true;
+	}
+      }
+      return false;
+    }
+
+    void insert(InternedStringData* data) {
+      if (count >= buckets.size())
+	rehash(buckets.size()*2);
+
+      InternedStringData*& head = bucket(data->hash);
+      data->next = head;
+      head = data;
+      ++count;
+    }
+
+    void rehash(std::size_t size) {
+      std::vector<InternedStringData*> old(size, static_cast<InternedStringData*>(NULL));
+      old.swap(buckets);
+
+      for (std::size_t i=0; i<old.size(); ++i) {
+	InternedStringData* data = old[i];
+	while (data) {
+	  InternedStringData* next = data->next;
+	  InternedStringData*& head = bucket(data->hash);
+	  data->next = head;
+	  head = data;
+	  data = next;
+	}
+      }
+    }
+  };
+
+  InternTable& get_table()
+  {
+    static InternTable* table = new InternTable();
+    return *table;
+  }
+
+  // FNV-1a
+  std::size_t hash_chars(const Char* str, std::size_t length)
+  {
+    std::size_t hash = sizeof(std::size_t) == 8 ? static_cast<std::size_t>(14695981039346656037ULL): 2166136261U;
+    std::size_t prime = sizeof(std::size_t) == 8 ? static_cast<std::size_t>(1099511628211ULL): 16777619U;
+    for (std::size_t i=0; i<length; ++i) {
+      hash ^= static_cast<std::size_t>(str[i]);
+      hash *= prime;
+    }
+    return hash;
+  }
+
+  InternedStringData* create_data(StringView str, std::size_t hash)
+  {
+    void* mem = ::operator new(sizeof(InternedStringData) + (str.size()+1)*sizeof(Char));
+    InternedStringData* data = new(mem) InternedStringData();
+    data->hash = hash;
+    data->length = str.size();
+    data->next = NULL;
+    data->refs.ref();
+
+    Char* chars = const_cast<Char*>(data->chars());
+    std::memcpy(chars, str.data(), str.size()*sizeof(Char));
+    chars[str.size()] = 0;
+    return data;
+  }
+
+  void destroy_data(InternedStringData* data)
+  {
+    data->~InternedStringData();
+    ::operator delete(data);
+  }
+
+  InternedStringData* intern(StringView str)
+  {
+    if (str.empty())
+      return NULL;
+
+    std::size_t hash = hash_chars(str.data(), str.size());
+    InternTable& table = get_table();
+    ScopedLock hold(table.mutex);
+
+    for (InternedStringData* data = table.bucket(hash); data; data = data->next) {
+      if (data->hash == hash && StringView(data->chars(), data->length) == str) {
+	if (data->refs.tryRef())
+	  return data;
+
+	// The last handle of "data" is being destroyed in other thread
+	// (waiting the mutex to remove it), we replace it with a new one
+	table.unlink(data);
+	break;
+      }
+    }
+
+    InternedStringData* data = create_data(str, hash);
+    table.insert(data);
+    return data;
+  }
+
+}
+
+InternedString::InternedString(const Char* str)
+  : m_data(intern(StringView(str)))
+{
+}
+
+InternedString::InternedString(const String& str)
+  : m_data(intern(StringView(str)))
+{
+}
+
+InternedString::InternedString(StringView str)
+  : m_data(intern(str))
+{
+}
+
+/**
+   Interns the text of a CompactString. Short texts are converted in
+   the stack (a String is created only for long ones).
+*/
+InternedString::InternedString(const CompactString& str)
+{
+  Char buf[64];
+  std::size_t len = str.copyTo(buf, 64);
+  if (len < 64)
+    m_data = intern(StringView(buf, len));
+  else
+    m_data = intern(StringView(str.str()));
+}
+
+/**
+   Returns the number of different strings in the table (for
+   debugging purposes).
+*/
+std::size_t InternedString::getInternedCount()
+{
+  InternTable& table = get_table();
+  ScopedLock hold(table.mutex);
+  return table.count;
+}
+
+void InternedString::release()
+{
+  if (m_data->refs.unref() == 0) {
+    {
+      InternTable& table = get_table();
+      ScopedLock hold(table.mutex);
+      table.unlink(m_data);
+    }
+    destroy_data(m_data);
+  }
+  m_data = NULL;
+}
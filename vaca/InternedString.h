@@ -0,0 +1,152 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#ifndef VACA_INTERNEDSTRING_H
+#define VACA_INTERNEDSTRING_H
+
+#include "vaca/base.h"
+#include "vaca/Referenceable.h"
+#include "vaca/StringView.h"
+
+#include <cstddef>
+#include <functional>
+
+namespace vaca {
+
+namespace details {
+
+  /**
+     @internal
+     Immutable characters of an InternedString, shared by all the
+     handles with the same text. The characters are allocated with
+     the structure (after it).
+  */
+  struct InternedStringData
+  {
+    AtomicRefCount refs;
+    std::size_t hash;
+    std::size_t length;
+    InternedStringData* next;	// next data in the same bucket of the table
+
+    const Char* chars() const {
+      return reinterpret_cast<const Char*>(this+1);
+    }
+  };
+
+}
+
+/**
+   A handle to an immutable string stored only once in the process.
+
+   All the InternedStrings with the same text point to the same
+   reference-counted buffer, so a handle has the size of a pointer,
+   copying it does not allocate memory, and comparing two handles or
+   getting the hash of one takes constant time. It is useful for texts
+   that are repeated a lot (like the labels of menus and list views,
+   or the names of widget classes).
+
+   Creating a handle from a string looks for the text in a global
+   table protected by a mutex, so InternedStrings can be created and
+   destroyed from any thread. The buffer is removed from the table
+   when its last handle is destroyed.
+
+   @code
+   InternedString a(L"Name"), b(String(L"Name"));
+   assert(a == b);		// the same buffer
+   assert(a.c_str() == b.c_str());
+   @endcode
+*/
+class VACA_DLL InternedString
+{
+  details::InternedStringData* m_data; // NULL for the empty string
+
+public:
+
+  InternedString() : m_data(NULL) { }
+  explicit InternedString(const Char* str);
+  explicit InternedString(const String& str);
+  explicit InternedString(StringView str);
+  explicit InternedString(const CompactString& str);
+
+  InternedString(const InternedString& other) : m_data(other.m_data) {
+    if (m_data)
+      m_data->refs.ref();
+  }
+
+  InternedString(InternedString&& other) : m_data(other.m_data) {
+    other.m_data = NULL;
+  }
+
+  ~InternedString() {
+    if (m_data)
+      release();
+  }
+
+  InternedString& operator=(const InternedString& other) {
+    InternedString(other).swap(*this);
+    return *this;
+  }
+
+  InternedString& operator=(InternedString&& other) {
+    InternedString(static_cast<InternedString&&>(other)).swap(*this);
+    return *this;
+  }
+
+  void swap(InternedString& other) {
+    details::InternedStringData* tmp = m_data;
+    m_data = other.m_data;
+    other.m_data = tmp;
+  }
+
+  bool empty() const { return m_data == NULL; }
+  std::size_t size() const { return m_data ? m_data->length: 0; }
+
+  /**
+     Returns the characters (with a null character at the end). The
+     pointer is valid while there is a handle with the same text.
+  */
+  const Char* c_str() const { return m_data ? m_data->chars(): L""; }
+
+  StringView view() const { return StringView(c_str(), size()); }
+  String str() const { return String(c_str(), size()); }
+
+  /**
+     Returns the hash of the text (it is calculated only once, when the
+     text is added to the table).
+  */
+  std::size_t hash() const { return m_data ? m_data->hash: 0; }
+
+  bool operator==(const InternedString& other) const { return m_data == other.m_data; }
+  bool operator!=(const InternedString& other) const { return m_data != other.m_data; }
+
+  /**
+     Compares the texts (alphabetically), so it can be used as key of
+     sorted containers.
+  */
+  bool operator<(const InternedString& other) const {
+    return m_data != other.m_data && view() < other.view();
+  }
+
+  static std::size_t getInternedCount();
+
+private:
+  void release();
+};
+
+} // namespace vaca
+
+namespace std {
+
+  template<>
+  struct hash<vaca::InternedString> {
+    std::size_t operator()(const vaca::InternedString& str) const {
+      return str.hash();
+    }
+  };
+
+}
+
+#endif // VACA_INTERNEDSTRING_H
@@ -29,13 +29,15 @@ Size Layout::getPreferredSize(Widget* parent, WidgetList& widgets, const Size& f
 #include "win32/WidgetsMovementImpl.h"
 
 WidgetsMovement::WidgetsMovement(const WidgetList& widgets)
-  : m_impl(new WidgetsMovementImpl(widgets))
+  : m_impl(new (FrameArena::getCurrent().allocate(sizeof(WidgetsMovementImpl)))
+	   WidgetsMovementImpl(widgets))
 {
 }
 
 WidgetsMovement::~WidgetsMovement()
 {
-  delete m_impl;
+  // the memory is given back to the arena by m_scope
+  m_impl->~WidgetsMovementImpl();
 }
 
 void WidgetsMovement::moveWidget(Widget* widget, const Rect& rc)
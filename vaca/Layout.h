@@ -8,6 +8,7 @@
 #define VACA_LAYOUT_H
 
 #include "vaca/base.h"
+#include "vaca/FrameArena.h"
 #include "vaca/Size.h"
 #include "vaca/Referenceable.h"
 #include "vaca/WidgetList.h"
@@ -40,6 +41,8 @@ public:
 
 /**
    Auxiliary class to move widgets inside onLayout() method.
+
+   Its implementation is allocated in the FrameArena of the thread.
  */
 class VACA_DLL WidgetsMovement
 {
@@ -51,6 +54,7 @@ public:
 
 private:
   class WidgetsMovementImpl;
+  FrameArena::Scope m_scope;
   WidgetsMovementImpl* m_impl;
 };
 
@@ -9,6 +9,7 @@
 
 #include "vaca/base.h"
 #include "vaca/Component.h"
+#include "vaca/InternedString.h"
 
 namespace vaca {
 
@@ -20,7 +21,7 @@ class VACA_DLL ListColumn : public Component
   friend class ListView;
 
   int		m_index;
-  String	m_text;
+  InternedString m_text;
   TextAlign	m_textAlign;
   int		m_width;
   ListView*	m_owner;
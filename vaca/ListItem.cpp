@@ -13,7 +13,7 @@ using namespace vaca;
 
 ListItem::ListItem(const String& text, int imageIndex)
 {
-  m_text.push_back(text);
+  m_text.push_back(InternedString(text));
   m_image = imageIndex;
   m_index = -1;
   m_owner = NULL;
@@ -43,7 +43,7 @@ String ListItem::getText(size_t columnIndex)
   assert(columnIndex >= 0);
 
   if (columnIndex < m_text.size())
-    return m_text[columnIndex];
+    return m_text[columnIndex].str();
   else
     return L"";
 }
@@ -77,7 +77,7 @@ void ListItem::setText(const String& text, size_t columnIndex)
   if (columnIndex >= m_text.size())
     m_text.resize(columnIndex+1);
 
-  m_text[columnIndex] = text;
+  m_text[columnIndex] = InternedString(text);
 }
 
 void ListItem::setImage(int image)
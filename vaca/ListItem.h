@@ -9,6 +9,7 @@
 
 #include "vaca/base.h"
 #include "vaca/Component.h"
+#include "vaca/InternedString.h"
 
 #include <vector>
 
@@ -22,7 +23,7 @@ class VACA_DLL ListItem : public Component
   friend class ListView;
 
   int			m_index;
-  std::vector<String>	m_text;
+  std::vector<InternedString> m_text;
   int			m_image;
   ListView*		m_owner;
 
@@ -47,7 +47,23 @@ MenuItem::MenuItem()
 MenuItem::MenuItem(const String& text, CommandId id, Keys::Type defaultShortcut)
 {
   m_parent = NULL;
-  m_text = text;
+  m_text = InternedString(text);
+  m_id = id;
+  m_enabled = true;
+  m_checked = false;
+
+  if (defaultShortcut != Keys::None)
+    addShortcut(defaultShortcut);
+}
+
+/**
+   Creates a new menu item with a CompactString (the text is converted
+   when the item is created, see InternedString).
+*/
+MenuItem::MenuItem(const CompactString& text, CommandId id, Keys::Type defaultShortcut)
+{
+  m_parent = NULL;
+  m_text = InternedString(text);
   m_id = id;
   m_enabled = true;
   m_checked = false;
@@ -83,21 +99,32 @@ CommandId MenuItem::getId()
   return m_id;
 }
 
-const String& MenuItem::getText() const
+String MenuItem::getText() const
 {
-  return m_text;
+  return m_text.str();
 }
 
 void MenuItem::setText(const String& text)
 {
-  m_text = text;
+  m_text = InternedString(text);
+  updateText();
+}
+
+void MenuItem::setText(const CompactString& text)
+{
+  m_text = InternedString(text);
+  updateText();
+}
 
+// Changes the text of the Win32 menu item
+void MenuItem::updateText()
+{
   if (m_parent != NULL) {
     MENUITEMINFO mii;
 
     mii.cbSize = sizeof(MENUITEMINFO);
     mii.fMask = MIIM_STRING;
-    mii.dwTypeData = const_cast<LPTSTR>(text.c_str());
+    mii.dwTypeData = const_cast<LPTSTR>(m_text.c_str());
 
     SetMenuItemInfo(m_parent->getHandle(),
 		    m_parent->getMenuItemIndex(this),
@@ -392,7 +419,7 @@ void Menu::subClass()
       case MFT_STRING:
 	if (mii.hSubMenu != NULL) {
 	  menuItem = new Menu(mii.hSubMenu);
-	  menuItem->m_text = buf;
+	  menuItem->m_text = InternedString(buf);
 	}
 	else {
 	  menuItem = new MenuItem(buf, mii.wID, Keys::None);
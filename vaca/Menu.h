@@ -10,6 +10,7 @@
 #include "vaca/base.h"
 #include "vaca/Component.h"
 #include "vaca/Event.h"
+#include "vaca/InternedString.h"
 #include "vaca/Keys.h"
 
 #include <vector>
@@ -27,7 +28,7 @@ class VACA_DLL MenuItem : public Component
   friend class Menu;
 
   Menu* m_parent;
-  String m_text;
+  InternedString m_text;
   CommandId m_id;
   std::vector<Keys::Type> m_shortcuts;
   bool m_enabled : 1;
@@ -37,14 +38,16 @@ public:
 
   MenuItem();
   MenuItem(const String& text, CommandId id, Keys::Type defaultShortcut = Keys::None);
+  MenuItem(const CompactString& text, CommandId id, Keys::Type defaultShortcut = Keys::None);
   virtual ~MenuItem();
 
   Menu* getParent();
   Menu* getRoot();
   CommandId getId();
 
-  const String& getText() const;
+  String getText() const;
   void setText(const String& text);
+  void setText(const CompactString& text);
   void setId(CommandId id);
 
   bool isEnabled();
@@ -70,6 +73,7 @@ protected:
   virtual void onUpdate(MenuItemEvent& ev);
 
 private:
+  void updateText();
   void updateFromCommand(Command* cmd);
 };
 
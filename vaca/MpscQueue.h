@@ -0,0 +1,189 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#ifndef VACA_MPSCQUEUE_H
+#define VACA_MPSCQUEUE_H
+
+#include "vaca/base.h"
+#include "vaca/NonCopyable.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace vaca {
+
+/**
+   A bounded lock-free queue for multiple producers and one consumer.
+
+   Any thread can #push elements, but only one thread (the owner of
+   the queue) can #pop them. Elements are constructed in place inside
+   a ring buffer allocated once in the constructor, so pushing and
+   popping do not allocate memory nor call the operating system.
+
+   When the queue is full #push returns false and the element is not
+   added, the producer decides what to do (wait, drop, etc.).
+
+   It is the classic array-based queue where each cell has a sequence
+   number that tells to producers and the consumer if the cell is free
+   or full.
+
+   @see QueuedSignal
+*/
+template<typename T>
+class MpscQueue : private NonCopyable
+{
+  struct Cell
+  {
+    std::atomic<std::size_t> sequence;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type data;
+
+    T* get() { return reinterpret_cast<T*>(&data); }
+  };
+
+  enum { CacheLineSize = 64 };
+
+  Cell* m_cells;
+  std::size_t m_mask;
+  char m_pad0[CacheLineSize];
+  std::atomic<std::size_t> m_pushPos;
+  char m_pad1[CacheLineSize];
+  std::size_t m_popPos;		// only used by the consumer
+
+public:
+
+  /**
+     Creates a queue that can hold up to @a capacity elements.
+
+     @a capacity is rounded up to the next power of two.
+  */
+  explicit MpscQueue(std::size_t capacity)
+    : m_pushPos(0)
+    , m_popPos(0)
+  {
+    std::size_t size = 2;
+    while (size < capacity)
+      size <<= 1;
+
+    m_cells = new Cell[size];
+    m_mask = size - 1;
+
+    for (std::size_t i=0; i<size; ++i)
+      m_cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  ~MpscQueue()
+  {
+    // destroy elements that were not consumed
+    while (pop(NullConsumer()))
+      ;
+    delete[] m_cells;
+  }
+
+  std::size_t getCapacity() const
+  {
+    return m_mask + 1;
+  }
+
+  /**
+     Constructs a new element at the end of the queue with the given
+     arguments.
+
+     It can be called from any thread.
+
+     @return False if the queue is full.
+  */
+  template<typename... A>
+  bool push(A&&... args)
+  {
+    Cell* cell;
+    std::size_t pos = m_pushPos.load(std::memory_order_relaxed);
+
+    for (;;) {
+      cell = &m_cells[pos & m_mask];
+      std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+      std::ptrdiff_t diff = (std::ptrdiff_t)seq - (std::ptrdiff_t)pos;
+
+      if (diff == 0) {
+	// the cell is free, try to reserve it
+	if (m_pushPos.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed))
+	  break;
+      }
+      else if (diff < 0) {
+	// the consumer has not released this cell yet: the queue is full
+	return false;
+      }
+      else
+	pos = m_pushPos.load(std::memory_order_relaxed);
+    }
+
+    new (cell->get()) T(std::forward<A>(args)...);
+    cell->sequence.store(pos+1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+     Removes the first element of the queue calling @a f with it.
+
+     It can be called only from the consumer thread.
+
+     @return False if the queue is empty (or the next element is still
+	     being constructed by a producer).
+  */
+  template<typename F>
+  bool pop(F f)
+  {
+    Cell* cell = &m_cells[m_popPos & m_mask];
+    std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+
+    if ((std::ptrdiff_t)seq - (std::ptrdiff_t)(m_popPos+1) < 0)
+      return false;
+
+    T* elem = cell->get();
+    try {
+      f(*elem);
+    }
+    catch (...) {
+      release(cell, elem);
+      throw;
+    }
+    release(cell, elem);
+    return true;
+  }
+
+  /**
+     Returns true if there are no elements to pop.
+
+     It can be called only from the consumer thread.
+  */
+  bool empty() const
+  {
+    const Cell* cell = &m_cells[m_popPos & m_mask];
+    std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+    return (std::ptrdiff_t)seq - (std::ptrdiff_t)(m_popPos+1) < 0;
+  }
+
+private:
+
+  struct NullConsumer {
+    void operator()(T&) const { }
+  };
+
+  void release(Cell* cell, T* elem)
+  {
+    elem->~T();
+    cell->sequence.store(m_popPos + m_mask + 1, std::memory_order_release);
+    ++m_popPos;
+  }
+
+};
+
+} // namespace vaca
+
+#endif // VACA_MPSCQUEUE_H
@@ -13,38 +13,55 @@ namespace vaca {
 
 /**
    A 2D coordinate in the screen or client area of a widget.
+
+   It is a literal type defined completely in this header (so the
+   operations are inlined in the loops of the layout managers) and it
+   can be used in constant expressions:
+
+   @code
+   constexpr Point origin(4, 4);
+   static_assert((origin + Point(2, 0)).x == 6, "");
+   @endcode
 */
-class VACA_DLL Point
+class Point
 {
 public:
 
   int x, y;
 
-  Point();
-  Point(int x, int y);
-  Point(const Point& point);
-  explicit Point(const Size& size);
-
-  const Point& operator=(const Point& pt);
-  const Point& operator+=(const Point& pt);
-  const Point& operator-=(const Point& pt);
-  const Point& operator+=(int value);
-  const Point& operator-=(int value);
-  const Point& operator*=(int value);
-  const Point& operator/=(int value);
-  Point operator+(const Point& pt) const;
-  Point operator-(const Point& pt) const;
-  Point operator+(int value) const;
-  Point operator-(int value) const;
-  Point operator*(int value) const;
-  Point operator/(int value) const;
-  Point operator-() const;
-
-  bool operator==(const Point& pt) const;
-  bool operator!=(const Point& pt) const;
+  constexpr Point() noexcept : x(0), y(0) { }
+  constexpr Point(int x, int y) noexcept : x(x), y(y) { }
+  constexpr explicit Point(const Size& size) noexcept;
+
+  Point& operator+=(const Point& pt) noexcept { x += pt.x; y += pt.y; return *this; }
+  Point& operator-=(const Point& pt) noexcept { x -= pt.x; y -= pt.y; return *this; }
+  Point& operator+=(int value) noexcept { x += value; y += value; return *this; }
+  Point& operator-=(int value) noexcept { x -= value; y -= value; return *this; }
+  Point& operator*=(int value) noexcept { x *= value; y *= value; return *this; }
+  Point& operator/=(int value) noexcept { x /= value; y /= value; return *this; }
+
+  constexpr Point operator+(const Point& pt) const noexcept { return Point(x+pt.x, y+pt.y); }
+  constexpr Point operator-(const Point& pt) const noexcept { return Point(x-pt.x, y-pt.y); }
+  constexpr Point operator+(int value) const noexcept { return Point(x+value, y+value); }
+  constexpr Point operator-(int value) const noexcept { return Point(x-value, y-value); }
+  constexpr Point operator*(int value) const noexcept { return Point(x*value, y*value); }
+  constexpr Point operator/(int value) const noexcept { return Point(x/value, y/value); }
+  constexpr Point operator-() const noexcept { return Point(-x, -y); }
+
+  constexpr bool operator==(const Point& pt) const noexcept { return x == pt.x && y == pt.y; }
+  constexpr bool operator!=(const Point& pt) const noexcept { return x != pt.x || y != pt.y; }
 
 };
 
 } // namespace vaca
 
+// Size and Point need each other to be complete
+#include "vaca/Size.h"
+
+namespace vaca {
+
+constexpr Point::Point(const Size& size) noexcept : x(size.w), y(size.h) { }
+
+} // namespace vaca
+
 #endif // VACA_POINT_H
@@ -0,0 +1,309 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#include "vaca/PrefixIndex.h"
+
+#include <algorithm>
+#include <cassert>
+#include <queue>
+
+using namespace vaca;
+
+namespace {
+
+  // Compares the first characters of a folded string with a prefix
+  // (from the character "from", the previous ones are known to be
+  // equal). A string shorter than the prefix goes before it.
+  int compare_prefix(StringView key, StringView prefix, std::size_t from)
+  {
+    for (std::size_t i=from; i<prefix.size(); ++i) {
+      if (i >= key.size())
+	return -1;
+
+      Char a = key[i];
+      Char b = PrefixIndex::foldCase(prefix[i]);
+      if (a != b)
+	return a < b ? -1: 1;
+    }
+    return 0;
+  }
+
+  struct SortedByText {
+    const std::vector<Char>* folded;
+    const std::vector<std::size_t>* offsets;
+
+    StringView text(int id) const {
+      const std::size_t* o = &(*offsets)[id];
+      return StringView(folded->data() + o[0], o[1] - o[0]);
+    }
+
+    bool operator()(int a, int b) const {
+      int res = text(a).compare(text(b));
+      return res < 0 || (res == 0 && a < b);
+    }
+  };
+
+}
+
+// ======================================================================
+// PrefixIndex::Search
+
+PrefixIndex::Search::Search(const PrefixIndex& index)
+  : m_index(&index)
+  , m_range(0, index.size())
+{
+}
+
+/**
+   Finds the strings that start with @a prefix. If the previous prefix
+   is a prefix of the new one, only the previous range is searched.
+*/
+void PrefixIndex::Search::setPrefix(StringView prefix)
+{
+  bool extends = (m_prefix.size() <= prefix.size());
+  for (std::size_t i=0; extends && i<m_prefix.size(); ++i)
+    extends = (m_prefix[i] == foldCase(prefix[i]));
+
+  if (extends)
+    m_range = m_index->find(prefix, m_range, m_prefix.size());
+  else
+    m_range = m_index->find(prefix);
+
+  m_prefix.resize(prefix.size());
+  for (std::size_t i=0; i<prefix.size(); ++i)
+    m_prefix[i] = foldCase(prefix[i]);
+}
+
+/**
+   Goes back to the empty prefix (all the strings).
+*/
+void PrefixIndex::Search::reset()
+{
+  m_prefix.clear();
+  m_range = Range(0, m_index->size());
+}
+
+// ======================================================================
+// PrefixIndex
+
+PrefixIndex::PrefixIndex()
+{
+  m_offsets.push_back(0);
+}
+
+/**
+   Adds a string to the index. You have to call #build after adding
+   strings and before searching.
+
+   @param text The string.
+   @param rank Higher ranks go first in #getTopMatches.
+
+   @return The ID of the string (0 for the first added string, 1 for
+	   the second one, etc.).
+*/
+int PrefixIndex::add(StringView text, int rank)
+{
+  m_chars.insert(m_chars.end(), text.begin(), text.end());
+  for (StringView::iterator it = text.begin(); it != text.end(); ++it)
+    m_folded.push_back(foldCase(*it));
+  m_offsets.push_back(m_chars.size());
+  m_ranks.push_back(rank);
+  return static_cast<int>(m_ranks.size()-1);
+}
+
+/**
+   Sorts the strings. It takes O(n log n) time.
+*/
+void PrefixIndex::build()
+{
+  std::size_t n = size();
+
+  m_sorted.resize(n);
+  for (std::size_t i=0; i<n; ++i)
+    m_sorted[i] = static_cast<int>(i);
+
+  if (n > 0) {
+    SortedByText pred = { &m_folded, &m_offsets };
+    std::sort(m_sorted.begin(), m_sorted.end(), pred);
+  }
+
+  // the leaves of the segment tree are in [leaves, 2*leaves)
+  std::size_t leaves = 1;
+  while (leaves < n)
+    leaves *= 2;
+
+  m_best.assign(2*leaves, -1);
+  for (std::size_t i=0; i<n; ++i)
+    m_best[leaves+i] = static_cast<int>(i);
+  for (std::size_t i=leaves-1; i>0; --i) {
+    int a = m_best[2*i], b = m_best[2*i+1];
+    m_best[i] = (b >= 0 && (a < 0 || isBetter(b, a))) ? b: a;
+  }
+}
+
+void PrefixIndex::clear()
+{
+  m_chars.clear();
+  m_folded.clear();
+  m_offsets.assign(1, 0);
+  m_ranks.clear();
+  m_sorted.clear();
+  m_best.clear();
+}
+
+/**
+   Returns the string with the given ID. The view is valid until a new
+   string is added.
+*/
+StringView PrefixIndex::getText(int id) const
+{
+  assert(id >= 0 && id < static_cast<int>(size()));
+  const std::size_t* o = &m_offsets[id];
+  return StringView(m_chars.data() + o[0], o[1] - o[0]);
+}
+
+StringView PrefixIndex::getFoldedText(int id) const
+{
+  const std::size_t* o = &m_offsets[id];
+  return StringView(m_folded.data() + o[0], o[1] - o[0]);
+}
+
+/**
+   Returns the positions of the strings that start with @a prefix.
+*/
+PrefixIndex::Range PrefixIndex::find(StringView prefix) const
+{
+  return find(prefix, Range(0, m_sorted.size()), 0);
+}
+
+/**
+   Returns the positions of the strings that start with @a prefix
+   inside @a range, when all the strings in the range are known to
+   start with the first @a knownLength characters of @a prefix.
+*/
+PrefixIndex::Range PrefixIndex::find(StringView prefix, Range range, std::size_t knownLength) const
+{
+  assert(m_sorted.size() == size()); // did you call build()?
+
+  if (knownLength >= prefix.size())
+    return range;
+
+  // first string that is not less than the prefix
+  std::size_t lo = range.first, hi = range.last;
+  while (lo < hi) {
+    std::size_t mid = lo + (hi - lo) / 2;
+    if (compare_prefix(getFoldedText(m_sorted[mid]), prefix, knownLength) < 0)
+      lo = mid+1;
+    else
+      hi = mid;
+  }
+  std::size_t first = lo;
+
+  // first string that is greater than the prefix
+  hi = range.last;
+  while (lo < hi) {
+    std::size_t mid = lo + (hi - lo) / 2;
+    if (compare_prefix(getFoldedText(m_sorted[mid]), prefix, knownLength) <= 0)
+      lo = mid+1;
+    else
+      hi = mid;
+  }
+
+  return Range(first, lo);
+}
+
+namespace {
+
+  struct Candidate {
+    std::size_t best, first, last;
+  };
+
+  struct WorseCandidate {
+    const std::vector<int>* ranks;
+    const std::vector<int>* sorted;
+
+    bool operator()(const Candidate& a, const Candidate& b) const {
+      int ra = (*ranks)[(*sorted)[a.best]];
+      int rb = (*ranks)[(*sorted)[b.best]];
+      return ra < rb || (ra == rb && a.best > b.best);
+    }
+  };
+
+}
+
+/**
+   Adds to @a ids the IDs of the @a k strings in @a range with the
+   highest rank (from the highest to the lowest, and alphabetically if
+   they have the same rank).
+*/
+void PrefixIndex::getTopMatches(Range range, std::size_t k, std::vector<int>& ids) const
+{
+  if (range.empty() || k == 0)
+    return;
+
+  WorseCandidate pred = { &m_ranks, &m_sorted };
+  std::priority_queue<Candidate, std::vector<Candidate>, WorseCandidate> queue(pred);
+  Candidate c = { getBest(range.first, range.last), range.first, range.last };
+  queue.push(c);
+
+  while (!queue.empty() && k > 0) {
+    c = queue.top();
+    queue.pop();
+    ids.push_back(m_sorted[c.best]);
+    --k;
+
+    // the rest of the range is split in two parts
+    if (c.first < c.best) {
+      Candidate left = { getBest(c.first, c.best), c.first, c.best };
+      queue.push(left);
+    }
+    if (c.best+1 < c.last) {
+      Candidate right = { getBest(c.best+1, c.last), c.best+1, c.last };
+      queue.push(right);
+    }
+  }
+}
+
+/**
+   Returns @a chr in lower case. Only ASCII and Latin-1 letters are
+   converted, so the result does not depend on the C locale.
+*/
+Char PrefixIndex::foldCase(Char chr)
+{
+  if ((chr >= L'A' && chr <= L'Z') ||
+      (chr >= 0xC0 && chr <= 0xDE && chr != 0xD7))
+    return chr + 32;
+  else
+    return chr;
+}
+
+// Returns the position in [first, last) of the string with the highest rank
+std::size_t PrefixIndex::getBest(std::size_t first, std::size_t last) const
+{
+  std::size_t leaves = m_best.size() / 2;
+  int best = -1;
+
+  for (std::size_t lo = first+leaves, hi = last+leaves; lo < hi; lo /= 2, hi /= 2) {
+    if (lo & 1) {
+      int b = m_best[lo++];
+      if (best < 0 || isBetter(b, best))
+	best = b;
+    }
+    if (hi & 1) {
+      int b = m_best[--hi];
+      if (best < 0 || isBetter(b, best))
+	best = b;
+    }
+  }
+  return static_cast<std::size_t>(best);
+}
+
+bool PrefixIndex::isBetter(std::size_t a, std::size_t b) const
+{
+  int ra = m_ranks[m_sorted[a]];
+  int rb = m_ranks[m_sorted[b]];
+  return ra > rb || (ra == rb && a < b);
+}
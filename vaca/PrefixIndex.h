@@ -0,0 +1,117 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#ifndef VACA_PREFIXINDEX_H
+#define VACA_PREFIXINDEX_H
+
+#include "vaca/base.h"
+#include "vaca/StringView.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace vaca {
+
+/**
+   An index of strings to find the ones that start with a prefix (e.g.
+   for auto-completion).
+
+   The strings are stored in a sorted array (in only two blocks of
+   characters, without a String for each one), so a prefix is found
+   with a binary search in O(m log n) time. The comparisons ignore the
+   case of letters (see #foldCase).
+
+   Each string has an ID (the order in which it was added) and a rank.
+   You can get the matches with the highest rank in O(k log n) time,
+   whatever the number of strings that match the prefix is.
+
+   @code
+   PrefixIndex index;
+   index.add(L"Blue", 10);	// ID 0
+   index.add(L"black", 20);	// ID 1
+   index.add(L"red", 30);	// ID 2
+   index.build();
+
+   PrefixIndex::Search search(index);
+   search.setPrefix(L"b");	// "black" and "Blue"
+   search.setPrefix(L"bl");	// narrows the previous result
+   std::vector<int> ids;
+   index.getTopMatches(search.getRange(), 1, ids); // ids = { 1 }
+   @endcode
+*/
+class VACA_DLL PrefixIndex
+{
+public:
+
+  /**
+     A range [first, last) of positions in the sorted list of strings.
+  */
+  struct Range {
+    std::size_t first, last;
+
+    Range() : first(0), last(0) { }
+    Range(std::size_t first, std::size_t last) : first(first), last(last) { }
+
+    std::size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+  };
+
+  /**
+     Finds a prefix narrowing the result of the previous prefix when it
+     is extended (e.g. when the user types one more character).
+  */
+  class VACA_DLL Search
+  {
+    const PrefixIndex* m_index;
+    String m_prefix;		// folded prefix of m_range
+    Range m_range;
+
+  public:
+    explicit Search(const PrefixIndex& index);
+
+    void setPrefix(StringView prefix);
+    void reset();
+
+    const Range& getRange() const { return m_range; }
+  };
+
+private:
+  std::vector<Char> m_chars;	// all the strings
+  std::vector<Char> m_folded;	// all the strings with foldCase
+  std::vector<std::size_t> m_offsets; // beginning of each string (and the end of the last one)
+  std::vector<int> m_ranks;
+  std::vector<int> m_sorted;	// IDs sorted by m_folded
+  std::vector<int> m_best;	// segment tree with the position of highest rank in each range
+
+public:
+
+  PrefixIndex();
+
+  int add(StringView text, int rank = 0);
+  void build();
+  void clear();
+
+  std::size_t size() const { return m_ranks.size(); }
+
+  StringView getText(int id) const;
+  int getRank(int id) const { return m_ranks[id]; }
+  int getId(std::size_t position) const { return m_sorted[position]; }
+
+  Range find(StringView prefix) const;
+  Range find(StringView prefix, Range range, std::size_t knownLength) const;
+  void getTopMatches(Range range, std::size_t k, std::vector<int>& ids) const;
+
+  static Char foldCase(Char chr);
+
+private:
+  StringView getFoldedText(int id) const;
+  std::size_t getBest(std::size_t first, std::size_t last) const;
+  bool isBetter(std::size_t a, std::size_t b) const;
+};
+
+} // namespace vaca
+
+#endif // VACA_PREFIXINDEX_H
@@ -0,0 +1,247 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#include "vaca/Profiling.h"
+#include "vaca/Mutex.h"
+#include "vaca/ScopedLock.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <vector>
+
+using namespace vaca;
+using namespace vaca::profiling;
+
+namespace {
+
+  typedef std::map<std::string, SignalStats*> StatsMap;
+
+  // Function-local statics, so signals of global objects can be named
+  // before this file is initialized. Statistics are never deleted:
+  // signals keep pointers to them.
+  Mutex& get_mutex()
+  {
+    static Mutex mutex;
+    return mutex;
+  }
+
+  StatsMap& get_stats()
+  {
+    static StatsMap* stats = new StatsMap;
+    return *stats;
+  }
+
+  struct ByTotalTime {
+    bool operator()(const SignalStats* a, const SignalStats* b) const {
+      return a->getTotalNanos() > b->getTotalNanos();
+    }
+  };
+
+  std::string json_string(const std::string& s)
+  {
+    std::string res = "\"";
+    for (std::string::const_iterator it = s.begin(); it != s.end(); ++it) {
+      if (*it == '"' || *it == '\\')
+	res.push_back('\\');
+      res.push_back(*it);
+    }
+    res.push_back('"');
+    return res;
+  }
+
+  void append_format(std::string& out, const char* fmt, ...)
+  {
+    char buf[512];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    out += buf;
+  }
+
+  void dump_text(std::string& out, const std::vector<SignalStats*>& stats)
+  {
+    append_format(out, "%-32s %10s %10s %12s %10s %10s %10s %10s\n",
+		  "Signal", "Emits", "Calls", "Total ms",
+		  "Mean us", "p50 us", "p99 us", "Max us");
+
+    for (std::vector<SignalStats*>::const_iterator
+	   it = stats.begin(), end = stats.end(); it != end; ++it) {
+      const SignalStats* s = *it;
+      unsigned long long calls = s->getSlotCalls();
+      double total = (double)s->getTotalNanos();
+
+      append_format(out, "%-32s %10llu %10llu %12.3f %10.3f %10.3f %10.3f %10.3f\n",
+		    s->getName().c_str(),
+		    s->getEmits(),
+		    calls,
+		    total / 1e6,
+		    calls > 0 ? total / calls / 1e3: 0.0,
+		    s->getPercentileNanos(0.50) / 1e3,
+		    s->getPercentileNanos(0.99) / 1e3,
+		    s->getMaxNanos() / 1e3);
+    }
+  }
+
+  void dump_json(std::string& out, const std::vector<SignalStats*>& stats)
+  {
+    out += "{\"signals\":[";
+    for (std::vector<SignalStats*>::const_iterator
+	   it = stats.begin(), end = stats.end(); it != end; ++it) {
+      const SignalStats* s = *it;
+      if (it != stats.begin())
+	out += ",";
+
+      out += "{\"name\":" + json_string(s->getName());
+      append_format(out, ",\"emits\":%llu,\"slot_calls\":%llu,\"total_ns\":%llu,\"max_ns\":%llu",
+		    s->getEmits(), s->getSlotCalls(),
+		    s->getTotalNanos(), s->getMaxNanos());
+
+      // only the buckets that are not empty: [upper bound in ns, count]
+      out += ",\"histogram\":[";
+      bool first = true;
+      for (int i=0; i<SignalStats::Buckets; ++i) {
+	unsigned long long count = s->getBucket(i);
+	if (count == 0)
+	  continue;
+	append_format(out, "%s[%llu,%llu]", first ? "": ",", 1ull << i, count);
+	first = false;
+      }
+      out += "]}";
+    }
+    out += "]}\n";
+  }
+
+}
+
+SignalStats::SignalStats(const std::string& name)
+  : m_name(name)
+  , m_emits(0)
+  , m_slotCalls(0)
+  , m_totalNanos(0)
+  , m_maxNanos(0)
+{
+  for (int i=0; i<Buckets; ++i)
+    m_histogram[i].store(0, std::memory_order_relaxed);
+}
+
+void SignalStats::addSlotCall(unsigned long long nanos)
+{
+  m_slotCalls.fetch_add(1, std::memory_order_relaxed);
+  m_totalNanos.fetch_add(nanos, std::memory_order_relaxed);
+  m_histogram[getBucketIndex(nanos)].fetch_add(1, std::memory_order_relaxed);
+
+  unsigned long long max = m_maxNanos.load(std::memory_order_relaxed);
+  while (nanos > max &&
+	 !m_maxNanos.compare_exchange_weak(max, nanos, std::memory_order_relaxed))
+    ;
+}
+
+/**
+   Returns an upper bound of the time (in nanoseconds) that takes the
+   given @a percentile (from 0.0 to 1.0) of slot calls.
+*/
+unsigned long long SignalStats::getPercentileNanos(double percentile) const
+{
+  unsigned long long calls = 0;
+  for (int i=0; i<Buckets; ++i)
+    calls += getBucket(i);
+  if (calls == 0)
+    return 0;
+
+  unsigned long long target = (unsigned long long)(percentile * calls + 0.5);
+  if (target < 1)
+    target = 1;
+
+  unsigned long long accum = 0;
+  for (int i=0; i<Buckets; ++i) {
+    accum += getBucket(i);
+    if (accum >= target)
+      return std::min(1ull << i, getMaxNanos());
+  }
+  return getMaxNanos();
+}
+
+void SignalStats::reset()
+{
+  m_emits.store(0, std::memory_order_relaxed);
+  m_slotCalls.store(0, std::memory_order_relaxed);
+  m_totalNanos.store(0, std::memory_order_relaxed);
+  m_maxNanos.store(0, std::memory_order_relaxed);
+  for (int i=0; i<Buckets; ++i)
+    m_histogram[i].store(0, std::memory_order_relaxed);
+}
+
+/**
+   Returns the bucket of the histogram for a call that took @a nanos.
+*/
+int SignalStats::getBucketIndex(unsigned long long nanos)
+{
+  int i = 0;
+  while (nanos > 0 && i < Buckets-1) {
+    nanos >>= 1;
+    ++i;
+  }
+  return i;
+}
+
+/**
+   Returns the statistics shared by all signals called @a name.
+
+   The returned pointer is valid until the program finishes.
+*/
+SignalStats* vaca::profiling::getSignalStats(const char* name)
+{
+  ScopedLock hold(get_mutex());
+  StatsMap& stats = get_stats();
+
+  StatsMap::iterator it = stats.find(name);
+  if (it != stats.end())
+    return it->second;
+
+  SignalStats* s = new SignalStats(name);
+  stats[name] = s;
+  return s;
+}
+
+/**
+   Returns a report of all named signals, sorted by the total time
+   spent in their slots.
+
+   The Json format is an object with a "signals" array, each element
+   has the "name", "emits", "slot_calls", "total_ns", "max_ns", and
+   "histogram" fields.
+*/
+std::string vaca::profiling::dumpSignals(DumpFormat format)
+{
+  std::vector<SignalStats*> stats;
+  {
+    ScopedLock hold(get_mutex());
+    for (StatsMap::iterator
+	   it = get_stats().begin(), end = get_stats().end(); it != end; ++it)
+      stats.push_back(it->second);
+  }
+  std::stable_sort(stats.begin(), stats.end(), ByTotalTime());
+
+  std::string out;
+  switch (format) {
+    case DumpFormat::Text: dump_text(out, stats); break;
+    case DumpFormat::Json: dump_json(out, stats); break;
+  }
+  return out;
+}
+
+/**
+   Clears the statistics of all signals.
+*/
+void vaca::profiling::resetSignals()
+{
+  ScopedLock hold(get_mutex());
+  for (StatsMap::iterator
+	 it = get_stats().begin(), end = get_stats().end(); it != end; ++it)
+    it->second->reset();
+}
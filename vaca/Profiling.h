@@ -0,0 +1,136 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#ifndef VACA_PROFILING_H
+#define VACA_PROFILING_H
+
+#include "vaca/base.h"
+#include "vaca/NonCopyable.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+namespace vaca {
+
+/**
+   Profiling of the signal subsystem.
+
+   When Vaca is compiled with @c VACA_PROFILING defined (the @c PROFILING
+   option of CMake), each Signal with a name (see Signal_base#setName)
+   counts its emissions and measures the time spent in each of its
+   slots. Signals with the same name share their statistics, e.g. all
+   the Widget::MouseMove signals of the application.
+
+   Without @c VACA_PROFILING the signals do not measure anything, and
+   Signal_base#setName does nothing.
+
+   @code
+   printf("%s", vaca::profiling::dumpSignals().c_str());
+   @endcode
+*/
+namespace profiling {
+
+/**
+   Formats of the report generated by dumpSignals.
+*/
+struct DumpFormatEnum
+{
+  enum enumeration {
+    Text,
+    Json
+  };
+  static const enumeration default_value = Text;
+};
+
+typedef Enum<DumpFormatEnum> DumpFormat;
+
+/**
+   Statistics of all signals with the same name.
+
+   All counters are atomic and they are updated without locks, so
+   the statistics can be used by signals emitted in any thread.
+
+   The time spent in slots is kept in a histogram with power of two
+   buckets: the bucket @c i counts the calls that took less than
+   <tt>2^i</tt> nanoseconds (and at least <tt>2^(i-1)</tt>).
+*/
+class VACA_DLL SignalStats : private NonCopyable
+{
+public:
+  enum { Buckets = 40 };
+
+private:
+  std::string m_name;
+  std::atomic<unsigned long long> m_emits;
+  std::atomic<unsigned long long> m_slotCalls;
+  std::atomic<unsigned long long> m_totalNanos;
+  std::atomic<unsigned long long> m_maxNanos;
+  std::atomic<unsigned long long> m_histogram[Buckets];
+
+public:
+  explicit SignalStats(const std::string& name);
+
+  const std::string& getName() const { return m_name; }
+
+  void addEmit() {
+    m_emits.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void addSlotCall(unsigned long long nanos);
+
+  unsigned long long getEmits() const { return m_emits.load(std::memory_order_relaxed); }
+  unsigned long long getSlotCalls() const { return m_slotCalls.load(std::memory_order_relaxed); }
+  unsigned long long getTotalNanos() const { return m_totalNanos.load(std::memory_order_relaxed); }
+  unsigned long long getMaxNanos() const { return m_maxNanos.load(std::memory_order_relaxed); }
+  unsigned long long getBucket(int i) const { return m_histogram[i].load(std::memory_order_relaxed); }
+
+  unsigned long long getPercentileNanos(double percentile) const;
+
+  void reset();
+
+  static int getBucketIndex(unsigned long long nanos);
+};
+
+VACA_DLL SignalStats* getSignalStats(const char* name);
+VACA_DLL std::string dumpSignals(DumpFormat format = DumpFormat::Text);
+VACA_DLL void resetSignals();
+
+namespace details {
+
+  /**
+     Adds the time elapsed between its construction and destruction to
+     a SignalStats (if it is not NULL).
+
+     @internal
+  */
+  class SlotStopwatch
+  {
+    typedef std::chrono::steady_clock Clock;
+
+    SignalStats* m_stats;
+    Clock::time_point m_start;
+
+  public:
+    explicit SlotStopwatch(SignalStats* stats) : m_stats(stats) {
+      if (m_stats)
+	m_start = Clock::now();
+    }
+
+    ~SlotStopwatch() {
+      if (m_stats)
+	m_stats->addSlotCall(std::chrono::duration_cast<std::chrono::nanoseconds>
+			     (Clock::now() - m_start).count());
+    }
+  };
+
+} // namespace details
+
+} // namespace profiling
+
+} // namespace vaca
+
+#endif // VACA_PROFILING_H
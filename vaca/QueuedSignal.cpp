@@ -0,0 +1,115 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#include "vaca/QueuedSignal.h"
+#include "vaca/Thread.h"
+
+using namespace vaca;
+using namespace vaca::details;
+
+namespace {
+
+  struct RunCall {
+    void operator()(QueuedCall& call) const { call.run(); }
+  };
+
+}
+
+QueuedCallQueue::QueuedCallQueue(ThreadId threadId, std::size_t capacity)
+  : m_queue(capacity)
+  , m_threadId(threadId)
+  , m_notified(false)
+  , m_dispatching(false)
+  , m_waiting(0)
+{
+}
+
+QueuedCallQueue::~QueuedCallQueue()
+{
+}
+
+void QueuedCallQueue::dispatch()
+{
+  assert(CurrentThread::getId() == m_threadId);
+
+  // A slot can run a nested message loop (e.g. a modal dialog), the
+  // pending calls will be made when the outer dispatch continues.
+  if (m_dispatching)
+    return;
+
+  m_dispatching = true;
+  try {
+    // Clear the flag before popping, so a producer that enqueues
+    // after this point will wake us up again.
+    m_notified.exchange(false, std::memory_order_acq_rel);
+
+    while (m_queue.pop(RunCall()))
+      ;
+  }
+  catch (...) {
+    m_dispatching = false;
+    notifyRoom();
+    throw;
+  }
+  m_dispatching = false;
+  notifyRoom();
+}
+
+/**
+   Called when the queue is full.
+
+   @return False if the caller must make the call directly because it
+	   is the owner thread and it is already dispatching calls.
+*/
+bool QueuedCallQueue::waitForRoom()
+{
+  if (CurrentThread::getId() == m_threadId) {
+    if (m_dispatching)
+      return false;
+
+    dispatch();
+  }
+  else {
+    ScopedLock hold(m_roomMutex);
+    m_waiting.fetch_add(1, std::memory_order_acq_rel);
+
+    // Only the first producer that finds the queue full wakes up the
+    // owner thread (it could be woken up already by enqueue())
+    if (!m_notified.exchange(true, std::memory_order_acq_rel))
+      wakeUpOwner();
+
+    // The timeout covers a dispatch() that finished before we started
+    // waiting, and a WM_NULL that the owner thread never got (e.g. a
+    // modal loop discards thread messages): the next producer that
+    // finds the queue full will post it again.
+    if (!m_roomAvailable.waitFor(hold, 0.05))
+      m_notified.store(false, std::memory_order_release);
+
+    m_waiting.fetch_sub(1, std::memory_order_acq_rel);
+  }
+  return true;
+}
+
+/**
+   Wakes up the producers waiting for room in the queue.
+*/
+void QueuedCallQueue::notifyRoom()
+{
+  if (m_waiting.load(std::memory_order_acquire) > 0) {
+    ScopedLock hold(m_roomMutex);
+    m_roomAvailable.notifyAll();
+  }
+}
+
+void QueuedCallQueue::wakeUpOwner()
+{
+#ifdef VACA_WINDOWS
+  // The WM_NULL message is processed in CurrentThread::getMessage.
+  // If it cannot be posted, the next enqueue() must try again.
+  if (!::PostThreadMessage(m_threadId, WM_NULL, 0, 0))
+    m_notified.store(false, std::memory_order_release);
+#endif
+}
@@ -0,0 +1,485 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#ifndef VACA_QUEUEDSIGNAL_H
+#define VACA_QUEUEDSIGNAL_H
+
+#include "vaca/base.h"
+#include "vaca/ConditionVariable.h"
+#include "vaca/MpscQueue.h"
+#include "vaca/Mutex.h"
+#include "vaca/NonCopyable.h"
+#include "vaca/ScopedLock.h"
+#include "vaca/Signal.h"
+#include "vaca/Slot.h"
+
+#include <atomic>
+#include <tuple>
+#include <vector>
+
+namespace vaca {
+
+namespace details {
+
+  // ======================================================================
+  // QueuedCall
+
+  /**
+     A function object (and its arguments) waiting in a QueuedCallQueue
+     to be called by the owner thread of the queue.
+
+     Small function objects are stored inside the QueuedCall, so a
+     QueuedCall fits in one cache line and enqueuing it does not
+     allocate memory.
+
+     @internal
+  */
+  class QueuedCall : private NonCopyable
+  {
+  public:
+    enum { StorageSize = 64 - sizeof(void*) };
+
+  private:
+    typedef void (*RunFn)(void*, bool);
+
+    union Storage {
+      void* ptr;
+      char buf[StorageSize];
+    };
+
+    template<typename F>
+    struct DestroyGuard {
+      F* f;
+      DestroyGuard(F* f) : f(f) { }
+      ~DestroyGuard() { f->~F(); }
+    };
+
+    template<typename F>
+    struct DeleteGuard {
+      F* f;
+      DeleteGuard(F* f) : f(f) { }
+      ~DeleteGuard() { delete f; }
+    };
+
+    // Calls (if "call" is true) and destroys the function object
+    template<typename F>
+    struct InlineOps {
+      static void run(void* p, bool call) {
+	F* f = static_cast<F*>(p);
+	DestroyGuard<F> guard(f);
+	if (call)
+	  (*f)();
+      }
+    };
+
+    template<typename F>
+    struct HeapOps {
+      static void run(void* p, bool call) {
+	F* f = *static_cast<F**>(p);
+	DeleteGuard<F> guard(f);
+	if (call)
+	  (*f)();
+      }
+    };
+
+    RunFn m_run;
+    Storage m_storage;
+
+  public:
+
+    template<typename F>
+    explicit QueuedCall(F&& f) {
+      typedef typename std::decay<F>::type G;
+      init<G>(std::forward<F>(f),
+	      std::integral_constant<bool, (sizeof(G) <= StorageSize &&
+					    alignof(G) <= alignof(void*))>());
+    }
+
+    ~QueuedCall() {
+      if (m_run)
+	m_run(&m_storage, false);
+    }
+
+    void run() {
+      RunFn run = m_run;
+      m_run = NULL;
+      run(&m_storage, true);
+    }
+
+  private:
+
+    template<typename G, typename F>
+    void init(F&& f, std::true_type) {
+      new (&m_storage) G(std::forward<F>(f));
+      m_run = &InlineOps<G>::run;
+    }
+
+    template<typename G, typename F>
+    void init(F&& f, std::false_type) {
+      m_storage.ptr = new G(std::forward<F>(f));
+      m_run = &HeapOps<G>::run;
+    }
+
+  };
+
+  // ======================================================================
+  // QueuedCallQueue
+
+  /**
+     Queue of calls that must be done by a specific thread.
+
+     Each thread that connects slots to a QueuedSignal has one of these
+     queues (see CurrentThread::details::getQueuedCalls). The queue is
+     dispatched by the message loop of that thread
+     (CurrentThread::doMessageLoop, CurrentThread::pumpMessageQueue).
+
+     The owner thread is woken up only when the queue goes from empty
+     to non-empty, so a burst of calls costs one system call. When the
+     queue is full, producers sleep on a condition variable until the
+     owner thread makes room.
+
+     @internal
+  */
+  class VACA_DLL QueuedCallQueue : private NonCopyable
+  {
+    MpscQueue<QueuedCall> m_queue;
+    ThreadId m_threadId;
+    std::atomic<bool> m_notified;
+    bool m_dispatching;
+
+    // Producers waiting for room in a full queue
+    Mutex m_roomMutex;
+    ConditionVariable m_roomAvailable;
+    std::atomic<int> m_waiting;
+
+  public:
+    enum { DefaultCapacity = 1024 };
+
+    QueuedCallQueue(ThreadId threadId, std::size_t capacity = DefaultCapacity);
+    ~QueuedCallQueue();
+
+    ThreadId getThreadId() const { return m_threadId; }
+
+    /**
+       Adds a call to the queue. It can be used from any thread.
+
+       If the queue is full, the calling thread sleeps until the
+       owner thread makes room.
+    */
+    template<typename F>
+    void enqueue(F&& f)
+    {
+      while (!m_queue.push(std::forward<F>(f))) {
+	if (!waitForRoom()) {
+	  // We are the owner thread and we are already dispatching
+	  // calls, so the only thing we can do is to make the call now.
+	  QueuedCall call(std::forward<F>(f));
+	  call.run();
+	  return;
+	}
+      }
+
+      if (!m_notified.exchange(true, std::memory_order_acq_rel))
+	wakeUpOwner();
+    }
+
+    /**
+       Makes all enqueued calls. It must be used from the owner thread.
+    */
+    void dispatch();
+
+  private:
+    bool waitForRoom();
+    void notifyRoom();
+    void wakeUpOwner();
+  };
+
+  // ======================================================================
+  // QueuedSlot and QueuedDelivery
+
+  template<std::size_t... I>
+  struct IndexSeq { };
+
+  template<std::size_t N, std::size_t... I>
+  struct MakeIndexSeq : MakeIndexSeq<N-1, N-1, I...> { };
+
+  template<std::size_t... I>
+  struct MakeIndexSeq<0, I...> { typedef IndexSeq<I...> type; };
+
+  /**
+     A slot connected to a QueuedSignal. It is destroyed when it is
+     disconnected and there are no more pending calls to it.
+
+     @internal
+  */
+  template<typename... Args>
+  struct QueuedSlot
+  {
+    Slot<void(Args...)> slot;
+    QueuedCallQueue* queue;
+    unsigned id;
+    std::atomic<bool> connected;
+    std::atomic<int> refs;
+
+    QueuedSlot(Slot<void(Args...)>&& slot, QueuedCallQueue* queue, unsigned id)
+      : slot(std::move(slot)), queue(queue), id(id), connected(true), refs(1) { }
+
+    void addRef() {
+      refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release() {
+      if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	delete this;
+    }
+  };
+
+  /**
+     References to the slots of a QueuedSignal taken at the moment of
+     an emission, so the calls can be enqueued without holding the
+     mutex of the signal.
+
+     @internal
+  */
+  template<typename... Args>
+  class QueuedSlotRefs : private NonCopyable
+  {
+    enum { InlineCount = 8 };
+
+    QueuedSlot<Args...>* m_inline[InlineCount];
+    std::vector<QueuedSlot<Args...>*> m_heap;
+    QueuedSlot<Args...>** m_slots;
+    std::size_t m_size;
+
+  public:
+    QueuedSlotRefs() : m_slots(m_inline), m_size(0) { }
+
+    ~QueuedSlotRefs() {
+      for (std::size_t i=0; i<m_size; ++i)
+	m_slots[i]->release();
+    }
+
+    template<class List>
+    void take(const List& slots) {
+      assert(m_size == 0);
+      if (slots.size() > InlineCount) {
+	m_heap.resize(slots.size());
+	m_slots = &m_heap[0];
+      }
+      for (; m_size<slots.size(); ++m_size) {
+	m_slots[m_size] = slots[m_size];
+	m_slots[m_size]->addRef();
+      }
+    }
+
+    std::size_t size() const { return m_size; }
+    QueuedSlot<Args...>* operator[](std::size_t i) const { return m_slots[i]; }
+  };
+
+  /**
+     The bound arguments of one emission of a QueuedSignal for one slot.
+
+     @internal
+  */
+  template<typename... Args>
+  class QueuedDelivery
+  {
+    QueuedSlot<Args...>* m_slot;
+    std::tuple<typename std::decay<Args>::type...> m_args;
+
+  public:
+    template<typename... A>
+    QueuedDelivery(QueuedSlot<Args...>* slot, A&&... args)
+      : m_slot(slot), m_args(std::forward<A>(args)...) {
+      m_slot->addRef();
+    }
+
+    QueuedDelivery(QueuedDelivery&& other)
+      : m_slot(other.m_slot), m_args(std::move(other.m_args)) {
+      other.m_slot = NULL;
+    }
+
+    ~QueuedDelivery() {
+      if (m_slot)
+	m_slot->release();
+    }
+
+    void operator()() {
+      if (m_slot->connected.load(std::memory_order_acquire))
+	call(typename MakeIndexSeq<sizeof...(Args)>::type());
+    }
+
+  private:
+    template<std::size_t... I>
+    void call(IndexSeq<I...>) {
+      m_slot->slot(std::get<I>(m_args)...);
+    }
+
+    QueuedDelivery(const QueuedDelivery&);
+    QueuedDelivery& operator=(const QueuedDelivery&);
+  };
+
+} // namespace details
+
+namespace CurrentThread {
+  namespace details {
+    VACA_DLL vaca::details::QueuedCallQueue* getQueuedCalls();
+    VACA_DLL void dispatchQueuedCalls();
+  }
+}
+
+// ======================================================================
+// QueuedSignal<void(Args...)>
+
+template<typename Signature>
+class QueuedSignal;
+
+/**
+   A signal that can be emitted from any thread, but its slots are
+   called from the thread that connected them.
+
+   Each slot remembers the thread that connected it. When the signal
+   is emitted, the arguments are copied and enqueued in the queue of
+   that thread, and the slot is called when that thread runs its
+   message loop (see CurrentThread::doMessageLoop and
+   CurrentThread::pumpMessageQueue).
+
+   Emitting the signal does not allocate memory if the arguments are
+   small (see details::QueuedCall), and it does not call the operating
+   system unless the owner thread has to be woken up.
+
+   @code
+   QueuedSignal<void(int)> Progress;	// member of MainFrame
+   ...
+   Progress.connect(&MainFrame::onProgress, this);  // in the UI thread
+   ...
+   frame->Progress(percent);		// in a worker thread
+   @endcode
+
+   @warning Slots must be disconnected from their own thread.
+
+   @see Signal, Thread
+*/
+template<typename... Args>
+class QueuedSignal<void(Args...)> : private NonCopyable
+{
+  typedef details::QueuedSlot<Args...> SlotRecord;
+  typedef std::vector<SlotRecord*> SlotList;
+
+  mutable Mutex m_mutex;
+  SlotList m_slots;
+  details::SignalLife* m_life;	// NULL until the first connection
+  unsigned m_nextId;
+
+public:
+  typedef Slot<void(Args...)> SlotType;
+
+  QueuedSignal() : m_life(NULL), m_nextId(0) { }
+
+  ~QueuedSignal() {
+    disconnectAll();
+    if (m_life)
+      m_life->kill();
+  }
+
+  /**
+     Connects a slot that will be called from the current thread.
+  */
+  Connection addSlot(SlotType&& slot)
+  {
+    details::QueuedCallQueue* queue = CurrentThread::details::getQueuedCalls();
+
+    ScopedLock hold(m_mutex);
+    unsigned id = ++m_nextId;
+    m_slots.push_back(new SlotRecord(std::move(slot), queue, id));
+    if (!m_life)
+      m_life = new details::SignalLife;
+    return Connection(this, m_life, &QueuedSignal::disconnectConnection, id, m_slots.size()-1);
+  }
+
+  template<typename F>
+  Connection connect(F&& f)
+  {
+    return addSlot(SlotType(std::forward<F>(f)));
+  }
+
+  template<class T, class T2>
+  Connection connect(void (T::*m)(Args...), T2* t)
+  {
+    return addSlot(SlotType(m, static_cast<T*>(t)));
+  }
+
+  void disconnect(const Connection& conn)
+  {
+    if (conn.m_signal != this)
+      return;
+
+    ScopedLock hold(m_mutex);
+    typename SlotList::iterator it = m_slots.begin();
+    if (conn.m_index < m_slots.size() && m_slots[conn.m_index]->id == conn.m_id)
+      it += conn.m_index;
+    else {
+      for (; it != m_slots.end(); ++it)
+	if ((*it)->id == conn.m_id)
+	  break;
+    }
+
+    if (it != m_slots.end()) {
+      (*it)->connected.store(false, std::memory_order_release);
+      (*it)->release();
+      m_slots.erase(it);
+    }
+  }
+
+  void disconnectAll()
+  {
+    ScopedLock hold(m_mutex);
+    for (typename SlotList::iterator
+	   it = m_slots.begin(), end = m_slots.end(); it != end; ++it) {
+      (*it)->connected.store(false, std::memory_order_release);
+      (*it)->release();
+    }
+    m_slots.clear();
+  }
+
+  bool empty() const
+  {
+    ScopedLock hold(m_mutex);
+    return m_slots.empty();
+  }
+
+  /**
+     Enqueues a call to each connected slot. It can be used from any
+     thread.
+  */
+  void operator()(Args... args)
+  {
+    // The calls are enqueued without holding the mutex: enqueue() can
+    // wait for an owner thread that is using this signal in a slot.
+    details::QueuedSlotRefs<Args...> slots;
+    {
+      ScopedLock hold(m_mutex);
+      slots.take(m_slots);
+    }
+
+    for (std::size_t i=0; i<slots.size(); ++i) {
+      SlotRecord* rec = slots[i];
+      rec->queue->enqueue(details::QueuedDelivery<Args...>(rec, args...));
+    }
+  }
+
+private:
+
+  static void disconnectConnection(void* signal, const Connection& conn)
+  {
+    static_cast<QueuedSignal*>(signal)->disconnect(conn);
+  }
+
+};
+
+} // namespace vaca
+
+#endif // VACA_QUEUEDSIGNAL_H
@@ -8,13 +8,26 @@
 #define VACA_RECT_H
 
 #include "vaca/base.h"
+#include "vaca/Point.h"
+#include "vaca/Size.h"
 
 namespace vaca {
 
 /**
    A rectangle.
+
+   Like Point and Size, it is a literal type defined completely in this
+   header: the member functions are inlined where they are used, and
+   the ones that do not modify the rectangle can be used in constant
+   expressions.
+
+   @code
+   constexpr Rect client(0, 0, 320, 240);
+   constexpr Rect area = client.createIntersect(Rect(300, 0, 40, 40));
+   static_assert(area.w == 20, "");
+   @endcode
 */
-class VACA_DLL Rect
+class Rect
 {
 public:
 
@@ -48,45 +61,301 @@ public:
   */
   int h;
 
-  Rect();
-  Rect(int w, int h);
-  explicit Rect(const Size& size);
-  Rect(const Rect& rect);
-  Rect(const Point& point, const Size& size);
-  Rect(const Point& point1, const Point& point2);
-  Rect(int x, int y, int w, int h);
+  /**
+     Creates a new empty rectangle with the origin in @c Point(0,0).
+
+     The rectangle will be @c #x=#y=#w=#h=0
 
-  bool isEmpty() const;
+     @see isEmpty
+  */
+  constexpr Rect() noexcept : x(0), y(0), w(0), h(0) { }
 
-  Point getCenter() const;
-  Point getOrigin() const;
-  Point getPoint2() const;
-  Size getSize() const;
+  /**
+     Creates a new rectangle with the specified size with the origin in @c Point(0,0).
 
-  Rect& setOrigin(const Point& pt);
-  Rect& setSize(const Size& sz);
+     The rectangle will be @c #x=#y=0.
+  */
+  constexpr Rect(int w, int h) noexcept : x(0), y(0), w(w), h(h) { }
 
-  Rect& offset(int dx, int dy);
-  Rect& offset(const Point& point);
-  Rect& inflate(int dw, int dh);
-  Rect& inflate(const Size& size);
+  /**
+     Creates a new rectangle with the specified size with the origin in @c Point(0,0).
 
-  Rect& enlarge(int unit);
-  Rect& shrink(int unit);
+     The rectangle will be @c #x=#y=0.
+  */
+  constexpr explicit Rect(const Size& size) noexcept
+    : x(0), y(0), w(size.w), h(size.h) { }
 
-  bool contains(const Point& pt) const;
-  bool contains(const Rect& rc) const;
-  bool intersects(const Rect& rc) const;
+  /**
+     Creates a new rectangle with the origin in @a point
+     and the specified @a size.
+  */
+  constexpr Rect(const Point& point, const Size& size) noexcept
+    : x(point.x), y(point.y), w(size.w), h(size.h) { }
 
-  Rect createUnion(const Rect& rc) const;
-  Rect createIntersect(const Rect& rc) const;
+  /**
+     Creates a new rectangle with the origin in @a point1 and size equal
+     to @a point2 - @a point1.
 
-  bool operator==(const Rect& rc) const;
-  bool operator!=(const Rect& rc) const;
+     If a coordinate of @a point1 is greater than @a point2 (Point#x
+     and/or Point#y), the coordinates are swapped. So the rectangle
+     will be:
+     @code
+     #x = MIN(point1.x, point2.x)
+     #y = MIN(point1.y, point2.y)
+     #w = MAX(point1.x, point2.x) - #x
+     #h = MAX(point1.x, point2.x) - #y
+     @endcode
+     See that @a point2 isn't included in the rectangle, it's
+     like the point returned by #getPoint2 member function.
+
+     @see #getPoint2
+  */
+  constexpr Rect(const Point& point1, const Point& point2) noexcept
+    : x(min_value(point1.x, point2.x))
+    , y(min_value(point1.y, point2.y))
+    , w(max_value(point1.x, point2.x) - min_value(point1.x, point2.x))
+    , h(max_value(point1.y, point2.y) - min_value(point1.y, point2.y)) { }
+
+  constexpr Rect(int x, int y, int w, int h) noexcept : x(x), y(y), w(w), h(h) { }
+
+  /**
+     Verifies if the width and/or height of the rectangle are less or
+     equal than zero.
+  */
+  constexpr bool isEmpty() const noexcept { return (w < 1 || h < 1); }
+
+  /**
+     Returns the middle point of the rectangle (the centroid).
+
+     @return
+       Point(#x+#w/2, #y+#h/2)
+  */
+  constexpr Point getCenter() const noexcept { return Point(x+w/2, y+h/2); }
+
+  /**
+     Returns the point in the upper-left corner (that is inside the rectangle).
+
+     @return
+       Point(#x, #y)
+  */
+  constexpr Point getOrigin() const noexcept { return Point(x, y); }
+
+  /**
+     Returns point in the lower-right corner (that is outside the rectangle).
+
+     @return
+       Point(#x+#w, #y+#h)
+  */
+  constexpr Point getPoint2() const noexcept { return Point(x+w, y+h); }
+
+  /**
+     Returns the size of the rectangle.
+
+     @return
+       Size(#w, #h)
+  */
+  constexpr Size getSize() const noexcept { return Size(w, h); }
+
+  /**
+     Changes the origin of the rectangle without modifying its size.
+  */
+  Rect& setOrigin(const Point& pt) noexcept
+  {
+    x = pt.x;
+    y = pt.y;
+    return *this;
+  }
+
+  /**
+     Changes the size of the rectangle without modifying its origin.
+  */
+  Rect& setSize(const Size& sz) noexcept
+  {
+    w = sz.w;
+    h = sz.h;
+    return *this;
+  }
+
+  /**
+     Moves the rectangle origin in the specified delta.
+
+     @param dx
+       How many pixels displace the #x coordinate (#x+=dx).
+
+     @param dy
+       How many pixels displace the #y coordinate (#y+=dy).
+
+     @return
+       A reference to @c this.
+  */
+  Rect& offset(int dx, int dy) noexcept
+  {
+    x += dx;
+    y += dy;
+    return *this;
+  }
+
+  /**
+     Moves the rectangle origin in the specified delta.
+
+     @param point
+       How many pixels displace the origin (#x+=point.x, #y+=point.y).
+
+     @return
+       A reference to @c this.
+  */
+  Rect& offset(const Point& point) noexcept
+  {
+    return offset(point.x, point.y);
+  }
+
+  /**
+     Increases (or decreases if the delta is negative) the size of the
+     rectangle.
+
+     @param dw
+       How many pixels to increase the width of the rectangle #w.
+
+     @param dh
+       How many pixels to increase the height of the rectangle #h.
+
+     @return
+       A reference to @c this.
+  */
+  Rect& inflate(int dw, int dh) noexcept
+  {
+    w += dw;
+    h += dh;
+    return *this;
+  }
+
+  /**
+     Increases (or decreases if the delta is negative) the size of the
+     rectangle.
+
+     @param size
+       How many pixels to increase the size of the
+       rectangle (#w+=size.w, #h+=size.h).
+
+     @return
+       A reference to @c this.
+  */
+  Rect& inflate(const Size& size) noexcept
+  {
+    return inflate(size.w, size.h);
+  }
+
+  /**
+     @todo docme
+     @return
+       A reference to @c this.
+  */
+  Rect& enlarge(int unit) noexcept
+  {
+    x -= unit;
+    y -= unit;
+    w += unit<<1;
+    h += unit<<1;
+    return *this;
+  }
+
+  /**
+     @todo docme
+     @return
+       A reference to @c this.
+  */
+  Rect& shrink(int unit) noexcept
+  {
+    x += unit;
+    y += unit;
+    w -= unit<<1;
+    h -= unit<<1;
+    return *this;
+  }
+
+  /**
+     Returns true if this rectangle encloses the @a pt point.
+  */
+  constexpr bool contains(const Point& pt) const noexcept
+  {
+    return
+      pt.x >= x && pt.x < x+w &&
+      pt.y >= y && pt.y < y+h;
+  }
+
+  /**
+     Returns true if this rectangle entirely contains the @a rc rectangle.
+
+     @warning
+       If some rectangle is empty, this member function returns false.
+  */
+  constexpr bool contains(const Rect& rc) const noexcept
+  {
+    return
+      !isEmpty() && !rc.isEmpty() &&
+      rc.x >= x && rc.x+rc.w <= x+w &&
+      rc.y >= y && rc.y+rc.h <= y+h;
+  }
+
+  /**
+     Returns true if the intersection between this rectangle with @a rc
+     rectangle is not empty.
+
+     @warning
+       If some rectangle is empty, this member function returns false.
+  */
+  constexpr bool intersects(const Rect& rc) const noexcept
+  {
+    return
+      !isEmpty() && !rc.isEmpty() &&
+      rc.x <= x+w && rc.x+rc.w > x &&
+      rc.y <= y+h && rc.y+rc.h > y;
+  }
+
+  /**
+     Returns the union rectangle between this and @c rc rectangle.
+
+     @warning
+       If some rectangle is empty, this member function will return the
+       other rectangle.
+  */
+  constexpr Rect createUnion(const Rect& rc) const noexcept
+  {
+    return
+      isEmpty() ? rc:
+      rc.isEmpty() ? *this:
+      Rect(Point(min_value(x, rc.x), min_value(y, rc.y)),
+	   Point(max_value(x+w, rc.x+rc.w), max_value(y+h, rc.y+rc.h)));
+  }
+
+  /**
+     Returns the intersection rectangle between this and @c rc rectangles.
+  */
+  constexpr Rect createIntersect(const Rect& rc) const noexcept
+  {
+    return
+      intersects(rc) ?
+      Rect(Point(max_value(x, rc.x), max_value(y, rc.y)),
+	   Point(min_value(x+w, rc.x+rc.w), min_value(y+h, rc.y+rc.h))):
+      Rect();
+  }
+
+  constexpr bool operator==(const Rect& rc) const noexcept
+  {
+    return
+      x == rc.x && w == rc.w &&
+      y == rc.y && h == rc.h;
+  }
+
+  constexpr bool operator!=(const Rect& rc) const noexcept
+  {
+    return
+      x != rc.x || w != rc.w ||
+      y != rc.y || h != rc.h;
+  }
 
 };
 
 } // namespace vaca
 
 #endif // VACA_RECT_H
-
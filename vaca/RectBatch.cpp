@@ -0,0 +1,466 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#include "vaca/RectBatch.h"
+#include "vaca/Point.h"
+
+#include <climits>
+
+#if defined(__AVX2__)
+  #include <immintrin.h>
+  #define VACA_RECTBATCH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define VACA_RECTBATCH_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+  #include <arm_neon.h>
+  #define VACA_RECTBATCH_NEON
+#endif
+
+#if defined(_MSC_VER)
+  #include <intrin.h>
+#endif
+
+using namespace vaca;
+
+namespace {
+
+  // Index of the lowest/highest bit of a mask (it must not be zero)
+  inline unsigned lowest_bit(unsigned mask)
+  {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+  }
+
+  inline unsigned highest_bit(unsigned mask)
+  {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return index;
+#else
+    return 31 - __builtin_clz(mask);
+#endif
+  }
+
+  // Operations with "Width" integers at the same time. "mask" returns
+  // a bit for each integer of the result of a comparison.
+
+#if defined(VACA_RECTBATCH_AVX2)
+
+  struct Lanes
+  {
+    typedef __m256i Vec;
+    enum { Width = 8 };
+
+    static Vec load(const int* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(int* p, Vec a) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a); }
+    static Vec set1(int value) { return _mm256_set1_epi32(value); }
+    static Vec add(Vec a, Vec b) { return _mm256_add_epi32(a, b); }
+    static Vec greater(Vec a, Vec b) { return _mm256_cmpgt_epi32(a, b); }
+    static Vec and_(Vec a, Vec b) { return _mm256_and_si256(a, b); }
+    static Vec andnot(Vec a, Vec b) { return _mm256_andnot_si256(a, b); } // ~a & b
+    static Vec min(Vec a, Vec b) { return _mm256_min_epi32(a, b); }
+    static Vec max(Vec a, Vec b) { return _mm256_max_epi32(a, b); }
+    static Vec select(Vec m, Vec a, Vec b) { return _mm256_blendv_epi8(b, a, m); }
+    static unsigned mask(Vec m) { return _mm256_movemask_ps(_mm256_castsi256_ps(m)); }
+  };
+
+#elif defined(VACA_RECTBATCH_SSE2)
+
+  struct Lanes
+  {
+    typedef __m128i Vec;
+    enum { Width = 4 };
+
+    static Vec load(const int* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(int* p, Vec a) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), a); }
+    static Vec set1(int value) { return _mm_set1_epi32(value); }
+    static Vec add(Vec a, Vec b) { return _mm_add_epi32(a, b); }
+    static Vec greater(Vec a, Vec b) { return _mm_cmpgt_epi32(a, b); }
+    static Vec and_(Vec a, Vec b) { return _mm_and_si128(a, b); }
+    static Vec andnot(Vec a, Vec b) { return _mm_andnot_si128(a, b); } // ~a & b
+    static Vec select(Vec m, Vec a, Vec b) { return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b)); }
+    // pminsd/pmaxsd are SSE4.1
+    static Vec min(Vec a, Vec b) { return select(_mm_cmpgt_epi32(a, b), b, a); }
+    static Vec max(Vec a, Vec b) { return select(_mm_cmpgt_epi32(a, b), a, b); }
+    static unsigned mask(Vec m) { return _mm_movemask_ps(_mm_castsi128_ps(m)); }
+  };
+
+#elif defined(VACA_RECTBATCH_NEON)
+
+  struct Lanes
+  {
+    typedef int32x4_t Vec;
+    enum { Width = 4 };
+
+    static Vec load(const int* p) { return vld1q_s32(p); }
+    static void store(int* p, Vec a) { vst1q_s32(p, a); }
+    static Vec set1(int value) { return vdupq_n_s32(value); }
+    static Vec add(Vec a, Vec b) { return vaddq_s32(a, b); }
+    static Vec greater(Vec a, Vec b) { return vreinterpretq_s32_u32(vcgtq_s32(a, b)); }
+    static Vec and_(Vec a, Vec b) { return vandq_s32(a, b); }
+    static Vec andnot(Vec a, Vec b) { return vbicq_s32(b, a); } // ~a & b
+    static Vec min(Vec a, Vec b) { return vminq_s32(a, b); }
+    static Vec max(Vec a, Vec b) { return vmaxq_s32(a, b); }
+    static Vec select(Vec m, Vec a, Vec b) { return vbslq_s32(vreinterpretq_u32_s32(m), a, b); }
+    static unsigned mask(Vec m) {
+      static const int bits[4] = { 1, 2, 4, 8 };
+      return vaddvq_s32(vandq_s32(m, vld1q_s32(bits)));
+    }
+  };
+
+#endif
+
+#if defined(VACA_RECTBATCH_AVX2) || defined(VACA_RECTBATCH_SSE2) || defined(VACA_RECTBATCH_NEON)
+  #define VACA_RECTBATCH_SIMD
+#endif
+
+#ifdef VACA_RECTBATCH_SIMD
+
+  // Rectangles that contain the point (px, py), like Rect::contains
+  inline Lanes::Vec contains_mask(Lanes::Vec x1, Lanes::Vec y1, Lanes::Vec x2, Lanes::Vec y2,
+				  Lanes::Vec px, Lanes::Vec py)
+  {
+    // x1 <= px < x2 && y1 <= py < y2
+    return Lanes::and_(Lanes::andnot(Lanes::greater(x1, px), Lanes::greater(x2, px)),
+		       Lanes::andnot(Lanes::greater(y1, py), Lanes::greater(y2, py)));
+  }
+
+  // Rectangles that intersect the non-empty rectangle [rx1, rx2) x
+  // [ry1, ry2), like Rect::intersects
+  inline Lanes::Vec intersects_mask(Lanes::Vec x1, Lanes::Vec y1, Lanes::Vec x2, Lanes::Vec y2,
+				    Lanes::Vec rx1, Lanes::Vec ry1, Lanes::Vec rx2, Lanes::Vec ry2)
+  {
+    // !isEmpty() && rx1 <= x2 && rx2 > x1 && ry1 <= y2 && ry2 > y1
+    Lanes::Vec notEmpty = Lanes::and_(Lanes::greater(x2, x1), Lanes::greater(y2, y1));
+    Lanes::Vec xs = Lanes::andnot(Lanes::greater(rx1, x2), Lanes::greater(rx2, x1));
+    Lanes::Vec ys = Lanes::andnot(Lanes::greater(ry1, y2), Lanes::greater(ry2, y1));
+    return Lanes::and_(notEmpty, Lanes::and_(xs, ys));
+  }
+
+#endif
+
+  inline bool contains(int x1, int y1, int x2, int y2, const Point& pt)
+  {
+    return (pt.x >= x1 && pt.x < x2 &&
+	    pt.y >= y1 && pt.y < y2);
+  }
+
+  inline bool intersects(int x1, int y1, int x2, int y2,
+			 int rx1, int ry1, int rx2, int ry2)
+  {
+    return (x1 < x2 && y1 < y2 &&
+	    rx1 <= x2 && rx2 > x1 &&
+	    ry1 <= y2 && ry2 > y1);
+  }
+
+}
+
+RectBatch::RectBatch()
+{
+}
+
+RectBatch::RectBatch(const std::vector<Rect>& rects)
+{
+  reserve(rects.size());
+  for (std::vector<Rect>::const_iterator it=rects.begin(); it!=rects.end(); ++it)
+    add(*it);
+}
+
+void RectBatch::clear()
+{
+  m_x1.clear();
+  m_y1.clear();
+  m_x2.clear();
+  m_y2.clear();
+}
+
+void RectBatch::reserve(std::size_t n)
+{
+  m_x1.reserve(n);
+  m_y1.reserve(n);
+  m_x2.reserve(n);
+  m_y2.reserve(n);
+}
+
+/**
+   Adds a rectangle at the end of the list.
+*/
+void RectBatch::add(const Rect& rc)
+{
+  m_x1.push_back(rc.x);
+  m_y1.push_back(rc.y);
+  m_x2.push_back(rc.x+rc.w);
+  m_y2.push_back(rc.y+rc.h);
+}
+
+/**
+   Replaces the rectangle in the specified position.
+*/
+void RectBatch::set(std::size_t index, const Rect& rc)
+{
+  m_x1[index] = rc.x;
+  m_y1[index] = rc.y;
+  m_x2[index] = rc.x+rc.w;
+  m_y2[index] = rc.y+rc.h;
+}
+
+/**
+   Returns the index of the first rectangle that contains the point,
+   or -1 if there is no one.
+
+   @see findLast, Rect::contains
+*/
+int RectBatch::findFirst(const Point& pt) const
+{
+  std::size_t n = size();
+  std::size_t i = 0;
+
+#ifdef VACA_RECTBATCH_SIMD
+  Lanes::Vec px = Lanes::set1(pt.x);
+  Lanes::Vec py = Lanes::set1(pt.y);
+  for (; i+Lanes::Width <= n; i += Lanes::Width) {
+    unsigned bits = Lanes::mask(contains_mask(Lanes::load(&m_x1[i]), Lanes::load(&m_y1[i]),
+					      Lanes::load(&m_x2[i]), Lanes::load(&m_y2[i]), px, py));
+    if (bits)
+      return static_cast<int>(i + lowest_bit(bits));
+  }
+#endif
+
+  for (; i<n; ++i)
+    if (contains(m_x1[i], m_y1[i], m_x2[i], m_y2[i], pt))
+      return static_cast<int>(i);
+
+  return -1;
+}
+
+/**
+   Returns the index of the last rectangle that contains the point, or
+   -1 if there is no one.
+
+   If the rectangles are the bounds of widgets sorted from bottom to
+   top (the order in which they are painted), it is the widget that is
+   below the point.
+
+   @see findFirst, Rect::contains
+*/
+int RectBatch::findLast(const Point& pt) const
+{
+  std::size_t n = size();
+  std::size_t i = n;
+
+#ifdef VACA_RECTBATCH_SIMD
+  // the last rectangles that do not fill a whole block
+  for (; i > n - n % Lanes::Width; --i)
+    if (contains(m_x1[i-1], m_y1[i-1], m_x2[i-1], m_y2[i-1], pt))
+      return static_cast<int>(i-1);
+
+  Lanes::Vec px = Lanes::set1(pt.x);
+  Lanes::Vec py = Lanes::set1(pt.y);
+  for (; i > 0; i -= Lanes::Width) {
+    std::size_t j = i - Lanes::Width;
+    unsigned bits = Lanes::mask(contains_mask(Lanes::load(&m_x1[j]), Lanes::load(&m_y1[j]),
+					      Lanes::load(&m_x2[j]), Lanes::load(&m_y2[j]), px, py));
+    if (bits)
+      return static_cast<int>(j + highest_bit(bits));
+  }
+#else
+  for (; i > 0; --i)
+    if (contains(m_x1[i-1], m_y1[i-1], m_x2[i-1], m_y2[i-1], pt))
+      return static_cast<int>(i-1);
+#endif
+
+  return -1;
+}
+
+/**
+   Puts in @a indices the positions of the rectangles that intersect
+   @a rc (see Rect::intersects), in ascending order.
+
+   @return The number of rectangles found.
+*/
+std::size_t RectBatch::findIntersecting(const Rect& rc, std::vector<int>& indices) const
+{
+  indices.clear();
+  if (rc.isEmpty())
+    return 0;
+
+  int rx1 = rc.x, ry1 = rc.y;
+  int rx2 = rc.x+rc.w, ry2 = rc.y+rc.h;
+  std::size_t n = size();
+  std::size_t i = 0;
+
+#ifdef VACA_RECTBATCH_SIMD
+  Lanes::Vec vx1 = Lanes::set1(rx1), vy1 = Lanes::set1(ry1);
+  Lanes::Vec vx2 = Lanes::set1(rx2), vy2 = Lanes::set1(ry2);
+  for (; i+Lanes::Width <= n; i += Lanes::Width) {
+    unsigned bits = Lanes::mask(intersects_mask(Lanes::load(&m_x1[i]), Lanes::load(&m_y1[i]),
+						Lanes::load(&m_x2[i]), Lanes::load(&m_y2[i]),
+						vx1, vy1, vx2, vy2));
+    for (; bits; bits &= bits-1)
+      indices.push_back(static_cast<int>(i + lowest_bit(bits)));
+  }
+#endif
+
+  for (; i<n; ++i)
+    if (intersects(m_x1[i], m_y1[i], m_x2[i], m_y2[i], rx1, ry1, rx2, ry2))
+      indices.push_back(static_cast<int>(i));
+
+  return indices.size();
+}
+
+/**
+   Returns the union of all rectangles (the empty ones are ignored, like
+   in Rect::createUnion).
+
+   @return An empty rectangle if all rectangles are empty.
+*/
+Rect RectBatch::getBounds() const
+{
+  int x1 = INT_MAX, y1 = INT_MAX;
+  int x2 = INT_MIN, y2 = INT_MIN;
+  std::size_t n = size();
+  std::size_t i = 0;
+
+#ifdef VACA_RECTBATCH_SIMD
+  if (n >= Lanes::Width) {
+    Lanes::Vec maxValue = Lanes::set1(INT_MAX);
+    Lanes::Vec minValue = Lanes::set1(INT_MIN);
+    Lanes::Vec vx1 = maxValue, vy1 = maxValue;
+    Lanes::Vec vx2 = minValue, vy2 = minValue;
+
+    for (; i+Lanes::Width <= n; i += Lanes::Width) {
+      Lanes::Vec ax1 = Lanes::load(&m_x1[i]);
+      Lanes::Vec ay1 = Lanes::load(&m_y1[i]);
+      Lanes::Vec ax2 = Lanes::load(&m_x2[i]);
+      Lanes::Vec ay2 = Lanes::load(&m_y2[i]);
+      Lanes::Vec notEmpty = Lanes::and_(Lanes::greater(ax2, ax1), Lanes::greater(ay2, ay1));
+
+      vx1 = Lanes::min(vx1, Lanes::select(notEmpty, ax1, maxValue));
+      vy1 = Lanes::min(vy1, Lanes::select(notEmpty, ay1, maxValue));
+      vx2 = Lanes::max(vx2, Lanes::select(notEmpty, ax2, minValue));
+      vy2 = Lanes::max(vy2, Lanes::select(notEmpty, ay2, minValue));
+    }
+
+    int bx1[Lanes::Width], by1[Lanes::Width];
+    int bx2[Lanes::Width], by2[Lanes::Width];
+    Lanes::store(bx1, vx1);
+    Lanes::store(by1, vy1);
+    Lanes::store(bx2, vx2);
+    Lanes::store(by2, vy2);
+    for (int j=0; j<Lanes::Width; ++j) {
+      x1 = std::min(x1, bx1[j]);
+      y1 = std::min(y1, by1[j]);
+      x2 = std::max(x2, bx2[j]);
+      y2 = std::max(y2, by2[j]);
+    }
+  }
+#endif
+
+  for (; i<n; ++i) {
+    if (m_x1[i] < m_x2[i] && m_y1[i] < m_y2[i]) {
+      x1 = std::min(x1, m_x1[i]);
+      y1 = std::min(y1, m_y1[i]);
+      x2 = std::max(x2, m_x2[i]);
+      y2 = std::max(y2, m_y2[i]);
+    }
+  }
+
+  if (x1 > x2)			// all rectangles are empty
+    return Rect();
+  else
+    return Rect(x1, y1, x2-x1, y2-y1);
+}
+
+/**
+   Replaces each rectangle with its intersection with @a rc (see
+   Rect::createIntersect). The rectangles that do not intersect @a rc
+   are replaced with an empty rectangle, Rect().
+*/
+RectBatch& RectBatch::intersect(const Rect& rc)
+{
+  std::size_t n = size();
+  std::size_t i = 0;
+
+  if (rc.isEmpty()) {
+    std::fill(m_x1.begin(), m_x1.end(), 0);
+    std::fill(m_y1.begin(), m_y1.end(), 0);
+    std::fill(m_x2.begin(), m_x2.end(), 0);
+    std::fill(m_y2.begin(), m_y2.end(), 0);
+    return *this;
+  }
+
+  int rx1 = rc.x, ry1 = rc.y;
+  int rx2 = rc.x+rc.w, ry2 = rc.y+rc.h;
+
+#ifdef VACA_RECTBATCH_SIMD
+  Lanes::Vec vx1 = Lanes::set1(rx1), vy1 = Lanes::set1(ry1);
+  Lanes::Vec vx2 = Lanes::set1(rx2), vy2 = Lanes::set1(ry2);
+  for (; i+Lanes::Width <= n; i += Lanes::Width) {
+    Lanes::Vec ax1 = Lanes::load(&m_x1[i]);
+    Lanes::Vec ay1 = Lanes::load(&m_y1[i]);
+    Lanes::Vec ax2 = Lanes::load(&m_x2[i]);
+    Lanes::Vec ay2 = Lanes::load(&m_y2[i]);
+    Lanes::Vec m = intersects_mask(ax1, ay1, ax2, ay2, vx1, vy1, vx2, vy2);
+
+    Lanes::store(&m_x1[i], Lanes::and_(m, Lanes::max(ax1, vx1)));
+    Lanes::store(&m_y1[i], Lanes::and_(m, Lanes::max(ay1, vy1)));
+    Lanes::store(&m_x2[i], Lanes::and_(m, Lanes::min(ax2, vx2)));
+    Lanes::store(&m_y2[i], Lanes::and_(m, Lanes::min(ay2, vy2)));
+  }
+#endif
+
+  for (; i<n; ++i) {
+    if (intersects(m_x1[i], m_y1[i], m_x2[i], m_y2[i], rx1, ry1, rx2, ry2)) {
+      m_x1[i] = std::max(m_x1[i], rx1);
+      m_y1[i] = std::max(m_y1[i], ry1);
+      m_x2[i] = std::min(m_x2[i], rx2);
+      m_y2[i] = std::min(m_y2[i], ry2);
+    }
+    else
+      m_x1[i] = m_y1[i] = m_x2[i] = m_y2[i] = 0;
+  }
+  return *this;
+}
+
+/**
+   Moves all rectangles.
+*/
+RectBatch& RectBatch::offset(int dx, int dy)
+{
+  std::size_t n = size();
+  std::size_t i = 0;
+
+#ifdef VACA_RECTBATCH_SIMD
+  Lanes::Vec vdx = Lanes::set1(dx);
+  Lanes::Vec vdy = Lanes::set1(dy);
+  for (; i+Lanes::Width <= n; i += Lanes::Width) {
+    Lanes::store(&m_x1[i], Lanes::add(Lanes::load(&m_x1[i]), vdx));
+    Lanes::store(&m_y1[i], Lanes::add(Lanes::load(&m_y1[i]), vdy));
+    Lanes::store(&m_x2[i], Lanes::add(Lanes::load(&m_x2[i]), vdx));
+    Lanes::store(&m_y2[i], Lanes::add(Lanes::load(&m_y2[i]), vdy));
+  }
+#endif
+
+  for (; i<n; ++i) {
+    m_x1[i] += dx;
+    m_y1[i] += dy;
+    m_x2[i] += dx;
+    m_y2[i] += dy;
+  }
+  return *this;
+}
+
+RectBatch& RectBatch::offset(const Point& point)
+{
+  return offset(point.x, point.y);
+}
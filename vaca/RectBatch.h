@@ -0,0 +1,85 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#ifndef VACA_RECTBATCH_H
+#define VACA_RECTBATCH_H
+
+#include "vaca/base.h"
+#include "vaca/Rect.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace vaca {
+
+/**
+   A list of rectangles to test or modify all of them at once (e.g. the
+   bounds of the children of a widget, or the cells of a grid).
+
+   The rectangles are stored as a structure of arrays (the left, top,
+   right and bottom sides of all rectangles in four arrays), so each
+   operation compares several rectangles with one instruction: 8 with
+   AVX2, 4 with SSE2 or NEON. Without those instructions (or for the
+   last rectangles of the list) the same operations are made one
+   rectangle at a time.
+
+   The results are the same of the Rect member functions (Rect::contains,
+   Rect::intersects, Rect::createIntersect and Rect::createUnion) for each
+   rectangle.
+
+   @code
+   RectBatch children;
+   for (...)
+     children.add(child->getBounds());
+
+   // the last child is above the others
+   int index = children.findLast(ev.getPoint());
+   @endcode
+*/
+class VACA_DLL RectBatch
+{
+  std::vector<int> m_x1;
+  std::vector<int> m_y1;
+  std::vector<int> m_x2;		// x+w
+  std::vector<int> m_y2;		// y+h
+
+public:
+
+  RectBatch();
+  explicit RectBatch(const std::vector<Rect>& rects);
+
+  std::size_t size() const { return m_x1.size(); }
+  bool empty() const { return m_x1.empty(); }
+
+  void clear();
+  void reserve(std::size_t n);
+  void add(const Rect& rc);
+  void set(std::size_t index, const Rect& rc);
+
+  /**
+     Returns the rectangle in the specified position.
+  */
+  Rect operator[](std::size_t index) const {
+    return Rect(m_x1[index], m_y1[index],
+		m_x2[index] - m_x1[index],
+		m_y2[index] - m_y1[index]);
+  }
+
+  int findFirst(const Point& pt) const;
+  int findLast(const Point& pt) const;
+  std::size_t findIntersecting(const Rect& rc, std::vector<int>& indices) const;
+
+  Rect getBounds() const;
+
+  RectBatch& intersect(const Rect& rc);
+  RectBatch& offset(int dx, int dy);
+  RectBatch& offset(const Point& point);
+
+};
+
+} // namespace vaca
+
+#endif // VACA_RECTBATCH_H
@@ -10,8 +10,6 @@
 #ifndef NDEBUG
 #include "vaca/Mutex.h"
 #include "vaca/ScopedLock.h"
-#include <vector>
-#include <typeinfo>
   #ifdef VACA_ON_WINDOWS
     #define WIN32_LEAN_AND_MEAN
     #include <windows.h>
@@ -19,103 +17,126 @@
 #endif
 
 using namespace vaca;
+using namespace vaca::details;
 
 #ifndef NDEBUG
-static Mutex s_mutex;
-static std::vector<Referenceable*> s_list;
+
+namespace {
+
+  enum { Shards = 16 };
+
+  // A list of live objects
+  struct Shard {
+    Mutex mutex;
+    LeakTracked* head;
+    std::size_t count;
+  };
+
+  // Created in the first use, so global referenceables can be
+  // constructed before this file is initialized. It is never deleted
+  // because global referenceables can be destroyed after it.
+  Shard* get_shards()
+  {
+    static Shard* shards = new Shard[Shards]();
+    return shards;
+  }
+
+  Shard& get_shard(const void* ptr)
+  {
+    // ignore the lowest bits, they are zero in heap blocks
+    return get_shards()[(reinterpret_cast<std::size_t>(ptr) >> 4) % Shards];
+  }
+
+}
+
 #endif
 
-/**
-   Constructs a new referenceable object starting with zero references.
-*/
-Referenceable::Referenceable()
+LeakTracked::LeakTracked()
 {
-  m_refCount = 0;
 #ifndef NDEBUG
-  {
-    ScopedLock hold(s_mutex);
-    VACA_TRACE("new Referenceable (%d, %p)\n", s_list.size()+1, this);
-    s_list.push_back(this);
-  }
+  Shard& shard = get_shard(this);
+  ScopedLock hold(shard.mutex);
+
+  m_prevLeak = NULL;
+  m_nextLeak = shard.head;
+  if (shard.head)
+    shard.head->m_prevLeak = this;
+  shard.head = this;
+  ++shard.count;
+#else
+  m_prevLeak = m_nextLeak = NULL;
 #endif
 }
 
-/**
-   Destroys a referenceable object.
-
-   When compiling with assertions it checks that the references'
-   counter is really zero.
-*/
-Referenceable::~Referenceable()
+LeakTracked::~LeakTracked()
 {
 #ifndef NDEBUG
-  {
-    ScopedLock hold(s_mutex);
-    VACA_TRACE("delete Referenceable (%d, %p)\n", s_list.size()-1, this);
-    remove_from_container(s_list, this);
-  }
+  Shard& shard = get_shard(this);
+  ScopedLock hold(shard.mutex);
+
+  if (m_prevLeak)
+    m_prevLeak->m_nextLeak = m_nextLeak;
+  else
+    shard.head = m_nextLeak;
+  if (m_nextLeak)
+    m_nextLeak->m_prevLeak = m_prevLeak;
+  --shard.count;
 #endif
-  assert(m_refCount == 0);
 }
 
 /**
-   Called by SharedPtr to destroy the referenceable.
+   Returns the number of referenceable objects that are alive (always
+   zero in release builds).
 */
-void Referenceable::destroy()
+std::size_t LeakTracked::getLiveCount()
 {
-  delete this;
+  std::size_t count = 0;
+#ifndef NDEBUG
+  Shard* shards = get_shards();
+  for (int i=0; i<Shards; ++i) {
+    ScopedLock hold(shards[i].mutex);
+    count += shards[i].count;
+  }
+#endif
+  return count;
 }
 
-/**
-   Makes a new reference to this object.
+void LeakTracked::showLeaks()
+{
+#ifndef NDEBUG
+  Shard* shards = get_shards();
 
-   You are responsible for removing references using the #unref
-   member function. Remember that for each call to #ref that you made,
-   there should be a corresponding #unref.
+#ifdef VACA_ON_WINDOWS
+  if (getLiveCount() > 0)
+    ::Beep(400, 100);
+#endif
 
-   @see unref
-*/
-void Referenceable::ref()
-{
-  ++m_refCount;
+  for (int i=0; i<Shards; ++i) {
+    ScopedLock hold(shards[i].mutex);
+    for (LeakTracked* node = shards[i].head; node; node = node->m_nextLeak)
+      VACA_TRACE("leak Referenceable %p\n", node);
+  }
+#endif
 }
 
-/**
-   Deletes an old reference to this object.
-
-   If assertions are activated this routine checks that the
-   reference counter never get negative, because that implies
-   an error of the programmer.
+// ======================================================================
+// Referenceable
 
-   @see ref
-*/
-unsigned Referenceable::unref()
+Referenceable::Referenceable()
 {
-  assert(m_refCount > 0);
-  return --m_refCount;
 }
 
-/**
-   Returns the current number of references that this object has.
-
-   If it's zero you can delete the object safely.
-*/
-unsigned Referenceable::getRefCount()
+Referenceable::~Referenceable()
 {
-  return m_refCount;
 }
 
 #ifndef NDEBUG
+/**
+   Reports (using VACA_TRACE) all the referenceable objects that were
+   not deleted.
+*/
 void Referenceable::showLeaks()
 {
-#ifdef VACA_ON_WINDOWS
-  if (!s_list.empty())
-    ::Beep(400, 100);
-#endif
-
-  for (std::vector<Referenceable*>::iterator
-	 it=s_list.begin(); it!=s_list.end(); ++it) {
-    VACA_TRACE("leak Referenceable %p\n", *it);
-  }
+  LeakTracked::showLeaks();
 }
 #endif
@@ -10,32 +10,293 @@
 #include "vaca/base.h"
 #include "vaca/NonCopyable.h"
 
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+
 namespace vaca {
 
+// ======================================================================
+// Reference counter policies
+
+/**
+   Reference counter that can be used from several threads at the
+   same time. It is the default policy of Referenceable.
+
+   New references use a relaxed increment (a new reference can only
+   be created from an existing one, so there is nothing to
+   synchronize), and the decrement has acquire-release semantics so
+   the thread that deletes the object sees all the changes made by
+   the other threads.
+*/
+class AtomicRefCount
+{
+  std::atomic<unsigned> m_count;
+
+public:
+  AtomicRefCount() : m_count(0) { }
+
+  void ref() {
+    m_count.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  unsigned unref() {
+    return m_count.fetch_sub(1, std::memory_order_acq_rel) - 1;
+  }
+
+  // Adds a reference only if the counter is not zero
+  bool tryRef() {
+    unsigned count = m_count.load(std::memory_order_relaxed);
+    while (count != 0)
+      if (m_count.compare_exchange_weak(count, count+1, std::memory_order_acquire,
+					std::memory_order_relaxed))
+	return true;
+    return false;
+  }
+
+  unsigned get() const {
+    return m_count.load(std::memory_order_relaxed);
+  }
+};
+
+/**
+   Plain reference counter for objects that are used only from one
+   thread (like widgets, which are bound to the thread that created
+   them).
+*/
+class NonAtomicRefCount
+{
+  unsigned m_count;
+
+public:
+  NonAtomicRefCount() : m_count(0) { }
+
+  void ref() { ++m_count; }
+  unsigned unref() { return --m_count; }
+  bool tryRef() { return m_count != 0 ? (++m_count, true): false; }
+  unsigned get() const { return m_count; }
+};
+
+// ======================================================================
+// details::LeakTracked
+
+namespace details {
+
+  /**
+     In debug builds, keeps all the referenceable objects in a list to
+     report leaks (see Referenceable#showLeaks).
+
+     The list is intrusive (each object is a node) and it is split in
+     shards selected by the address of the object, so adding and
+     removing an object takes constant time and threads that create
+     objects rarely wait for each other.
+
+     The class has the same members in all builds (in release builds
+     the links are not used), so the size of the objects does not
+     depend on the NDEBUG setting of the application that includes
+     this header.
+
+     @internal
+  */
+  class VACA_DLL LeakTracked
+  {
+    LeakTracked* m_prevLeak;
+    LeakTracked* m_nextLeak;
+
+  protected:
+    LeakTracked();
+    ~LeakTracked();
+
+  public:
+    static std::size_t getLiveCount();
+    static void showLeaks();
+
+  private:
+    LeakTracked(const LeakTracked&);
+    LeakTracked& operator=(const LeakTracked&);
+  };
+
+  /**
+     Control block shared by a referenceable object and its WeakPtrs.
+
+     It is created when the first WeakPtr to the object is created, and
+     it lives until the object and all its WeakPtrs are destroyed. The
+     object holds one reference to the block.
+
+     @internal
+  */
+  class WeakRefBlock
+  {
+    std::atomic<unsigned> m_refs;
+    std::atomic_flag m_lock;
+    bool m_expired;
+
+  public:
+    WeakRefBlock() : m_refs(1), m_expired(false) {
+      m_lock.clear();
+    }
+
+    void ref() {
+      m_refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void unref() {
+      if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	delete this;
+    }
+
+    // The lock is held only to check/modify m_expired and to add a
+    // reference to the object, so it never waits for long
+    void lock() {
+      while (m_lock.test_and_set(std::memory_order_acquire))
+	;
+    }
+
+    void unlock() {
+      m_lock.clear(std::memory_order_release);
+    }
+
+    bool isExpired() const { return m_expired; }
+
+    // Called by the object before it is deleted
+    void expire() {
+      lock();
+      m_expired = true;
+      unlock();
+      unref();
+    }
+  };
+
+} // namespace details
+
+// ======================================================================
+// BasicReferenceable
+
 /**
    Class that counts references and can be wrapped by a SharedPtr.
+
+   @tparam RefCount The reference counter policy: AtomicRefCount or
+		    NonAtomicRefCount.
+
+   @see Referenceable
 */
-class VACA_DLL Referenceable : private NonCopyable
+template<class RefCount>
+class BasicReferenceable : private NonCopyable
+			 , public details::LeakTracked
 {
   template<class> friend class SharedPtr;
-  unsigned m_refCount;
+  template<class> friend class WeakPtr;
+
+  RefCount m_refCount;
+  std::atomic<details::WeakRefBlock*> m_weakRefBlock;
 
 public:
 
-  Referenceable();
-  virtual ~Referenceable();
+  /**
+     Constructs a new referenceable object starting with zero references.
+  */
+  BasicReferenceable() : m_weakRefBlock(NULL) { }
+
+  /**
+     Destroys a referenceable object.
+
+     When compiling with assertions it checks that the references'
+     counter is really zero.
+
+     The WeakPtrs to this object are expired.
+  */
+  virtual ~BasicReferenceable() {
+    assert(m_refCount.get() == 0);
+
+    details::WeakRefBlock* block = m_weakRefBlock.load(std::memory_order_acquire);
+    if (block)
+      block->expire();
+  }
+
+  /**
+     Makes a new reference to this object.
+
+     You are responsible for removing references using the #unref
+     member function. Remember that for each call to #ref that you made,
+     there should be a corresponding #unref.
+
+     @see unref
+  */
+  void ref() {
+    m_refCount.ref();
+  }
+
+  /**
+     Deletes an old reference to this object.
+
+     If assertions are activated this routine checks that the
+     reference counter never get negative, because that implies
+     an error of the programmer.
 
-  void ref();
-  unsigned unref();
+     @return The number of references after removing this one.
 
-  unsigned getRefCount();
+     @see ref
+  */
+  unsigned unref() {
+    assert(m_refCount.get() > 0);
+    return m_refCount.unref();
+  }
+
+  /**
+     Returns the current number of references that this object has.
+
+     If it's zero you can delete the object safely.
+  */
+  unsigned getRefCount() const {
+    return m_refCount.get();
+  }
+
+private:
+
+  /**
+     Called by SharedPtr to destroy the referenceable.
+  */
+  void destroy() {
+    delete this;
+  }
+
+  /**
+     Returns the control block for WeakPtrs, creating it the first time.
+     The caller must have a reference to this object.
+  */
+  details::WeakRefBlock* getWeakRefBlock() {
+    details::WeakRefBlock* block = m_weakRefBlock.load(std::memory_order_acquire);
+    if (!block) {
+      details::WeakRefBlock* newBlock = new details::WeakRefBlock;
+      if (m_weakRefBlock.compare_exchange_strong(block, newBlock,
+						 std::memory_order_acq_rel))
+	block = newBlock;
+      else
+	delete newBlock;	// other thread created it first
+    }
+    return block;
+  }
+};
+
+// ======================================================================
+// Referenceable
+
+/**
+   Referenceable object with an atomic reference counter, so
+   SharedPtrs to it can be used in different threads (e.g. an Image
+   loaded in a worker thread and painted in the UI thread).
+
+   @see BasicReferenceable, SharedPtr
+*/
+class VACA_DLL Referenceable : public BasicReferenceable<AtomicRefCount>
+{
+public:
+  Referenceable();
+  virtual ~Referenceable();
 
 #ifndef NDEBUG
   static void showLeaks();
 #endif
-
-private:
-  void destroy();
 };
 
 } // namespace vaca
@@ -6,39 +6,496 @@
 
 #include "vaca/Region.h"
 #include "vaca/Rect.h"
-#include "vaca/Debug.h"
 #include "vaca/Point.h"
 #include "vaca/Size.h"
-#include "vaca/win32.h"
+#include "vaca/SmallObject.h"
+
+#ifdef VACA_WINDOWS
+  #include "vaca/win32.h"
+#endif
+
+#include <cassert>
+#include <climits>
+#include <cmath>
+#include <vector>
 
 using namespace vaca;
 
+// Operations as truth tables: bit (inA*2 + inB) says if a point which
+// is (or not) in each region is in the result
+enum {
+  Union     = 14,		// 1110
+  Intersect = 8,		// 1000
+  Subtract  = 4,		// 0100
+  Xor       = 6			// 0110
+};
+
+namespace {
+
+  // A rectangle of a region (from x1 to x2-1 and from y1 to y2-1)
+  struct Box {
+    int x1, y1, x2, y2;
+  };
+
+}
+
+static inline bool is_inside(int op, bool inA, bool inB)
+{
+  return ((op >> ((inA ? 2: 0) + (inB ? 1: 0))) & 1) != 0;
+}
+
+// The rectangles of a Region. If the region is empty or a rectangle,
+// "boxes" is empty and "extents" is the rectangle (so the simple
+// regions do not allocate memory for boxes).
+class Region::Data : public Referenceable
+		   , public SmallObject
+{
+public:
+  Box extents;
+  std::vector<Box> boxes;
+#ifdef VACA_WINDOWS
+  mutable HRGN hrgn;		// created by Region::getHandle
+#endif
+
+  Data() {
+#ifdef VACA_WINDOWS
+    hrgn = NULL;
+#endif
+    setRect(0, 0, 0, 0);
+  }
+
+  virtual ~Data() {
+    changed();
+  }
+
+  const Box* begin() const { return boxes.empty() ? &extents: &boxes[0]; }
+  const Box* end() const { return begin() + size(); }
+
+  std::size_t size() const {
+    if (!boxes.empty())
+      return boxes.size();
+    else
+      return extents.x1 < extents.x2 ? 1: 0;
+  }
+
+  void setRect(int x1, int y1, int x2, int y2) {
+    boxes.clear();
+    if (x1 < x2 && y1 < y2) {
+      extents.x1 = x1;
+      extents.y1 = y1;
+      extents.x2 = x2;
+      extents.y2 = y2;
+    }
+    else
+      extents.x1 = extents.y1 = extents.x2 = extents.y2 = 0;
+    changed();
+  }
+
+  void copy(const Data& other) {
+    if (this != &other) {
+      extents = other.extents;
+      boxes = other.boxes;
+      changed();
+    }
+  }
+
+  void assign(std::vector<Box>& res);
+  void replace(std::size_t from, std::size_t to, const std::vector<Box>& res);
+  void update();
+  void combine(const Data& a, const Data& b, int op);
+
+  // The cached HRGN is not valid after modifying the boxes
+  void changed() {
+#ifdef VACA_WINDOWS
+    if (hrgn) {
+      ::DeleteObject(hrgn);
+      hrgn = NULL;
+    }
+#endif
+  }
+};
+
+static inline bool overlap(const Box& a, const Box& b)
+{
+  return (a.x1 < b.x2 && b.x1 < a.x2 &&
+	  a.y1 < b.y2 && b.y1 < a.y2);
+}
+
+static inline bool contains_box(const Box& a, const Box& b)
+{
+  return (a.x1 <= b.x1 && b.x2 <= a.x2 &&
+	  a.y1 <= b.y1 && b.y2 <= a.y2);
+}
+
+// Returns the first box in [it, end) with some part below the row "y"
+// (the y2 of the boxes is sorted, so it is a binary search)
+static const Box* first_below(const Box* it, const Box* end, int y)
+{
+  std::size_t n = end - it;
+  while (n > 0) {
+    std::size_t half = n / 2;
+    if (it[half].y2 <= y) {
+      it += half+1;
+      n -= half+1;
+    }
+    else
+      n = half;
+  }
+  return it;
+}
+
+// Returns the first box in [it, end) which starts in the row "y" or
+// below it
+static const Box* first_from(const Box* it, const Box* end, int y)
+{
+  std::size_t n = end - it;
+  while (n > 0) {
+    std::size_t half = n / 2;
+    if (it[half].y1 < y) {
+      it += half+1;
+      n -= half+1;
+    }
+    else
+      n = half;
+  }
+  return it;
+}
+
+// Returns the end of the band that starts in "box"
+static inline const Box* band_end(const Box* box, const Box* end)
+{
+  const Box* it = box;
+  while (it != end && it->y1 == box->y1)
+    ++it;
+  return it;
+}
+
+// Adds the rectangles in the row [y1, y2) of the points that are in
+// the result of "op" with the spans [a, aEnd) and [b, bEnd)
+static void merge_spans(const Box* a, const Box* aEnd,
+			const Box* b, const Box* bEnd,
+			int op, int y1, int y2, std::vector<Box>& res)
+{
+  std::size_t start = res.size();
+  int x = std::min(a != aEnd ? a->x1: INT_MAX,
+		   b != bEnd ? b->x1: INT_MAX);
+
+  for (;;) {
+    while (a != aEnd && a->x2 <= x) ++a;
+    while (b != bEnd && b->x2 <= x) ++b;
+    if (a == aEnd && b == bEnd)
+      break;
+
+    bool inA = (a != aEnd && a->x1 <= x);
+    bool inB = (b != bEnd && b->x1 <= x);
+    int next = INT_MAX;
+    if (a != aEnd) next = inA ? a->x2: a->x1;
+    if (b != bEnd) next = std::min(next, inB ? b->x2: b->x1);
+
+    if (is_inside(op, inA, inB)) {
+      if (res.size() > start && res.back().x2 == x)
+	res.back().x2 = next;
+      else {
+	Box box = { x, y1, next, y2 };
+	res.push_back(box);
+      }
+    }
+    x = next;
+  }
+}
+
+// Returns the index of the first box of the last band of "res"
+static std::size_t band_start(const std::vector<Box>& res)
+{
+  std::size_t i = res.size() - 1;
+  while (i > 0 && res[i-1].y1 == res.back().y1)
+    --i;
+  return i;
+}
+
+// Merges the last band of "res" (which starts in "band") with the
+// previous one (which starts in "prevBand") if they have the same
+// spans and one is just below the other.
+static bool coalesce(std::vector<Box>& res, std::size_t prevBand, std::size_t band)
+{
+  std::size_t n = res.size() - band;
+  if (band - prevBand != n || res[prevBand].y2 != res[band].y1)
+    return false;
+
+  for (std::size_t i=0; i<n; ++i)
+    if (res[prevBand+i].x1 != res[band+i].x1 ||
+	res[prevBand+i].x2 != res[band+i].x2)
+      return false;
+
+  int y2 = res[band].y2;
+  for (std::size_t i=0; i<n; ++i)
+    res[prevBand+i].y2 = y2;
+  res.resize(band);
+  return true;
+}
+
+// Combines the bands of [a, aEnd) and [b, bEnd), which must be sorted
+// from top to bottom, with the operation "op". The result is added to
+// the bands of "res" (which must be above the new ones).
+static void combine_bands(const Box* a, const Box* aEnd,
+			  const Box* b, const Box* bEnd,
+			  int op, std::vector<Box>& res)
+{
+  // bands that are only in "a" (or "b") are copied to the result or skipped
+  bool keepA = is_inside(op, true, false);
+  bool keepB = is_inside(op, false, true);
+  std::size_t prevBand = (res.empty() ? std::size_t(-1): band_start(res));
+  int y = INT_MIN;
+
+  while ((a != aEnd && (keepA || b != bEnd)) ||
+	 (b != bEnd && (keepB || a != aEnd))) {
+    const Box* aBand = band_end(a, aEnd);
+    const Box* bBand = band_end(b, bEnd);
+    int aTop = (a != aEnd ? std::max(a->y1, y): INT_MAX);
+    int bTop = (b != bEnd ? std::max(b->y1, y): INT_MAX);
+    int top = std::min(aTop, bTop);
+    bool inA = (aTop == top);
+    bool inB = (bTop == top);
+    int bottom = std::min(inA ? a->y2: aTop,
+			  inB ? b->y2: bTop);
+
+    std::size_t band = res.size();
+    if (inA && inB)
+      merge_spans(a, aBand, b, bBand, op, top, bottom, res);
+    else if ((inA && keepA) || (inB && keepB)) {
+      const Box* it = (inA ? a: b);
+      const Box* end = (inA ? aBand: bBand);
+      for (; it != end; ++it) {
+	Box box = { it->x1, top, it->x2, bottom };
+	res.push_back(box);
+      }
+    }
+
+    if (res.size() > band) {
+      if (prevBand == std::size_t(-1) || !coalesce(res, prevBand, band))
+	prevBand = band;
+    }
+
+    y = bottom;
+    if (inA && a->y2 == bottom) a = aBand;
+    if (inB && b->y2 == bottom) b = bBand;
+  }
+}
+
+// Replaces the boxes with the banded boxes in "res" (which is left
+// with the old ones)
+void Region::Data::assign(std::vector<Box>& res)
+{
+  boxes.swap(res);
+  update();
+}
+
+// Replaces the boxes [from, to) with the banded boxes in "res"
+void Region::Data::replace(std::size_t from, std::size_t to, const std::vector<Box>& res)
+{
+  // the extents are calculated again only if a box in a side is removed
+  Box old = extents;
+  bool sides = false;
+  for (std::size_t i=from; i<to; ++i)
+    if (boxes[i].x1 == old.x1 || boxes[i].x2 == old.x2)
+      sides = true;
+
+  std::size_t size = boxes.size();
+  std::size_t n = res.size();
+  if (n > to - from) {
+    boxes.resize(size + n - (to - from));
+    std::copy_backward(boxes.begin()+to, boxes.begin()+size, boxes.end());
+  }
+  else if (n < to - from) {
+    std::copy(boxes.begin()+to, boxes.end(), boxes.begin()+from+n);
+    boxes.resize(size - (to - from) + n);
+  }
+  std::copy(res.begin(), res.end(), boxes.begin()+from);
+
+  if (sides || boxes.size() <= 1)
+    update();
+  else {
+    extents.y1 = boxes.front().y1;
+    extents.y2 = boxes.back().y2;
+    for (std::vector<Box>::const_iterator it=res.begin(); it!=res.end(); ++it) {
+      extents.x1 = std::min(extents.x1, it->x1);
+      extents.x2 = std::max(extents.x2, it->x2);
+    }
+    changed();
+  }
+}
+
+// Calculates the extents after modifying the boxes
+void Region::Data::update()
+{
+  if (boxes.size() <= 1) {
+    if (boxes.empty())
+      setRect(0, 0, 0, 0);
+    else
+      setRect(boxes[0].x1, boxes[0].y1, boxes[0].x2, boxes[0].y2);
+    return;
+  }
+
+  extents.x1 = INT_MAX;
+  extents.x2 = INT_MIN;
+  extents.y1 = boxes.front().y1;
+  extents.y2 = boxes.back().y2;
+  for (std::vector<Box>::iterator it=boxes.begin(); it!=boxes.end(); ++it) {
+    extents.x1 = std::min(extents.x1, it->x1);
+    extents.x2 = std::max(extents.x2, it->x2);
+  }
+  changed();
+}
+
+// Puts in this region the result of the operation "op" with the
+// regions "a" and "b" (any of them can be this same region)
+void Region::Data::combine(const Data& a, const Data& b, int op)
+{
+  const Box& ea = a.extents;
+  const Box& eb = b.extents;
+  bool aSimple = a.boxes.empty();
+  bool bSimple = b.boxes.empty();
+
+  // fast paths when a region is empty or a rectangle, or when the
+  // regions do not overlap
+  switch (op) {
+
+    case Union:
+      if (a.size() == 0 || (bSimple && contains_box(eb, ea)))
+	return copy(b);
+      if (b.size() == 0 || (aSimple && contains_box(ea, eb)))
+	return copy(a);
+      // two rectangles that form a rectangle
+      if (aSimple && bSimple &&
+	  ((ea.y1 == eb.y1 && ea.y2 == eb.y2 && ea.x1 <= eb.x2 && eb.x1 <= ea.x2) ||
+	   (ea.x1 == eb.x1 && ea.x2 == eb.x2 && ea.y1 <= eb.y2 && eb.y1 <= ea.y2)))
+	return setRect(std::min(ea.x1, eb.x1), std::min(ea.y1, eb.y1),
+		       std::max(ea.x2, eb.x2), std::max(ea.y2, eb.y2));
+      break;
+
+    case Intersect:
+      if (!overlap(ea, eb))
+	return setRect(0, 0, 0, 0);
+      if (aSimple && bSimple)
+	return setRect(std::max(ea.x1, eb.x1), std::max(ea.y1, eb.y1),
+		       std::min(ea.x2, eb.x2), std::min(ea.y2, eb.y2));
+      if (aSimple && contains_box(ea, eb))
+	return copy(b);
+      if (bSimple && contains_box(eb, ea))
+	return copy(a);
+      break;
+
+    case Subtract:
+      if (!overlap(ea, eb))
+	return copy(a);
+      if (bSimple && contains_box(eb, ea))
+	return setRect(0, 0, 0, 0);
+      break;
+
+    case Xor:
+      if (a.size() == 0)
+	return copy(b);
+      if (b.size() == 0)
+	return copy(a);
+      break;
+  }
+
+  // only the bands of "a" which are beside "b" can change (the other
+  // ones are copied or skipped), and the previous and next bands are
+  // combined too because they could be merged with the new ones
+  const Box* first = a.begin();
+  const Box* last = a.end();
+  const Box* from = first_below(first, last, eb.y1);
+  const Box* to = first_from(from, last, eb.y2);
+  bool keepA = is_inside(op, true, false);
+  if (keepA) {
+    if (from != first) from = first_below(first, from, (from-1)->y1);
+    if (to != last) to = band_end(to, last);
+  }
+
+  std::vector<Box> res;
+
+  // "b" is combined with a part of this region, which is modified in
+  // its place (e.g. adding a rectangle to a big region)
+  if (keepA && this == &a && !boxes.empty()) {
+    combine_bands(from, to, b.begin(), b.end(), op, res);
+    replace(from - first, to - first, res);
+    return;
+  }
+
+  res.reserve(a.size() + b.size());
+  if (keepA)
+    res.assign(first, from);
+  combine_bands(from, to, b.begin(), b.end(), op, res);
+  if (keepA)
+    res.insert(res.end(), to, last);
+  assign(res);
+}
+
 Region::Region()
-  : SharedPtr<GdiObject<HRGN> >(new GdiObject<HRGN>(CreateRectRgn(0, 0, 0, 0)))
+  : m_data(new Data)
 {
-  assert(getHandle()); // TODO exception
 }
 
 Region::Region(const Region& rgn)
-  : SharedPtr<GdiObject<HRGN> >(rgn)
+  : m_data(rgn.m_data)
 {
 }
 
-Region::Region(HRGN hrgn)
-  : SharedPtr<GdiObject<HRGN> >(new GdiObject<HRGN>)
+Region::Region(Region&& rgn)
+  : m_data(std::move(rgn.m_data))
 {
-  assert(hrgn);
-  get()->setHandle(hrgn);
 }
 
+/**
+   Creates a region with the rectangle @a rc (or an empty region if
+   the rectangle is empty).
+*/
 Region::Region(const Rect& rc)
-  : SharedPtr<GdiObject<HRGN> >(new GdiObject<HRGN>)
+  : m_data(new Data)
 {
-  RECT _rc = convert_to<RECT>(rc);
-  get()->setHandle(CreateRectRgnIndirect(&_rc));
-  assert(getHandle()); // TODO exception
+  m_data->setRect(rc.x, rc.y, rc.x+rc.w, rc.y+rc.h);
 }
 
+#ifdef VACA_WINDOWS
+
+/**
+   Creates a region with the rectangles of the Win32 region @a hrgn.
+
+   The Region is the owner of the handle (it will be deleted with
+   DeleteObject), and it is returned by #getHandle until the Region
+   is modified.
+*/
+Region::Region(HRGN hrgn)
+  : m_data(new Data)
+{
+  assert(hrgn);
+
+  DWORD size = GetRegionData(hrgn, 0, NULL);
+  std::vector<char> buf(size);
+  RGNDATA* data = reinterpret_cast<RGNDATA*>(&buf[0]);
+  if (size > 0 && GetRegionData(hrgn, size, data) == size) {
+    const RECT* rects = reinterpret_cast<const RECT*>(data->Buffer);
+    std::vector<Box> boxes(data->rdh.nCount);
+    for (std::size_t i=0; i<boxes.size(); ++i) {
+      Box box = { rects[i].left, rects[i].top, rects[i].right, rects[i].bottom };
+      boxes[i] = box;
+    }
+
+    // Win32 regions are banded too, but the bands are merged again
+    // to get the same boxes of the other regions
+    std::vector<Box> res;
+    res.reserve(boxes.size());
+    if (!boxes.empty())
+      combine_bands(&boxes[0], &boxes[0] + boxes.size(), NULL, NULL, Union, res);
+    m_data->assign(res);
+  }
+
+  m_data->hrgn = hrgn;
+}
+
+#endif
+
 Region::~Region()
 {
 }
@@ -48,10 +505,7 @@ Region::~Region()
 */
 bool Region::isEmpty() const
 {
-  assert(getHandle());
-
-  RECT rc;
-  return GetRgnBox(getHandle(), &rc) == NULLREGION;
+  return m_data->size() == 0;
 }
 
 /**
@@ -61,10 +515,7 @@ bool Region::isEmpty() const
 */
 bool Region::isSimple() const
 {
-  assert(getHandle());
-
-  RECT rc;
-  return GetRgnBox(getHandle(), &rc) == SIMPLEREGION;
+  return m_data->size() == 1;
 }
 
 /**
@@ -72,29 +523,25 @@ bool Region::isSimple() const
 */
 bool Region::isComplex() const
 {
-  assert(getHandle());
-
-  RECT rc;
-  return GetRgnBox(getHandle(), &rc) == COMPLEXREGION;
+  return m_data->size() > 1;
 }
 
 Region& Region::operator=(const Region& rgn)
 {
-  SharedPtr<GdiObject<HRGN> >::operator=(rgn);
+  m_data = rgn.m_data;
   return *this;
 }
 
-Region Region::clone() const
+Region& Region::operator=(Region&& rgn)
 {
-  assert(getHandle());
+  m_data = std::move(rgn.m_data);
+  return *this;
+}
 
-  // copy the this region to "rgn"
+Region Region::clone() const
+{
   Region copy;
-  int res = CombineRgn(copy->getHandle(), getHandle(), NULL, RGN_COPY);
-  if (res == ERROR) {
-    assert(false);	// TODO exception
-  }
-
+  copy.m_data->copy(*m_data);
   return copy;
 }
 
@@ -106,20 +553,86 @@ Region Region::clone() const
 */
 Rect Region::getBounds() const
 {
-  assert(getHandle());
+  const Box& e = m_data->extents;
+  return Rect(e.x1, e.y1, e.x2 - e.x1, e.y2 - e.y1);
+}
 
-  RECT rc;
-  int res = GetRgnBox(getHandle(), &rc);
+/**
+   Returns the rectangles of the region. They do not overlap, their
+   union is the region, and they are sorted by their top side and then
+   by their left side.
+
+   @code
+   for (const Rect& rc : rgn.rects(true))
+     g.fillRect(brush, rc);
+   @endcode
+
+   @param coalesce
+     If it is false the rectangles are the bands of the region (each
+     band is a row of rectangles with the same top and bottom). If it
+     is true, the rectangles of consecutive bands with the same left
+     and right sides are joined, so there are less rectangles (e.g. a
+     tall rectangle with a small one at its side is two rectangles
+     instead of four). Use it to paint or copy each rectangle.
+*/
+std::vector<Rect> Region::rects(bool coalesce) const
+{
+  std::vector<Rect> res;
+  res.reserve(m_data->size());
+
+  if (!coalesce) {
+    for (const Box* it=m_data->begin(); it!=m_data->end(); ++it)
+      res.push_back(Rect(it->x1, it->y1, it->x2 - it->x1, it->y2 - it->y1));
+    return res;
+  }
 
-  if (res == NULLREGION)
-    return Rect();		// empty rectangle
-  else
-    return convert_to<Rect>(rc);
+  // "open" has the rectangles that end in the previous band (sorted by
+  // their left side, like the boxes of each band)
+  std::vector<std::size_t> open, next;
+  const Box* end = m_data->end();
+
+  for (const Box* it=m_data->begin(); it!=end; ) {
+    const Box* bandEnd = it;
+    while (bandEnd != end && bandEnd->y1 == it->y1)
+      ++bandEnd;
+
+    std::vector<std::size_t>::const_iterator o = open.begin();
+    for (; it!=bandEnd; ++it) {
+      while (o != open.end() && res[*o].x < it->x1)
+	++o;
+
+      if (o != open.end()) {
+	Rect& rc = res[*o];
+	if (rc.x == it->x1 && rc.x+rc.w == it->x2 && rc.y+rc.h == it->y1) {
+	  rc.h = it->y2 - rc.y;
+	  next.push_back(*o);
+	  continue;
+	}
+      }
+
+      next.push_back(res.size());
+      res.push_back(Rect(it->x1, it->y1, it->x2 - it->x1, it->y2 - it->y1));
+    }
+
+    open.swap(next);
+    next.clear();
+  }
+  return res;
 }
 
 Region& Region::offset(int dx, int dy)
 {
-  OffsetRgn(getHandle(), dx, dy);
+  if (m_data->size() > 0) {
+    Box& e = m_data->extents;
+    e.x1 += dx; e.y1 += dy;
+    e.x2 += dx; e.y2 += dy;
+
+    for (std::vector<Box>::iterator it=m_data->boxes.begin(); it!=m_data->boxes.end(); ++it) {
+      it->x1 += dx; it->y1 += dy;
+      it->x2 += dx; it->y2 += dy;
+    }
+    m_data->changed();
+  }
   return *this;
 }
 
@@ -128,29 +641,47 @@ Region& Region::offset(const Point& point)
   return offset(point.x, point.y);
 }
 
+/**
+   Returns true if the point @a pt is inside the region.
+*/
 bool Region::contains(const Point& pt) const
 {
-  assert(getHandle());
-
-  return PtInRegion(getHandle(), pt.x, pt.y) != FALSE;
+  return contains(Rect(pt.x, pt.y, 1, 1));
 }
 
+/**
+   Returns true if some part of the rectangle @a rc is inside the
+   region (like the RectInRegion function of Win32).
+*/
 bool Region::contains(const Rect& rc) const
 {
-  assert(getHandle());
-
-  RECT rc2 = convert_to<RECT>(rc);
-  return RectInRegion(getHandle(), &rc2) != FALSE;
+  Box box = { rc.x, rc.y, rc.x+rc.w, rc.y+rc.h };
+  if (box.x1 >= box.x2 || box.y1 >= box.y2 ||
+      !overlap(m_data->extents, box))
+    return false;
+  if (m_data->boxes.empty())
+    return true;
+
+  const Box* end = m_data->end();
+  const Box* it = first_below(m_data->begin(), end, box.y1);
+  for (; it != end && it->y1 < box.y2; ++it)
+    if (it->x1 < box.x2 && box.x1 < it->x2)
+      return true;
+  return false;
 }
 
 bool Region::operator==(const Region& rgn) const
 {
-  BOOL res = EqualRgn(getHandle(), rgn.getHandle()) != FALSE;
-
-  if (res == ERROR)
+  const Data& a = *m_data;
+  const Data& b = *rgn.m_data;
+  if (a.size() != b.size())
     return false;
-  else
-    return res != FALSE;
+
+  for (const Box* it=a.begin(), *it2=b.begin(); it!=a.end(); ++it, ++it2)
+    if (it->x1 != it2->x1 || it->y1 != it2->y1 ||
+	it->x2 != it2->x2 || it->y2 != it2->y2)
+      return false;
+  return true;
 }
 
 bool Region::operator!=(const Region& rgn) const
@@ -158,15 +689,18 @@ bool Region::operator!=(const Region& rgn) const
   return !operator==(rgn);
 }
 
-Region Region::operator|(const Region& rgn) const
+Region Region::combine(const Region& rgn, int op) const
 {
   Region res;
-  CombineRgn(res.getHandle(),
-	     this->getHandle(),
-	     rgn.getHandle(), RGN_OR);
+  res.m_data->combine(*m_data, *rgn.m_data, op);
   return res;
 }
 
+Region Region::operator|(const Region& rgn) const
+{
+  return combine(rgn, Union);
+}
+
 Region Region::operator+(const Region& rgn) const
 {
   return operator|(rgn);
@@ -174,29 +708,17 @@ Region Region::operator+(const Region& rgn) const
 
 Region Region::operator&(const Region& rgn) const
 {
-  Region res;
-  CombineRgn(res.getHandle(),
-	     this->getHandle(),
-	     rgn.getHandle(), RGN_AND);
-  return res;
+  return combine(rgn, Intersect);
 }
 
 Region Region::operator-(const Region& rgn) const
 {
-  Region res;
-  CombineRgn(res.getHandle(),
-	     this->getHandle(),
-	     rgn.getHandle(), RGN_DIFF);
-  return res;
+  return combine(rgn, Subtract);
 }
 
 Region Region::operator^(const Region& rgn) const
 {
-  Region res;
-  CombineRgn(res.getHandle(),
-	     this->getHandle(),
-	     rgn.getHandle(), RGN_XOR);
-  return res;
+  return combine(rgn, Xor);
 }
 
 /**
@@ -205,9 +727,7 @@ Region Region::operator^(const Region& rgn) const
 */
 Region& Region::operator|=(const Region& rgn)
 {
-  CombineRgn(this->getHandle(),
-	     this->getHandle(),
-	     rgn.getHandle(), RGN_OR);
+  m_data->combine(*m_data, *rgn.m_data, Union);
   return *this;
 }
 
@@ -226,9 +746,7 @@ Region& Region::operator+=(const Region& rgn)
 */
 Region& Region::operator&=(const Region& rgn)
 {
-  CombineRgn(this->getHandle(),
-	     this->getHandle(),
-	     rgn.getHandle(), RGN_AND);
+  m_data->combine(*m_data, *rgn.m_data, Intersect);
   return *this;
 }
 
@@ -237,9 +755,7 @@ Region& Region::operator&=(const Region& rgn)
 */
 Region& Region::operator-=(const Region& rgn)
 {
-  CombineRgn(this->getHandle(),
-	     this->getHandle(),
-	     rgn.getHandle(), RGN_DIFF);
+  m_data->combine(*m_data, *rgn.m_data, Subtract);
   return *this;
 }
 
@@ -249,47 +765,129 @@ Region& Region::operator-=(const Region& rgn)
 */
 Region& Region::operator^=(const Region& rgn)
 {
-  CombineRgn(this->getHandle(),
-	     this->getHandle(),
-	     rgn.getHandle(), RGN_XOR);
+  m_data->combine(*m_data, *rgn.m_data, Xor);
   return *this;
 }
 
 /**
    Creates a region from a rectangle.
 */
-Region Region::fromRect(const Rect &_rc)
+Region Region::fromRect(const Rect& rc)
+{
+  return Region(rc);
+}
+
+// Returns the space between the side of a row of an ellipse of w x h
+// and the side of its bounds
+static int ellipse_inset(int row, int w, int h)
 {
-  RECT rc = convert_to<RECT>(_rc);
-  return Region(CreateRectRgnIndirect(&rc));
+  double rx = w / 2.0;
+  double ry = h / 2.0;
+  double dy = (row + 0.5 - ry) / ry;
+  return static_cast<int>(std::floor(rx - rx*std::sqrt(1.0 - dy*dy) + 0.5));
+}
+
+// Adds a row to a shape which is created from top to bottom, merging
+// it with the previous row if it has the same sides
+static void add_row(std::vector<Box>& boxes, int y, int x1, int x2)
+{
+  if (x1 >= x2)
+    return;
+
+  if (!boxes.empty() &&
+      boxes.back().y2 == y &&
+      boxes.back().x1 == x1 &&
+      boxes.back().x2 == x2)
+    ++boxes.back().y2;
+  else {
+    Box box = { x1, y, x2, y+1 };
+    boxes.push_back(box);
+  }
 }
 
 /**
    Creates a region from an ellipse.
 */
-Region Region::fromEllipse(const Rect &_rc)
+Region Region::fromEllipse(const Rect& rc)
 {
-  RECT rc = convert_to<RECT>(_rc);
-  return Region(CreateEllipticRgnIndirect(&rc));
+  std::vector<Box> boxes;
+  for (int row=0; row<rc.h; ++row) {
+    int inset = ellipse_inset(row, rc.w, rc.h);
+    add_row(boxes, rc.y+row, rc.x+inset, rc.x+rc.w-inset);
+  }
+
+  Region rgn;
+  rgn.m_data->assign(boxes);
+  return rgn;
 }
 
 /**
    Creates a region from a rounded rectangle.
 
-   It uses the CreateRoundRectRgn function of Win32.
+   @param ellipseSize
+     Size of the ellipse of the corners (like in the CreateRoundRectRgn
+     function of Win32).
 */
-Region Region::fromRoundRect(const Rect& _rc, const Size& ellipseSize)
+Region Region::fromRoundRect(const Rect& rc, const Size& ellipseSize)
 {
-  RECT rc = convert_to<RECT>(_rc);
-  return Region(CreateRoundRectRgn(rc.left, rc.top,
-				   rc.right, rc.bottom,
-				   ellipseSize.w, ellipseSize.h));
+  int ew = std::min(ellipseSize.w, rc.w);
+  int eh = std::min(ellipseSize.h, rc.h);
+  if (ew <= 0 || eh <= 0)
+    return Region(rc);
+
+  std::vector<Box> boxes;
+  for (int row=0; row<rc.h; ++row) {
+    int inset = 0;
+    if (row < eh/2)
+      inset = ellipse_inset(row, ew, eh);
+    else if (row >= rc.h - eh/2)
+      inset = ellipse_inset(row - (rc.h - eh), ew, eh);
+    add_row(boxes, rc.y+row, rc.x+inset, rc.x+rc.w-inset);
+  }
+
+  Region rgn;
+  rgn.m_data->assign(boxes);
+  return rgn;
 }
 
+#ifdef VACA_WINDOWS
+
 /**
-   Returns the Win32 region handler.
+   Returns a Win32 region with the rectangles of this Region.
+
+   The handle is created the first time that it is needed, and it is
+   valid until the Region is modified (or destroyed).
 */
 HRGN Region::getHandle() const
 {
-  return get()->getHandle();
+  const Data& data = *m_data;
+  if (!data.hrgn) {
+    std::size_t n = data.size();
+    if (n <= 1)
+      data.hrgn = CreateRectRgn(data.extents.x1, data.extents.y1,
+				data.extents.x2, data.extents.y2);
+    else {
+      std::vector<char> buf(sizeof(RGNDATAHEADER) + n*sizeof(RECT));
+      RGNDATA* rgndata = reinterpret_cast<RGNDATA*>(&buf[0]);
+      rgndata->rdh.dwSize = sizeof(RGNDATAHEADER);
+      rgndata->rdh.iType = RDH_RECTANGLES;
+      rgndata->rdh.nCount = static_cast<DWORD>(n);
+      rgndata->rdh.nRgnSize = static_cast<DWORD>(n*sizeof(RECT));
+      SetRect(&rgndata->rdh.rcBound,
+	      data.extents.x1, data.extents.y1,
+	      data.extents.x2, data.extents.y2);
+
+      RECT* rects = reinterpret_cast<RECT*>(rgndata->Buffer);
+      for (std::size_t i=0; i<n; ++i)
+	SetRect(&rects[i],
+		data.boxes[i].x1, data.boxes[i].y1,
+		data.boxes[i].x2, data.boxes[i].y2);
+
+      data.hrgn = ExtCreateRegion(NULL, static_cast<DWORD>(buf.size()), rgndata);
+    }
+    assert(data.hrgn); // TODO exception
+  }
+  return data.hrgn;
 }
+
+#endif
@@ -8,23 +8,47 @@
 #define VACA_REGION_H
 
 #include "vaca/base.h"
-#include "vaca/GdiObject.h"
 #include "vaca/SharedPtr.h"
 
+#include <vector>
+
 namespace vaca {
 
 /**
    A region, it can be simple as a rectangle, complex as any shape,
    but also can be empty.
+
+   The region is a set of rectangles sorted in horizontal bands (like
+   the regions of X11): the rectangles of a band have the same top and
+   bottom, and the bands are sorted from top to bottom. The union,
+   intersection, substraction and XOR of two regions are calculated
+   going through the bands of both regions at the same time, in time
+   proportional to the number of rectangles (and a lot faster when
+   some of the regions is just a rectangle).
+
+   A Region does not use resources of the operating system. A Win32
+   region (HRGN) is created only when it is needed by the Win32 API
+   (see #getHandle).
+
+   Like other graphics objects (e.g. Pen or Brush), copies of a Region
+   share the same rectangles: modifying one of them (e.g. with @c |=)
+   modifies all of them. Use #clone to get an independent copy.
 */
-class VACA_DLL Region : private SharedPtr<GdiObject<HRGN> >
+class VACA_DLL Region
 {
+  class Data;
+
+  SharedPtr<Data> m_data;
+
 public:
 
   Region();
   Region(const Region& rgn);
-  explicit Region(HRGN hrgn);
+  Region(Region&& rgn);
   explicit Region(const Rect& rc);
+#ifdef VACA_WINDOWS
+  explicit Region(HRGN hrgn);
+#endif
   virtual ~Region();
 
   bool isEmpty() const;
@@ -32,9 +56,11 @@ public:
   bool isComplex() const;
 
   Region& operator=(const Region& rgn);
+  Region& operator=(Region&& rgn);
   Region clone() const;
 
   Rect getBounds() const;
+  std::vector<Rect> rects(bool coalesce = false) const;
 
   Region& offset(int dx, int dy);
   Region& offset(const Point& point);
@@ -61,7 +87,12 @@ public:
   static Region fromEllipse(const Rect& rc);
   static Region fromRoundRect(const Rect& rc, const Size& ellipseSize);
 
+#ifdef VACA_WINDOWS
   HRGN getHandle() const;
+#endif
+
+private:
+  Region combine(const Region& rgn, int op) const;
 
 };
 
@@ -194,15 +194,131 @@ void SciEdit::searchAnchor()
 
 bool SciEdit::searchNext(int flags, String& str)
 {
+  std::string text = encodeText(str);
   return sendMessage(SCI_SEARCHNEXT,
 		     flags,
-		     reinterpret_cast<LPARAM>(str.c_str())) >= 0;
+		     reinterpret_cast<LPARAM>(text.c_str())) >= 0;
 }
 
 bool SciEdit::searchPrev(int flags, String& str)
 {
+  std::string text = encodeText(str);
   return sendMessage(SCI_SEARCHPREV, flags,
-		     reinterpret_cast<LPARAM>(str.c_str())) >= 0;
+		     reinterpret_cast<LPARAM>(text.c_str())) >= 0;
+}
+
+// The document is searched in windows of this size (plus the length
+// of the needle), starting from the selection
+static const int search_window_size = 64*1024;
+
+/**
+   Selects the next match of @a search after the selection.
+
+   The search is done in the bytes of the document, so the needle must
+   be in the same encoding (see #encodeText). Unlike #searchNext, the
+   same @a search can be used for each "Find Next" without preparing
+   the needle again.
+
+   The bytes are copied from the editor in small windows starting at
+   the selection, so the nearest matches are found without copying the
+   whole document.
+
+   @return False if there is not a next match (the selection is not
+	   modified).
+*/
+bool SciEdit::findNext(const Utf8TextSearch& search)
+{
+  const int n = search.size();
+  const int length = getTextLength();
+
+  for (int from = getSelectionEnd(); from < length; from += search_window_size) {
+    // One byte before and after the matches of this window are
+    // included, so whole words can be checked
+    int start = from > 0 ? from-1: 0;
+    int end = min_value(length, from + search_window_size + n);
+    getTextRange(start, end, m_searchWindow);
+
+    std::size_t pos = search.findNext(m_searchWindow, from - start);
+    if (pos != Utf8TextSearch::npos &&
+	(end == length || start+static_cast<int>(pos) < from+search_window_size)) {
+      pos += start;
+      goToPos(pos + n);
+      setAnchor(pos);
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+   Selects the previous match of @a search before the selection.
+
+   @return False if there is not a previous match (the selection is not
+	   modified).
+*/
+bool SciEdit::findPrev(const Utf8TextSearch& search)
+{
+  const int n = search.size();
+  const int length = getTextLength();
+
+  // look for matches that start in [from, before)
+  for (int before = getSelectionStart(); before > 0; before -= search_window_size) {
+    int from = max_value(0, before - search_window_size);
+    int start = from > 0 ? from-1: 0;
+    int end = min_value(length, before + n);
+    getTextRange(start, end, m_searchWindow);
+
+    std::size_t pos = search.findPrev(m_searchWindow, before - start);
+    if (pos != Utf8TextSearch::npos && start+static_cast<int>(pos) >= from) {
+      pos += start;
+      goToPos(pos);
+      setAnchor(pos + n);
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+   Adds to @a positions the position of each match of @a search in the
+   document (e.g. to highlight all of them). The document is searched
+   only once.
+*/
+void SciEdit::findAll(const Utf8TextSearch& search, std::vector<std::size_t>& positions) const
+{
+  const int n = search.size();
+  const int length = getTextLength();
+
+  for (int from = 0; n > 0 && from < length; ) {
+    int start = from > 0 ? from-1: 0;
+    int end = min_value(length, from + search_window_size + n);
+    int limit = (end == length ? length: from + search_window_size);
+    getTextRange(start, end, m_searchWindow);
+
+    // matches that start in [from, limit), the last one can end after limit
+    int next = limit;
+    for (std::size_t pos = search.findNext(m_searchWindow, from - start);
+	 pos != Utf8TextSearch::npos && start+static_cast<int>(pos) < limit;
+	 pos = search.findNext(m_searchWindow, pos + n)) {
+      positions.push_back(start + pos);
+      next = max_value(limit, start + static_cast<int>(pos) + n);
+    }
+    from = next;
+  }
+}
+
+// Copies the bytes in [start, end) of the document
+void SciEdit::getTextRange(int start, int end, std::string& text) const
+{
+  text.resize(end - start + 1);
+
+  TextRange tr;
+  tr.chrg.cpMin = start;
+  tr.chrg.cpMax = end;
+  tr.lpstrText = &text[0];
+  const_cast<SciEdit*>(this)->sendMessage(SCI_GETTEXTRANGE, 0, reinterpret_cast<LPARAM>(&tr));
+
+  text.resize(end - start);
 }
 
 // ======================================================================
@@ -469,6 +585,30 @@ bool SciEdit::getViewEol() const
 // ======================================================================
 // Other settings
 
+void SciEdit::setCodePage(int codePage)
+{
+  sendMessage(SCI_SETCODEPAGE, codePage, 0);
+}
+
+int SciEdit::getCodePage() const
+{
+  return const_cast<SciEdit*>(this)->sendMessage(SCI_GETCODEPAGE, 0, 0);
+}
+
+/**
+   Converts @a str to the encoding of the bytes of the document: UTF-8
+   if the code page is SC_CP_UTF8, or the ANSI code page otherwise.
+
+   Use it to prepare the needle of a Utf8TextSearch for #findNext.
+*/
+std::string SciEdit::encodeText(const String& str) const
+{
+  if (getCodePage() == SC_CP_UTF8)
+    return to_utf8(str);
+  else
+    return convert_to<std::string>(str);
+}
+
 // ======================================================================
 // Brace highlighting
 
@@ -9,6 +9,10 @@
 
 #include "vaca/base.h"
 #include "vaca/Widget.h"
+#include "vaca/TextSearch.h"
+
+#include <string>
+#include <vector>
 
 namespace vaca {
 
@@ -46,6 +50,7 @@ public:
   // Text retrieval and modification
   virtual String getText() const;
   virtual void setText(const String& str);
+  using Widget::setText;
   void setSavePoint();
   String getLine(int line) const;
   void replaceSel(const String& str);
@@ -73,6 +78,9 @@ public:
   void searchAnchor();
   bool searchNext(int flags, String& str);
   bool searchPrev(int flags, String& str);
+  bool findNext(const Utf8TextSearch& search);
+  bool findPrev(const Utf8TextSearch& search);
+  void findAll(const Utf8TextSearch& search, std::vector<std::size_t>& positions) const;
 
   // ======================================================================
   // Searching and replace using target
@@ -287,8 +295,9 @@ public:
 // SCI_GETBUFFEREDDRAW
 // SCI_SETTWOPHASEDRAW(bool twoPhase)
 // SCI_GETTWOPHASEDRAW
-// SCI_SETCODEPAGE(int codePage)
-// SCI_GETCODEPAGE
+  void setCodePage(int codePage);
+  int getCodePage() const;
+  std::string encodeText(const String& str) const;
 // SCI_SETWORDCHARS(<unused>, const char* chars)
 // SCI_SETWHITESPACECHARS(<unused>, const char* chars)
 // SCI_SETCHARSDEFAULT
@@ -619,6 +628,12 @@ protected:
 // SCEN_SETFOCUS
 // SCEN_KILLFOCUS
 
+private:
+  void getTextRange(int start, int end, std::string& text) const;
+
+  // Buffer for the windows of the document that are searched
+  mutable std::string m_searchWindow;
+
 };
 
 } // namespace vaca
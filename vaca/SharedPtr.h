@@ -10,6 +10,8 @@
 #include "vaca/base.h"
 #include "vaca/Referenceable.h"
 
+#include <utility>
+
 namespace vaca {
 
 /**
@@ -26,12 +28,21 @@ namespace vaca {
    The SharedPtr is mainly used to wrap classes that handle
    graphics resources (like Brush, Pen, Image, Icon, etc.).
 
-   @tparam T Must be of Referenceable type, because Referenceable has
-	     the reference counter.
+   Moving a SharedPtr (e.g. returning it by value) does not modify
+   the reference counter. To reference an object without keeping it
+   alive use a WeakPtr.
+
+   @tparam T Must be of Referenceable type (or any BasicReferenceable),
+	     because it has the reference counter.
+
+   @see WeakPtr, make_shared_ptr
 */
 template<class T>
 class SharedPtr
 {
+  template<class> friend class SharedPtr;
+  template<class> friend class WeakPtr;
+
   T* m_ptr;
 
 public:
@@ -56,6 +67,21 @@ public:
     ref();
   }
 
+  /**
+     Takes the reference of @a other (which is left empty) without
+     touching the reference counter.
+  */
+  SharedPtr(SharedPtr<T>&& other) {
+    m_ptr = other.m_ptr;
+    other.m_ptr = NULL;
+  }
+
+  template<class T2>
+  SharedPtr(SharedPtr<T2>&& other) {
+    m_ptr = static_cast<T*>(other.m_ptr);
+    other.m_ptr = NULL;
+  }
+
   virtual ~SharedPtr() {
     unref();
   }
@@ -68,6 +94,12 @@ public:
     }
   }
 
+  void swap(SharedPtr<T>& other) {
+    T* ptr = m_ptr;
+    m_ptr = other.m_ptr;
+    other.m_ptr = ptr;
+  }
+
   SharedPtr& operator=(const SharedPtr<T>& other) {
     if (m_ptr != other.get()) {
       unref();
@@ -87,6 +119,27 @@ public:
     return *this;
   }
 
+  SharedPtr& operator=(SharedPtr<T>&& other) {
+    if (this != &other) {
+      // take the pointer before releasing the old object, it could
+      // be the owner of "other"
+      T* ptr = other.m_ptr;
+      other.m_ptr = NULL;
+      unref();
+      m_ptr = ptr;
+    }
+    return *this;
+  }
+
+  template<class T2>
+  SharedPtr& operator=(SharedPtr<T2>&& other) {
+    T* ptr = static_cast<T*>(other.m_ptr);
+    other.m_ptr = NULL;
+    unref();
+    m_ptr = ptr;
+    return *this;
+  }
+
   inline T* get() const { return m_ptr; }
   inline T& operator*() const { return *m_ptr; }
   inline T* operator->() const { return m_ptr; }
@@ -94,20 +147,45 @@ public:
 
 private:
 
+  struct AdoptRef { };
+
+  // Used by WeakPtr#lock, the reference was already added
+  SharedPtr(T* ptr, AdoptRef) {
+    m_ptr = ptr;
+  }
+
   void ref() {
     if (m_ptr)
-      ((Referenceable*)m_ptr)->ref();
+      m_ptr->ref();
   }
 
   void unref() {
     if (m_ptr) {
-      if (((Referenceable*)m_ptr)->unref() == 0)
-	((Referenceable*)m_ptr)->destroy();
+      if (m_ptr->unref() == 0)
+	m_ptr->destroy();
       m_ptr = NULL;
     }
   }
 };
 
+/**
+   Creates a new object of type @a T (using @a args for its constructor)
+   wrapped in a SharedPtr.
+
+   The reference counter is inside the object (see BasicReferenceable),
+   so there is only one allocation: the object and its counter are in
+   the same block of memory.
+
+   @code
+   SharedPtr<ImageHandle> handle = make_shared_ptr<ImageHandle>();
+   @endcode
+*/
+template<class T, class... Args>
+SharedPtr<T> make_shared_ptr(Args&&... args)
+{
+  return SharedPtr<T>(new T(std::forward<Args>(args)...));
+}
+
 /**
    Compares if two shared-pointers points to the same place (object, memory address).
 
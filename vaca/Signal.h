@@ -10,6 +10,13 @@
 #include "vaca/base.h"
 #include "vaca/Slot.h"
 
+#ifdef VACA_PROFILING
+  #include "vaca/Profiling.h"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
 #include <vector>
 
 namespace vaca {
@@ -20,461 +27,753 @@ namespace vaca {
  */
 
 // ======================================================================
-// Signal0_base<R>
+// Connection
 
-/**
-   Base class for signals which call functions without parameters.
-*/
-template<typename R>
-class Signal0_base
-{
-public:
-  typedef R ReturnType;
-  typedef Slot0<R> SlotType;
-  typedef std::vector<SlotType*> SlotList;
+template<typename Signature>
+class Signal_base;
 
-protected:
-  SlotList m_slots;
+template<typename Signature>
+class QueuedSignal;
 
-public:
-  Signal0_base() { }
-  Signal0_base(const Signal0_base<R>& s)
-  {
-    copy(s);
-  }
-  ~Signal0_base()
-  {
-    disconnectAll();
-  }
+namespace details {
 
-  SlotType* addSlot(SlotType* slot)
-  {
-    m_slots.push_back(slot);
-    return slot;
-  }
+  /**
+     Tells the connections of a signal if the signal still exists. It
+     is shared by the signal and its connections, and it is deleted
+     with the last of them.
 
-  template<typename F>
-  SlotType* connect(const F& f)
+     @internal
+  */
+  class SignalLife
   {
-    return addSlot(new Slot0_fun<R, F>(f));
-  }
+    std::atomic<unsigned> m_refs;
+    std::atomic<bool> m_alive;
 
-  template<class T>
-  SlotType* connect(R (T::*m)(), T* t)
-  {
-    return addSlot(new Slot0_mem<R, T>(m, t));
-  }
+  public:
+    SignalLife() : m_refs(1), m_alive(true) { }
 
-  const SlotList& getSlots() const
-  {
-    return m_slots;
+    void ref() {
+      m_refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void unref() {
+      if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	delete this;
+    }
+
+    bool isAlive() const {
+      return m_alive.load(std::memory_order_acquire);
+    }
+
+    // Called by the signal when it is destroyed (or when it is
+    // assigned, so the old connections do not disconnect new slots)
+    void kill() {
+      m_alive.store(false, std::memory_order_release);
+      unref();
+    }
+  };
+
+}
+
+/**
+   Identifies a slot connected to a signal.
+
+   It is returned by Signal_base#connect and can be used to disconnect
+   the slot later (see #disconnect or Signal_base#disconnect), both
+   operations take constant time. Disconnecting a slot twice is
+   harmless, and so is disconnecting it after the signal was
+   destroyed (the connection is not valid anymore).
+
+   @see ScopedConnection
+*/
+class Connection
+{
+  template<typename Signature>
+  friend class Signal_base;
+  template<typename Signature>
+  friend class QueuedSignal;
+
+  typedef void (*DisconnectFn)(void*, const Connection&);
+
+  void* m_signal;
+  details::SignalLife* m_life;
+  DisconnectFn m_disconnect;
+  unsigned m_id;
+  unsigned m_index;		// where the slot was when it was connected
+
+  Connection(void* signal, details::SignalLife* life, DisconnectFn disconnect,
+	     unsigned id, unsigned index)
+    : m_signal(signal), m_life(life), m_disconnect(disconnect), m_id(id), m_index(index) {
+    m_life->ref();
   }
 
-  void disconnect(SlotType* slot)
-  {
-    remove_from_container(m_slots, slot);
+public:
+  Connection() : m_signal(NULL), m_life(NULL), m_disconnect(NULL), m_id(0), m_index(0) { }
+
+  Connection(const Connection& c)
+    : m_signal(c.m_signal), m_life(c.m_life), m_disconnect(c.m_disconnect)
+    , m_id(c.m_id), m_index(c.m_index) {
+    if (m_life)
+      m_life->ref();
   }
 
-  void disconnectAll()
-  {
-    typename SlotList::iterator end = m_slots.end();
-    for (typename SlotList::iterator
-	   it = m_slots.begin(); it != end; ++it)
-      delete *it;
-    m_slots.clear();
+  Connection(Connection&& c)
+    : m_signal(c.m_signal), m_life(c.m_life), m_disconnect(c.m_disconnect)
+    , m_id(c.m_id), m_index(c.m_index) {
+    c.m_signal = NULL;
+    c.m_life = NULL;
   }
 
-  bool empty() const
-  {
-    return m_slots.empty();
+  ~Connection() {
+    if (m_life)
+      m_life->unref();
   }
 
-  Signal0_base& operator=(const Signal0_base<R>& s) {
-    copy(s);
+  Connection& operator=(Connection c) {
+    std::swap(m_signal, c.m_signal);
+    std::swap(m_life, c.m_life);
+    std::swap(m_disconnect, c.m_disconnect);
+    std::swap(m_id, c.m_id);
+    std::swap(m_index, c.m_index);
     return *this;
   }
 
-private:
+  unsigned getId() const { return m_id; }
+  bool isValid() const { return m_signal != NULL && m_life->isAlive(); }
 
-  void copy(const Signal0_base<R>& s)
-  {
-    typename SlotList::const_iterator end = s.m_slots.end();
-    for (typename SlotList::const_iterator
-	   it = s.m_slots.begin(); it != end; ++it) {
-      m_slots.push_back((*it)->clone());
+  void disconnect() {
+    if (m_signal) {
+      if (m_life->isAlive())
+	m_disconnect(m_signal, *this);
+      m_signal = NULL;
+      m_life->unref();
+      m_life = NULL;
     }
   }
 
+  bool operator==(const Connection& c) const { return m_signal == c.m_signal && m_id == c.m_id; }
+  bool operator!=(const Connection& c) const { return !operator==(c); }
 };
 
 // ======================================================================
-// Signal0<R>
+// ScopedConnection
 
-template<typename R>
-class Signal0 : public Signal0_base<R>
+/**
+   Disconnects a slot when it is destroyed. If the signal is destroyed
+   first (e.g. the button in the example is deleted before MyWidget),
+   it does nothing.
+
+   @code
+   class MyWidget : public Widget
+   {
+     ScopedConnection m_conn;
+   public:
+     MyWidget(Button* button) {
+       m_conn = button->Click.connect(&MyWidget::onButtonClick, this);
+     }
+     ...
+   };
+   @endcode
+
+   @see Connection
+*/
+class ScopedConnection
 {
-public:
-  Signal0() { }
+  Connection m_conn;
 
-  Signal0(const Signal0<R>& s)
-    : Signal0_base<R>(s) { }
-
-  R operator()(R default_result = R())
-  {
-    R result(default_result);
-    typename Signal0_base<R>::SlotList::iterator end = Signal0_base<R>::m_slots.end();
-    for (typename Signal0_base<R>::SlotList::iterator
-	   it = Signal0_base<R>::m_slots.begin(); it != end; ++it) {
-      typename Signal0_base<R>::SlotType* slot = *it;
-      result = (*slot)();
-    }
-    return result;
+public:
+  ScopedConnection() { }
+  ScopedConnection(const Connection& conn) : m_conn(conn) { }
+  ScopedConnection(ScopedConnection&& other) : m_conn(other.release()) { }
+  ~ScopedConnection() { m_conn.disconnect(); }
+
+  ScopedConnection& operator=(const Connection& conn) {
+    m_conn.disconnect();
+    m_conn = conn;
+    return *this;
   }
 
-  template<typename Merger>
-  R operator()(R default_result, const Merger& m)
-  {
-    R result(default_result);
-    Merger merger(m);
-    typename Signal0_base<R>::SlotList::iterator end = Signal0_base<R>::m_slots.end();
-    for (typename Signal0_base<R>::SlotList::iterator
-	   it = Signal0_base<R>::m_slots.begin(); it != end; ++it) {
-      typename Signal0_base<R>::SlotType* slot = *it;
-      result = merger(result, (*slot)());
+  ScopedConnection& operator=(ScopedConnection&& other) {
+    if (this != &other) {
+      m_conn.disconnect();
+      m_conn = other.release();
     }
-    return result;
+    return *this;
   }
 
-};
-
-// ======================================================================
-// Signal0<void>
-
-template<>
-class Signal0<void> : public Signal0_base<void>
-{
-public:
-  Signal0() { }
+  const Connection& get() const { return m_conn; }
 
-  Signal0(const Signal0<void>& s)
-    : Signal0_base<void>(s) { }
+  void disconnect() { m_conn.disconnect(); }
 
-  void operator()()
-  {
-    SlotList::iterator end = m_slots.end();
-    for (SlotList::iterator
-	   it = m_slots.begin(); it != end; ++it) {
-      SlotType* slot = *it;
-      (*slot)();
-    }
+  /**
+     Returns the connection without disconnecting it.
+  */
+  Connection release() {
+    Connection conn = m_conn;
+    m_conn = Connection();
+    return conn;
   }
 
+private:
+  ScopedConnection(const ScopedConnection&);
+  ScopedConnection& operator=(const ScopedConnection&);
 };
 
 // ======================================================================
-// Signal1_base<R, A1>
+// Signal_base<R(Args...)>
 
 /**
-   Base class for signals which call functions with one parameter.
+   Base class for all signals: it keeps the list of connected slots.
+
+   Slots are stored by value in a contiguous array (see Slot), so
+   connecting small callables does not allocate memory (except when the
+   array has to grow) and emitting the signal does not follow a pointer
+   for each slot.
+
+   It is safe to connect or disconnect slots (even the slot that is
+   being called) while the signal is being emitted:
+   @li disconnected slots are marked as dead and are not called
+       anymore, they are removed from the array when the outermost
+       emission finishes;
+   @li new slots are kept apart until the outermost emission finishes,
+       so they will be called in the next emission.
+
+   With @c VACA_PROFILING, named signals (see #setName) record their
+   emissions and the time spent in their slots (see vaca::profiling).
 */
-template<typename R, typename A1>
-class Signal1_base
+template<typename R, typename... Args>
+class Signal_base<R(Args...)>
 {
 public:
   typedef R ReturnType;
-  typedef Slot1<R, A1> SlotType;
-  typedef std::vector<SlotType*> SlotList;
+  typedef Slot<R(Args...)> SlotType;
 
 protected:
+  struct SlotRecord
+  {
+    SlotType slot;
+    unsigned id;
+    bool alive;
+
+    SlotRecord(SlotType&& slot, unsigned id)
+      : slot(std::move(slot)), id(id), alive(true) { }
+  };
+
+  typedef std::vector<SlotRecord> SlotList;
+
+  // Calls endEmit() even if a slot throws an exception
+  class EmitScope
+  {
+    Signal_base* m_signal;
+  public:
+    EmitScope(Signal_base* signal) : m_signal(signal) {
+      ++m_signal->m_emitting;
+#ifdef VACA_PROFILING
+      if (m_signal->m_stats)
+	m_signal->m_stats->addEmit();
+#endif
+    }
+    ~EmitScope() { m_signal->endEmit(); }
+  };
+
+  // Measures the time spent in one slot call
+#ifdef VACA_PROFILING
+  class SlotTimer : private profiling::details::SlotStopwatch
+  {
+  public:
+    SlotTimer(Signal_base* signal) : SlotStopwatch(signal->m_stats) { }
+  };
+#else
+  struct SlotTimer
+  {
+    SlotTimer(Signal_base*) { }
+  };
+#endif
+
   SlotList m_slots;
+  SlotList* m_pending;		// slots connected while emitting
+  details::SignalLife* m_life;	// NULL until the first connection
+  unsigned m_nextId;
+  unsigned m_dead;		// dead slots in m_slots
+  unsigned m_emitting;		// emissions in progress
+#ifdef VACA_PROFILING
+  profiling::SignalStats* m_stats; // NULL if the signal has no name
+#endif
 
 public:
-  Signal1_base() { }
-  Signal1_base(const Signal1_base<R, A1>& s)
-  {
+  Signal_base() : m_pending(NULL), m_life(NULL), m_nextId(0), m_dead(0), m_emitting(0) {
+#ifdef VACA_PROFILING
+    m_stats = NULL;
+#endif
+  }
+  // The connections of the other signal are not valid for this one
+  Signal_base(const Signal_base& s)
+    : m_pending(NULL), m_life(NULL), m_nextId(0), m_dead(0), m_emitting(0) {
+#ifdef VACA_PROFILING
+    m_stats = s.m_stats;
+#endif
     copy(s);
   }
-  ~Signal1_base()
-  {
-    disconnectAll();
+  ~Signal_base() {
+    if (m_life)
+      m_life->kill();
+    delete m_pending;
   }
 
-  SlotType* addSlot(SlotType* slot)
+  /**
+     Gives a name to the signal for profiling purposes (e.g.
+     "Widget::MouseMove"). Signals with the same name share their
+     statistics. It does nothing if Vaca was compiled without
+     @c VACA_PROFILING.
+
+     @see vaca::profiling
+  */
+  void setName(const char* name)
   {
-    m_slots.push_back(slot);
-    return slot;
+#ifdef VACA_PROFILING
+    m_stats = profiling::getSignalStats(name);
+#else
+    (void)name;
+#endif
   }
 
-  template<typename F>
-  SlotType* connect(const F& f)
+  Connection addSlot(SlotType&& slot)
   {
-    return addSlot(new Slot1_fun<R, F, A1>(f));
+    unsigned id = ++m_nextId;
+    unsigned index;
+    if (m_emitting > 0) {
+      // do not touch m_slots: a slot of it could be running right now
+      if (!m_pending)
+	m_pending = new SlotList;
+      index = m_slots.size() + m_pending->size();
+      m_pending->push_back(SlotRecord(std::move(slot), id));
+    }
+    else {
+      index = m_slots.size();
+      m_slots.push_back(SlotRecord(std::move(slot), id));
+    }
+    if (!m_life)
+      m_life = new details::SignalLife;
+    return Connection(this, m_life, &Signal_base::disconnectConnection, id, index);
   }
 
-  template<class T>
-  SlotType* connect(R (T::*m)(A1), T* t)
+  template<typename F>
+  Connection connect(F&& f)
   {
-    return addSlot(new Slot1_mem<R, T, A1>(m, t));
+    return addSlot(SlotType(std::forward<F>(f)));
   }
 
-  const SlotList& getSlots() const
+  template<class T, class T2>
+  Connection connect(R (T::*m)(Args...), T2* t)
   {
-    return m_slots;
+    return addSlot(SlotType(m, static_cast<T*>(t)));
   }
 
-  void disconnect(SlotType* slot)
+  void disconnect(const Connection& conn)
   {
-    remove_from_container(m_slots, slot);
+    if (conn.m_signal != this)
+      return;
+
+    SlotRecord* rec = findSlotIn(m_slots, conn.m_id, conn.m_index);
+    if (!rec) {
+      // slots connected while emitting are not running, so they can be
+      // destroyed right now
+      if (m_pending) {
+	rec = findSlotIn(*m_pending, conn.m_id, conn.m_index - m_slots.size());
+	if (rec)
+	  m_pending->erase(m_pending->begin() + (rec - &m_pending->front()));
+      }
+      return;
+    }
+
+    if (!rec->alive)
+      return;
+
+    rec->alive = false;
+    ++m_dead;
+    if (m_emitting == 0) {
+      rec->slot.reset();
+      if (m_dead > m_slots.size() / 2)
+	compact();
+    }
   }
 
   void disconnectAll()
   {
-    typename SlotList::iterator end = m_slots.end();
-    for (typename SlotList::iterator
-	   it = m_slots.begin(); it != end; ++it)
-      delete *it;
-    m_slots.clear();
+    if (m_emitting > 0) {
+      for (typename SlotList::iterator
+	     it = m_slots.begin(), end = m_slots.end(); it != end; ++it)
+	it->alive = false;
+      m_dead = m_slots.size();
+    }
+    else {
+      m_slots.clear();
+      m_dead = 0;
+    }
+    delete m_pending;
+    m_pending = NULL;
   }
 
   bool empty() const
   {
-    return m_slots.empty();
+    return size() == 0;
   }
 
-  Signal1_base& operator=(const Signal1_base<R, A1>& s) {
-    copy(s);
+  std::size_t size() const
+  {
+    return m_slots.size() - m_dead + (m_pending ? m_pending->size(): 0);
+  }
+
+  /**
+     Reserves memory for @a n slots, useful to avoid reallocations when
+     you know how many slots will be connected.
+  */
+  void reserve(std::size_t n)
+  {
+    m_slots.reserve(n);
+  }
+
+  /**
+     Replaces the slots with a copy of the slots of @a s. The old
+     connections of this signal are not valid anymore.
+  */
+  Signal_base& operator=(const Signal_base& s) {
+    if (this != &s) {
+      disconnectAll();
+      if (m_life) {
+	m_life->kill();
+	m_life = NULL;
+      }
+      copy(s);
+    }
     return *this;
   }
 
-private:
+protected:
 
-  void copy(const Signal1_base<R, A1>& s)
+  void endEmit()
   {
-    typename SlotList::const_iterator end = s.m_slots.end();
-    for (typename SlotList::const_iterator
-	   it = s.m_slots.begin(); it != end; ++it) {
-      m_slots.push_back((*it)->clone());
+    if (--m_emitting > 0)
+      return;
+
+    if (m_dead > 0)
+      compact();
+
+    if (m_pending) {
+      for (typename SlotList::iterator
+	     it = m_pending->begin(), end = m_pending->end(); it != end; ++it)
+	m_slots.push_back(std::move(*it));
+      delete m_pending;
+      m_pending = NULL;
     }
   }
 
-};
-
-// ======================================================================
-// Signal1<R, A1>
+private:
 
-template<typename R, typename A1>
-class Signal1 : public Signal1_base<R, A1>
-{
-public:
-  Signal1() { }
+  struct IsDead {
+    bool operator()(const SlotRecord& rec) const { return !rec.alive; }
+  };
 
-  Signal1(const Signal1<R, A1>& s)
-    : Signal1_base<R, A1>(s) { }
+  struct IdLess {
+    bool operator()(const SlotRecord& rec, unsigned id) const { return rec.id < id; }
+  };
 
-  R operator()(A1 a1, R default_result = R())
+  void compact()
   {
-    R result(default_result);
-    typename Signal1_base<R, A1>::SlotList::iterator end = Signal1_base<R, A1>::m_slots.end();
-    for (typename Signal1_base<R, A1>::SlotList::iterator
-	   it = Signal1_base<R, A1>::m_slots.begin(); it != end; ++it) {
-      typename Signal1_base<R, A1>::SlotType* slot = *it;
-      result = (*slot)(a1);
-    }
-    return result;
+    m_slots.erase(std::remove_if(m_slots.begin(), m_slots.end(), IsDead()),
+		  m_slots.end());
+    m_dead = 0;
   }
 
-  template<typename Merger>
-  R operator()(A1 a1, R default_result, const Merger& m)
+  // The slot is where it was connected unless the array was compacted,
+  // in that case we use a binary search because the array is always
+  // sorted by ID.
+  static SlotRecord* findSlotIn(SlotList& slots, unsigned id, unsigned index)
   {
-    R result(default_result);
-    Merger merger(m);
-    typename Signal1_base<R, A1>::SlotList::iterator end = Signal1_base<R, A1>::m_slots.end();
-    for (typename Signal1_base<R, A1>::SlotList::iterator
-	   it = Signal1_base<R, A1>::m_slots.begin(); it != end; ++it) {
-      typename Signal1_base<R, A1>::SlotType* slot = *it;
-      result = merger(result, (*slot)(a1));
-    }
-    return result;
-  }
+    if (index < slots.size() && slots[index].id == id)
+      return &slots[index];
 
-};
+    typename SlotList::iterator it =
+      std::lower_bound(slots.begin(), slots.end(), id, IdLess());
+    if (it != slots.end() && it->id == id)
+      return &*it;
 
-// ======================================================================
-// Signal1<void, A1>
+    return NULL;
+  }
 
-template<typename A1>
-class Signal1<void, A1> : public Signal1_base<void, A1>
-{
-public:
-  Signal1() { }
+  void copy(const Signal_base& s)
+  {
+    for (typename SlotList::const_iterator
+	   it = s.m_slots.begin(), end = s.m_slots.end(); it != end; ++it)
+      if (it->alive)
+	m_slots.push_back(*it);
 
-  Signal1(const Signal1<void, A1>& s)
-    : Signal1_base<void, A1>(s) { }
+    if (s.m_pending)
+      m_slots.insert(m_slots.end(), s.m_pending->begin(), s.m_pending->end());
 
-  void operator()(A1 a1)
+    m_nextId = s.m_nextId;
+  }
+
+  static void disconnectConnection(void* signal, const Connection& conn)
   {
-    typename Signal1_base<void, A1>::SlotList::iterator end = Signal1_base<void, A1>::m_slots.end();
-    for (typename Signal1_base<void, A1>::SlotList::iterator
-	   it = Signal1_base<void, A1>::m_slots.begin(); it != end; ++it) {
-      typename Signal1_base<void, A1>::SlotType* slot = *it;
-      (*slot)(a1);
-    }
+    static_cast<Signal_base*>(signal)->disconnect(conn);
   }
 
 };
 
 // ======================================================================
-// Signal2_base<R, A1, A2>
+// Collectors
+
+/**
+   @defgroup collector_group Signal Collectors
+
+   A collector receives the value returned by each slot of a Signal
+   (see Signal#collect) and builds the result of the emission. It must
+   have:
+   @li a @c ResultType typedef;
+   @li a <tt>void reserve(std::size_t n)</tt> member that is called
+       before the first slot with the number of connected slots;
+   @li a <tt>bool operator()(T&& value)</tt> member that receives the
+       value returned by a slot and returns false if the rest of slots
+       must not be called (the result is already decided);
+   @li a <tt>ResultType getResult()</tt> member.
+
+   Values are moved from the slot to the collector, they are not
+   copied nor assigned to a temporary result.
+
+   @{
+*/
 
 /**
-   Base class for signals which call functions with two parameters.
+   True if any slot returns true (false if there are no slots). It
+   stops calling slots after the first one that returns true.
 */
-template<typename R, typename A1, typename A2>
-class Signal2_base
+class AnyOf
 {
+  bool m_result;
 public:
-  typedef R ReturnType;
-  typedef Slot2<R, A1, A2> SlotType;
-  typedef std::vector<SlotType*> SlotList;
-
-protected:
-  SlotList m_slots;
+  typedef bool ResultType;
+  AnyOf() : m_result(false) { }
+  void reserve(std::size_t) { }
+  bool operator()(bool value) { m_result = value; return !value; }
+  bool getResult() const { return m_result; }
+};
 
+/**
+   True if all slots return true (true if there are no slots). It
+   stops calling slots after the first one that returns false.
+*/
+class AllOf
+{
+  bool m_result;
 public:
-  Signal2_base() { }
-  Signal2_base(const Signal2_base<R, A1, A2>& s)
-  {
-    copy(s);
-  }
-  ~Signal2_base()
-  {
-    disconnectAll();
-  }
+  typedef bool ResultType;
+  AllOf() : m_result(true) { }
+  void reserve(std::size_t) { }
+  bool operator()(bool value) { m_result = value; return value; }
+  bool getResult() const { return m_result; }
+};
 
-  SlotType* addSlot(SlotType* slot)
-  {
-    m_slots.push_back(slot);
-    return slot;
-  }
+/**
+   The first value that is different from <tt>T()</tt> (or @c T() if
+   all slots return it). It stops calling slots after the first one
+   that returns something different from <tt>T()</tt>.
+*/
+template<typename T>
+class FirstNonDefault
+{
+  T m_result;
+public:
+  typedef T ResultType;
+  FirstNonDefault() : m_result() { }
+  void reserve(std::size_t) { }
+  bool operator()(T&& value) {
+    if (value == T())
+      return true;
+    m_result = std::move(value);
+    return false;
+  }
+  T getResult() { return std::move(m_result); }
+};
 
-  template<typename F>
-  SlotType* connect(const F& f)
-  {
-    return addSlot(new Slot2_fun<R, F, A1, A2>(f));
-  }
+/**
+   The value returned by the last slot (or @a default_result if there
+   are no slots). Like the Signal#operator() without a merger.
+*/
+template<typename T>
+class Last
+{
+  T m_result;
+public:
+  typedef T ResultType;
+  Last(const T& default_result = T()) : m_result(default_result) { }
+  void reserve(std::size_t) { }
+  bool operator()(T&& value) { m_result = std::move(value); return true; }
+  T getResult() { return std::move(m_result); }
+};
 
-  template<class T>
-  SlotType* connect(R (T::*m)(A1, A2), T* t)
-  {
-    return addSlot(new Slot2_mem<R, T, A1, A2>(m, t));
-  }
+/**
+   All returned values in the same order that slots were called. The
+   vector is allocated once with enough capacity for all slots.
+*/
+template<typename T>
+class ToVector
+{
+  std::vector<T> m_result;
+public:
+  typedef std::vector<T> ResultType;
+  void reserve(std::size_t n) { m_result.reserve(n); }
+  bool operator()(T&& value) { m_result.push_back(std::move(value)); return true; }
+  std::vector<T> getResult() { return std::move(m_result); }
+};
 
-  const SlotList& getSlots() const
-  {
-    return m_slots;
-  }
+inline AnyOf any_of() { return AnyOf(); }
+inline AllOf all_of() { return AllOf(); }
 
-  void disconnect(SlotType* slot)
-  {
-    remove_from_container(m_slots, slot);
-  }
+template<typename T>
+FirstNonDefault<T> first_non_default() { return FirstNonDefault<T>(); }
 
-  void disconnectAll()
-  {
-    typename SlotList::iterator end = m_slots.end();
-    for (typename SlotList::iterator
-	   it = m_slots.begin(); it != end; ++it)
-      delete *it;
-    m_slots.clear();
-  }
+template<typename T>
+Last<T> last(const T& default_result = T()) { return Last<T>(default_result); }
 
-  bool empty() const
-  {
-    return m_slots.empty();
-  }
+template<typename T>
+ToVector<T> to_vector() { return ToVector<T>(); }
 
-  Signal2_base& operator=(const Signal2_base<R, A1, A2>& s) {
-    copy(s);
-    return *this;
-  }
+/** @} */
 
-private:
+// ======================================================================
+// Signal<R(Args...)>
 
-  void copy(const Signal2_base<R, A1, A2>& s)
-  {
-    typename SlotList::const_iterator end = s.m_slots.end();
-    for (typename SlotList::const_iterator
-	   it = s.m_slots.begin(); it != end; ++it) {
-      m_slots.push_back((*it)->clone());
-    }
-  }
+template<typename Signature>
+class Signal;
 
-};
+/**
+   A signal which calls every connected slot with the @a Args
+   arguments.
 
-// ======================================================================
-// Signal2<R, A1>
+   Returns the value returned by the last slot (or @a default_result
+   if there are no slots), the result of a merger, or the result of a
+   collector (see #collect).
 
-template<typename R, typename A1, typename A2>
-class Signal2 : public Signal2_base<R, A1, A2>
+   @see Slot, Signal_base#connect
+*/
+template<typename R, typename... Args>
+class Signal<R(Args...)> : public Signal_base<R(Args...)>
 {
+  typedef Signal_base<R(Args...)> Base;
+
 public:
-  Signal2() { }
+  Signal() { }
 
-  Signal2(const Signal2<R, A1, A2>& s)
-    : Signal2_base<R, A1, A2>(s) { }
+  R operator()(Args... args)
+  {
+    return (*this)(args..., R());
+  }
 
-  R operator()(A1 a1, A2 a2, R default_result = R())
+  R operator()(Args... args, R default_result)
   {
     R result(default_result);
-    typename Signal2_base<R, A1, A2>::SlotList::iterator end = Signal2_base<R, A1, A2>::m_slots.end();
-    for (typename Signal2_base<R, A1, A2>::SlotList::iterator
-	   it = Signal2_base<R, A1, A2>::m_slots.begin(); it != end; ++it) {
-      typename Signal2_base<R, A1, A2>::SlotType* slot = *it;
-      result = (*slot)(a1, a2);
+    typename Base::EmitScope scope(this);
+    for (std::size_t i = 0, n = Base::m_slots.size(); i < n; ++i) {
+      typename Base::SlotRecord& rec = Base::m_slots[i];
+      if (rec.alive) {
+	typename Base::SlotTimer timer(this);
+	result = rec.slot(args...);
+      }
     }
     return result;
   }
 
   template<typename Merger>
-  R operator()(A1 a1, A2 a2, R default_result, const Merger& m)
+  R operator()(Args... args, R default_result, const Merger& m)
   {
     R result(default_result);
     Merger merger(m);
-    typename Signal2_base<R, A1, A2>::SlotList::iterator end = Signal2_base<R, A1, A2>::m_slots.end();
-    for (typename Signal2_base<R, A1, A2>::SlotList::iterator
-	   it = Signal2_base<R, A1, A2>::m_slots.begin(); it != end; ++it) {
-      typename Signal2_base<R, A1, A2>::SlotType* slot = *it;
-      result = merger(result, (*slot)(a1, a2));
+    typename Base::EmitScope scope(this);
+    for (std::size_t i = 0, n = Base::m_slots.size(); i < n; ++i) {
+      typename Base::SlotRecord& rec = Base::m_slots[i];
+      if (rec.alive) {
+	typename Base::SlotTimer timer(this);
+	result = merger(result, rec.slot(args...));
+      }
     }
     return result;
   }
 
+  /**
+     Calls slots passing their results to the @a collector until it
+     decides the result of the emission.
+
+     @code
+     Signal<bool()> Enabled;
+     ...
+     bool enabled = Enabled.collect(all_of());
+     std::vector<int> values = Values.collect(5, to_vector<int>());
+     @endcode
+
+     @see collector_group
+  */
+  template<typename Collector>
+  typename Collector::ResultType collect(Args... args, Collector collector)
+  {
+    typename Base::EmitScope scope(this);
+    collector.reserve(Base::size());
+    for (std::size_t i = 0, n = Base::m_slots.size(); i < n; ++i) {
+      typename Base::SlotRecord& rec = Base::m_slots[i];
+      if (rec.alive) {
+	typename Base::SlotTimer timer(this);
+	if (!collector(rec.slot(args...)))
+	  break;
+      }
+    }
+    return collector.getResult();
+  }
+
 };
 
 // ======================================================================
-// Signal2<void, A1>
+// Signal<void(Args...)>
 
-template<typename A1, typename A2>
-class Signal2<void, A1, A2> : public Signal2_base<void, A1, A2>
+template<typename... Args>
+class Signal<void(Args...)> : public Signal_base<void(Args...)>
 {
-public:
-  Signal2() { }
+  typedef Signal_base<void(Args...)> Base;
 
-  Signal2(const Signal2<void, A1, A2>& s)
-    : Signal2_base<void, A1, A2>(s) { }
+public:
+  Signal() { }
 
-  void operator()(A1 a1, A2 a2)
+  void operator()(Args... args)
   {
-    typename Signal2_base<void, A1, A2>::SlotList::iterator end = Signal2_base<void, A1, A2>::m_slots.end();
-    for (typename Signal2_base<void, A1, A2>::SlotList::iterator
-	   it = Signal2_base<void, A1, A2>::m_slots.begin(); it != end; ++it) {
-      typename Signal2_base<void, A1, A2>::SlotType* slot = *it;
-      (*slot)(a1, a2);
+    typename Base::EmitScope scope(this);
+    for (std::size_t i = 0, n = Base::m_slots.size(); i < n; ++i) {
+      typename Base::SlotRecord& rec = Base::m_slots[i];
+      if (rec.alive) {
+	typename Base::SlotTimer timer(this);
+	rec.slot(args...);
+      }
     }
   }
 
 };
 
+// ======================================================================
+// Signal0..Signal4 (backward compatibility)
+
+template<typename R>
+using Signal0 = Signal<R()>;
+
+template<typename R, typename A1>
+using Signal1 = Signal<R(A1)>;
+
+template<typename R, typename A1, typename A2>
+using Signal2 = Signal<R(A1, A2)>;
+
+template<typename R, typename A1, typename A2, typename A3>
+using Signal3 = Signal<R(A1, A2, A3)>;
+
+template<typename R, typename A1, typename A2, typename A3, typename A4>
+using Signal4 = Signal<R(A1, A2, A3, A4)>;
+
 /** @} */
 
 } // namespace vaca
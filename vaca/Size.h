@@ -13,41 +13,60 @@ namespace vaca {
 
 /**
    A 2D size.
+
+   Like Point, it is a literal type defined completely in this header,
+   so it can be used in constant expressions (e.g. tables of sizes for
+   a layout).
 */
-class VACA_DLL Size
+class Size
 {
 public:
 
   int w, h;
 
-  Size();
-  Size(int w, int h);
-  Size(const Size& size);
-  explicit Size(const Point& point);
-
-  Size createUnion(const Size& sz) const;
-  Size createIntersect(const Size& sz) const;
-
-  const Size& operator=(const Size& sz);
-  const Size& operator+=(const Size& sz);
-  const Size& operator-=(const Size& sz);
-  const Size& operator+=(int value);
-  const Size& operator-=(int value);
-  const Size& operator*=(int value);
-  const Size& operator/=(int value);
-  Size operator+(const Size& sz) const;
-  Size operator-(const Size& sz) const;
-  Size operator+(int value) const;
-  Size operator-(int value) const;
-  Size operator*(int value) const;
-  Size operator/(int value) const;
-  Size operator-() const;
-
-  bool operator==(const Size& sz) const;
-  bool operator!=(const Size& sz) const;
+  constexpr Size() noexcept : w(0), h(0) { }
+  constexpr Size(int w, int h) noexcept : w(w), h(h) { }
+  constexpr explicit Size(const Point& point) noexcept;
+
+  constexpr Size createUnion(const Size& sz) const noexcept
+  {
+    return Size(max_value(w, sz.w), max_value(h, sz.h));
+  }
+
+  constexpr Size createIntersect(const Size& sz) const noexcept
+  {
+    return Size(min_value(w, sz.w), min_value(h, sz.h));
+  }
+
+  Size& operator+=(const Size& sz) noexcept { w += sz.w; h += sz.h; return *this; }
+  Size& operator-=(const Size& sz) noexcept { w -= sz.w; h -= sz.h; return *this; }
+  Size& operator+=(int value) noexcept { w += value; h += value; return *this; }
+  Size& operator-=(int value) noexcept { w -= value; h -= value; return *this; }
+  Size& operator*=(int value) noexcept { w *= value; h *= value; return *this; }
+  Size& operator/=(int value) noexcept { w /= value; h /= value; return *this; }
+
+  constexpr Size operator+(const Size& sz) const noexcept { return Size(w+sz.w, h+sz.h); }
+  constexpr Size operator-(const Size& sz) const noexcept { return Size(w-sz.w, h-sz.h); }
+  constexpr Size operator+(int value) const noexcept { return Size(w+value, h+value); }
+  constexpr Size operator-(int value) const noexcept { return Size(w-value, h-value); }
+  constexpr Size operator*(int value) const noexcept { return Size(w*value, h*value); }
+  constexpr Size operator/(int value) const noexcept { return Size(w/value, h/value); }
+  constexpr Size operator-() const noexcept { return Size(-w, -h); }
+
+  constexpr bool operator==(const Size& sz) const noexcept { return w == sz.w && h == sz.h; }
+  constexpr bool operator!=(const Size& sz) const noexcept { return w != sz.w || h != sz.h; }
 
 };
 
 } // namespace vaca
 
+// Size and Point need each other to be complete
+#include "vaca/Point.h"
+
+namespace vaca {
+
+constexpr Size::Size(const Point& point) noexcept : w(point.x), h(point.y) { }
+
+} // namespace vaca
+
 #endif // VACA_SIZE_H
@@ -9,6 +9,12 @@
 
 #include "vaca/base.h"
 
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
 namespace vaca {
 
 /**
@@ -16,217 +22,257 @@ namespace vaca {
    @{
  */
 
-// ======================================================================
-// Slot0
+template<typename Signature>
+class Slot;
 
-template<typename R>
-class Slot0
-{
-public:
-  Slot0() { }
-  Slot0(const Slot0& s) { (void)s; }
-  virtual ~Slot0() { }
-  virtual R operator()() = 0;
-  virtual Slot0* clone() const = 0;
-};
+namespace details {
 
-// ======================================================================
-// Slot0_fun - hold a F instance and use the function call operator
+  // Calls a function object converting its result to R (or
+  // discarding it when R is void).
+  template<typename R>
+  struct SlotCall
+  {
+    template<typename F, typename... Args>
+    static R call(F& f, Args&&... args) {
+      return f(std::forward<Args>(args)...);
+    }
+  };
 
-template<typename R, typename F>
-class Slot0_fun : public Slot0<R>
-{
-  F f;
-public:
-  Slot0_fun(const F& f) : f(f) { }
-  Slot0_fun(const Slot0_fun& s) : Slot0<R>(s), f(s.f) { }
-  ~Slot0_fun() { }
-  R operator()() { return f(); }
-  Slot0_fun* clone() const { return new Slot0_fun(*this); }
-};
+  template<>
+  struct SlotCall<void>
+  {
+    template<typename F, typename... Args>
+    static void call(F& f, Args&&... args) {
+      f(std::forward<Args>(args)...);
+    }
+  };
 
-template<typename F>
-class Slot0_fun<void, F> : public Slot0<void>
-{
-  F f;
-public:
-  Slot0_fun(const F& f) : f(f) { }
-  Slot0_fun(const Slot0_fun& s) : Slot0<void>(s), f(s.f) { }
-  ~Slot0_fun() { }
-  void operator()() { f(); }
-  Slot0_fun* clone() const { return new Slot0_fun(*this); }
-};
-  
-// ======================================================================
-// Slot0_mem - pointer to a member function of the T class
+  // Copies a callable, or throws std::logic_error if it can only be
+  // moved (e.g. a Bind() holding a std::unique_ptr).
+  template<typename F, bool = std::is_copy_constructible<F>::value>
+  struct SlotCopy
+  {
+    static F* clone(const F& f) { return new F(f); }
+    static void construct(void* dst, const F& f) { new (dst) F(f); }
+  };
 
-template<typename R, class T>
-class Slot0_mem : public Slot0<R>
-{
-  R (T::*m)();
-  T* t;
-public:
-  Slot0_mem(R (T::*m)(), T* t) : m(m), t(t) { }
-  Slot0_mem(const Slot0_mem& s) : Slot0<R>(s), m(s.m), t(s.t) { }
-  ~Slot0_mem() { }
-  R operator()() { return (t->*m)(); }
-  Slot0_mem* clone() const { return new Slot0_mem(*this); }
-};
+  template<typename F>
+  struct SlotCopy<F, false>
+  {
+    static F* clone(const F&) {
+      throw std::logic_error("vaca::Slot: the stored callable cannot be copied");
+    }
+    static void construct(void*, const F&) {
+      throw std::logic_error("vaca::Slot: the stored callable cannot be copied");
+    }
+  };
 
-template<class T>
-class Slot0_mem<void, T> : public Slot0<void>
-{
-  void (T::*m)();
-  T* t;
-public:
-  Slot0_mem(void (T::*m)(), T* t) : m(m), t(t) { }
-  Slot0_mem(const Slot0_mem& s) : Slot0<void>(s), m(s.m), t(s.t) { }
-  ~Slot0_mem() { }
-  void operator()() { (t->*m)(); }
-  Slot0_mem* clone() const { return new Slot0_mem(*this); }
-};
+  // Pointer to a member function of the T class plus the instance
+  // where it has to be called.
+  template<typename M, typename T>
+  struct SlotMemFun
+  {
+    M m;
+    T* t;
+    SlotMemFun(M m, T* t) : m(m), t(t) { }
 
-// ======================================================================
-// Slot1
+    template<typename... Args>
+    auto operator()(Args&&... args) -> decltype((t->*m)(std::forward<Args>(args)...)) {
+      return (t->*m)(std::forward<Args>(args)...);
+    }
+  };
 
-template<typename R, typename A1>
-class Slot1
-{
-public:
-  Slot1() { }
-  Slot1(const Slot1& s) { (void)s; }
-  virtual ~Slot1() { }
-  virtual R operator()(A1 a1) = 0;
-  virtual Slot1* clone() const = 0;
-};
+} // namespace details
 
 // ======================================================================
-// Slot1_fun - hold a F instance and use the function call operator
+// Slot<R(Args...)>
 
-template<typename R, typename F, typename A1>
-class Slot1_fun : public Slot1<R, A1>
-{
-  F f;
-public:
-  Slot1_fun(const F& f) : f(f) { }
-  Slot1_fun(const Slot1_fun& s) : Slot1<R, A1>(s), f(s.f) { }
-  ~Slot1_fun() { }
-  R operator()(A1 a1) { return f(a1); }
-  Slot1_fun* clone() const { return new Slot1_fun(*this); }
-};
+/**
+   A callable object stored by value: it can hold a function pointer,
+   a functor, or a member function plus its instance.
 
-template<typename F, typename A1>
-class Slot1_fun<void, F, A1> : public Slot1<void, A1>
-{
-  F f;
-public:
-  Slot1_fun(const F& f) : f(f) { }
-  Slot1_fun(const Slot1_fun& s) : Slot1<void, A1>(s), f(s.f) { }
-  ~Slot1_fun() { }
-  void operator()(A1 a1) { f(a1); }
-  Slot1_fun* clone() const { return new Slot1_fun(*this); }
-};
-  
-// ======================================================================
-// Slot1_mem - pointer to a member function of the T class
+   Small callables (up to @c InlineSize bytes, like a pointer to a
+   member function plus its object) are stored inside the slot itself,
+   so connecting them to a Signal does not allocate memory. Bigger
+   callables are allocated in the heap.
 
-template<typename R, class T, typename A1>
-class Slot1_mem : public Slot1<R, A1>
-{
-  R (T::*m)(A1);
-  T* t;
-public:
-  Slot1_mem(R (T::*m)(A1), T* t) : m(m), t(t) { }
-  Slot1_mem(const Slot1_mem& s) : Slot1<R, A1>(s), m(s.m), t(s.t) { }
-  ~Slot1_mem() { }
-  R operator()(A1 a1) { return (t->*m)(a1); }
-  Slot1_mem* clone() const { return new Slot1_mem(*this); }
-};
+   Calls go through a plain function pointer (a "thunk") generated for
+   the exact type of the stored callable, so there is no virtual call
+   and no clone() to copy slots.
 
-template<class T, typename A1>
-class Slot1_mem<void, T, A1> : public Slot1<void, A1>
+   @see Signal
+*/
+template<typename R, typename... Args>
+class Slot<R(Args...)>
 {
-  void (T::*m)(A1);
-  T* t;
 public:
-  Slot1_mem(void (T::*m)(A1), T* t) : m(m), t(t) { }
-  Slot1_mem(const Slot1_mem& s) : Slot1<void, A1>(s), m(s.m), t(s.t) { }
-  ~Slot1_mem() { }
-  void operator()(A1 a1) { (t->*m)(a1); }
-  Slot1_mem* clone() const { return new Slot1_mem(*this); }
-};
+  typedef R ReturnType;
 
-// ======================================================================
-// Slot2
+  enum { InlineSize = 4 * sizeof(void*) };
 
-template<typename R, typename A1, typename A2>
-class Slot2
-{
-public:
-  Slot2() { }
-  Slot2(const Slot2& s) { (void)s; }
-  virtual ~Slot2() { }
-  virtual R operator()(A1 a1, A2 a2) = 0;
-  virtual Slot2* clone() const = 0;
-};
+private:
+  enum Operation { CopyOp, MoveOp, DestroyOp };
 
-// ======================================================================
-// Slot2_fun - hold a F instance and use the function call operator
+  typedef R (*InvokeFn)(void*, Args...);
+  typedef void (*ManageFn)(Operation, void*, void*);
 
-template<typename R, typename F, typename A1, typename A2>
-class Slot2_fun : public Slot2<R, A1, A2>
-{
-  F f;
-public:
-  Slot2_fun(const F& f) : f(f) { }
-  Slot2_fun(const Slot2_fun& s) : Slot2<R, A1, A2>(s), f(s.f) { }
-  ~Slot2_fun() { }
-  R operator()(A1 a1, A2 a2) { return f(a1, a2); }
-  Slot2_fun* clone() const { return new Slot2_fun(*this); }
-};
+  union Storage {
+    void* ptr;
+    typename std::aligned_storage<InlineSize, alignof(std::max_align_t)>::type buf;
+  };
 
-template<typename F, typename A1, typename A2>
-class Slot2_fun<void, F, A1, A2> : public Slot2<void, A1, A2>
-{
-  F f;
-public:
-  Slot2_fun(const F& f) : f(f) { }
-  Slot2_fun(const Slot2_fun& s) : Slot2<void, A1, A2>(s), f(s.f) { }
-  ~Slot2_fun() { }
-  void operator()(A1 a1, A2 a2) { f(a1, a2); }
-  Slot2_fun* clone() const { return new Slot2_fun(*this); }
-};
+  template<typename F>
+  struct IsInline {
+    enum { value = (sizeof(F) <= InlineSize &&
+		    alignof(std::max_align_t) % alignof(F) == 0 &&
+		    std::is_nothrow_move_constructible<F>::value) };
+  };
 
-// ======================================================================
-// Slot2_mem - pointer to a member function of the T class
+  // Thunks for callables stored in the inline buffer
+  template<typename F>
+  struct InlineOps
+  {
+    static R invoke(void* p, Args... args) {
+      return details::SlotCall<R>::call(*static_cast<F*>(p), args...);
+    }
+    static void manage(Operation op, void* dst, void* src) {
+      switch (op) {
+	case CopyOp: details::SlotCopy<F>::construct(dst, *static_cast<const F*>(src)); break;
+	case MoveOp: new (dst) F(std::move(*static_cast<F*>(src)));
+	             static_cast<F*>(src)->~F(); break;
+	case DestroyOp: static_cast<F*>(dst)->~F(); break;
+      }
+    }
+  };
 
-template<typename R, class T, typename A1, typename A2>
-class Slot2_mem : public Slot2<R, A1, A2>
-{
-  R (T::*m)(A1, A2);
-  T* t;
-public:
-  Slot2_mem(R (T::*m)(A1, A2), T* t) : m(m), t(t) { }
-  Slot2_mem(const Slot2_mem& s) : Slot2<R, A1, A2>(s), m(s.m), t(s.t) { }
-  ~Slot2_mem() { }
-  R operator()(A1 a1, A2 a2) { return (t->*m)(a1, a2); }
-  Slot2_mem* clone() const { return new Slot2_mem(*this); }
-};
+  // Thunks for callables allocated in the heap
+  template<typename F>
+  struct HeapOps
+  {
+    static R invoke(void* p, Args... args) {
+      return details::SlotCall<R>::call(**static_cast<F**>(p), args...);
+    }
+    static void manage(Operation op, void* dst, void* src) {
+      switch (op) {
+	case CopyOp: *static_cast<F**>(dst) = details::SlotCopy<F>::clone(**static_cast<F* const*>(src)); break;
+	case MoveOp: *static_cast<F**>(dst) = *static_cast<F**>(src); break;
+	case DestroyOp: delete *static_cast<F**>(dst); break;
+      }
+    }
+  };
+
+  Storage m_storage;
+  InvokeFn m_invoke;
+  ManageFn m_manage;
 
-template<class T, typename A1, typename A2>
-class Slot2_mem<void, T, A1, A2> : public Slot2<void, A1, A2>
-{
-  void (T::*m)(A1, A2);
-  T* t;
 public:
-  Slot2_mem(void (T::*m)(A1, A2), T* t) : m(m), t(t) { }
-  Slot2_mem(const Slot2_mem& s) : Slot2<void, A1, A2>(s), m(s.m), t(s.t) { }
-  ~Slot2_mem() { }
-  void operator()(A1 a1, A2 a2) { return (t->*m)(a1, a2); }
-  Slot2_mem* clone() const { return new Slot2_mem(*this); }
+
+  Slot() : m_invoke(NULL), m_manage(NULL) { }
+
+  template<typename F,
+	   typename = typename std::enable_if<
+	     !std::is_same<typename std::decay<F>::type, Slot>::value>::type>
+  Slot(F&& f) {
+    init<typename std::decay<F>::type>(std::forward<F>(f));
+  }
+
+  template<typename M, class T>
+  Slot(M m, T* t) {
+    init<details::SlotMemFun<M, T> >(details::SlotMemFun<M, T>(m, t));
+  }
+
+  Slot(const Slot& s) : m_invoke(s.m_invoke), m_manage(s.m_manage) {
+    if (m_manage)
+      m_manage(CopyOp, &m_storage, const_cast<Storage*>(&s.m_storage));
+  }
+
+  Slot(Slot&& s) noexcept : m_invoke(s.m_invoke), m_manage(s.m_manage) {
+    if (m_manage)
+      m_manage(MoveOp, &m_storage, &s.m_storage);
+    s.m_invoke = NULL;
+    s.m_manage = NULL;
+  }
+
+  ~Slot() {
+    reset();
+  }
+
+  Slot& operator=(const Slot& s) {
+    if (this != &s) {
+      Slot tmp(s);
+      *this = std::move(tmp);
+    }
+    return *this;
+  }
+
+  Slot& operator=(Slot&& s) noexcept {
+    if (this != &s) {
+      reset();
+      m_invoke = s.m_invoke;
+      m_manage = s.m_manage;
+      if (m_manage)
+	m_manage(MoveOp, &m_storage, &s.m_storage);
+      s.m_invoke = NULL;
+      s.m_manage = NULL;
+    }
+    return *this;
+  }
+
+  void reset() {
+    if (m_manage)
+      m_manage(DestroyOp, &m_storage, NULL);
+    m_invoke = NULL;
+    m_manage = NULL;
+  }
+
+  bool empty() const {
+    return m_invoke == NULL;
+  }
+
+  R operator()(Args... args) {
+    return m_invoke(&m_storage, std::forward<Args>(args)...);
+  }
+
+private:
+
+  template<typename F, typename G>
+  void init(G&& f) {
+    init<F>(std::forward<G>(f), std::integral_constant<bool, IsInline<F>::value>());
+  }
+
+  template<typename F, typename G>
+  void init(G&& f, std::true_type) {
+    new (&m_storage) F(std::forward<G>(f));
+    m_invoke = &InlineOps<F>::invoke;
+    m_manage = &InlineOps<F>::manage;
+  }
+
+  template<typename F, typename G>
+  void init(G&& f, std::false_type) {
+    m_storage.ptr = new F(std::forward<G>(f));
+    m_invoke = &HeapOps<F>::invoke;
+    m_manage = &HeapOps<F>::manage;
+  }
+
 };
 
 // ======================================================================
+// Slot0..Slot4 (backward compatibility)
+
+template<typename R>
+using Slot0 = Slot<R()>;
+
+template<typename R, typename A1>
+using Slot1 = Slot<R(A1)>;
+
+template<typename R, typename A1, typename A2>
+using Slot2 = Slot<R(A1, A2)>;
+
+template<typename R, typename A1, typename A2, typename A3>
+using Slot3 = Slot<R(A1, A2, A3)>;
+
+template<typename R, typename A1, typename A2, typename A3, typename A4>
+using Slot4 = Slot<R(A1, A2, A3, A4)>;
 
 /** @} */
 
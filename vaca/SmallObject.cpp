@@ -0,0 +1,193 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#include "vaca/SmallObject.h"
+#include "vaca/Mutex.h"
+#include "vaca/ScopedLock.h"
+
+#include <new>
+
+using namespace vaca;
+
+namespace {
+
+  enum {
+    Granularity = 16,
+    Classes = SmallObject::MaxSize / Granularity,
+    SlabSize = 4096,
+    // Free blocks that a thread can keep for each size, when there are
+    // more it gives the half of them to the depot
+    MaxCachedBlocks = 512,
+    // Blocks that a thread takes from the depot
+    BatchBlocks = MaxCachedBlocks / 2
+  };
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  struct FreeList {
+    FreeBlock* head;
+    std::size_t count;
+
+    void push(FreeBlock* block) {
+      block->next = head;
+      head = block;
+      ++count;
+    }
+
+    FreeBlock* pop() {
+      FreeBlock* block = head;
+      head = block->next;
+      --count;
+      return block;
+    }
+
+    // Moves the first "n" blocks of "other" to this list
+    void take(FreeList& other, std::size_t n) {
+      if (n > other.count)
+	n = other.count;
+      if (n == 0)
+	return;
+
+      FreeBlock* first = other.head;
+      FreeBlock* last = first;
+      for (std::size_t i=1; i<n; ++i)
+	last = last->next;
+
+      other.head = last->next;
+      other.count -= n;
+      last->next = head;
+      head = first;
+      count += n;
+    }
+  };
+
+  // Blocks given by finished threads (or by threads with too many free
+  // blocks). Created in the first use and never deleted, objects can
+  // be deleted after static destructors.
+  struct Depot {
+    Mutex mutex;
+    FreeList lists[Classes];
+  };
+
+  Depot& get_depot()
+  {
+    static Depot* depot = new Depot();
+    return *depot;
+  }
+
+  // It is a trivial type, so it can be used in any moment of the
+  // thread life (even after CacheFlusher was destroyed).
+  struct ThreadCache {
+    FreeList lists[Classes];
+    bool finished;
+  };
+
+  thread_local ThreadCache cache;
+
+  void give_to_depot(FreeList& list, std::size_t n, int index)
+  {
+    Depot& depot = get_depot();
+    ScopedLock hold(depot.mutex);
+    depot.lists[index].take(list, n);
+  }
+
+  // Gives the free blocks of the thread to the depot when it finishes
+  struct CacheFlusher {
+    CacheFlusher() { }
+    ~CacheFlusher() {
+      for (int i=0; i<Classes; ++i)
+	give_to_depot(cache.lists[i], cache.lists[i].count, i);
+      cache.finished = true;
+    }
+  };
+
+  void register_flusher()
+  {
+    static thread_local CacheFlusher flusher;
+    (void)flusher;
+  }
+
+  inline int get_class_index(std::size_t size)
+  {
+    return (int)((size + Granularity - 1) / Granularity) - 1;
+  }
+
+  // Fills an empty list, first with blocks from the depot, and if
+  // there is nothing there, with a new slab
+  void refill(FreeList& list, int index)
+  {
+    {
+      Depot& depot = get_depot();
+      ScopedLock hold(depot.mutex);
+      list.take(depot.lists[index], BatchBlocks);
+    }
+    if (list.head)
+      return;
+
+    std::size_t blockSize = (index+1) * Granularity;
+    std::size_t blocks = SlabSize / blockSize;
+    char* slab = static_cast<char*>(::operator new(blocks * blockSize));
+
+    for (std::size_t i=blocks; i>0; --i)
+      list.push(reinterpret_cast<FreeBlock*>(slab + (i-1)*blockSize));
+  }
+
+}
+
+void* SmallObject::operator new(std::size_t size)
+{
+  if (size > MaxSize)
+    return ::operator new(size);
+
+  int index = get_class_index(size);
+
+  // the thread is finishing, the remaining blocks go to the depot
+  if (cache.finished) {
+    FreeList list = { NULL, 0 };
+    refill(list, index);
+    void* ptr = list.pop();
+    give_to_depot(list, list.count, index);
+    return ptr;
+  }
+
+  FreeList& list = cache.lists[index];
+  if (!list.head) {
+    register_flusher();
+    refill(list, index);
+  }
+  return list.pop();
+}
+
+void SmallObject::operator delete(void* ptr, std::size_t size)
+{
+  if (!ptr)
+    return;
+
+  if (size > MaxSize) {
+    ::operator delete(ptr);
+    return;
+  }
+
+  int index = get_class_index(size);
+  FreeBlock* block = static_cast<FreeBlock*>(ptr);
+
+  if (cache.finished) {
+    FreeList list = { NULL, 0 };
+    list.push(block);
+    give_to_depot(list, 1, index);
+    return;
+  }
+
+  FreeList& list = cache.lists[index];
+  if (!list.head)
+    register_flusher();
+
+  list.push(block);
+  if (list.count > MaxCachedBlocks)
+    give_to_depot(list, list.count - MaxCachedBlocks/2, index);
+}
@@ -0,0 +1,65 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#ifndef VACA_SMALLOBJECT_H
+#define VACA_SMALLOBJECT_H
+
+#include "vaca/base.h"
+
+#include <cstddef>
+
+namespace vaca {
+
+/**
+   Class whose instances are allocated from per-thread pools.
+
+   If you derive from this class, the objects of your class (and of
+   any derived class) that have at most SmallObject::MaxSize bytes are
+   allocated from slabs of blocks of the same size, which are kept in a
+   free-list of the thread that allocates or deletes them. Creating and
+   deleting these objects in a loop (like the Pen and Brush temporaries
+   of a paint event) does not use the global heap, and does not lock
+   anything, after the first iteration.
+
+   Objects can be deleted in any thread: the block goes to the
+   free-list of that thread. When a thread finishes, its free blocks
+   are given to a global depot, where other threads take them. The
+   slabs are never given back to the global heap.
+
+   If objects are deleted through a pointer to a base class, the base
+   class must have a virtual destructor (like Referenceable), so the
+   size of the block is known.
+
+   Example:
+   @code
+   class MyHandle : public Referenceable, public SmallObject
+   {
+     ...
+   };
+   @endcode
+
+   @see GdiObject
+*/
+class VACA_DLL SmallObject
+{
+public:
+  /**
+     Objects bigger than this size are allocated with the global
+     operator new.
+  */
+  enum { MaxSize = 128 };
+
+  static void* operator new(std::size_t size);
+  static void operator delete(void* ptr, std::size_t size);
+
+protected:
+  SmallObject() { }
+  ~SmallObject() { }
+};
+
+} // namespace vaca
+
+#endif // VACA_SMALLOBJECT_H
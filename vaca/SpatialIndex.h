@@ -0,0 +1,637 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#ifndef VACA_SPATIALINDEX_H
+#define VACA_SPATIALINDEX_H
+
+#include "vaca/base.h"
+#include "vaca/NonCopyable.h"
+#include "vaca/Point.h"
+#include "vaca/Rect.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace vaca {
+
+/**
+   An index of items by their bounds, to find the items that are in a
+   point or that intersect a rectangle without looking all of them.
+
+   It is an R-tree: the rectangles are grouped in nodes of up to 16
+   elements, and each node has the rectangle that bounds its elements,
+   so a query only visits the nodes that touch the point or rectangle.
+   With @e n items the queries are O(log n) (while the items are not
+   piled up in the same place) instead of a loop over all of them.
+
+   The index can be modified incrementally (#insert, #update and
+   #remove), or loaded at once with #load, which packs the items in
+   full nodes sorting them by position (Sort-Tile-Recursive). Loading
+   is faster than inserting the items one by one, and gives better
+   nodes.
+
+   @code
+   SpatialIndex<Shape*> index;
+   index.load(items);			// std::pair<Shape*, Rect> of each shape
+   ...
+   index.update(shape, newBounds);	// when a shape is moved
+   index.findAt(mousePoint, shapes);	// shapes under the mouse
+   @endcode
+
+   @a T must be a valid key for @c std::unordered_map (e.g. a pointer),
+   and each item can be only one time in the index.
+
+   An empty rectangle does not contain any point nor intersect
+   anything, but the item is kept in the index (so its bounds can be
+   updated).
+
+   @see Widget#getChildAt, Widget#getChildrenIn
+*/
+template<typename T>
+class SpatialIndex : private NonCopyable
+{
+public:
+
+  /**
+     An item with its bounds, used to #load the index.
+  */
+  typedef std::pair<T, Rect> Item;
+
+private:
+
+  enum { MaxEntries = 16, MinEntries = 6 };
+
+  // Half-open rectangle [x1, x2) x [y1, y2)
+  struct Box
+  {
+    int x1, y1, x2, y2;
+  };
+
+  // Leaves (level 0) have items, the other nodes have children
+  struct Node
+  {
+    Node* parent;
+    int level;
+    int count;
+    Box box;
+    Box boxes[MaxEntries];
+    Node* children[MaxEntries];
+    T items[MaxEntries];
+  };
+
+  // An element to be added to a node
+  struct Entry
+  {
+    Box box;
+    Node* child;
+    T item;
+  };
+
+  typedef std::unordered_map<T, Node*> Leaves;
+
+  Node* m_root;
+  Leaves m_leaves;			// the leaf where each item is
+
+public:
+
+  SpatialIndex() : m_root(NULL) { }
+  ~SpatialIndex() { deleteNode(m_root); }
+
+  std::size_t size() const { return m_leaves.size(); }
+  bool empty() const { return m_leaves.empty(); }
+  bool contains(const T& item) const { return m_leaves.find(item) != m_leaves.end(); }
+
+  void clear()
+  {
+    deleteNode(m_root);
+    m_root = NULL;
+    m_leaves.clear();
+  }
+
+  /**
+     Adds an item that is not in the index.
+  */
+  void insert(const T& item, const Rect& bounds)
+  {
+    assert(!contains(item));
+
+    Entry entry;
+    entry.box = to_box(bounds);
+    entry.child = NULL;
+    entry.item = item;
+    insertEntry(entry, 0);
+  }
+
+  /**
+     Changes the bounds of an item.
+
+     When the new bounds are inside the node of the item it is updated
+     in place, otherwise the item is moved to another node.
+
+     @return False if the item is not in the index.
+  */
+  bool update(const T& item, const Rect& bounds)
+  {
+    typename Leaves::iterator it = m_leaves.find(item);
+    if (it == m_leaves.end())
+      return false;
+
+    Node* leaf = it->second;
+    int i = find_item(leaf, item);
+    Box box = to_box(bounds);
+
+    if (same_box(leaf->boxes[i], box))
+      return true;
+
+    if (contains_box(leaf->box, box)) {
+      leaf->boxes[i] = box;
+      adjust(leaf);
+    }
+    else {
+      m_leaves.erase(it);
+      removeEntry(leaf, i);
+      insert(item, bounds);
+    }
+    return true;
+  }
+
+  /**
+     Removes an item from the index.
+
+     @return False if the item is not in the index.
+  */
+  bool remove(const T& item)
+  {
+    typename Leaves::iterator it = m_leaves.find(item);
+    if (it == m_leaves.end())
+      return false;
+
+    Node* leaf = it->second;
+    m_leaves.erase(it);
+    removeEntry(leaf, find_item(leaf, item));
+    return true;
+  }
+
+  /**
+     Replaces the content of the index with the specified items (which
+     must be different).
+  */
+  void load(std::vector<Item> items)
+  {
+    clear();
+    if (items.empty())
+      return;
+
+    std::vector<Entry> entries(items.size());
+    for (std::size_t i=0; i<items.size(); ++i) {
+      entries[i].box = to_box(items[i].second);
+      entries[i].child = NULL;
+      entries[i].item = items[i].first;
+    }
+
+    // pack each level in nodes until there is only one (the root)
+    for (int level=0; ; ++level) {
+      std::vector<Node*> nodes;
+      pack(entries, level, nodes);
+      if (nodes.size() == 1) {
+	m_root = nodes[0];
+	break;
+      }
+
+      entries.resize(nodes.size());
+      for (std::size_t i=0; i<nodes.size(); ++i) {
+	entries[i].box = nodes[i]->box;
+	entries[i].child = nodes[i];
+      }
+    }
+  }
+
+  /**
+     Gets the items that contain the specified point.
+
+     @return The number of items in @a items (the previous content of
+	     the vector is removed).
+  */
+  std::size_t findAt(const Point& pt, std::vector<T>& items) const
+  {
+    items.clear();
+    if (m_root != NULL)
+      findAt(m_root, pt.x, pt.y, items);
+    return items.size();
+  }
+
+  /**
+     Gets the items that intersect the specified rectangle (touching
+     its edges is not enough).
+
+     @return The number of items in @a items (the previous content of
+	     the vector is removed).
+  */
+  std::size_t findIntersecting(const Rect& rc, std::vector<T>& items) const
+  {
+    items.clear();
+    if (m_root != NULL)
+      findIntersecting(m_root, to_box(rc), items);
+    return items.size();
+  }
+
+private:
+
+  static Box to_box(const Rect& rc)
+  {
+    Box box = { rc.x, rc.y, rc.x+rc.w, rc.y+rc.h };
+    return box;
+  }
+
+  static bool same_box(const Box& a, const Box& b)
+  {
+    return a.x1 == b.x1 && a.y1 == b.y1 && a.x2 == b.x2 && a.y2 == b.y2;
+  }
+
+  static bool contains_box(const Box& a, const Box& b)
+  {
+    return a.x1 <= b.x1 && a.y1 <= b.y1 && b.x2 <= a.x2 && b.y2 <= a.y2;
+  }
+
+  static bool contains_point(const Box& a, int x, int y)
+  {
+    return a.x1 <= x && x < a.x2 && a.y1 <= y && y < a.y2;
+  }
+
+  // Works with empty boxes too (they do not overlap anything)
+  static bool overlap(const Box& a, const Box& b)
+  {
+    return (std::max(a.x1, b.x1) < std::min(a.x2, b.x2) &&
+	    std::max(a.y1, b.y1) < std::min(a.y2, b.y2));
+  }
+
+  static Box union_box(const Box& a, const Box& b)
+  {
+    Box box = { std::min(a.x1, b.x1), std::min(a.y1, b.y1),
+		std::max(a.x2, b.x2), std::max(a.y2, b.y2) };
+    return box;
+  }
+
+  static double area(const Box& a)
+  {
+    return double(a.x2 - a.x1) * double(a.y2 - a.y1);
+  }
+
+  static int find_item(const Node* leaf, const T& item)
+  {
+    for (int i=0; i<leaf->count; ++i)
+      if (leaf->items[i] == item)
+	return i;
+    assert(false);
+    return -1;
+  }
+
+  static int find_child(const Node* node, const Node* child)
+  {
+    for (int i=0; i<node->count; ++i)
+      if (node->children[i] == child)
+	return i;
+    assert(false);
+    return -1;
+  }
+
+  static Box bounds_of(const Node* node)
+  {
+    Box box = node->boxes[0];
+    for (int i=1; i<node->count; ++i)
+      box = union_box(box, node->boxes[i]);
+    return box;
+  }
+
+  static Node* newNode(int level)
+  {
+    Node* node = new Node;
+    node->parent = NULL;
+    node->level = level;
+    node->count = 0;
+    return node;
+  }
+
+  static void deleteNode(Node* node)
+  {
+    if (node != NULL && node->level > 0)
+      for (int i=0; i<node->count; ++i)
+	deleteNode(node->children[i]);
+    delete node;
+  }
+
+  void setEntry(Node* node, int i, const Entry& entry)
+  {
+    node->boxes[i] = entry.box;
+    if (node->level == 0) {
+      node->items[i] = entry.item;
+      m_leaves[entry.item] = node;
+    }
+    else {
+      node->children[i] = entry.child;
+      entry.child->parent = node;
+    }
+  }
+
+  Entry getEntry(const Node* node, int i) const
+  {
+    Entry entry;
+    entry.box = node->boxes[i];
+    if (node->level == 0) {
+      entry.child = NULL;
+      entry.item = node->items[i];
+    }
+    else
+      entry.child = node->children[i];
+    return entry;
+  }
+
+  // Recalculates the bounds of the node and its ancestors (stops when
+  // a node does not change)
+  static void adjust(Node* node)
+  {
+    while (node != NULL) {
+      Box box = bounds_of(node);
+      if (same_box(box, node->box))
+	break;
+
+      node->box = box;
+      if (node->parent != NULL)
+	node->parent->boxes[find_child(node->parent, node)] = box;
+      node = node->parent;
+    }
+  }
+
+  // Adds an entry in a node of the specified level (0 for items)
+  void insertEntry(const Entry& entry, int level)
+  {
+    if (m_root == NULL) {
+      m_root = newNode(0);
+      m_root->box = entry.box;
+    }
+    assert(m_root->level >= level);
+
+    // go down choosing the child that grows less
+    Node* node = m_root;
+    while (node->level > level) {
+      int best = 0;
+      double bestGrowth = 0, bestArea = 0;
+      for (int i=0; i<node->count; ++i) {
+	double a = area(node->boxes[i]);
+	double growth = area(union_box(node->boxes[i], entry.box)) - a;
+	if (i == 0 || growth < bestGrowth || (growth == bestGrowth && a < bestArea)) {
+	  best = i;
+	  bestGrowth = growth;
+	  bestArea = a;
+	}
+      }
+      node = node->children[best];
+    }
+
+    addEntry(node, entry);
+  }
+
+  void addEntry(Node* node, const Entry& entry)
+  {
+    if (node->count < MaxEntries) {
+      setEntry(node, node->count++, entry);
+      if (node->count == 1)
+	node->box = entry.box;
+      adjust(node);
+    }
+    else
+      split(node, entry);
+  }
+
+  // Splits a full node in two to add a new entry (Guttman's quadratic
+  // split)
+  void split(Node* node, const Entry& extra)
+  {
+    Entry entries[MaxEntries+1];
+    int n = node->count;
+    for (int i=0; i<n; ++i)
+      entries[i] = getEntry(node, i);
+    entries[n++] = extra;
+
+    // the two entries that waste more space together are the seeds
+    int seed1 = 0, seed2 = 1;
+    double worst = -1;
+    for (int i=0; i<n; ++i)
+      for (int j=i+1; j<n; ++j) {
+	double waste = (area(union_box(entries[i].box, entries[j].box))
+			- area(entries[i].box) - area(entries[j].box));
+	if (waste > worst) {
+	  worst = waste;
+	  seed1 = i;
+	  seed2 = j;
+	}
+      }
+
+    Node* sibling = newNode(node->level);
+    node->count = 0;
+    setEntry(node, node->count++, entries[seed1]);
+    setEntry(sibling, sibling->count++, entries[seed2]);
+    node->box = entries[seed1].box;
+    sibling->box = entries[seed2].box;
+
+    bool assigned[MaxEntries+1] = { false };
+    assigned[seed1] = assigned[seed2] = true;
+
+    for (int remaining=n-2; remaining > 0; --remaining) {
+      Node* group;
+
+      // a group needs all the remaining entries
+      if (node->count + remaining <= MinEntries ||
+	  sibling->count + remaining <= MinEntries) {
+	group = (node->count < sibling->count ? node: sibling);
+	for (int i=0; i<n; ++i)
+	  if (!assigned[i]) {
+	    assigned[i] = true;
+	    setEntry(group, group->count++, entries[i]);
+	    group->box = union_box(group->box, entries[i].box);
+	  }
+	break;
+      }
+
+      // the entry with the biggest preference for one of the groups
+      int next = -1;
+      double d1 = 0, d2 = 0, maxDiff = -1;
+      for (int i=0; i<n; ++i) {
+	if (assigned[i])
+	  continue;
+
+	double g1 = area(union_box(node->box, entries[i].box)) - area(node->box);
+	double g2 = area(union_box(sibling->box, entries[i].box)) - area(sibling->box);
+	double diff = std::fabs(g1 - g2);
+	if (diff > maxDiff) {
+	  maxDiff = diff;
+	  next = i;
+	  d1 = g1;
+	  d2 = g2;
+	}
+      }
+
+      if (d1 != d2)
+	group = (d1 < d2 ? node: sibling);
+      else if (area(node->box) != area(sibling->box))
+	group = (area(node->box) < area(sibling->box) ? node: sibling);
+      else
+	group = (node->count <= sibling->count ? node: sibling);
+
+      assigned[next] = true;
+      setEntry(group, group->count++, entries[next]);
+      group->box = union_box(group->box, entries[next].box);
+    }
+
+    Entry entry;
+    entry.box = sibling->box;
+    entry.child = sibling;
+
+    if (node == m_root) {
+      m_root = newNode(node->level+1);
+      m_root->box = union_box(node->box, sibling->box);
+      setEntry(m_root, m_root->count++, getNodeEntry(node));
+      setEntry(m_root, m_root->count++, entry);
+    }
+    else {
+      Node* parent = node->parent;
+      parent->boxes[find_child(parent, node)] = node->box;
+      adjust(parent);
+      addEntry(parent, entry);
+    }
+  }
+
+  static Entry getNodeEntry(Node* node)
+  {
+    Entry entry;
+    entry.box = node->box;
+    entry.child = node;
+    return entry;
+  }
+
+  // Removes the entry "i" of a leaf. The nodes with few entries are
+  // removed from the tree, and their entries are added again.
+  void removeEntry(Node* leaf, int i)
+  {
+    if (i != leaf->count-1)
+      setEntry(leaf, i, getEntry(leaf, leaf->count-1));
+    --leaf->count;
+
+    std::vector<Node*> orphans;
+    Node* node = leaf;
+    while (node != m_root) {
+      Node* parent = node->parent;
+      int j = find_child(parent, node);
+
+      if (node->count < MinEntries) {
+	if (j != parent->count-1) {
+	  parent->children[j] = parent->children[parent->count-1];
+	  parent->boxes[j] = parent->boxes[parent->count-1];
+	}
+	--parent->count;
+	orphans.push_back(node);
+      }
+      else {
+	node->box = bounds_of(node);
+	parent->boxes[j] = node->box;
+      }
+      node = parent;
+    }
+    if (m_root->count > 0)
+      m_root->box = bounds_of(m_root);
+
+    for (std::size_t k=0; k<orphans.size(); ++k) {
+      Node* orphan = orphans[k];
+      for (int j=0; j<orphan->count; ++j)
+	insertEntry(getEntry(orphan, j), orphan->level);
+      delete orphan;
+    }
+
+    // the root must have two children at least
+    while (m_root->level > 0 && m_root->count == 1) {
+      Node* child = m_root->children[0];
+      delete m_root;
+      m_root = child;
+      m_root->parent = NULL;
+    }
+    if (m_root->count == 0) {
+      delete m_root;
+      m_root = NULL;
+    }
+  }
+
+  // Groups the entries in nodes of the specified level: they are sorted
+  // in vertical slices, and each slice is sorted from top to bottom
+  void pack(std::vector<Entry>& entries, int level, std::vector<Node*>& nodes)
+  {
+    std::size_t n = entries.size();
+    std::size_t nodeCount = (n + MaxEntries - 1) / MaxEntries;
+    std::size_t slices = static_cast<std::size_t>(std::ceil(std::sqrt(double(nodeCount))));
+    std::size_t sliceSize = slices * MaxEntries;
+
+    std::sort(entries.begin(), entries.end(), compare_x);
+
+    for (std::size_t i=0; i<n; i += sliceSize) {
+      std::size_t sliceEnd = std::min(i + sliceSize, n);
+      std::sort(entries.begin()+i, entries.begin()+sliceEnd, compare_y);
+
+      for (std::size_t j=i; j<sliceEnd; j += MaxEntries) {
+	Node* node = newNode(level);
+	std::size_t end = std::min<std::size_t>(j + MaxEntries, sliceEnd);
+	for (std::size_t k=j; k<end; ++k)
+	  setEntry(node, node->count++, entries[k]);
+	node->box = bounds_of(node);
+	nodes.push_back(node);
+      }
+    }
+  }
+
+  static bool compare_x(const Entry& a, const Entry& b)
+  {
+    return a.box.x1 + a.box.x2 < b.box.x1 + b.box.x2;
+  }
+
+  static bool compare_y(const Entry& a, const Entry& b)
+  {
+    return a.box.y1 + a.box.y2 < b.box.y1 + b.box.y2;
+  }
+
+  static void findAt(const Node* node, int x, int y, std::vector<T>& items)
+  {
+    for (int i=0; i<node->count; ++i) {
+      if (!contains_point(node->boxes[i], x, y))
+	continue;
+
+      if (node->level == 0)
+	items.push_back(node->items[i]);
+      else
+	findAt(node->children[i], x, y, items);
+    }
+  }
+
+  static void findIntersecting(const Node* node, const Box& box, std::vector<T>& items)
+  {
+    for (int i=0; i<node->count; ++i) {
+      if (!overlap(node->boxes[i], box))
+	continue;
+
+      if (node->level == 0)
+	items.push_back(node->items[i]);
+      else
+	findIntersecting(node->children[i], box, items);
+    }
+  }
+
+};
+
+} // namespace vaca
+
+#endif // VACA_SPATIALINDEX_H
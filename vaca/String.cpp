@@ -7,45 +7,44 @@
 #define VACA_STRING_CPP
 
 #include "vaca/String.h"
+#include "vaca/CharConv.h"
 #include "vaca/Debug.h"
 #include "vaca/Exception.h"
+#include "vaca/UrlEncoding.h"
 #include <cstdarg>
 #include <cstdlib>
 #include <cctype>
 #include <vector>
-#include <iterator>
-#include <wininet.h>
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 
 using namespace vaca;
 
 String vaca::format_string(const Char* fmt, ...)
 {
-  std::auto_ptr<Char> buf;
-  int size = 512;
+  // most strings fit in a buffer in the stack
+  Char stackBuf[256];
+  std::vector<Char> heapBuf;
+  Char* buf = stackBuf;
+  int size = 256;
 
   while (true) {
-    buf = std::auto_ptr<Char>(new Char[size <<= 1]);
-
     va_list ap;
     va_start(ap, fmt);
-    int written = _vsnwprintf(buf.get(), size, fmt, ap);
+    int written = _vsnwprintf(buf, size, fmt, ap);
     va_end(ap);
 
-    if (written == size) {
-      if (buf.get()[size] == 0)
-	break;
-    }
-    else if (written >= 0 && written < size) {
-      assert(buf.get()[written] == 0);
-      break;
-    }
-    // else continue growing the buffer...
-  }
+    if (written >= 0 && written < size)
+      return String(buf, written);
 
-  return String(buf.get());
+    // _vsnwprintf returns -1 (or "size" if there is no space for the
+    // null character) when the buffer is too small
+    size = (written > size) ? written+1: size*2;
+    heapBuf.resize(size);
+    buf = &heapBuf[0];
+  }
 }
 
 String vaca::trim_string(const String& str)
@@ -57,89 +56,56 @@ String vaca::trim_string(const Char* str)
 {
   assert(str != NULL);
 
-  String res(str);
-  while (!res.empty() && std::isspace(res.at(0)))
-    res.erase(res.begin());
-  while (!res.empty() && std::isspace(res.at(res.size()-1)))
-    res.erase(res.end()-1);
-
-  return res;
+  return trim_string(StringView(str)).str();
 }
 
-std::string vaca::to_utf8(const String& string)
-{
-  int required_size =
-    WideCharToMultiByte(CP_UTF8, 0,
-			string.c_str(), string.size(),
-			NULL, 0, NULL, NULL);
-
-  if (required_size == 0)
-    return std::string();
-
-  std::vector<char> buf(++required_size);
-
-  WideCharToMultiByte(CP_UTF8, 0, 
-		      string.c_str(), string.size(),
-		      &buf[0], required_size,
-		      NULL, NULL);
-
-  return std::string(&buf[0]);
-}
-
-String vaca::from_utf8(const std::string& string)
+void vaca::split_string(const String& string, std::vector<String>& parts, const String& separators)
 {
-  int required_size =
-    MultiByteToWideChar(CP_UTF8, 0,
-			string.c_str(), string.size(),
-			NULL, 0);
+  StringSplitter splitter = split_string(StringView(string), StringView(separators));
 
-  if (required_size == 0)
-    return String();
-
-  std::vector<wchar_t> buf(++required_size);
-
-  MultiByteToWideChar(CP_UTF8, 0,
-		      string.c_str(), string.size(),
-		      &buf[0], required_size);
-
-  return String(&buf[0]);
+  parts.clear();
+  for (StringSplitter::iterator it = splitter.begin(); it != splitter.end(); ++it)
+    parts.push_back(it->str());
 }
 
 namespace {
-  struct is_separator
+
+  // Converts the number like wcstol/wcstod do (skipping white spaces
+  // and accepting a '+' sign), but without using the C locale. Returns
+  // zero if the string is not a number, and the nearest value if the
+  // number is too big.
+  template<class T>
+  T parse_number(const String& from)
   {
-    const String* separators;
-    is_separator(const String* separators) : separators(separators) { }
-    bool operator()(Char chr)
-    {
-      for (String::const_iterator
-	     it = separators->begin(),
-	     end = separators->end(); it != end; ++it) {
-	if (chr == *it)
-	  return true;
-      }
-      return false;
+    const Char* first = from.c_str();
+    const Char* last = first + from.size();
+
+    while (first != last && details::is_space(*first))
+      ++first;
+    if (first != last && *first == L'+')
+      ++first;
+
+    T value = T();
+    FromCharsResult res = from_chars(first, last, value);
+    if (res.error == CharConvError::OutOfRange) {
+      typedef std::numeric_limits<T> Limits;
+      T huge = Limits::is_integer ? Limits::max(): Limits::infinity();
+      if (*first == L'-')
+	value = Limits::is_integer ? Limits::min(): T(0) - huge;
+      else
+	value = huge;
     }
-  };
-}
-
-void vaca::split_string(const String& string, std::vector<String>& parts, const String& separators)
-{
-  size_t elements = 1 + std::count_if(string.begin(), string.end(), is_separator(&separators));
-  parts.resize(elements);
+    return value;
+  }
 
-  size_t beg = 0, end;
-  while (true) {
-    end = string.find_first_of(separators);
-    if (end != String::npos) {
-      parts.push_back(string.substr(beg, end - beg));
-      beg = end+1;
-    }
-    else {
-      parts.push_back(string.substr(beg));
-      break;
-    }
+  template<class T>
+  String number_to_string(T value)
+  {
+    Char buf[max_number_chars];
+    ToCharsResult res = to_chars(buf, buf+max_number_chars, value);
+    return String(buf, res.ptr);
   }
+
 }
 
 template<> std::string vaca::convert_to(const Char* const& from)
@@ -166,32 +132,32 @@ template<> std::string vaca::convert_to(const String& from)
 
 template<> int vaca::convert_to(const String& from)
 {
-  return (int)std::wcstol(from.c_str(), NULL, 10);
+  return parse_number<int>(from);
 }
 
 template<> long vaca::convert_to(const String& from)
 {
-  return (long)std::wcstol(from.c_str(), NULL, 10);
+  return parse_number<long>(from);
 }
 
 template<> unsigned int vaca::convert_to(const String& from)
 {
-  return (unsigned int)std::wcstoul(from.c_str(), NULL, 10);
+  return parse_number<unsigned int>(from);
 }
 
 template<> unsigned long vaca::convert_to(const String& from)
 {
-  return (unsigned long)std::wcstoul(from.c_str(), NULL, 10);
+  return parse_number<unsigned long>(from);
 }
 
 template<> float vaca::convert_to(const String& from)
 {
-  return (float)std::wcstod(from.c_str(), NULL);
+  return parse_number<float>(from);
 }
 
 template<> double vaca::convert_to(const String& from)
 {
-  return std::wcstod(from.c_str(), NULL);
+  return parse_number<double>(from);
 }
 
 template<> String vaca::convert_to(const char* const& from)
@@ -218,32 +184,32 @@ template<> String vaca::convert_to(const std::string& from)
 
 template<> String vaca::convert_to(const int& from)
 {
-  return format_string(L"%d", from);
+  return number_to_string(from);
 }
 
 template<> String vaca::convert_to(const long& from)
 {
-  return format_string(L"%ld", from);
+  return number_to_string(from);
 }
 
 template<> String vaca::convert_to(const unsigned int& from)
 {
-  return format_string(L"%u", from);
+  return number_to_string(from);
 }
 
 template<> String vaca::convert_to(const unsigned long& from)
 {
-  return format_string(L"%lu", from);
+  return number_to_string(from);
 }
 
 template<> String vaca::convert_to(const float& from)
 {
-  return format_string(L"%.16g", from);
+  return number_to_string(from);
 }
 
 template<> String vaca::convert_to(const double& from)
 {
-  return format_string(L"%.16g", from);
+  return number_to_string(from);
 }
 
 /**
@@ -313,20 +279,7 @@ String& vaca::operator/=(String& path, const String& comp)
 */
 String vaca::file_path(const String& fullpath)
 {
-  String::const_reverse_iterator rit;
-  String res;
-
-  for (rit=fullpath.rbegin(); rit!=fullpath.rend(); ++rit)
-    if (*rit == L'\\' || *rit == L'/')
-      break;
-
-  if (rit != fullpath.rend()) {
-    ++rit;
-    std::copy(fullpath.begin(), String::const_iterator(rit.base()),
-	      std::back_inserter(res));
-  }
-
-  return res;
+  return file_path(StringView(fullpath)).str();
 }
 
 /**
@@ -337,17 +290,7 @@ String vaca::file_path(const String& fullpath)
 */
 String vaca::file_name(const String& fullpath)
 {
-  String::const_reverse_iterator rit;
-  String res;
-
-  for (rit=fullpath.rbegin(); rit!=fullpath.rend(); ++rit)
-    if (*rit == L'\\' || *rit == L'/')
-      break;
-
-  std::copy(String::const_iterator(rit.base()), fullpath.end(),
-	    std::back_inserter(res));
-
-  return res;
+  return file_name(StringView(fullpath)).str();
 }
 
 /**
@@ -361,23 +304,7 @@ String vaca::file_name(const String& fullpath)
 */
 String vaca::file_extension(const String& fullpath)
 {
-  String::const_reverse_iterator rit;
-  String res;
-
-  // search for the first dot from the end of the string
-  for (rit=fullpath.rbegin(); rit!=fullpath.rend(); ++rit) {
-    if (*rit == L'\\' || *rit == L'/')
-      return res;
-    else if (*rit == L'.')
-      break;
-  }
-
-  if (rit != fullpath.rend()) {
-    std::copy(String::const_iterator(rit.base()), fullpath.end(),
-	      std::back_inserter(res));
-  }
-
-  return res;
+  return file_extension(StringView(fullpath)).str();
 }
 
 /**
@@ -391,92 +318,54 @@ String vaca::file_extension(const String& fullpath)
 */
 String vaca::file_title(const String& fullpath)
 {
-  String::const_reverse_iterator rit;
-  String::const_iterator last_dot = fullpath.end();
-  String res;
-
-  for (rit=fullpath.rbegin(); rit!=fullpath.rend(); ++rit) {
-    if (*rit == L'\\' || *rit == L'/')
-      break;
-    else if (*rit == L'.' && last_dot == fullpath.end())
-      last_dot = rit.base()-1;
-  }
-
-  for (String::const_iterator it(rit.base()); it!=fullpath.end(); ++it) {
-    if (it == last_dot)
-      break;
-    else
-      res.push_back(*it);
-  }
-
-  return res;
+  return file_title(StringView(fullpath)).str();
 }
 
+/**
+   Returns the host of the URL (the host of "http://vaca.sf.net/doc/"
+   is "vaca.sf.net").
+*/
 String vaca::url_host(const String& url)
 {
-  String host;
-  int len = url.size();
-  for (int c=0; c<len; ++c) {
-    if (url[c] == L':' && url[c+1] == L'/' && url[c+2] == L'/') {
-      for (c+=3; c<len && url[c] != L'/'; ++c)
-	host.push_back(url[c]);
-    }
-  }
-  return host;
+  return url_host(StringView(url)).str();
 }
 
+/**
+   Returns the object of the URL (the object of "http://vaca.sf.net/doc/"
+   is "/doc/").
+*/
 String vaca::url_object(const String& url)
 {
-  String object;
-  int len = url.size();
-  for (int c=0; c<len; ++c) {
-    if (url[c] == ':' && url[c+1] == '/' && url[c+2] == '/') {
-      for (c+=3; c<len && url[c] != '/'; ++c)
-	;
-      for (; c<len; ++c)
-	object.push_back(url[c]);
-    }
-  }
-  return object;
+  return url_object(StringView(url)).str();
 }
 
+/**
+   Encodes the characters that cannot be in a URL (like spaces or
+   non-ASCII characters) as "%XX" escapes of their UTF-8 bytes. The
+   delimiters of the URL (like '/' or '?') and the escapes are kept.
+
+   @see decode_url, url_encode
+*/
 String vaca::encode_url(const String& url)
 {
-  std::auto_ptr<Char> buf;
-  DWORD size = 1024;
-
-  while (true) {
-    buf = std::auto_ptr<Char>(new Char[size]);
-
-    if (::InternetCanonicalizeUrl(url.c_str(), buf.get(), &size, 0))
-      break;
+  std::string utf8 = to_utf8(url);
+  std::string res(3*utf8.size(), '\0');
+  res.resize(url_encode(utf8.data(), utf8.size(), &res[0], UrlEncoding::Url));
 
-    if (GetLastError() != ERROR_INSUFFICIENT_BUFFER)
-      throw Exception();
-
-    // else continue growing the buffer...
-  }
-
-  return String(buf.get());
+  // the result is ASCII
+  return String(res.begin(), res.end());
 }
 
+/**
+   Decodes the "%XX" escapes of the URL (the bytes are decoded as
+   UTF-8).
+
+   @see encode_url, url_decode
+*/
 String vaca::decode_url(const String& url)
 {
-  std::auto_ptr<Char> buf;
-  DWORD size = 1024;
-
-  while (true) {
-    buf = std::auto_ptr<Char>(new Char[size]);
-
-    if (::InternetCanonicalizeUrl(url.c_str(), buf.get(), &size,
-				  ICU_DECODE | ICU_NO_ENCODE))
-      break;
-
-    if (GetLastError() != ERROR_INSUFFICIENT_BUFFER)
-      throw Exception();
-
-    // else continue growing the buffer...
-  }
-
-  return String(buf.get());
+  std::string utf8 = to_utf8(url);
+  std::string res(utf8.size(), '\0');
+  res.resize(url_decode(utf8.data(), utf8.size(), &res[0]));
+  return from_utf8(res);
 }
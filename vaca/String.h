@@ -8,6 +8,7 @@
 #define VACA_STRING_H
 
 #include "vaca/base.h"
+#include "vaca/StringView.h"
 #include <vector>
 
 namespace vaca {
@@ -26,10 +27,11 @@ namespace vaca {
   VACA_DLL String trim_string(const String& str);
   VACA_DLL String trim_string(const Char* str);
 
+  // UTF-8 conversions (defined in Utf.cpp, see @ref utf_utils)
   VACA_DLL std::string to_utf8(const String& string);
   VACA_DLL String from_utf8(const std::string& string);
 
-  // Split a string in parts
+  // Split a string in parts (see split_string(StringView, StringView) to iterate them without copies)
   VACA_DLL void split_string(const String& string, std::vector<String>& parts, const String& separators);
 
   // ============================================================
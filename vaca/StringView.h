@@ -0,0 +1,376 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#ifndef VACA_STRINGVIEW_H
+#define VACA_STRINGVIEW_H
+
+#include "vaca/base.h"
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <string>
+
+namespace vaca {
+
+/**
+   A read-only reference to a sequence of characters.
+
+   A view is a pointer and a size: it does not own the characters, so
+   copying it or getting a part of it (#substr) does not allocate
+   memory. The referenced string must live more than the view.
+
+   The helpers of @ref string_utils have versions that receive and
+   return views (e.g. file_name(StringView)), so you can parse a lot
+   of paths or URLs without creating temporary strings:
+   @code
+   String fullpath = ...;
+   StringView ext = file_extension(StringView(fullpath));
+   if (ext == L"cpp")
+     ...
+   @endcode
+
+   @see StringView, BasicStringSplitter
+*/
+template<class T>
+class BasicStringView
+{
+  const T* m_data;
+  std::size_t m_size;
+
+public:
+  typedef T value_type;
+  typedef const T* iterator;
+  typedef const T* const_iterator;
+  typedef std::size_t size_type;
+  typedef std::char_traits<T> traits_type;
+
+  static const std::size_t npos = static_cast<std::size_t>(-1);
+
+  BasicStringView() : m_data(NULL), m_size(0) { }
+  BasicStringView(const T* str) : m_data(str), m_size(traits_type::length(str)) { }
+  BasicStringView(const T* data, std::size_t size) : m_data(data), m_size(size) { }
+  BasicStringView(const std::basic_string<T>& str) : m_data(str.data()), m_size(str.size()) { }
+
+  const T* data() const { return m_data; }
+  std::size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  const_iterator begin() const { return m_data; }
+  const_iterator end() const { return m_data + m_size; }
+
+  T operator[](std::size_t i) const {
+    assert(i < m_size);
+    return m_data[i];
+  }
+
+  /**
+     Returns the view of @a n characters from @a pos (or the rest of
+     the string if @a n is too big).
+  */
+  BasicStringView substr(std::size_t pos, std::size_t n = npos) const {
+    assert(pos <= m_size);
+    if (n > m_size - pos)
+      n = m_size - pos;
+    return BasicStringView(m_data + pos, n);
+  }
+
+  std::size_t find(T chr, std::size_t pos = 0) const {
+    if (pos >= m_size)
+      return npos;
+    const T* ptr = traits_type::find(m_data + pos, m_size - pos, chr);
+    return ptr ? ptr - m_data: npos;
+  }
+
+  std::size_t find(BasicStringView str, std::size_t pos = 0) const {
+    if (str.m_size == 0)
+      return pos <= m_size ? pos: npos;
+    for (; pos < m_size && str.m_size <= m_size - pos; ++pos) {
+      pos = find(str.m_data[0], pos);
+      if (pos == npos || str.m_size > m_size - pos)
+	break;
+      if (traits_type::compare(m_data + pos, str.m_data, str.m_size) == 0)
+	return pos;
+    }
+    return npos;
+  }
+
+  std::size_t rfind(T chr) const {
+    for (std::size_t i = m_size; i > 0; --i)
+      if (m_data[i-1] == chr)
+	return i-1;
+    return npos;
+  }
+
+  std::size_t find_first_of(BasicStringView chars, std::size_t pos = 0) const {
+    if (chars.m_size == 1)
+      return find(chars.m_data[0], pos);
+    for (; pos < m_size; ++pos)
+      if (chars.contains(m_data[pos]))
+	return pos;
+    return npos;
+  }
+
+  std::size_t find_last_of(BasicStringView chars) const {
+    for (std::size_t i = m_size; i > 0; --i)
+      if (chars.contains(m_data[i-1]))
+	return i-1;
+    return npos;
+  }
+
+  bool contains(T chr) const {
+    return m_size > 0 && traits_type::find(m_data, m_size, chr) != NULL;
+  }
+
+  int compare(BasicStringView other) const {
+    std::size_t n = m_size < other.m_size ? m_size: other.m_size;
+    int res = n > 0 ? traits_type::compare(m_data, other.m_data, n): 0;
+    if (res != 0)
+      return res;
+    return m_size < other.m_size ? -1: (m_size > other.m_size ? 1: 0);
+  }
+
+  /**
+     Returns a copy of the characters.
+  */
+  std::basic_string<T> str() const {
+    return std::basic_string<T>(m_data, m_size);
+  }
+
+  friend bool operator==(BasicStringView a, BasicStringView b) {
+    return a.m_size == b.m_size && (a.m_size == 0 ||
+				    traits_type::compare(a.m_data, b.m_data, a.m_size) == 0);
+  }
+
+  friend bool operator!=(BasicStringView a, BasicStringView b) { return !(a == b); }
+  friend bool operator<(BasicStringView a, BasicStringView b) { return a.compare(b) < 0; }
+};
+
+template<class T>
+const std::size_t BasicStringView<T>::npos;
+
+/**
+   View of a String.
+*/
+typedef BasicStringView<Char> StringView;
+
+/**
+   A lazy sequence with the parts of a string separated by any of the
+   given separators.
+
+   The parts are found while you iterate, and each one is a view of
+   the original string. Empty parts are not skipped: "a,,b" has three
+   parts ("a", "" and "b") and an empty string has one empty part.
+
+   @code
+   StringSplitter fields = split_string(StringView(line), L",;");
+   for (StringSplitter::iterator it = fields.begin(); it != fields.end(); ++it) {
+     StringView field = *it;
+     ...
+   }
+   @endcode
+
+   @see split_string
+*/
+template<class T>
+class BasicStringSplitter
+{
+  BasicStringView<T> m_string;
+  BasicStringView<T> m_separators;
+
+public:
+
+  class iterator : public std::iterator<std::forward_iterator_tag, BasicStringView<T> >
+  {
+    const T* m_pos;		// beginning of the current part
+    const T* m_partEnd;		// end of the current part
+    const T* m_end;		// end of the whole string
+    bool m_done;		// true when all parts were visited
+    BasicStringView<T> m_separators;
+    BasicStringView<T> m_part;
+
+  public:
+    iterator() : m_pos(NULL), m_partEnd(NULL), m_end(NULL), m_done(true) { }
+
+    iterator(BasicStringView<T> string, BasicStringView<T> separators)
+      : m_pos(string.begin())
+      , m_end(string.end())
+      , m_done(false)
+      , m_separators(separators) {
+      findPartEnd();
+    }
+
+    const BasicStringView<T>& operator*() const { return m_part; }
+    const BasicStringView<T>* operator->() const { return &m_part; }
+
+    iterator& operator++() {
+      if (m_partEnd == m_end)
+	m_done = true;
+      else {
+	m_pos = m_partEnd+1;
+	findPartEnd();
+      }
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator old(*this);
+      ++(*this);
+      return old;
+    }
+
+    bool operator==(const iterator& other) const {
+      return m_done == other.m_done && (m_done || m_pos == other.m_pos);
+    }
+
+    bool operator!=(const iterator& other) const {
+      return !operator==(other);
+    }
+
+  private:
+    void findPartEnd() {
+      BasicStringView<T> rest(m_pos, m_end - m_pos);
+      std::size_t i = rest.find_first_of(m_separators);
+      m_partEnd = (i != BasicStringView<T>::npos) ? m_pos + i: m_end;
+      m_part = BasicStringView<T>(m_pos, m_partEnd - m_pos);
+    }
+  };
+
+  typedef iterator const_iterator;
+
+  BasicStringSplitter(BasicStringView<T> string, BasicStringView<T> separators)
+    : m_string(string)
+    , m_separators(separators) {
+  }
+
+  iterator begin() const { return iterator(m_string, m_separators); }
+  iterator end() const { return iterator(); }
+};
+
+typedef BasicStringSplitter<Char> StringSplitter;
+
+namespace details {
+
+  template<class T>
+  struct Identity { typedef T type; };
+
+  template<class T>
+  inline bool is_space(T chr) {
+    return (chr == ' ' || chr == '\t' || chr == '\n' ||
+	    chr == '\r' || chr == '\v' || chr == '\f');
+  }
+
+  template<class T>
+  inline bool is_path_separator(T chr) {
+    return chr == '\\' || chr == '/';
+  }
+
+  // Returns the index after the last path separator (0 if there is not one)
+  template<class T>
+  std::size_t file_name_pos(BasicStringView<T> fullpath) {
+    std::size_t i = fullpath.size();
+    while (i > 0 && !is_path_separator(fullpath[i-1]))
+      --i;
+    return i;
+  }
+
+  // Returns the index after the "://" of the URL (npos if there is not one)
+  template<class T>
+  std::size_t url_host_pos(BasicStringView<T> url) {
+    for (std::size_t i = 0; i+2 < url.size(); ++i)
+      if (url[i] == ':' && url[i+1] == '/' && url[i+2] == '/')
+	return i+3;
+    return BasicStringView<T>::npos;
+  }
+
+}
+
+/**
+   @addtogroup string_utils
+   @{
+*/
+
+/**
+   Returns the part of the string without the white spaces at the
+   beginning and at the end.
+*/
+template<class T>
+BasicStringView<T> trim_string(BasicStringView<T> str)
+{
+  std::size_t beg = 0, end = str.size();
+  while (beg < end && details::is_space(str[beg]))
+    ++beg;
+  while (end > beg && details::is_space(str[end-1]))
+    --end;
+  return str.substr(beg, end-beg);
+}
+
+/**
+   Returns a lazy sequence with the parts of @a str separated by any
+   of the characters of @a separators.
+*/
+template<class T>
+BasicStringSplitter<T> split_string(BasicStringView<T> str,
+				    typename details::Identity<BasicStringView<T> >::type separators)
+{
+  return BasicStringSplitter<T>(str, separators);
+}
+
+template<class T>
+BasicStringView<T> file_path(BasicStringView<T> fullpath)
+{
+  std::size_t pos = details::file_name_pos(fullpath);
+  return fullpath.substr(0, pos > 0 ? pos-1: 0);
+}
+
+template<class T>
+BasicStringView<T> file_name(BasicStringView<T> fullpath)
+{
+  return fullpath.substr(details::file_name_pos(fullpath));
+}
+
+template<class T>
+BasicStringView<T> file_extension(BasicStringView<T> fullpath)
+{
+  BasicStringView<T> name = file_name(fullpath);
+  std::size_t dot = name.rfind('.');
+  return dot != BasicStringView<T>::npos ? name.substr(dot+1): BasicStringView<T>();
+}
+
+template<class T>
+BasicStringView<T> file_title(BasicStringView<T> fullpath)
+{
+  BasicStringView<T> name = file_name(fullpath);
+  return name.substr(0, name.rfind('.'));
+}
+
+template<class T>
+BasicStringView<T> url_host(BasicStringView<T> url)
+{
+  std::size_t beg = details::url_host_pos(url);
+  if (beg == BasicStringView<T>::npos)
+    return BasicStringView<T>();
+
+  BasicStringView<T> rest = url.substr(beg);
+  return rest.substr(0, rest.find('/'));
+}
+
+template<class T>
+BasicStringView<T> url_object(BasicStringView<T> url)
+{
+  std::size_t beg = details::url_host_pos(url);
+  if (beg == BasicStringView<T>::npos)
+    return BasicStringView<T>();
+
+  std::size_t slash = url.find('/', beg);
+  return slash != BasicStringView<T>::npos ? url.substr(slash): BasicStringView<T>();
+}
+
+/** @} */
+
+} // namespace vaca
+
+#endif // VACA_STRINGVIEW_H
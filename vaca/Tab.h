@@ -144,6 +144,7 @@ public:
 
   virtual String getText() const;
   virtual void setText(const String& str);
+  using Widget::setText;
 
   int getPageIndex();
 
@@ -0,0 +1,549 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#include "vaca/TextBuffer.h"
+#include "vaca/Referenceable.h"
+
+#include <cassert>
+#include <cstring>
+#include <new>
+
+using namespace vaca;
+using namespace vaca::details;
+
+namespace {
+
+  enum {
+    // Maximum length of the leaves created from a new text
+    MaxLeafLength = 2048,
+    // Adjacent leaves are merged (copying the characters) while they
+    // are shorter than this, so typing character by character does
+    // not create a leaf per character
+    MergeLeafLength = 256
+  };
+
+  // An immutable block of characters referenced by leaves
+  struct TextBlock
+  {
+    AtomicRefCount refs;
+
+    Char* chars() { return reinterpret_cast<Char*>(this+1); }
+  };
+
+  TextBlock* create_block(std::size_t length)
+  {
+    void* mem = ::operator new(sizeof(TextBlock) + length*sizeof(Char));
+    TextBlock* block = new(mem) TextBlock();
+    block->refs.ref();
+    return block;
+  }
+
+  void unref_block(TextBlock* block)
+  {
+    if (block->refs.unref() == 0) {
+      block->~TextBlock();
+      ::operator delete(block);
+    }
+  }
+
+}
+
+namespace vaca {
+namespace details {
+
+  /**
+     @internal
+     A node of the TextBuffer tree. Nodes are immutable (except the
+     reference counter) so they can be shared by several trees.
+
+     Leaves have a block and a range of its characters, other nodes
+     have two children.
+  */
+  struct TextNode
+  {
+    AtomicRefCount refs;
+    TextNode* left;
+    TextNode* right;
+    TextBlock* block;
+    const Char* chars;
+    std::size_t length;		// number of characters
+    std::size_t lines;		// number of '\n'
+    int height;			// 0 for leaves
+
+    bool isLeaf() const { return left == NULL; }
+  };
+
+}
+}
+
+namespace {
+
+  // All the functions that receive or return nodes transfer the
+  // ownership of one reference.
+
+  inline int height(const TextNode* node) { return node ? node->height: -1; }
+
+  inline TextNode* ref_node(TextNode* node)
+  {
+    node->refs.ref();
+    return node;
+  }
+
+  void unref_node(TextNode* node)
+  {
+    while (node && node->refs.unref() == 0) {
+      TextNode* right = node->right;
+      if (node->isLeaf())
+	unref_block(node->block);
+      else
+	unref_node(node->left);
+      delete node;
+      node = right;		// iterate instead of recursion
+    }
+  }
+
+  std::size_t count_lines(const Char* chars, std::size_t length)
+  {
+    std::size_t lines = 0;
+    for (std::size_t i=0; i<length; ++i)
+      if (chars[i] == L'\n')
+	++lines;
+    return lines;
+  }
+
+  // "lines" can be given if it is known
+  TextNode* make_leaf(TextBlock* block, const Char* chars, std::size_t length,
+		      std::size_t lines = std::size_t(-1))
+  {
+    TextNode* node = new TextNode;
+    node->refs.ref();
+    node->left = node->right = NULL;
+    node->block = block;
+    node->chars = chars;
+    node->length = length;
+    node->lines = (lines != std::size_t(-1) ? lines: count_lines(chars, length));
+    node->height = 0;
+    block->refs.ref();
+    return node;
+  }
+
+  TextNode* make_node(TextNode* left, TextNode* right)
+  {
+    assert(left && right);
+    assert(left->height - right->height <= 1 && right->height - left->height <= 1);
+
+    TextNode* node = new TextNode;
+    node->refs.ref();
+    node->left = left;
+    node->right = right;
+    node->block = NULL;
+    node->chars = NULL;
+    node->length = left->length + right->length;
+    node->lines = left->lines + right->lines;
+    node->height = 1 + (left->height > right->height ? left->height: right->height);
+    return node;
+  }
+
+  // Returns new references to the children of "node" and releases the
+  // reference to "node"
+  void take_children(TextNode* node, TextNode*& left, TextNode*& right)
+  {
+    left = ref_node(node->left);
+    right = ref_node(node->right);
+    unref_node(node);
+  }
+
+  TextNode* merge_leaves(TextNode* a, TextNode* b)
+  {
+    TextBlock* block = create_block(a->length + b->length);
+    std::memcpy(block->chars(), a->chars, a->length*sizeof(Char));
+    std::memcpy(block->chars() + a->length, b->chars, b->length*sizeof(Char));
+
+    TextNode* node = make_leaf(block, block->chars(), a->length + b->length,
+			       a->lines + b->lines);
+    unref_block(block);
+    unref_node(a);
+    unref_node(b);
+    return node;
+  }
+
+  // Creates a node with "a" and "b" when their heights differ in two
+  // levels (with one or two rotations)
+  TextNode* balance(TextNode* a, TextNode* b)
+  {
+    TextNode *x, *y, *z, *w;
+
+    if (height(a) > height(b)+1) {
+      take_children(a, x, y);
+      if (height(x) >= height(y))
+	return make_node(x, make_node(y, b));
+
+      take_children(y, z, w);
+      return make_node(make_node(x, z), make_node(w, b));
+    }
+    else if (height(b) > height(a)+1) {
+      take_children(b, x, y);
+      if (height(y) >= height(x))
+	return make_node(make_node(a, x), y);
+
+      take_children(x, z, w);
+      return make_node(make_node(a, z), make_node(w, y));
+    }
+    else
+      return make_node(a, b);
+  }
+
+  // Joins two trees (all the text of "a" goes before the text of
+  // "b"). It takes O(|height(a) - height(b)|) time.
+  TextNode* concat(TextNode* a, TextNode* b)
+  {
+    if (!a) return b;
+    if (!b) return a;
+
+    if (a->isLeaf() && b->isLeaf() &&
+	a->length + b->length <= MergeLeafLength)
+      return merge_leaves(a, b);
+
+    TextNode *x, *y;
+    if (a->height > b->height+1) {
+      take_children(a, x, y);
+      return balance(x, concat(y, b));
+    }
+    else if (b->height > a->height+1) {
+      take_children(b, x, y);
+      return balance(concat(a, x), y);
+    }
+    else
+      return make_node(a, b);
+  }
+
+  // Splits the tree in the text before "pos" and the text after it
+  void split(TextNode* node, std::size_t pos, TextNode*& a, TextNode*& b)
+  {
+    if (!node || pos == 0) {
+      a = NULL;
+      b = node;
+    }
+    else if (pos >= node->length) {
+      a = node;
+      b = NULL;
+    }
+    else if (node->isLeaf()) {
+      a = make_leaf(node->block, node->chars, pos);
+      b = make_leaf(node->block, node->chars+pos, node->length-pos, node->lines - a->lines);
+      unref_node(node);
+    }
+    else {
+      TextNode *x, *y, *tmp;
+      take_children(node, x, y);
+      if (pos <= x->length) {
+	split(x, pos, a, tmp);
+	b = concat(tmp, y);
+      }
+      else {
+	split(y, pos - x->length, tmp, b);
+	a = concat(x, tmp);
+      }
+    }
+  }
+
+  // Creates a balanced tree with leaves[first..last)
+  TextNode* build_tree(TextNode** leaves, std::size_t first, std::size_t last)
+  {
+    if (last - first == 1)
+      return leaves[first];
+
+    std::size_t middle = first + (last - first) / 2;
+    TextNode* a = build_tree(leaves, first, middle);
+    TextNode* b = build_tree(leaves, middle, last);
+    return make_node(a, b);
+  }
+
+  // Copies the text in a new block and creates a tree for it
+  TextNode* create_tree(StringView text)
+  {
+    if (text.empty())
+      return NULL;
+
+    TextBlock* block = create_block(text.size());
+    std::memcpy(block->chars(), text.data(), text.size()*sizeof(Char));
+
+    std::vector<TextNode*> leaves;
+    leaves.reserve(text.size() / MaxLeafLength + 1);
+    for (std::size_t pos=0; pos<text.size(); pos += MaxLeafLength) {
+      std::size_t length = text.size() - pos;
+      if (length > MaxLeafLength)
+	length = MaxLeafLength;
+      leaves.push_back(make_leaf(block, block->chars()+pos, length));
+    }
+    unref_block(block);
+
+    return build_tree(&leaves[0], 0, leaves.size());
+  }
+
+  void copy_text(const TextNode* node, std::size_t pos, std::size_t n, String& out)
+  {
+    while (n > 0) {
+      if (node->isLeaf()) {
+	out.append(node->chars + pos, n);
+	return;
+      }
+
+      std::size_t leftLength = node->left->length;
+      if (pos < leftLength) {
+	std::size_t m = leftLength - pos;
+	if (m > n)
+	  m = n;
+	copy_text(node->left, pos, m, out);
+	pos = 0;
+	n -= m;
+      }
+      else
+	pos -= leftLength;
+      node = node->right;
+    }
+  }
+
+}
+
+// ======================================================================
+// TextBuffer::ChunkIterator
+
+TextBuffer::ChunkIterator::ChunkIterator(const TextNode* root)
+  : m_leaf(NULL)
+{
+  if (root)
+    pushLeftmost(root);
+}
+
+TextBuffer::ChunkIterator& TextBuffer::ChunkIterator::operator++()
+{
+  if (m_stack.empty()) {
+    m_leaf = NULL;
+    m_chunk = StringView();
+  }
+  else {
+    const TextNode* node = m_stack.back();
+    m_stack.pop_back();
+    pushLeftmost(node);
+  }
+  return *this;
+}
+
+void TextBuffer::ChunkIterator::pushLeftmost(const TextNode* node)
+{
+  while (!node->isLeaf()) {
+    m_stack.push_back(node->right);
+    node = node->left;
+  }
+  m_leaf = node;
+  m_chunk = StringView(node->chars, node->length);
+}
+
+// ======================================================================
+// TextBuffer
+
+TextBuffer::TextBuffer()
+  : m_root(NULL)
+{
+}
+
+/**
+   Creates a buffer with a copy of @a text.
+*/
+TextBuffer::TextBuffer(StringView text)
+  : m_root(create_tree(text))
+{
+}
+
+/**
+   Creates a snapshot of @a other (in constant time).
+*/
+TextBuffer::TextBuffer(const TextBuffer& other)
+  : m_root(other.m_root ? ref_node(other.m_root): NULL)
+{
+}
+
+TextBuffer::TextBuffer(TextBuffer&& other)
+  : m_root(other.m_root)
+{
+  other.m_root = NULL;
+}
+
+TextBuffer::~TextBuffer()
+{
+  unref_node(m_root);
+}
+
+TextBuffer& TextBuffer::operator=(const TextBuffer& other)
+{
+  TextBuffer(other).swap(*this);
+  return *this;
+}
+
+TextBuffer& TextBuffer::operator=(TextBuffer&& other)
+{
+  TextBuffer(static_cast<TextBuffer&&>(other)).swap(*this);
+  return *this;
+}
+
+void TextBuffer::swap(TextBuffer& other)
+{
+  TextNode* tmp = m_root;
+  m_root = other.m_root;
+  other.m_root = tmp;
+}
+
+/**
+   Returns the number of characters.
+*/
+std::size_t TextBuffer::size() const
+{
+  return m_root ? m_root->length: 0;
+}
+
+/**
+   Returns the character in the position @a pos (in O(log n) time).
+*/
+Char TextBuffer::at(std::size_t pos) const
+{
+  assert(pos < size());
+
+  const TextNode* node = m_root;
+  while (!node->isLeaf()) {
+    if (pos < node->left->length)
+      node = node->left;
+    else {
+      pos -= node->left->length;
+      node = node->right;
+    }
+  }
+  return node->chars[pos];
+}
+
+/**
+   Returns a copy of @a n characters from @a pos (or the rest of the
+   text if @a n is too big).
+*/
+String TextBuffer::substr(std::size_t pos, std::size_t n) const
+{
+  assert(pos <= size());
+
+  if (n > size() - pos)
+    n = size() - pos;
+
+  String res;
+  res.reserve(n);
+  if (n > 0)
+    copy_text(m_root, pos, n, res);
+  return res;
+}
+
+String TextBuffer::str() const
+{
+  return substr(0, size());
+}
+
+/**
+   Inserts @a text before the character in the position @a pos.
+*/
+void TextBuffer::insert(std::size_t pos, StringView text)
+{
+  assert(pos <= size());
+
+  if (text.empty())
+    return;
+
+  TextNode *a, *b;
+  split(m_root, pos, a, b);
+  m_root = concat(concat(a, create_tree(text)), b);
+}
+
+/**
+   Removes @a n characters from @a pos (or the rest of the text if
+   @a n is too big).
+*/
+void TextBuffer::erase(std::size_t pos, std::size_t n)
+{
+  assert(pos <= size());
+
+  if (n == 0 || pos == size())
+    return;
+
+  TextNode *a, *b, *c;
+  split(m_root, pos, a, b);
+  split(b, n, b, c);
+  unref_node(b);
+  m_root = concat(a, c);
+}
+
+void TextBuffer::clear()
+{
+  unref_node(m_root);
+  m_root = NULL;
+}
+
+/**
+   Returns the number of lines (the number of '\\n' plus one).
+*/
+std::size_t TextBuffer::getLineCount() const
+{
+  return (m_root ? m_root->lines: 0) + 1;
+}
+
+/**
+   Returns the position of the first character of the line @a line
+   (starting from 0), or the size of the text if there is not such
+   line.
+*/
+std::size_t TextBuffer::getLineOffset(std::size_t line) const
+{
+  if (line == 0)
+    return 0;
+  if (!m_root || line > m_root->lines)
+    return size();
+
+  // look for the line-th '\n'
+  const TextNode* node = m_root;
+  std::size_t offset = 0;
+  while (!node->isLeaf()) {
+    if (line <= node->left->lines)
+      node = node->left;
+    else {
+      line -= node->left->lines;
+      offset += node->left->length;
+      node = node->right;
+    }
+  }
+
+  for (std::size_t i=0; ; ++i) {
+    if (node->chars[i] == L'\n' && --line == 0)
+      return offset + i + 1;
+  }
+}
+
+/**
+   Returns the line (starting from 0) of the character in the position
+   @a pos.
+*/
+std::size_t TextBuffer::getLineAt(std::size_t pos) const
+{
+  if (pos >= size())
+    return getLineCount()-1;
+
+  const TextNode* node = m_root;
+  std::size_t line = 0;
+  while (!node->isLeaf()) {
+    if (pos < node->left->length)
+      node = node->left;
+    else {
+      pos -= node->left->length;
+      line += node->left->lines;
+      node = node->right;
+    }
+  }
+  return line + count_lines(node->chars, pos);
+}
@@ -0,0 +1,122 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#ifndef VACA_TEXTBUFFER_H
+#define VACA_TEXTBUFFER_H
+
+#include "vaca/base.h"
+#include "vaca/StringView.h"
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace vaca {
+
+namespace details { struct TextNode; }
+
+/**
+   A text that can be edited in any position in logarithmic time.
+
+   The text is stored as a balanced tree (a rope) whose leaves
+   reference parts of immutable blocks of characters. Inserting or
+   erasing text creates O(log n) new nodes, and the rest of the tree
+   is shared, so:
+   @li editing the middle of a big document does not move the rest of
+       the characters (as String::insert does),
+   @li copying a TextBuffer takes constant time (the copy is a snapshot
+       of the text that is not modified by the edits of the original),
+       so an undo history can keep a copy of each version.
+
+   Each node counts its characters and its new lines ('\\n'), so
+   positions can be translated to lines (and vice versa) in O(log n).
+
+   @code
+   TextBuffer text(L"Hello world");
+   TextBuffer snapshot = text;     // constant time
+   text.insert(5, L",");           // "Hello, world"
+   text.erase(0, 7);               // "world"
+   for (TextBuffer::ChunkIterator it = snapshot.begin(); it != snapshot.end(); ++it)
+     out.write(it->data(), it->size());   // "Hello world"
+   @endcode
+
+   A TextBuffer can be copied and read from different threads, but an
+   object must not be modified while other thread uses it.
+*/
+class VACA_DLL TextBuffer
+{
+  details::TextNode* m_root;	// NULL if the text is empty
+
+public:
+
+  /**
+     Iterates the text in contiguous parts (chunks), from the beginning
+     to the end, without copying the characters.
+
+     The iterator is valid while the TextBuffer (or a copy of it) is not
+     modified or destroyed.
+  */
+  class VACA_DLL ChunkIterator : public std::iterator<std::forward_iterator_tag, StringView>
+  {
+    std::vector<const details::TextNode*> m_stack; // right subtrees to visit
+    const details::TextNode* m_leaf;
+    StringView m_chunk;
+
+  public:
+    ChunkIterator() : m_leaf(NULL) { }
+    explicit ChunkIterator(const details::TextNode* root);
+
+    const StringView& operator*() const { return m_chunk; }
+    const StringView* operator->() const { return &m_chunk; }
+
+    ChunkIterator& operator++();
+    ChunkIterator operator++(int) {
+      ChunkIterator old(*this);
+      ++(*this);
+      return old;
+    }
+
+    bool operator==(const ChunkIterator& other) const { return m_leaf == other.m_leaf; }
+    bool operator!=(const ChunkIterator& other) const { return m_leaf != other.m_leaf; }
+
+  private:
+    void pushLeftmost(const details::TextNode* node);
+  };
+
+  TextBuffer();
+  explicit TextBuffer(StringView text);
+  TextBuffer(const TextBuffer& other);
+  TextBuffer(TextBuffer&& other);
+  ~TextBuffer();
+
+  TextBuffer& operator=(const TextBuffer& other);
+  TextBuffer& operator=(TextBuffer&& other);
+  void swap(TextBuffer& other);
+
+  std::size_t size() const;
+  bool empty() const { return m_root == NULL; }
+
+  Char at(std::size_t pos) const;
+  String substr(std::size_t pos, std::size_t n) const;
+  String str() const;
+
+  void insert(std::size_t pos, StringView text);
+  void insert(std::size_t pos, Char chr) { insert(pos, StringView(&chr, 1)); }
+  void erase(std::size_t pos, std::size_t n);
+  void clear();
+
+  std::size_t getLineCount() const;
+  std::size_t getLineOffset(std::size_t line) const;
+  std::size_t getLineAt(std::size_t pos) const;
+
+  ChunkIterator begin() const { return ChunkIterator(m_root); }
+  ChunkIterator end() const { return ChunkIterator(); }
+
+};
+
+} // namespace vaca
+
+#endif // VACA_TEXTBUFFER_H
@@ -0,0 +1,412 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#include "vaca/TextSearch.h"
+#include "vaca/PrefixIndex.h"
+
+#include <cstring>
+#include <cwchar>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define VACA_TEXTSEARCH_SSE2
+#endif
+
+#if defined(_MSC_VER)
+  #include <intrin.h>
+#endif
+
+using namespace vaca;
+
+namespace {
+
+  typedef unsigned char Byte;
+
+  // Needles with this length or more are found with Horspool's
+  // algorithm (shorter ones skip too few characters in each step).
+  // When the case is ignored, each candidate of the filter has to be
+  // folded to be compared, so Horspool is better with shorter needles.
+  const std::size_t LongNeedle = 32;
+  const std::size_t LongFoldedNeedle = 16;
+
+  // The first character of the needle is looked for with memchr()
+  // while there is less than one candidate in this number of bytes of
+  // text, after that the block filter is faster.
+  const std::size_t RareCharDistance = 64;
+
+  // Finds a character with the C library, which uses the best
+  // instructions of the CPU
+  inline const char* find_char(const char* text, std::size_t size, char chr)
+  {
+    return static_cast<const char*>(std::memchr(text, chr, size));
+  }
+
+  inline const Char* find_char(const Char* text, std::size_t size, Char chr)
+  {
+    return std::wmemchr(text, chr, size);
+  }
+
+  // The case folding is the same as in PrefixIndex for String, and
+  // only ASCII for UTF-8 (the bytes of multibyte sequences are >= 0x80
+  // so they are not modified)
+
+  inline char fold_case(char chr)
+  {
+    return (chr >= 'A' && chr <= 'Z') ? chr + ('a' - 'A'): chr;
+  }
+
+  inline Char fold_case(Char chr)
+  {
+    return PrefixIndex::foldCase(chr);
+  }
+
+  // Returns the upper case of a folded character
+  inline char upper_case(char chr)
+  {
+    return (chr >= 'a' && chr <= 'z') ? chr - ('a' - 'A'): chr;
+  }
+
+  inline Char upper_case(Char chr)
+  {
+    if ((chr >= L'a' && chr <= L'z') ||
+	(chr >= 0xE0 && chr <= 0xFE && chr != 0xF7))
+      return chr - 32;
+    else
+      return chr;
+  }
+
+  // Characters of words for the "whole word" option (like the default
+  // word characters of Scintilla; non-ASCII characters are letters)
+  template<class T>
+  inline bool is_word_char(T chr)
+  {
+    return ((chr >= '0' && chr <= '9') ||
+	    (chr >= 'a' && chr <= 'z') ||
+	    (chr >= 'A' && chr <= 'Z') ||
+	    chr == '_' ||
+	    static_cast<unsigned>(chr) >= 0x80);
+  }
+
+  // Index of the lowest/highest bit of a mask (it must not be zero)
+  inline unsigned lowest_bit(unsigned mask)
+  {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+  }
+
+  inline unsigned highest_bit(unsigned mask)
+  {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return index;
+#else
+    return 31 - __builtin_clz(mask);
+#endif
+  }
+
+#if defined(VACA_TEXTSEARCH_SSE2)
+
+  // Comparisons of 16 bytes for characters of each size. The mask of
+  // equal positions has one bit for each character (the lowest bit of
+  // its bytes).
+  template<std::size_t Size> struct Lanes;
+
+  template<> struct Lanes<1> {
+    enum { Mask = 0xFFFF };
+    static __m128i splat(int chr) { return _mm_set1_epi8(static_cast<char>(chr)); }
+    static __m128i equal(__m128i a, __m128i b) { return _mm_cmpeq_epi8(a, b); }
+  };
+
+  template<> struct Lanes<2> {
+    enum { Mask = 0x5555 };
+    static __m128i splat(int chr) { return _mm_set1_epi16(static_cast<short>(chr)); }
+    static __m128i equal(__m128i a, __m128i b) { return _mm_cmpeq_epi16(a, b); }
+  };
+
+  template<> struct Lanes<4> {
+    enum { Mask = 0x1111 };
+    static __m128i splat(int chr) { return _mm_set1_epi32(chr); }
+    static __m128i equal(__m128i a, __m128i b) { return _mm_cmpeq_epi32(a, b); }
+  };
+
+  // Finds the positions in a block of 16 bytes where the first and last
+  // characters of the needle are
+  template<class T>
+  class BlockFilter
+  {
+    typedef Lanes<sizeof(T)> L;
+    __m128i m_first0, m_first1, m_last0, m_last1;
+    std::size_t m_lastOffset;
+
+  public:
+    enum { Positions = 16 / sizeof(T) };
+
+    BlockFilter(const T* first, const T* last, std::size_t lastOffset)
+      : m_first0(L::splat(first[0]))
+      , m_first1(L::splat(first[1]))
+      , m_last0(L::splat(last[0]))
+      , m_last1(L::splat(last[1]))
+      , m_lastOffset(lastOffset) { }
+
+    // Returns a mask with one bit for each candidate in the block (the
+    // bit "sizeof(T)*i" for the position i)
+    unsigned operator()(const T* block) const {
+      __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+      __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + m_lastOffset));
+      __m128i eq = _mm_and_si128(_mm_or_si128(L::equal(a, m_first0), L::equal(a, m_first1)),
+				 _mm_or_si128(L::equal(b, m_last0), L::equal(b, m_last1)));
+      return _mm_movemask_epi8(eq) & L::Mask;
+    }
+  };
+
+#endif
+
+}
+
+/**
+   Prepares the search of @a needle.
+
+   @param needle The string to find. The searcher makes a copy of it.
+   @param matchCase False to ignore the case of letters.
+   @param wholeWord True to skip matches that start or end in the
+		    middle of a word.
+*/
+template<class T>
+BasicTextSearch<T>::BasicTextSearch(View needle, bool matchCase, bool wholeWord)
+  : m_needle(needle.str())
+  , m_matchCase(matchCase)
+  , m_wholeWord(wholeWord)
+{
+  if (!m_matchCase)
+    for (std::size_t i=0; i<m_needle.size(); ++i)
+      m_needle[i] = fold_case(m_needle[i]);
+
+  if (!m_needle.empty()) {
+    m_first[0] = m_first[1] = m_needle[0];
+    m_last[0] = m_last[1] = m_needle[m_needle.size()-1];
+    if (!m_matchCase) {
+      m_first[1] = upper_case(m_first[0]);
+      m_last[1] = upper_case(m_last[0]);
+    }
+  }
+  else
+    m_first[0] = m_first[1] = m_last[0] = m_last[1] = T();
+
+  // Horspool's table: how much the needle can be moved when a
+  // character is below its last position. The characters are grouped
+  // by their lowest byte (it only makes the steps shorter). When the
+  // case is ignored both cases have an entry, so the text is not
+  // folded to look up the table.
+  if (m_needle.size() >= (m_matchCase ? LongNeedle: LongFoldedNeedle)) {
+    std::size_t n = m_needle.size();
+    m_shift.assign(256, n);
+    for (std::size_t i=0; i<n-1; ++i) {
+      m_shift[static_cast<Byte>(m_needle[i])] = n-1-i;
+      if (!m_matchCase)
+	m_shift[static_cast<Byte>(upper_case(m_needle[i]))] = n-1-i;
+    }
+  }
+}
+
+/**
+   Returns the position of the first match that starts in @a from or
+   after it, or @c npos if there is not such match.
+*/
+template<class T>
+std::size_t BasicTextSearch<T>::findNext(View text, std::size_t from) const
+{
+  if (m_needle.empty() || from >= text.size())
+    return npos;
+
+  if (!m_shift.empty())
+    return findHorspool(text.data(), text.size(), from);
+  else
+    return findFiltering(text.data(), text.size(), from);
+}
+
+/**
+   Returns the position of the last match that starts before @a before
+   (e.g. the start of the selection), or @c npos if there is not such
+   match.
+*/
+template<class T>
+std::size_t BasicTextSearch<T>::findPrev(View text, std::size_t before) const
+{
+  const std::size_t n = m_needle.size();
+  if (n == 0 || n > text.size())
+    return npos;
+
+  const T* data = text.data();
+  std::size_t i = text.size() - n + 1;	// candidates are in [0, i)
+  if (i > before)
+    i = before;
+
+#if defined(VACA_TEXTSEARCH_SSE2)
+  BlockFilter<T> filter(m_first, m_last, n-1);
+  while (i >= BlockFilter<T>::Positions) {
+    i -= BlockFilter<T>::Positions;
+    for (unsigned mask = filter(data+i); mask != 0; ) {
+      unsigned bit = highest_bit(mask);
+      std::size_t pos = i + bit/sizeof(T);
+      if (matchesAt(data, text.size(), pos))
+	return pos;
+      mask &= ~(1u << bit);
+    }
+  }
+#endif
+
+  while (i > 0) {
+    --i;
+    if (isCandidate(data[i], data[i+n-1]) && matchesAt(data, text.size(), i))
+      return i;
+  }
+  return npos;
+}
+
+/**
+   Adds to @a positions the position of each match in @a text, from the
+   beginning to the end. The matches do not overlap (after a match, the
+   search continues at the end of it).
+*/
+template<class T>
+void BasicTextSearch<T>::findAll(View text, std::vector<std::size_t>& positions) const
+{
+  const std::size_t n = m_needle.size();
+  for (std::size_t pos = findNext(text, 0);
+       pos != npos;
+       pos = findNext(text, pos+n))
+    positions.push_back(pos);
+}
+
+template<class T>
+std::size_t BasicTextSearch<T>::findFiltering(const T* text, std::size_t size, std::size_t from) const
+{
+  const std::size_t n = m_needle.size();
+  if (n > size)
+    return npos;
+
+  const std::size_t end = size - n + 1; // candidates are in [from, end)
+  std::size_t i = from;
+
+  // A first character with only one case (e.g. the case is matched)
+  // can be found with memchr() while it is rare in the text
+  if (m_first[0] == m_first[1]) {
+    std::size_t candidates = 0;
+    while (i < end) {
+      const T* found = find_char(text+i, end-i, m_first[0]);
+      if (!found)
+	return npos;
+
+      i = found - text;
+      if ((text[i+n-1] == m_last[0] || text[i+n-1] == m_last[1]) &&
+	  matchesAt(text, size, i))
+	return i;
+      ++i;
+
+      if (++candidates > 16 &&
+	  candidates * RareCharDistance > (i - from) * sizeof(T))
+	break;
+    }
+  }
+
+#if defined(VACA_TEXTSEARCH_SSE2)
+  const std::size_t P = BlockFilter<T>::Positions;
+  BlockFilter<T> filter(m_first, m_last, n-1);
+
+  // two blocks in each step, most of them do not have candidates
+  for (; i+2*P <= end; i += 2*P) {
+    unsigned mask0 = filter(text+i);
+    unsigned mask1 = filter(text+i+P);
+    if ((mask0 | mask1) == 0)
+      continue;
+
+    for (; mask0 != 0; mask0 &= mask0-1) {
+      std::size_t pos = i + lowest_bit(mask0)/sizeof(T);
+      if (matchesAt(text, size, pos))
+	return pos;
+    }
+    for (; mask1 != 0; mask1 &= mask1-1) {
+      std::size_t pos = i + P + lowest_bit(mask1)/sizeof(T);
+      if (matchesAt(text, size, pos))
+	return pos;
+    }
+  }
+
+  for (; i+P <= end; i += P) {
+    for (unsigned mask = filter(text+i); mask != 0; mask &= mask-1) {
+      std::size_t pos = i + lowest_bit(mask)/sizeof(T);
+      if (matchesAt(text, size, pos))
+	return pos;
+    }
+  }
+#endif
+
+  for (; i<end; ++i)
+    if (isCandidate(text[i], text[i+n-1]) && matchesAt(text, size, i))
+      return i;
+  return npos;
+}
+
+template<class T>
+std::size_t BasicTextSearch<T>::findHorspool(const T* text, std::size_t size, std::size_t from) const
+{
+  const std::size_t n = m_needle.size();
+
+  for (std::size_t pos = from; pos+n <= size; ) {
+    const T chr = text[pos+n-1];
+    if ((chr == m_last[0] || chr == m_last[1]) && matchesAt(text, size, pos))
+      return pos;
+
+    pos += m_shift[static_cast<Byte>(chr)];
+  }
+  return npos;
+}
+
+template<class T>
+bool BasicTextSearch<T>::isCandidate(T first, T last) const
+{
+  return ((first == m_first[0] || first == m_first[1]) &&
+	  (last == m_last[0] || last == m_last[1]));
+}
+
+// Compares the whole needle with the text in "pos"
+template<class T>
+bool BasicTextSearch<T>::matchesAt(const T* text, std::size_t size, std::size_t pos) const
+{
+  const std::size_t n = m_needle.size();
+  const T* str = text + pos;
+
+  if (m_matchCase) {
+    if (std::char_traits<T>::compare(str, m_needle.data(), n) != 0)
+      return false;
+  }
+  else {
+    for (std::size_t i=0; i<n; ++i)
+      if (fold_case(str[i]) != m_needle[i])
+	return false;
+  }
+
+  if (m_wholeWord) {
+    if (pos > 0 && is_word_char(text[pos-1]) && is_word_char(str[0]))
+      return false;
+    if (pos+n < size && is_word_char(str[n]) && is_word_char(str[n-1]))
+      return false;
+  }
+  return true;
+}
+
+namespace vaca {
+
+template class VACA_DLL BasicTextSearch<char>;
+template class VACA_DLL BasicTextSearch<Char>;
+
+} // namespace vaca
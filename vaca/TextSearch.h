@@ -0,0 +1,100 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#ifndef VACA_TEXTSEARCH_H
+#define VACA_TEXTSEARCH_H
+
+#include "vaca/base.h"
+#include "vaca/StringView.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace vaca {
+
+/**
+   Finds a string (the needle) inside texts.
+
+   The needle is prepared only once in the constructor, so you can keep
+   a BasicTextSearch to find the same string again and again (e.g. each
+   time the user presses "Find Next"):
+   @li short needles are found comparing their first and last
+       characters with a block of positions of the text at once (with
+       SSE2 when it is available), and only the candidates are
+       compared completely;
+   @li long needles are found with the Boyer-Moore-Horspool algorithm,
+       which skips up to the length of the needle in each step.
+
+   When the case is ignored, ASCII letters are compared in lower case
+   (and Latin-1 letters too for String). UTF-8 sequences of other
+   characters are compared byte by byte.
+
+   There are two versions: Utf8TextSearch for UTF-8 texts (like the
+   text of a SciEdit) and TextSearch for String texts. The positions
+   are in characters of the text (bytes for UTF-8).
+
+   @code
+   TextSearch search(L"vaca", false);	// ignore case
+   std::size_t pos = search.findNext(text);
+   while (pos != TextSearch::npos) {
+     ...
+     pos = search.findNext(text, pos+1);
+   }
+   @endcode
+*/
+template<class T>
+class BasicTextSearch
+{
+  std::basic_string<T> m_needle;	// with the case folded if it is ignored
+  T m_first[2];			// first character of the needle in both cases
+  T m_last[2];			// last character of the needle in both cases
+  bool m_matchCase;
+  bool m_wholeWord;
+  std::vector<std::size_t> m_shift;	// Horspool's table (only for long needles)
+
+public:
+
+  typedef BasicStringView<T> View;
+
+  static const std::size_t npos = static_cast<std::size_t>(-1);
+
+  explicit BasicTextSearch(View needle, bool matchCase = true, bool wholeWord = false);
+
+  std::size_t findNext(View text, std::size_t from = 0) const;
+  std::size_t findPrev(View text, std::size_t before) const;
+  void findAll(View text, std::vector<std::size_t>& positions) const;
+
+  std::size_t size() const { return m_needle.size(); }
+  bool isMatchCase() const { return m_matchCase; }
+  bool isWholeWord() const { return m_wholeWord; }
+
+private:
+  std::size_t findFiltering(const T* text, std::size_t size, std::size_t from) const;
+  std::size_t findHorspool(const T* text, std::size_t size, std::size_t from) const;
+  bool isCandidate(T first, T last) const;
+  bool matchesAt(const T* text, std::size_t size, std::size_t pos) const;
+};
+
+template<class T>
+const std::size_t BasicTextSearch<T>::npos;
+
+/**
+   Searches in UTF-8 texts (e.g. the text of a SciEdit).
+*/
+typedef BasicTextSearch<char> Utf8TextSearch;
+
+/**
+   Searches in String texts.
+*/
+typedef BasicTextSearch<Char> TextSearch;
+
+extern template class VACA_DLL BasicTextSearch<char>;
+extern template class VACA_DLL BasicTextSearch<Char>;
+
+} // namespace vaca
+
+#endif // VACA_TEXTSEARCH_H
@@ -10,6 +10,7 @@
 #include "vaca/Signal.h"
 #include "vaca/Timer.h"
 #include "vaca/Mutex.h"
+#include "vaca/QueuedSignal.h"
 #include "vaca/ScopedLock.h"
 #include "vaca/Slot.h"
 #include "vaca/TimePoint.h"
@@ -53,11 +54,22 @@ struct ThreadData
   */
   Widget* outsideWidget;
 
+  /**
+     Calls from other threads to slots connected in this thread (see
+     QueuedSignal). It is created the first time it is needed.
+  */
+  vaca::details::QueuedCallQueue* queuedCalls;
+
   ThreadData(ThreadId id) {
     threadId = id;
     breakLoop = false;
     updateIndicators = true;
     outsideWidget = NULL;
+    queuedCalls = NULL;
+  }
+
+  ~ThreadData() {
+    delete queuedCalls;
   }
 
 };
@@ -100,7 +112,7 @@ static DWORD WINAPI ThreadProxy(LPVOID slot)
     PeekMessage(&msg, NULL, WM_USER, WM_USER, PM_NOREMOVE);
   }
 
-  std::auto_ptr<Slot0<void> > slot_ptr(reinterpret_cast<Slot0<void>*>(slot));
+  std::auto_ptr<Slot<void()> > slot_ptr(reinterpret_cast<Slot<void()>*>(slot));
   (*slot_ptr)();
   return 0;
 }
@@ -121,9 +133,9 @@ Thread::Thread()
 
    @internal
 */
-void Thread::_Thread(const Slot0<void>& slot)
+void Thread::_Thread(const Slot<void()>& slot)
 {
-  Slot0<void>* slotclone = slot.clone();
+  Slot<void()>* slotclone = new Slot<void()>(slot);
   DWORD id;
 
   m_handle = CreateThread(NULL, 0,
@@ -300,6 +312,8 @@ void vaca::CurrentThread::doMessageLoopFor(Widget* widget)
 
 void vaca::CurrentThread::pumpMessageQueue()
 {
+  CurrentThread::details::dispatchQueuedCalls();
+
   Message msg;
   while (peekMessage(msg))
     processMessage(msg);
@@ -362,9 +376,11 @@ bool vaca::CurrentThread::getMessage(Message& message)
   if (bRet == 0)
     return false;
 
-  // WM_NULL message... maybe Timers or CallInNextRound
-  if (msg->message == WM_NULL)
+  // WM_NULL message... maybe Timers, CallInNextRound, or QueuedSignals
+  if (msg->message == WM_NULL) {
     Timer::pollTimers();
+    CurrentThread::details::dispatchQueuedCalls();
+  }
 
   return true;
 }
@@ -479,6 +495,33 @@ void CurrentThread::details::removeFrame(Frame* frame)
     CurrentThread::breakMessageLoop();
 }
 
+/**
+   Returns the queue of calls to slots connected in this thread.
+
+   @see QueuedSignal
+   @internal
+*/
+vaca::details::QueuedCallQueue* CurrentThread::details::getQueuedCalls()
+{
+  ThreadData* data = get_thread_data();
+  if (!data->queuedCalls)
+    data->queuedCalls = new vaca::details::QueuedCallQueue(data->threadId);
+  return data->queuedCalls;
+}
+
+/**
+   Makes the pending calls to slots connected in this thread.
+
+   @see QueuedSignal
+   @internal
+*/
+void CurrentThread::details::dispatchQueuedCalls()
+{
+  ThreadData* data = get_thread_data();
+  if (data->queuedCalls)
+    data->queuedCalls->dispatch();
+}
+
 void details::removeAllThreadData()
 {
   ScopedLock hold(data_mutex);
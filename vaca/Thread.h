@@ -98,7 +98,7 @@ public:
   */
   template<typename F>
   explicit Thread(F f) {
-    _Thread(Slot0_fun<void, F>(f));
+    _Thread(Slot<void()>(f));
   }
 
   ThreadId getId() const;
@@ -115,7 +115,7 @@ public:
   void enqueueMessage(const Message& message);
 
 private:
-  void _Thread(const Slot0<void>& slot);
+  void _Thread(const Slot<void()>& slot);
 
 };
 
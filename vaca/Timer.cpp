@@ -34,6 +34,8 @@ Timer::Timer(int interval)
   , m_tickCounter(0)
 {
   assert(interval > 0);
+
+  Tick.setName("Timer::Tick");
 }
 
 Timer::~Timer()
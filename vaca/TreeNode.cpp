@@ -161,7 +161,7 @@ bool TreeNode::hasChildren()
 */
 String TreeNode::getText()
 {
-  return m_text;
+  return m_text.str();
 }
 
 /**
@@ -205,7 +205,12 @@ int TreeNode::getSelectedImage()
 */
 void TreeNode::setText(const String& text)
 {
-  m_text = text;
+  m_text = InternedString(text);
+}
+
+void TreeNode::setText(const CompactString& text)
+{
+  m_text = InternedString(text);
 }
 
 /**
@@ -329,7 +334,7 @@ void TreeNode::onAfterLabelEdit(TreeViewEvent& ev)
 {
   // if the event isn't cancelled, change the label
   if (!ev.isCanceled())
-    m_text = ev.getLabel();
+    m_text = InternedString(ev.getLabel());
 }
 
 /**
@@ -9,6 +9,7 @@
 
 #include "vaca/base.h"
 #include "vaca/Component.h"
+#include "vaca/InternedString.h"
 #include "vaca/NonCopyable.h"
 
 #include <vector>
@@ -27,7 +28,7 @@ class VACA_DLL TreeNode : public Component
   friend class TreeView;
   friend class TreeViewIterator;
 
-  String       m_text;
+  InternedString m_text;
   int          m_image;
   int          m_selectedImage;
   TreeNode*    m_parent;
@@ -56,6 +57,7 @@ public:
   virtual int getSelectedImage();
 
   void setText(const String& text);
+  void setText(const CompactString& text);
   void setImage(int imageIndex);
   void setSelectedImage(int selectedImageIndex);
 
@@ -0,0 +1,340 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#include "vaca/UrlEncoding.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define VACA_URL_SSE2
+#endif
+
+#if defined(_MSC_VER)
+  #include <intrin.h>
+#endif
+
+using namespace vaca;
+
+namespace {
+
+  typedef unsigned char Byte;
+
+  // Bytes that are not encoded in each mode (the bits of char_class)
+  enum {
+    ComponentChar = 1,		// unreserved characters
+    UrlChar = 2			// unreserved and reserved characters, and '%'
+  };
+
+  // Bytes processed one by one after a SIMD block with bytes to encode
+  // or decode (before trying with SIMD again)
+  enum { Block = 16 };
+
+  const char hex_digits[] = "0123456789ABCDEF";
+
+  // Classes of each byte (see ComponentChar and UrlChar)
+  const Byte char_class[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 2, 0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 2,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 2, 2, 0, 2, 0, 2,
+    2, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 2, 0, 2, 0, 3,
+    0, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 0, 0, 0, 3, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  };
+
+  // Value of each hexadecimal digit (16 for other characters)
+  const Byte hex_value[256] = {
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 16, 16, 16, 16, 16, 16,
+    16, 10, 11, 12, 13, 14, 15, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 10, 11, 12, 13, 14, 15, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+  };
+
+  inline unsigned lowest_bit(unsigned mask)
+  {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+  }
+
+#if defined(VACA_URL_SSE2)
+
+  // Bytes of "v" in the range [lo, hi] (only for ASCII ranges, bytes
+  // >= 0x80 are negative so they are never in the range)
+  inline __m128i in_range(__m128i v, char lo, char hi)
+  {
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo-1)),
+			 _mm_cmplt_epi8(v, _mm_set1_epi8(hi+1)));
+  }
+
+  inline __m128i equal(__m128i v, char chr)
+  {
+    return _mm_cmpeq_epi8(v, _mm_set1_epi8(chr));
+  }
+
+  // Returns a mask with the bytes that are not encoded in a block
+  inline unsigned component_mask(__m128i v)
+  {
+    __m128i ok = _mm_or_si128(_mm_or_si128(in_range(v, '0', '9'),
+					   in_range(v, 'A', 'Z')),
+			      _mm_or_si128(in_range(v, 'a', 'z'),
+					   _mm_or_si128(_mm_or_si128(equal(v, '-'), equal(v, '.')),
+							_mm_or_si128(equal(v, '_'), equal(v, '~')))));
+    return _mm_movemask_epi8(ok);
+  }
+
+  inline unsigned url_mask(__m128i v)
+  {
+    __m128i bad = _mm_or_si128(_mm_or_si128(_mm_or_si128(equal(v, '"'), equal(v, '<')),
+					    _mm_or_si128(equal(v, '>'), equal(v, '\\'))),
+			       _mm_or_si128(_mm_or_si128(equal(v, '^'), equal(v, '`')),
+					    _mm_or_si128(_mm_or_si128(equal(v, '{'), equal(v, '|')),
+							 equal(v, '}'))));
+    return _mm_movemask_epi8(_mm_andnot_si128(bad, in_range(v, '!', '~')));
+  }
+
+#endif
+
+  // Returns the number of bytes at the beginning of "src" that are not
+  // encoded (only in complete SIMD blocks, zero without SIMD support)
+  std::size_t copy_run(const Byte* src, std::size_t len, char* dst, bool component)
+  {
+    std::size_t i = 0;
+#if defined(VACA_URL_SSE2)
+    for (; i+16 <= len; i += 16) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i));
+      unsigned mask = component ? component_mask(v): url_mask(v);
+      if (mask != 0xFFFF) {
+	std::size_t n = lowest_bit(~mask);
+	std::memcpy(dst+i, src+i, n);
+	return i+n;
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i), v);
+    }
+#endif
+    return i;
+  }
+
+  // Returns the number of bytes at the beginning of "src" without
+  // escapes (only in complete SIMD blocks, zero without SIMD support)
+  std::size_t copy_unescaped(const Byte* src, std::size_t len, char* dst, bool plusAsSpace)
+  {
+    std::size_t i = 0;
+#if defined(VACA_URL_SSE2)
+    const __m128i percent = _mm_set1_epi8('%');
+    const __m128i plus = _mm_set1_epi8(plusAsSpace ? '+': '%');
+    for (; i+16 <= len; i += 16) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i));
+      unsigned mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, percent),
+						     _mm_cmpeq_epi8(v, plus)));
+      if (mask != 0) {
+	std::size_t n = lowest_bit(mask);
+	std::memcpy(dst+i, src+i, n);
+	return i+n;
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i), v);
+    }
+#endif
+    return i;
+  }
+
+  // Decodes "src" until the end, or until an incomplete escape at the
+  // end if "final" is false. Returns the number of written bytes, and
+  // the number of read bytes in "used".
+  std::size_t decode_bytes(const Byte* src, std::size_t len, char* dst,
+			   bool plusAsSpace, bool final, std::size_t& used)
+  {
+    std::size_t i = 0;
+    char* d = dst;
+
+    while (i < len) {
+      std::size_t n = copy_unescaped(src+i, len-i, d, plusAsSpace);
+      i += n;
+      d += n;
+
+      std::size_t stop = (len-i > Block ? i+Block: len);
+      while (i < stop) {
+	Byte chr = src[i];
+	if (chr == '%') {
+	  if (len-i >= 3) {
+	    Byte hi = hex_value[src[i+1]];
+	    Byte lo = hex_value[src[i+2]];
+	    if (hi < 16 && lo < 16) {
+	      *d++ = static_cast<char>((hi << 4) | lo);
+	      i += 3;
+	      continue;
+	    }
+	  }
+	  else if (!final) {
+	    used = i;
+	    return d - dst;
+	  }
+	  // an invalid escape is copied as it is
+	  *d++ = '%';
+	}
+	else if (chr == '+' && plusAsSpace)
+	  *d++ = ' ';
+	else
+	  *d++ = static_cast<char>(chr);
+	++i;
+      }
+    }
+
+    used = i;
+    return d - dst;
+  }
+
+}
+
+/**
+   Encodes the bytes of @a src as "%XX" escapes (see UrlEncoding for
+   the bytes that are encoded). The destination buffer must have space
+   for 3*len bytes.
+
+   @return The number of bytes written in @a dst.
+*/
+std::size_t vaca::url_encode(const char* src, std::size_t len, char* dst, UrlEncoding encoding)
+{
+  const Byte* s = reinterpret_cast<const Byte*>(src);
+  const bool component = (encoding == UrlEncoding::Component);
+  const Byte safe = component ? ComponentChar: UrlChar;
+  std::size_t i = 0;
+  char* d = dst;
+
+  while (i < len) {
+    std::size_t n = copy_run(s+i, len-i, d, component);
+    i += n;
+    d += n;
+
+    std::size_t stop = (len-i > Block ? i+Block: len);
+    for (; i < stop; ++i) {
+      Byte chr = s[i];
+      if (char_class[chr] & safe)
+	*d++ = static_cast<char>(chr);
+      else {
+	d[0] = '%';
+	d[1] = hex_digits[chr >> 4];
+	d[2] = hex_digits[chr & 15];
+	d += 3;
+      }
+    }
+  }
+  return d - dst;
+}
+
+/**
+   Decodes the "%XX" escapes of @a src. Invalid escapes (like "%G0" or
+   a '%' at the end) are copied as they are. The destination buffer
+   must have space for @a len bytes.
+
+   @param plusAsSpace True to decode '+' as a space (as in the values
+		      of HTML forms).
+
+   @return The number of bytes written in @a dst.
+*/
+std::size_t vaca::url_decode(const char* src, std::size_t len, char* dst, bool plusAsSpace)
+{
+  std::size_t used;
+  return decode_bytes(reinterpret_cast<const Byte*>(src), len, dst, plusAsSpace, true, used);
+}
+
+// ======================================================================
+// UrlDecoder
+
+UrlDecoder::UrlDecoder(bool plusAsSpace)
+  : m_pendingSize(0)
+  , m_plusAsSpace(plusAsSpace)
+{
+}
+
+/**
+   Decodes a part of the URL. An incomplete escape at the end of @a src
+   is kept to be decoded with the next part.
+
+   @param dst It must have space for len+2 bytes.
+
+   @return The number of bytes written in @a dst.
+*/
+std::size_t UrlDecoder::decode(const char* src, std::size_t len, char* dst)
+{
+  std::size_t written = 0;
+  std::size_t used;
+
+  // complete the escape of the previous part (two more bytes are
+  // enough to know what it is)
+  if (m_pendingSize > 0) {
+    Byte buf[4];
+    std::size_t n = 0;
+    for (; n < m_pendingSize; ++n)
+      buf[n] = m_pending[n];
+    std::size_t fromSrc = (len < 2 ? len: 2);
+    for (std::size_t i=0; i<fromSrc; ++i)
+      buf[n++] = src[i];
+
+    written = decode_bytes(buf, n, dst, m_plusAsSpace, false, used);
+    if (used < m_pendingSize) {
+      // still incomplete (it has less than 3 bytes)
+      for (m_pendingSize=0; used < n; ++used)
+	m_pending[m_pendingSize++] = buf[used];
+      return written;
+    }
+
+    used -= m_pendingSize;
+    m_pendingSize = 0;
+    src += used;
+    len -= used;
+  }
+
+  written += decode_bytes(reinterpret_cast<const Byte*>(src), len, dst+written, m_plusAsSpace, false, used);
+
+  for (; used < len; ++used)
+    m_pending[m_pendingSize++] = src[used];
+
+  return written;
+}
+
+/**
+   Finishes the decoding: an incomplete escape at the end of the last
+   part is decoded like url_decode does (the '%' is copied as it is).
+
+   @param dst It must have space for 2 bytes.
+
+   @return The number of bytes written in @a dst.
+*/
+std::size_t UrlDecoder::finish(char* dst)
+{
+  std::size_t used;
+  std::size_t n = decode_bytes(reinterpret_cast<const Byte*>(m_pending), m_pendingSize,
+			       dst, m_plusAsSpace, true, used);
+  m_pendingSize = 0;
+  return n;
+}
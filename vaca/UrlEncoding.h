@@ -0,0 +1,132 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#ifndef VACA_URLENCODING_H
+#define VACA_URLENCODING_H
+
+#include "vaca/base.h"
+#include "vaca/Enum.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace vaca {
+
+/**
+   @defgroup url_encoding URL Encoding
+   @{
+
+   Percent-encoding of URLs (RFC 3986): each byte that cannot be in the
+   URL is written as "%XX" (two hexadecimal digits). The functions work
+   with bytes, so non-ASCII text must be converted to UTF-8 first (see
+   @ref utf_utils).
+
+   The bytes are classified with tables, and the runs of bytes that do
+   not need to be encoded (or decoded) are copied in blocks of 16 bytes
+   with SSE2 instructions when the compiler targets them.
+
+   A big text can be encoded or decoded in parts (e.g. while it is
+   read), using buffers (#url_encode, UrlDecoder) or iterators.
+
+   @see encode_url, decode_url
+*/
+
+struct UrlEncodingEnum
+{
+  enum enumeration {
+    Component,
+    Url
+  };
+  static const enumeration default_value = Component;
+};
+
+/**
+   Characters that are encoded by #url_encode.
+
+   One of the following values:
+   @li UrlEncoding::Component (default): everything except the
+       unreserved characters (letters, digits, '-', '.', '_' and '~'),
+       for a part of the URL (e.g. a value of the query string).
+   @li UrlEncoding::Url: the characters that cannot be in a URL
+       (spaces, control characters, non-ASCII bytes, '"', '<', '>',
+       '\\', '^', '`', '{', '|' and '}'). The delimiters (like '/',
+       '?', '&' or '=') and the '%' of escapes are not encoded.
+*/
+typedef Enum<UrlEncodingEnum> UrlEncoding;
+
+VACA_DLL std::size_t url_encode(const char* src, std::size_t len, char* dst,
+				UrlEncoding encoding = UrlEncoding::Component);
+
+VACA_DLL std::size_t url_decode(const char* src, std::size_t len, char* dst,
+				bool plusAsSpace = false);
+
+/**
+   Decodes a URL that is received in parts. An escape ("%XX") can be
+   split between two parts.
+
+   @code
+   UrlDecoder decoder;
+   while ((len = read(buf, sizeof(buf))) > 0) {
+     n = decoder.decode(buf, len, out);  // out has space for len+2 bytes
+     ...
+   }
+   n = decoder.finish(out);
+   @endcode
+*/
+class VACA_DLL UrlDecoder
+{
+  char m_pending[2];		// the beginning of an incomplete escape
+  std::size_t m_pendingSize;
+  bool m_plusAsSpace;
+
+public:
+  explicit UrlDecoder(bool plusAsSpace = false);
+
+  std::size_t decode(const char* src, std::size_t len, char* dst);
+  std::size_t finish(char* dst);
+};
+
+/**
+   Encodes the bytes in [first, last) writing the result in @a out.
+   The bytes are encoded in blocks with #url_encode.
+*/
+template<class InputIterator, class OutputIterator>
+OutputIterator url_encode(InputIterator first, InputIterator last, OutputIterator out,
+			  UrlEncoding encoding = UrlEncoding::Component)
+{
+  char src[256], dst[3*256];
+  while (first != last) {
+    std::size_t n = 0;
+    for (; n < sizeof(src) && first != last; ++first)
+      src[n++] = static_cast<char>(*first);
+    out = std::copy(dst, dst + url_encode(src, n, dst, encoding), out);
+  }
+  return out;
+}
+
+/**
+   Decodes the bytes in [first, last) writing the result in @a out.
+*/
+template<class InputIterator, class OutputIterator>
+OutputIterator url_decode(InputIterator first, InputIterator last, OutputIterator out,
+			  bool plusAsSpace = false)
+{
+  UrlDecoder decoder(plusAsSpace);
+  char src[256], dst[256+2];
+  while (first != last) {
+    std::size_t n = 0;
+    for (; n < sizeof(src) && first != last; ++first)
+      src[n++] = static_cast<char>(*first);
+    out = std::copy(dst, dst + decoder.decode(src, n, dst), out);
+  }
+  return std::copy(dst, dst + decoder.finish(dst), out);
+}
+
+/** @} */
+
+} // namespace vaca
+
+#endif // VACA_URLENCODING_H
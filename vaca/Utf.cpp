@@ -0,0 +1,687 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#include "vaca/Utf.h"
+#include "vaca/String.h"
+
+#if defined(__AVX2__)
+  #include <immintrin.h>
+  #define VACA_UTF_SSE2
+  #define VACA_UTF_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define VACA_UTF_SSE2
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__aarch64__)
+  #include <arm_neon.h>
+  #define VACA_UTF_NEON
+#endif
+
+using namespace vaca;
+
+namespace {
+
+  typedef unsigned char Byte;
+
+  const char32_t replacement_char = 0xFFFD;
+
+  // Characters converted one by one when a SIMD block is not ASCII
+  // (before trying with SIMD again)
+  enum { Block = 16 };
+
+  // ======================================================================
+  // ASCII runs
+  //
+  // Each function converts the longest prefix of ASCII characters
+  // that fits in complete SIMD blocks, and returns the number of
+  // characters converted (zero without SIMD support).
+
+  template<class Unit16>
+  std::size_t ascii_utf8_to_16(const Byte* src, std::size_t len, Unit16* dst)
+  {
+    std::size_t i = 0;
+#if defined(VACA_UTF_AVX2)
+    for (; i+32 <= len; i += 32) {
+      __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src+i));
+      if (_mm256_movemask_epi8(v) != 0)
+	break;
+      __m128i lo = _mm256_castsi256_si128(v);
+      __m128i hi = _mm256_extracti128_si256(v, 1);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst+i), _mm256_cvtepu8_epi16(lo));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst+i+16), _mm256_cvtepu8_epi16(hi));
+    }
+#endif
+#if defined(VACA_UTF_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i+16 <= len; i += 16) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i));
+      if (_mm_movemask_epi8(v) != 0)
+	break;
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i), _mm_unpacklo_epi8(v, zero));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i+8), _mm_unpackhi_epi8(v, zero));
+    }
+#elif defined(VACA_UTF_NEON)
+    for (; i+16 <= len; i += 16) {
+      uint8x16_t v = vld1q_u8(src+i);
+      if (vmaxvq_u8(v) >= 0x80)
+	break;
+      vst1q_u16(reinterpret_cast<uint16_t*>(dst+i), vmovl_u8(vget_low_u8(v)));
+      vst1q_u16(reinterpret_cast<uint16_t*>(dst+i+8), vmovl_u8(vget_high_u8(v)));
+    }
+#endif
+    return i;
+  }
+
+  template<class Unit32>
+  std::size_t ascii_utf8_to_32(const Byte* src, std::size_t len, Unit32* dst)
+  {
+    std::size_t i = 0;
+#if defined(VACA_UTF_AVX2)
+    for (; i+16 <= len; i += 16) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i));
+      if (_mm_movemask_epi8(v) != 0)
+	break;
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst+i), _mm256_cvtepu8_epi32(v));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst+i+8),
+			  _mm256_cvtepu8_epi32(_mm_srli_si128(v, 8)));
+    }
+#elif defined(VACA_UTF_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i+16 <= len; i += 16) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i));
+      if (_mm_movemask_epi8(v) != 0)
+	break;
+      __m128i lo = _mm_unpacklo_epi8(v, zero);
+      __m128i hi = _mm_unpackhi_epi8(v, zero);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i), _mm_unpacklo_epi16(lo, zero));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i+4), _mm_unpackhi_epi16(lo, zero));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i+8), _mm_unpacklo_epi16(hi, zero));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i+12), _mm_unpackhi_epi16(hi, zero));
+    }
+#elif defined(VACA_UTF_NEON)
+    for (; i+16 <= len; i += 16) {
+      uint8x16_t v = vld1q_u8(src+i);
+      if (vmaxvq_u8(v) >= 0x80)
+	break;
+      uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+      uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+      uint32_t* d = reinterpret_cast<uint32_t*>(dst+i);
+      vst1q_u32(d, vmovl_u16(vget_low_u16(lo)));
+      vst1q_u32(d+4, vmovl_u16(vget_high_u16(lo)));
+      vst1q_u32(d+8, vmovl_u16(vget_low_u16(hi)));
+      vst1q_u32(d+12, vmovl_u16(vget_high_u16(hi)));
+    }
+#endif
+    return i;
+  }
+
+  template<class Unit16>
+  std::size_t ascii_utf16_to_8(const Unit16* src, std::size_t len, Byte* dst)
+  {
+    std::size_t i = 0;
+#if defined(VACA_UTF_AVX2)
+    const __m256i mask256 = _mm256_set1_epi16((short)0xFF80);
+    for (; i+32 <= len; i += 32) {
+      __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src+i));
+      __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src+i+16));
+      if (!_mm256_testz_si256(_mm256_or_si256(a, b), mask256))
+	break;
+      // packus works in 128-bit lanes, permute to restore the order
+      __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst+i), packed);
+    }
+#endif
+#if defined(VACA_UTF_SSE2)
+    const __m128i mask = _mm_set1_epi16((short)0xFF80);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i+16 <= len; i += 16) {
+      __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i));
+      __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i+8));
+      __m128i high = _mm_and_si128(_mm_or_si128(a, b), mask);
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(high, zero)) != 0xFFFF)
+	break;
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i), _mm_packus_epi16(a, b));
+    }
+#elif defined(VACA_UTF_NEON)
+    for (; i+16 <= len; i += 16) {
+      uint16x8_t a = vld1q_u16(reinterpret_cast<const uint16_t*>(src+i));
+      uint16x8_t b = vld1q_u16(reinterpret_cast<const uint16_t*>(src+i+8));
+      if (vmaxvq_u16(vorrq_u16(a, b)) >= 0x80)
+	break;
+      vst1q_u8(dst+i, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+    }
+#endif
+    return i;
+  }
+
+  template<class Unit32>
+  std::size_t ascii_utf32_to_8(const Unit32* src, std::size_t len, Byte* dst)
+  {
+    std::size_t i = 0;
+#if defined(VACA_UTF_SSE2)
+    const __m128i mask = _mm_set1_epi32((int)0xFFFFFF80);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i+16 <= len; i += 16) {
+      const __m128i* s = reinterpret_cast<const __m128i*>(src+i);
+      __m128i a = _mm_loadu_si128(s);
+      __m128i b = _mm_loadu_si128(s+1);
+      __m128i c = _mm_loadu_si128(s+2);
+      __m128i d = _mm_loadu_si128(s+3);
+      __m128i high = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b),
+						_mm_or_si128(c, d)), mask);
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(high, zero)) != 0xFFFF)
+	break;
+      // values are less than 0x80, so the signed saturation does nothing
+      __m128i ab = _mm_packs_epi32(a, b);
+      __m128i cd = _mm_packs_epi32(c, d);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst+i), _mm_packus_epi16(ab, cd));
+    }
+#elif defined(VACA_UTF_NEON)
+    for (; i+8 <= len; i += 8) {
+      uint32x4_t a = vld1q_u32(reinterpret_cast<const uint32_t*>(src+i));
+      uint32x4_t b = vld1q_u32(reinterpret_cast<const uint32_t*>(src+i+4));
+      if (vmaxvq_u32(vorrq_u32(a, b)) >= 0x80)
+	break;
+      uint16x8_t ab = vcombine_u16(vmovn_u32(a), vmovn_u32(b));
+      vst1_u8(dst+i, vmovn_u16(ab));
+    }
+#endif
+    return i;
+  }
+
+  // ======================================================================
+  // Scalar coding
+
+  // Decodes a non-ASCII UTF-8 sequence. Returns its length, or the
+  // negative length of the invalid prefix (the "maximal subpart" to
+  // replace with U+FFFD, as the Unicode standard recommends).
+  inline int decode_utf8(const Byte* s, const Byte* end, char32_t& cp)
+  {
+    Byte c = s[0];
+    Byte lo = 0x80, hi = 0xBF;
+    int n;
+
+    if (c < 0xC2)		// continuation or overlong lead byte
+      return -1;
+    else if (c < 0xE0) {
+      n = 2;
+      cp = c & 0x1F;
+    }
+    else if (c < 0xF0) {
+      n = 3;
+      cp = c & 0x0F;
+      if (c == 0xE0) lo = 0xA0;	// overlong
+      else if (c == 0xED) hi = 0x9F; // surrogates
+    }
+    else if (c < 0xF5) {
+      n = 4;
+      cp = c & 0x07;
+      if (c == 0xF0) lo = 0x90;	// overlong
+      else if (c == 0xF4) hi = 0x8F; // bigger than U+10FFFF
+    }
+    else
+      return -1;
+
+    for (int i=1; i<n; ++i) {
+      if (s+i == end || s[i] < lo || s[i] > hi)
+	return -i;
+      cp = (cp << 6) | (s[i] & 0x3F);
+      lo = 0x80;
+      hi = 0xBF;
+    }
+    return n;
+  }
+
+  inline Byte* encode_utf8(char32_t cp, Byte* d)
+  {
+    if (cp < 0x80) {
+      *d++ = (Byte)cp;
+    }
+    else if (cp < 0x800) {
+      *d++ = (Byte)(0xC0 | (cp >> 6));
+      *d++ = (Byte)(0x80 | (cp & 0x3F));
+    }
+    else if (cp < 0x10000) {
+      *d++ = (Byte)(0xE0 | (cp >> 12));
+      *d++ = (Byte)(0x80 | ((cp >> 6) & 0x3F));
+      *d++ = (Byte)(0x80 | (cp & 0x3F));
+    }
+    else {
+      *d++ = (Byte)(0xF0 | (cp >> 18));
+      *d++ = (Byte)(0x80 | ((cp >> 12) & 0x3F));
+      *d++ = (Byte)(0x80 | ((cp >> 6) & 0x3F));
+      *d++ = (Byte)(0x80 | (cp & 0x3F));
+    }
+    return d;
+  }
+
+  template<class Unit16>
+  inline Unit16* encode_utf16(char32_t cp, Unit16* d)
+  {
+    if (cp < 0x10000)
+      *d++ = (Unit16)cp;
+    else {
+      cp -= 0x10000;
+      *d++ = (Unit16)(0xD800 | (cp >> 10));
+      *d++ = (Unit16)(0xDC00 | (cp & 0x3FF));
+    }
+    return d;
+  }
+
+  inline bool is_high_surrogate(char32_t u) { return (u & 0xFC00) == 0xD800; }
+  inline bool is_low_surrogate(char32_t u) { return (u & 0xFC00) == 0xDC00; }
+
+  // ======================================================================
+  // Conversions
+
+  template<class Unit16>
+  std::size_t convert_utf8_to_utf16(const char* src, std::size_t len, Unit16* dst, bool replace)
+  {
+    const Byte* s = reinterpret_cast<const Byte*>(src);
+    const Byte* end = s + len;
+    Unit16* d = dst;
+
+    while (s != end) {
+      std::size_t n = ascii_utf8_to_16(s, end-s, d);
+      s += n;
+      d += n;
+
+      // a block with non-ASCII characters (or the tail)
+      const Byte* stop = (end-s > Block ? s+Block: end);
+      while (s < stop) {
+	if (*s < 0x80) {
+	  *d++ = *s++;
+	  continue;
+	}
+
+	char32_t cp;
+	int r = decode_utf8(s, end, cp);
+	if (r < 0) {
+	  if (!replace)
+	    return utf_error;
+	  *d++ = (Unit16)replacement_char;
+	  s += -r;
+	}
+	else {
+	  d = encode_utf16(cp, d);
+	  s += r;
+	}
+      }
+    }
+    return d - dst;
+  }
+
+  template<class Unit32>
+  std::size_t convert_utf8_to_utf32(const char* src, std::size_t len, Unit32* dst, bool replace)
+  {
+    const Byte* s = reinterpret_cast<const Byte*>(src);
+    const Byte* end = s + len;
+    Unit32* d = dst;
+
+    while (s != end) {
+      std::size_t n = ascii_utf8_to_32(s, end-s, d);
+      s += n;
+      d += n;
+
+      const Byte* stop = (end-s > Block ? s+Block: end);
+      while (s < stop) {
+	if (*s < 0x80) {
+	  *d++ = *s++;
+	  continue;
+	}
+
+	char32_t cp;
+	int r = decode_utf8(s, end, cp);
+	if (r < 0) {
+	  if (!replace)
+	    return utf_error;
+	  *d++ = replacement_char;
+	  s += -r;
+	}
+	else {
+	  *d++ = cp;
+	  s += r;
+	}
+      }
+    }
+    return d - dst;
+  }
+
+  template<class Unit16>
+  std::size_t convert_utf16_to_utf8(const Unit16* src, std::size_t len, char* dst, bool replace)
+  {
+    const Unit16* s = src;
+    const Unit16* end = s + len;
+    Byte* d = reinterpret_cast<Byte*>(dst);
+
+    while (s != end) {
+      std::size_t n = ascii_utf16_to_8(s, end-s, d);
+      s += n;
+      d += n;
+
+      const Unit16* stop = (end-s > Block ? s+Block: end);
+      while (s < stop) {
+	char32_t cp = (char32_t)*s++;
+	if (cp >= 0xD800 && cp <= 0xDFFF) {
+	  if (is_high_surrogate(cp) && s != end && is_low_surrogate(*s))
+	    cp = 0x10000 + ((cp - 0xD800) << 10) + ((char32_t)*s++ - 0xDC00);
+	  else if (replace)
+	    cp = replacement_char;
+	  else
+	    return utf_error;
+	}
+	d = encode_utf8(cp, d);
+      }
+    }
+    return d - reinterpret_cast<Byte*>(dst);
+  }
+
+  template<class Unit32>
+  std::size_t convert_utf32_to_utf8(const Unit32* src, std::size_t len, char* dst, bool replace)
+  {
+    const Unit32* s = src;
+    const Unit32* end = s + len;
+    Byte* d = reinterpret_cast<Byte*>(dst);
+
+    while (s != end) {
+      std::size_t n = ascii_utf32_to_8(s, end-s, d);
+      s += n;
+      d += n;
+
+      const Unit32* stop = (end-s > Block ? s+Block: end);
+      while (s < stop) {
+	char32_t cp = (char32_t)*s++;
+	if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+	  if (!replace)
+	    return utf_error;
+	  cp = replacement_char;
+	}
+	d = encode_utf8(cp, d);
+      }
+    }
+    return d - reinterpret_cast<Byte*>(dst);
+  }
+
+  // ======================================================================
+  // Lengths (of valid input)
+
+  // Returns the number of bytes that are not UTF-8 continuation bytes
+  // plus "extra" for each 4-bytes lead byte
+  std::size_t count_utf8_units(const char* src, std::size_t len, std::size_t extra)
+  {
+    const Byte* s = reinterpret_cast<const Byte*>(src);
+    std::size_t count = 0;
+    std::size_t i = 0;
+
+#if defined(VACA_UTF_SSE2)
+    // as signed bytes, continuation bytes are in [-128, -65] and
+    // 4-bytes leads in [-16, -1]
+    const __m128i cont = _mm_set1_epi8(-65);
+    const __m128i lead4 = _mm_set1_epi8(-17);
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ext = _mm_set1_epi8((char)extra);
+
+    while (i+16 <= len) {
+      // each byte adds 2 at most, accumulate 127 blocks in 8 bits
+      __m128i acc = zero;
+      for (int k=0; k<127 && i+16 <= len; ++k, i += 16) {
+	__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s+i));
+	__m128i isLead4 = _mm_and_si128(_mm_cmpgt_epi8(v, lead4),
+					_mm_cmplt_epi8(v, zero));
+	acc = _mm_add_epi8(acc, _mm_and_si128(_mm_cmpgt_epi8(v, cont), one));
+	acc = _mm_add_epi8(acc, _mm_and_si128(isLead4, ext));
+      }
+      __m128i sum = _mm_sad_epu8(acc, zero);
+      count += _mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_srli_si128(sum, 8));
+    }
+#endif
+
+    for (; i<len; ++i) {
+      if ((s[i] & 0xC0) != 0x80) ++count;
+      if (s[i] >= 0xF0) count += extra;
+    }
+    return count;
+  }
+
+  template<class Unit16>
+  std::size_t count_utf8_length_from_utf16(const Unit16* src, std::size_t len)
+  {
+    std::size_t count = 0;
+    std::size_t i = 0;
+
+#if defined(VACA_UTF_SSE2)
+    // ASCII blocks
+    const __m128i mask = _mm_set1_epi16((short)0xFF80);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i+8 <= len; i += 8) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src+i));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, mask), zero)) != 0xFFFF)
+	break;
+      count += 8;
+    }
+#endif
+
+    for (; i<len; ++i) {
+      char32_t u = (char32_t)src[i];
+      if (u < 0x80) count += 1;
+      else if (u < 0x800) count += 2;
+      else if (is_high_surrogate(u)) count += 1; // 4 bytes with the low surrogate
+      else count += 3;
+    }
+    return count;
+  }
+
+  template<class Unit32>
+  std::size_t count_utf8_length_from_utf32(const Unit32* src, std::size_t len)
+  {
+    std::size_t count = 0;
+    for (std::size_t i=0; i<len; ++i) {
+      char32_t u = (char32_t)src[i];
+      if (u < 0x80) count += 1;
+      else if (u < 0x800) count += 2;
+      else if (u < 0x10000) count += 3;
+      else count += 4;
+    }
+    return count;
+  }
+
+  // Dispatches the wchar_t functions
+  template<int Size> struct Wide;
+
+  template<> struct Wide<2> {
+    static std::size_t lengthFromUtf8(const char* s, std::size_t n) { return count_utf8_units(s, n, 1); }
+    static std::size_t utf8Length(const Char* s, std::size_t n) { return count_utf8_length_from_utf16(s, n); }
+    static std::size_t fromUtf8(const char* s, std::size_t n, Char* d, bool r) { return convert_utf8_to_utf16(s, n, d, r); }
+    static std::size_t toUtf8(const Char* s, std::size_t n, char* d, bool r) { return convert_utf16_to_utf8(s, n, d, r); }
+    enum { MaxUtf8PerUnit = 3 };
+  };
+
+  template<> struct Wide<4> {
+    static std::size_t lengthFromUtf8(const char* s, std::size_t n) { return count_utf8_units(s, n, 0); }
+    static std::size_t utf8Length(const Char* s, std::size_t n) { return count_utf8_length_from_utf32(s, n); }
+    static std::size_t fromUtf8(const char* s, std::size_t n, Char* d, bool r) { return convert_utf8_to_utf32(s, n, d, r); }
+    static std::size_t toUtf8(const Char* s, std::size_t n, char* d, bool r) { return convert_utf32_to_utf8(s, n, d, r); }
+    enum { MaxUtf8PerUnit = 4 };
+  };
+
+  typedef Wide<sizeof(Char)> WideChar;
+
+}
+
+/**
+   Returns true if @a src is a valid UTF-8 string.
+*/
+bool vaca::is_valid_utf8(const char* src, std::size_t len)
+{
+  const Byte* s = reinterpret_cast<const Byte*>(src);
+  const Byte* end = s + len;
+
+  while (s != end) {
+#if defined(VACA_UTF_SSE2)
+    while (end-s >= 16 &&
+	   _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s))) == 0)
+      s += 16;
+    if (s == end)
+      break;
+#endif
+    if (*s < 0x80)
+      ++s;
+    else {
+      char32_t cp;
+      int r = decode_utf8(s, end, cp);
+      if (r < 0)
+	return false;
+      s += r;
+    }
+  }
+  return true;
+}
+
+/**
+   Returns the number of UTF-16 units of the valid UTF-8 string @a src.
+*/
+std::size_t vaca::utf16_length_from_utf8(const char* src, std::size_t len)
+{
+  return count_utf8_units(src, len, 1);
+}
+
+/**
+   Returns the number of code points of the valid UTF-8 string @a src.
+*/
+std::size_t vaca::utf32_length_from_utf8(const char* src, std::size_t len)
+{
+  return count_utf8_units(src, len, 0);
+}
+
+/**
+   Returns the number of bytes to encode the valid UTF-16 string @a src
+   in UTF-8.
+*/
+std::size_t vaca::utf8_length_from_utf16(const char16_t* src, std::size_t len)
+{
+  return count_utf8_length_from_utf16(src, len);
+}
+
+/**
+   Returns the number of bytes to encode the valid UTF-32 string @a src
+   in UTF-8.
+*/
+std::size_t vaca::utf8_length_from_utf32(const char32_t* src, std::size_t len)
+{
+  return count_utf8_length_from_utf32(src, len);
+}
+
+/**
+   Converts @a len bytes of UTF-8 to UTF-16.
+
+   @return The number of units written in @a dst, or #utf_error.
+*/
+std::size_t vaca::utf8_to_utf16(const char* src, std::size_t len, char16_t* dst, bool replaceInvalid)
+{
+  return convert_utf8_to_utf16(src, len, dst, replaceInvalid);
+}
+
+/**
+   Converts @a len bytes of UTF-8 to UTF-32.
+
+   @return The number of code points written in @a dst, or #utf_error.
+*/
+std::size_t vaca::utf8_to_utf32(const char* src, std::size_t len, char32_t* dst, bool replaceInvalid)
+{
+  return convert_utf8_to_utf32(src, len, dst, replaceInvalid);
+}
+
+/**
+   Converts @a len units of UTF-16 to UTF-8.
+
+   @return The number of bytes written in @a dst, or #utf_error.
+*/
+std::size_t vaca::utf16_to_utf8(const char16_t* src, std::size_t len, char* dst, bool replaceInvalid)
+{
+  return convert_utf16_to_utf8(src, len, dst, replaceInvalid);
+}
+
+/**
+   Converts @a len code points of UTF-32 to UTF-8.
+
+   @return The number of bytes written in @a dst, or #utf_error.
+*/
+std::size_t vaca::utf32_to_utf8(const char32_t* src, std::size_t len, char* dst, bool replaceInvalid)
+{
+  return convert_utf32_to_utf8(src, len, dst, replaceInvalid);
+}
+
+std::size_t vaca::wide_length_from_utf8(const char* src, std::size_t len)
+{
+  return WideChar::lengthFromUtf8(src, len);
+}
+
+std::size_t vaca::utf8_length_from_wide(const Char* src, std::size_t len)
+{
+  return WideChar::utf8Length(src, len);
+}
+
+std::size_t vaca::utf8_to_wide(const char* src, std::size_t len, Char* dst, bool replaceInvalid)
+{
+  return WideChar::fromUtf8(src, len, dst, replaceInvalid);
+}
+
+std::size_t vaca::wide_to_utf8(const Char* src, std::size_t len, char* dst, bool replaceInvalid)
+{
+  return WideChar::toUtf8(src, len, dst, replaceInvalid);
+}
+
+// ======================================================================
+// String conversions
+
+/**
+   Converts a String to UTF-8.
+
+   Invalid characters (unpaired surrogates) are converted to U+FFFD.
+   The result is written directly in the returned string, its size is
+   calculated before the conversion.
+
+   @see from_utf8, @ref utf_utils
+*/
+std::string vaca::to_utf8(const String& string)
+{
+  std::string res;
+  if (string.empty())
+    return res;
+
+  res.resize(utf8_length_from_wide(string.data(), string.size()));
+  std::size_t n = wide_to_utf8(string.data(), string.size(), &res[0]);
+
+  // invalid input, the size can be different with replacements
+  if (n == utf_error) {
+    res.resize(string.size() * WideChar::MaxUtf8PerUnit);
+    res.resize(wide_to_utf8(string.data(), string.size(), &res[0], true));
+  }
+  return res;
+}
+
+/**
+   Converts a UTF-8 string to a String.
+
+   Invalid UTF-8 sequences are converted to U+FFFD.
+
+   @see to_utf8, @ref utf_utils
+*/
+String vaca::from_utf8(const std::string& string)
+{
+  String res;
+  if (string.empty())
+    return res;
+
+  res.resize(wide_length_from_utf8(string.data(), string.size()));
+  std::size_t n = utf8_to_wide(string.data(), string.size(), &res[0]);
+
+  if (n == utf_error) {
+    res.resize(string.size());
+    res.resize(utf8_to_wide(string.data(), string.size(), &res[0], true));
+  }
+  return res;
+}
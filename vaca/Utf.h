@@ -0,0 +1,71 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#ifndef VACA_UTF_H
+#define VACA_UTF_H
+
+#include "vaca/base.h"
+
+#include <cstddef>
+
+namespace vaca {
+
+/**
+   @defgroup utf_utils UTF Transcoding
+   @{
+
+   Conversions between UTF-8, UTF-16 and UTF-32.
+
+   The input is validated strictly: overlong sequences, surrogates
+   encoded in UTF-8, unpaired surrogates in UTF-16 and code points
+   bigger than U+10FFFF are invalid. By default the conversion
+   functions return #utf_error when they find an invalid sequence; if
+   @a replaceInvalid is true, each invalid sequence is converted to
+   U+FFFD (the replacement character) instead.
+
+   The destination buffer must have space for the result. Use the
+   @c *_length_from_* functions to know the exact size of the
+   converted valid input. If the input can be invalid and
+   @a replaceInvalid is true, reserve the maximum size:
+   @li @a len units for UTF-8 to UTF-16/UTF-32,
+   @li <tt>3*len</tt> bytes for UTF-16 to UTF-8,
+   @li <tt>4*len</tt> bytes for UTF-32 to UTF-8.
+
+   ASCII runs are converted with SSE2, AVX2 or NEON instructions when
+   the compiler targets them (e.g. @c -mavx2 for AVX2).
+
+   @see to_utf8, from_utf8
+*/
+
+/**
+   Value returned by the conversion functions when the input is not
+   valid.
+*/
+const std::size_t utf_error = static_cast<std::size_t>(-1);
+
+VACA_DLL bool is_valid_utf8(const char* src, std::size_t len);
+
+VACA_DLL std::size_t utf16_length_from_utf8(const char* src, std::size_t len);
+VACA_DLL std::size_t utf32_length_from_utf8(const char* src, std::size_t len);
+VACA_DLL std::size_t utf8_length_from_utf16(const char16_t* src, std::size_t len);
+VACA_DLL std::size_t utf8_length_from_utf32(const char32_t* src, std::size_t len);
+
+VACA_DLL std::size_t utf8_to_utf16(const char* src, std::size_t len, char16_t* dst, bool replaceInvalid = false);
+VACA_DLL std::size_t utf8_to_utf32(const char* src, std::size_t len, char32_t* dst, bool replaceInvalid = false);
+VACA_DLL std::size_t utf16_to_utf8(const char16_t* src, std::size_t len, char* dst, bool replaceInvalid = false);
+VACA_DLL std::size_t utf32_to_utf8(const char32_t* src, std::size_t len, char* dst, bool replaceInvalid = false);
+
+// Char (wchar_t) is UTF-16 on Windows and UTF-32 in other platforms
+VACA_DLL std::size_t wide_length_from_utf8(const char* src, std::size_t len);
+VACA_DLL std::size_t utf8_length_from_wide(const Char* src, std::size_t len);
+VACA_DLL std::size_t utf8_to_wide(const char* src, std::size_t len, Char* dst, bool replaceInvalid = false);
+VACA_DLL std::size_t wide_to_utf8(const Char* src, std::size_t len, char* dst, bool replaceInvalid = false);
+
+/** @} */
+
+} // namespace vaca
+
+#endif // VACA_UTF_H
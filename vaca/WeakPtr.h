@@ -0,0 +1,135 @@
+// Vaca - Visual Application Components Abstraction
+// Copyright (c) 2005-2010 David Capello
+//
+// This file is distributed under the terms of the MIT license,
+// please read LICENSE.txt for more information.
+
+#ifndef VACA_WEAKPTR_H
+#define VACA_WEAKPTR_H
+
+#include "vaca/base.h"
+#include "vaca/SharedPtr.h"
+
+namespace vaca {
+
+/**
+   A pointer to a referenceable object that does not keep it alive.
+
+   It is useful for caches (e.g. of fonts or images): the cache can
+   hold WeakPtrs to the objects and give a SharedPtr to the user
+   (using #lock) only while some other SharedPtr still references the
+   object.
+
+   The WeakPtrs of an object share a control block that is created
+   with the first WeakPtr. It can be used from several threads if @a T
+   uses the AtomicRefCount policy (like Referenceable).
+
+   @code
+   SharedPtr<ImageHandle> handle = ...;
+   WeakPtr<ImageHandle> weak(handle);
+   ...
+   if (SharedPtr<ImageHandle> handle = weak.lock()) {
+     // the handle is still alive
+   }
+   @endcode
+
+   @tparam T Must be of Referenceable type (or any BasicReferenceable).
+
+   @see SharedPtr
+*/
+template<class T>
+class WeakPtr
+{
+  T* m_ptr;
+  details::WeakRefBlock* m_block;
+
+public:
+
+  WeakPtr() {
+    m_ptr = NULL;
+    m_block = NULL;
+  }
+
+  WeakPtr(const SharedPtr<T>& ptr) {
+    m_ptr = ptr.get();
+    m_block = m_ptr ? m_ptr->getWeakRefBlock(): NULL;
+    if (m_block)
+      m_block->ref();
+  }
+
+  WeakPtr(const WeakPtr<T>& other) {
+    m_ptr = other.m_ptr;
+    m_block = other.m_block;
+    if (m_block)
+      m_block->ref();
+  }
+
+  WeakPtr(WeakPtr<T>&& other) {
+    m_ptr = other.m_ptr;
+    m_block = other.m_block;
+    other.m_ptr = NULL;
+    other.m_block = NULL;
+  }
+
+  ~WeakPtr() {
+    if (m_block)
+      m_block->unref();
+  }
+
+  WeakPtr& operator=(WeakPtr<T> other) {
+    swap(other);
+    return *this;
+  }
+
+  void reset() {
+    WeakPtr<T>().swap(*this);
+  }
+
+  void swap(WeakPtr<T>& other) {
+    T* ptr = m_ptr;
+    details::WeakRefBlock* block = m_block;
+    m_ptr = other.m_ptr;
+    m_block = other.m_block;
+    other.m_ptr = ptr;
+    other.m_block = block;
+  }
+
+  /**
+     Returns true if the object was deleted (or if this WeakPtr is
+     empty).
+
+     The object can be deleted just after this function returns false,
+     use #lock to get a reference to it.
+  */
+  bool isExpired() const {
+    if (!m_block)
+      return true;
+
+    m_block->lock();
+    bool expired = m_block->isExpired() || m_ptr->getRefCount() == 0;
+    m_block->unlock();
+    return expired;
+  }
+
+  /**
+     Returns a SharedPtr to the object, or an empty SharedPtr if it
+     was already deleted.
+  */
+  SharedPtr<T> lock() const {
+    if (!m_block)
+      return SharedPtr<T>();
+
+    m_block->lock();
+    bool alive = (!m_block->isExpired() && m_ptr->m_refCount.tryRef());
+    m_block->unlock();
+
+    if (alive)
+      return SharedPtr<T>(m_ptr, typename SharedPtr<T>::AdoptRef());
+    else
+      return SharedPtr<T>();
+  }
+};
+
+} // namespace vaca
+
+#endif // VACA_WEAKPTR_H
@@ -14,6 +14,7 @@
 #include "vaca/DropFilesEvent.h"
 #include "vaca/Font.h"
 #include "vaca/Frame.h"
+#include "vaca/FrameArena.h"
 #include "vaca/Image.h"
 #include "vaca/KeyEvent.h"
 #include "vaca/Layout.h"
@@ -24,7 +25,9 @@
 #include "vaca/System.h"
 #include "vaca/Mutex.h"
 #include "vaca/ScopedLock.h"
+#include "vaca/SpatialIndex.h"
 #include "vaca/Command.h"
+#include "vaca/CompactString.h"
 #include "vaca/ScrollInfo.h"
 #include "vaca/ScrollEvent.h"
 #include "vaca/FocusEvent.h"
@@ -181,10 +184,29 @@ void Widget::initialize()
   m_hasMouse          = false;
   m_deleteAfterEvent  = false;
   m_doubleBuffered    = false;
+  m_paintByRects      = false;
   m_preferredSize     = NULL;
   m_defWndProc        = ::DefWindowProc;
   m_destroyHandleProc = Widget_DestroyHandleProc;
   m_hbrush            = NULL;
+  m_childIndex        = NULL;
+  m_zOrder            = 0;
+  m_zOrderValid       = false;
+
+  // names for vaca::profiling
+  Resize.setName("Widget::Resize");
+  MouseEnter.setName("Widget::MouseEnter");
+  MouseLeave.setName("Widget::MouseLeave");
+  MouseDown.setName("Widget::MouseDown");
+  MouseUp.setName("Widget::MouseUp");
+  MouseMove.setName("Widget::MouseMove");
+  MouseWheel.setName("Widget::MouseWheel");
+  DoubleClick.setName("Widget::DoubleClick");
+  KeyUp.setName("Widget::KeyUp");
+  KeyDown.setName("Widget::KeyDown");
+  FocusEnter.setName("Widget::FocusEnter");
+  FocusLeave.setName("Widget::FocusLeave");
+  DropFiles.setName("Widget::DropFiles");
 }
 
 /**
@@ -233,6 +255,7 @@ Widget::~Widget()
   m_constraint = NULL;		// unref the constraint
   m_layout = NULL;		// unref the layout manager
   delete m_preferredSize;	// delete the preferred size
+  delete m_childIndex;		// delete the index of children
 
   // restore the old window-procedure
   if (m_baseWndProc != NULL)
@@ -380,6 +403,59 @@ bool Widget::hasChild(const Widget* child) const
   return std::find(m_children.begin(), m_children.end(), child) != m_children.end();
 }
 
+/**
+   Returns the visible child that contains the specified point
+   (relative to the client area), or NULL if there is not a child
+   there. When children are overlapped, returns the last one in the
+   list of children (the one that is above the others).
+
+   The children are found with a SpatialIndex of their bounds, so it
+   is fast even with thousands of children (e.g. the shapes of a
+   diagram editor). Overlapped children are compared by their
+   position in the list, which is numbered again only when the list
+   has changed.
+
+   @see getChildrenIn
+*/
+Widget* Widget::getChildAt(const Point& pt) const
+{
+  WidgetList candidates;
+  getChildIndex().findAt(pt, candidates);
+
+  // number the children again if the list was changed
+  if (candidates.size() > 1 && !m_zOrderValid) {
+    int zOrder = 0;
+    for (WidgetList::const_iterator
+	   it = m_children.begin(); it != m_children.end(); ++it)
+      (*it)->m_zOrder = zOrder++;
+    m_zOrderValid = true;
+  }
+
+  Widget* top = NULL;
+  for (WidgetList::iterator
+	 it = candidates.begin(); it != candidates.end(); ++it) {
+    Widget* child = *it;
+    if (child->isVisible() &&
+	(top == NULL || child->m_zOrder > top->m_zOrder))
+      top = child;
+  }
+  return top;
+}
+
+/**
+   Gets the children whose bounds intersect the specified rectangle
+   (relative to the client area), e.g. the children that must be
+   painted in a damaged area. They are not in a particular order.
+
+   Invisible children are included too.
+
+   @see getChildAt
+*/
+void Widget::getChildrenIn(const Rect& rc, WidgetList& children) const
+{
+  getChildIndex().findIntersecting(rc, children);
+}
+
 bool Widget::hasDescendant(const Widget* descendant) const
 {
   WidgetList remaining;
@@ -416,6 +492,7 @@ void Widget::moveBeforeWidget(Widget* sibling)
 
   assert(m_parent != NULL);
   remove_from_container(m_parent->m_children, this);
+  m_parent->m_zOrderValid = false;
 
   if (sibling != NULL) {
     WidgetList::iterator it =
@@ -457,6 +534,7 @@ void Widget::moveAfterWidget(Widget* sibling)
 
   assert(m_parent != NULL);
   remove_from_container(m_parent->m_children, this);
+  m_parent->m_zOrderValid = false;
 
   if (sibling != NULL) {
     WidgetList::iterator it =
@@ -536,9 +614,14 @@ void Widget::setConstraint(ConstraintPtr constraint)
    This member function is called from Widget#onResize, so when the
    Widget is shown for first time or it is resized, the
    children are automatically positioned.
+
+   The temporaries of the layout managers are allocated in the
+   FrameArena of the thread, and given back when this function
+   returns.
 */
 void Widget::layout()
 {
+  FrameArena::Scope scope;
   LayoutEvent ev(this, getClientBounds());
   onLayout(ev);
 }
@@ -602,6 +685,27 @@ void Widget::setText(const String& str)
   ::SetWindowText(m_handle, str.c_str());
 }
 
+/**
+   Returns the text of the widget as a CompactString (e.g. to keep the
+   labels of a big form with less memory).
+
+   @see getText
+*/
+CompactString Widget::getCompactText() const
+{
+  return CompactString(getText());
+}
+
+/**
+   Changes the text of the widget with a CompactString. The text is
+   converted to a String to call #setText(const String&), so classes
+   that override that function receive the text too.
+*/
+void Widget::setText(const CompactString& str)
+{
+  setText(str.str());
+}
+
 /**
    Returns the current font used to paint the Widget.
 */
@@ -1053,6 +1157,33 @@ void Widget::setDoubleBuffered(bool doubleBuffered)
   m_doubleBuffered = doubleBuffered;
 }
 
+/**
+   Returns true if the widget is painted by rectangles.
+
+   @see setPaintByRects
+*/
+bool Widget::isPaintByRects()
+{
+  return m_paintByRects;
+}
+
+/**
+   Sets if the #onPaint event is called for each rectangle of the
+   damaged region, instead of one time for the bounds of the region.
+
+   When the damaged region is complex (e.g. two thin strips at the top
+   and the bottom of the widget) only its pixels are painted, and with
+   double-buffering the images are of the size of each rectangle. The
+   event can use Graphics#getClipBounds to know the rectangle that is
+   being painted.
+
+   @see isPaintByRects, doPaint, Region#rects
+*/
+void Widget::setPaintByRects(bool paintByRects)
+{
+  m_paintByRects = paintByRects;
+}
+
 /**
    Validates the entire widget.
 
@@ -1798,11 +1929,9 @@ void Widget::onPreferredSize(PreferredSizeEvent& ev)
 
   // there is a layout?
   if (m_layout != NULL) {
-    // get the list of children
-    WidgetList children = getChildren();
-
-    // calculate the preferred size through the layout manager
-    sz = m_layout->getPreferredSize(this, children, ev.fitInSize());
+    // calculate the preferred size through the layout manager (like
+    // onLayout, it uses the list of children directly, without a copy)
+    sz = m_layout->getPreferredSize(this, m_children, ev.fitInSize());
   }
 
   // Search for layout-free widgets
@@ -2290,6 +2419,10 @@ void Widget::addChildWin32(Widget* child, bool setParent)
 
   m_children.push_back(child);
   child->m_parent = this;
+  child->m_zOrder = static_cast<int>(m_children.size()) - 1; // the last one
+
+  if (m_childIndex != NULL)
+    m_childIndex->insert(child, child->getBounds());
 
   if (setParent) {
     child->addStyle(Style(WS_CHILD, 0));
@@ -2298,6 +2431,43 @@ void Widget::addChildWin32(Widget* child, bool setParent)
   }
 }
 
+/**
+   Returns the index of the bounds of the children. It is created (and
+   bulk-loaded with the current bounds) the first time it is used, and
+   then it is updated incrementally by #addChildWin32,
+   #removeChildWin32 and #updateIndexedBounds.
+
+   @internal
+*/
+SpatialIndex<Widget*>& Widget::getChildIndex() const
+{
+  if (m_childIndex == NULL) {
+    std::vector<SpatialIndex<Widget*>::Item> items;
+    items.reserve(m_children.size());
+    for (WidgetList::const_iterator
+	   it = m_children.begin(); it != m_children.end(); ++it)
+      items.push_back(SpatialIndex<Widget*>::Item(*it, (*it)->getBounds()));
+
+    m_childIndex = new SpatialIndex<Widget*>;
+    m_childIndex->load(items);
+  }
+  return *m_childIndex;
+}
+
+/**
+   Changes the bounds of this widget in the index of its parent (if the
+   parent has one). Called when the widget receives
+   @msdn{WM_WINDOWPOSCHANGED}, which is sent by #setBounds,
+   WidgetsMovement and any other way to move the widget.
+
+   @internal
+*/
+void Widget::updateIndexedBounds(const Rect& rc)
+{
+  if (m_parent != NULL && m_parent->m_childIndex != NULL)
+    m_parent->m_childIndex->update(this, rc);
+}
+
 /**
    Removes a child from this widget.
 
@@ -2317,6 +2487,10 @@ void Widget::removeChildWin32(Widget* child, bool setParent)
   assert(child->m_parent == this);
 
   remove_from_container(m_children, child);
+  m_zOrderValid = false;
+
+  if (m_childIndex != NULL)
+    m_childIndex->remove(child);
 
   if (setParent) {
     invalidate(child->getBounds(), true);
@@ -2572,10 +2746,24 @@ bool Widget::wndProc(UINT message, WPARAM wParam, LPARAM lParam, LRESULT& lResul
 
 	PAINTSTRUCT ps;
 	bool painted = false;
+	Region damage;
+
+	// the clipping region of the HDC does not have the damaged
+	// region, it must be got before BeginPaint validates it
+	if (m_paintByRects) {
+	  HRGN hrgn = ::CreateRectRgn(0, 0, 0, 0);
+	  if (::GetUpdateRgn(m_handle, hrgn, FALSE) == COMPLEXREGION)
+	    damage = Region(hrgn);
+	  else
+	    ::DeleteObject(hrgn);
+	}
+
 	HDC hdc = ::BeginPaint(m_handle, &ps);
 
 	if (!::IsRectEmpty(&ps.rcPaint)) {
 	  Graphics g(hdc);
+	  if (!damage.isEmpty())
+	    g.setClipRegion(damage);
 	  painted = doPaint(g);
 	}
 
@@ -2612,6 +2800,15 @@ bool Widget::wndProc(UINT message, WPARAM wParam, LPARAM lParam, LRESULT& lResul
       break;
     }
 
+    case WM_WINDOWPOSCHANGED: {
+      // the only place where the index of the parent is updated: it
+      // is sent by setBounds, WidgetsMovement, the user, the control...
+      LPWINDOWPOS pos = reinterpret_cast<LPWINDOWPOS>(lParam);
+      if ((pos->flags & (SWP_NOMOVE | SWP_NOSIZE)) != (SWP_NOMOVE | SWP_NOSIZE))
+	updateIndexedBounds(getBounds());
+      break;
+    }
+
     case WM_SETCURSOR:
       if (hasMouseAbove()) {
 	WidgetHit hitTest = WidgetHit::Error;
@@ -3018,12 +3215,50 @@ LRESULT Widget::defWndProc(UINT message, WPARAM wParam, LPARAM lParam)
    double-buffering technique (draw in a Graphics of a temporary
    Image, and then copy its content to @a g).
 
+   If #m_paintByRects is true and the clipping region of @a g is
+   complex, each rectangle of the region (see Region#rects) is painted
+   separately.
+
    @param g Where to draw.
 
    @internal
 */
 bool Widget::doPaint(Graphics& g)
 {
+  if (m_paintByRects) {
+    Region clipRegion;
+    g.getClipRegion(clipRegion);
+
+    std::vector<Rect> rects = clipRegion.rects(true);
+    if (rects.size() > 1) {
+      bool painted = false;
+
+      for (std::vector<Rect>::iterator
+	     it = rects.begin(); it != rects.end(); ++it) {
+	Region rectRegion(*it);
+	g.setClipRegion(rectRegion);
+	if (paintClipBounds(g))
+	  painted = true;
+      }
+
+      g.setClipRegion(clipRegion);
+      return painted;
+    }
+  }
+
+  return paintClipBounds(g);
+}
+
+/**
+   Paints the bounds of the clipping region of @a g calling the
+   #onPaint event one time (with double-buffering if it is activated).
+
+   @internal
+*/
+bool Widget::paintClipBounds(Graphics& g)
+{
+  // onPaint can allocate temporaries in the FrameArena
+  FrameArena::Scope scope;
   bool painted = false;
 
   // use double-buffering technique?
@@ -140,6 +140,14 @@ private:
   */
   bool m_doubleBuffered : 1;
 
+  /**
+     Calls the #onPaint event for each rectangle of the damaged region
+     (instead of one time for its bounds).
+
+     @see #setPaintByRects, #doPaint
+  */
+  bool m_paintByRects : 1;
+
   /**
      Current font of the Widget (used mainly to draw the text of the widget).
 
@@ -161,6 +169,29 @@ private:
   */
   HBRUSH m_hbrush;
 
+  /**
+     Index of the bounds of the children. It is NULL until the first
+     call to #getChildAt or #getChildrenIn.
+
+     @see getChildIndex
+  */
+  mutable SpatialIndex<Widget*>* m_childIndex;
+
+  /**
+     Position of this widget in the list of children of its parent
+     (the last one is above the others). It is valid only when the
+     parent has #m_zOrderValid.
+
+     @see getChildAt
+  */
+  mutable int m_zOrder;
+
+  /**
+     False when the list of children changes, so #getChildAt numbers
+     the #m_zOrder of the children again.
+  */
+  mutable bool m_zOrderValid;
+
   // ============================================================
   // Special hooks...
   // ============================================================
@@ -218,6 +249,9 @@ public:
   bool hasChild(const Widget* child) const;
   bool hasDescendant(const Widget* descendant) const;
 
+  Widget* getChildAt(const Point& pt) const;
+  void getChildrenIn(const Rect& rc, WidgetList& children) const;
+
   void moveBeforeWidget(Widget* sibling);
   void moveAfterWidget(Widget* sibling);
 
@@ -241,6 +275,8 @@ public:
 
   virtual String getText() const;
   virtual void setText(const String& str);
+  CompactString getCompactText() const;
+  void setText(const CompactString& str);
 
   virtual Font getFont() const;
   virtual void setFont(Font font);
@@ -296,6 +332,9 @@ public:
   bool isDoubleBuffered();
   void setDoubleBuffered(bool doubleBuffered);
 
+  bool isPaintByRects();
+  void setPaintByRects(bool paintByRects);
+
   void validate();
   void validate(const Rect& rc);
   void invalidate(bool eraseBg);
@@ -442,6 +481,9 @@ private:
   void initialize();
   void addChildWin32(Widget* child, bool setParent);
   void removeChildWin32(Widget* child, bool setParent);
+  SpatialIndex<Widget*>& getChildIndex() const;
+  bool paintClipBounds(Graphics& g);
+  void updateIndexedBounds(const Rect& rc);
 
   virtual HWND createHandle(LPCTSTR className, Widget* parent, Style style);
 
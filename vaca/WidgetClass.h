@@ -8,6 +8,7 @@
 #define VACA_WIDGETCLASS_H
 
 #include "vaca/base.h"
+#include "vaca/InternedString.h"
 
 namespace vaca {
 
@@ -29,7 +30,7 @@ public:
   static const WidgetClassName None;
 
 private:
-  String m_className;
+  InternedString m_className;
 
   WidgetClassName();		// None constructor
 
@@ -117,7 +117,7 @@ To convert_to(const From& from) {
    @see max_value, clamp_value
 */
 template<typename T>
-inline T min_value(T x, T y)
+constexpr T min_value(T x, T y)
 {
   return x < y ? x: y;
 }
@@ -131,7 +131,7 @@ inline T min_value(T x, T y)
    @see min_value, clamp_value
 */
 template<typename T>
-inline T max_value(T x, T y)
+constexpr T max_value(T x, T y)
 {
   return x > y ? x: y;
 }
@@ -146,7 +146,7 @@ inline T max_value(T x, T y)
    @see min_value, max_value
 */
 template<typename T>
-inline T clamp_value(T x, T low, T high)
+constexpr T clamp_value(T x, T low, T high)
 {
   return x > high ? high: (x < low ? low: x);
 }
@@ -409,6 +409,7 @@ class Command;
 class CommandEvent;
 class CommandsClient;
 class CommonDialog;
+class CompactString;
 class Component;
 class ConditionVariable;
 class Constraint;
@@ -520,6 +521,9 @@ class WidgetClassName;
 template<class T>
 class SharedPtr;
 
+template<typename T>
+class SpatialIndex;
+
 // ======================================================================
 // Smart Pointers
 
@@ -22,6 +22,7 @@
 #include "vaca/Button.h"
 #include "vaca/ButtonBase.h"
 #include "vaca/CancelableEvent.h"
+#include "vaca/CharConv.h"
 #include "vaca/CheckBox.h"
 #include "vaca/ClientLayout.h"
 #include "vaca/Clipboard.h"
@@ -32,6 +33,7 @@
 #include "vaca/Command.h"
 #include "vaca/CommandEvent.h"
 #include "vaca/CommonDialog.h"
+#include "vaca/CompactString.h"
 #include "vaca/Component.h"
 #include "vaca/ConditionVariable.h"
 #include "vaca/Constraint.h"
@@ -55,7 +57,9 @@
 #include "vaca/FocusEvent.h"
 #include "vaca/Font.h"
 #include "vaca/FontDialog.h"
+#include "vaca/Format.h"
 #include "vaca/Frame.h"
+#include "vaca/FrameArena.h"
 #include "vaca/GdiObject.h"
 #include "vaca/Graphics.h"
 #include "vaca/GraphicsPath.h"
@@ -64,6 +68,7 @@
 #include "vaca/Icon.h"
 #include "vaca/Image.h"
 #include "vaca/ImageList.h"
+#include "vaca/InternedString.h"
 #include "vaca/KeyEvent.h"
 #include "vaca/Keys.h"
 #include "vaca/Label.h"
@@ -79,6 +84,7 @@
 #include "vaca/MenuItemEvent.h"
 #include "vaca/Message.h"
 #include "vaca/MouseEvent.h"
+#include "vaca/MpscQueue.h"
 #include "vaca/MsgBox.h"
 #include "vaca/Mutex.h"
 #include "vaca/NonCopyable.h"
@@ -87,10 +93,14 @@
 #include "vaca/Pen.h"
 #include "vaca/Point.h"
 #include "vaca/PreferredSizeEvent.h"
+#include "vaca/PrefixIndex.h"
+#include "vaca/Profiling.h"
 #include "vaca/ProgressBar.h"
+#include "vaca/QueuedSignal.h"
 #include "vaca/RadioButton.h"
 #include "vaca/ReBar.h"
 #include "vaca/Rect.h"
+#include "vaca/RectBatch.h"
 #include "vaca/Referenceable.h"
 #include "vaca/Region.h"
 #include "vaca/Register.h"
@@ -110,15 +120,20 @@
 #include "vaca/Size.h"
 #include "vaca/Slider.h"
 #include "vaca/Slot.h"
+#include "vaca/SmallObject.h"
+#include "vaca/SpatialIndex.h"
 #include "vaca/SpinButton.h"
 #include "vaca/Spinner.h"
 #include "vaca/SplitBar.h"
 #include "vaca/StatusBar.h"
 #include "vaca/String.h"
+#include "vaca/StringView.h"
 #include "vaca/Style.h"
 #include "vaca/System.h"
 #include "vaca/Tab.h"
+#include "vaca/TextBuffer.h"
 #include "vaca/TextEdit.h"
+#include "vaca/TextSearch.h"
 #include "vaca/Thread.h"
 #include "vaca/TimePoint.h"
 #include "vaca/Timer.h"
@@ -127,6 +142,9 @@
 #include "vaca/TreeNode.h"
 #include "vaca/TreeView.h"
 #include "vaca/TreeViewEvent.h"
+#include "vaca/UrlEncoding.h"
+#include "vaca/Utf.h"
+#include "vaca/WeakPtr.h"
 #include "vaca/Widget.h"
 #include "vaca/WidgetClass.h"
 #include "vaca/WidgetHit.h"
@@ -13,6 +13,9 @@
 class vaca::WidgetsMovement::WidgetsMovementImpl
 {
   HDWP m_hdwp;
+
+  // It cannot use the FrameArena: it grows while nested scopes (like
+  // the Bix::Matrix of the layout) are open.
   WidgetList m_relayoutWidgets;
 
 public:
@@ -20,6 +23,7 @@ public:
   WidgetsMovementImpl(const WidgetList& widgets)
   {
     m_hdwp = BeginDeferWindowPos(widgets.size());
+    m_relayoutWidgets.reserve(widgets.size());
   }
 
   ~WidgetsMovementImpl()